@@ -0,0 +1,197 @@
+#include "ecs/ecs.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+// Compares the three component backends on 100k entities holding four components each: iterating all four through
+// a view, churning one component on every tenth entity (remove then emplace, two structural changes each for the
+// archetype backend), and the heap memory a component manager allocates for that world. Memory is counted by
+// replacing the global allocation functions in this binary.
+
+namespace
+{
+
+std::size_t allocated_bytes{0U};
+
+enum class ComponentType : std::uint8_t
+{
+  NONE = 0U,
+  POSITION = 1U << 0U,
+  VELOCITY = 1U << 1U,
+  MASS = 1U << 2U,
+  COLOR = 1U << 3U,
+};
+
+struct Position : rtw::ecs::Component<ComponentType, ComponentType::POSITION>
+{
+  Position(const float x, const float y, const float z) : x{x}, y{y}, z{z} {}
+  float x;
+  float y;
+  float z;
+};
+
+struct Velocity : rtw::ecs::Component<ComponentType, ComponentType::VELOCITY>
+{
+  Velocity(const float x, const float y, const float z) : x{x}, y{y}, z{z} {}
+  float x;
+  float y;
+  float z;
+};
+
+struct Mass : rtw::ecs::Component<ComponentType, ComponentType::MASS>
+{
+  explicit Mass(const float value) : value{value} {}
+  float value;
+};
+
+struct Color : rtw::ecs::Component<ComponentType, ComponentType::COLOR>
+{
+  explicit Color(const std::uint32_t rgba) : rgba{rgba} {}
+  std::uint32_t rgba;
+};
+
+constexpr std::size_t ENTITY_COUNT{100'000U};
+constexpr std::size_t CHURN_STRIDE{10U};
+constexpr std::size_t MAX_NUMBER_OF_SYSTEMS{1U};
+constexpr std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP{1U};
+constexpr float DT{1.0F / 60.0F};
+
+template <template <typename, std::size_t, typename...> class ECSManagerT>
+using World = ECSManagerT<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Position, Velocity, Mass, Color>;
+using HashMapWorld = World<rtw::ecs::ECSManager>;
+using SparseSetWorld = World<rtw::ecs::SparseSetECSManager>;
+using ArchetypeWorld = World<rtw::ecs::ArchetypeECSManager>;
+
+template <template <typename, typename...> class ComponentManagerT>
+using Components = ComponentManagerT<ComponentType, Position, Velocity, Mass, Color>;
+using HashMapComponents = Components<rtw::ecs::ComponentManager>;
+using SparseSetComponents = Components<rtw::ecs::SparseSetComponentManager>;
+using ArchetypeComponents = Components<rtw::ecs::ArchetypeComponentManager>;
+
+constexpr rtw::ecs::EntitySignature<ComponentType> SIGNATURE{ComponentType::POSITION | ComponentType::VELOCITY
+                                                             | ComponentType::MASS | ComponentType::COLOR};
+
+template <typename WorldT>
+std::unique_ptr<WorldT> make_world()
+{
+  auto world = std::make_unique<WorldT>(ENTITY_COUNT, MAX_NUMBER_OF_SYSTEMS);
+  for (std::size_t i = 0U; i < ENTITY_COUNT; ++i)
+  {
+    const auto entity = world->create_entity(SIGNATURE);
+    world->template emplace_component<Position>(entity, static_cast<float>(i), 0.0F, 0.0F);
+    world->template emplace_component<Velocity>(entity, 1.0F, 2.0F, 3.0F);
+    world->template emplace_component<Mass>(entity, 1.0F);
+    world->template emplace_component<Color>(entity, 0xFF'FF'FF'FFU);
+  }
+  return world;
+}
+
+template <typename WorldT>
+void bm_ecs_iterate(benchmark::State& state)
+{
+  auto world = make_world<WorldT>();
+  for (auto _ : state)
+  {
+    world->template view<Position, const Velocity, const Mass, Color>().each(
+        [](Position& position, const Velocity& velocity, const Mass& mass, Color& color)
+        {
+          const auto step = DT / mass.value;
+          position.x += velocity.x * step;
+          position.y += velocity.y * step;
+          position.z += velocity.z * step;
+          color.rgba ^= 1U;
+        });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * ENTITY_COUNT));
+}
+
+template <typename WorldT>
+void bm_ecs_churn(benchmark::State& state)
+{
+  auto world = make_world<WorldT>();
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0U; i < ENTITY_COUNT; i += CHURN_STRIDE)
+    {
+      const typename WorldT::Entity entity{rtw::ecs::EntityId{static_cast<rtw::ecs::EntityId::INDEX_TYPE>(i), 0U}};
+      world->template remove_component<Mass>(entity);
+      world->template emplace_component<Mass>(entity, 2.0F);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * (ENTITY_COUNT / CHURN_STRIDE)));
+}
+
+/// Builds a component manager for the world and reports the bytes it allocated.
+template <typename ComponentManagerT>
+void bm_ecs_memory(benchmark::State& state)
+{
+  std::size_t bytes = 0U;
+  for (auto _ : state)
+  {
+    const auto before = allocated_bytes;
+    auto manager = std::make_unique<ComponentManagerT>(ENTITY_COUNT);
+    for (std::size_t i = 0U; i < ENTITY_COUNT; ++i)
+    {
+      const typename ComponentManagerT::Entity entity{
+          rtw::ecs::EntityId{static_cast<rtw::ecs::EntityId::INDEX_TYPE>(i), 0U}};
+      manager->template emplace<Position>(entity, static_cast<float>(i), 0.0F, 0.0F);
+      manager->template emplace<Velocity>(entity, 1.0F, 2.0F, 3.0F);
+      manager->template emplace<Mass>(entity, 1.0F);
+      manager->template emplace<Color>(entity, 0xFF'FF'FF'FFU);
+    }
+    bytes = allocated_bytes - before;
+    benchmark::DoNotOptimize(manager);
+  }
+  state.counters["bytes"] = static_cast<double>(bytes);
+  state.counters["bytes_per_entity"] = static_cast<double>(bytes) / static_cast<double>(ENTITY_COUNT);
+}
+
+} // namespace
+
+void* operator new(const std::size_t size)
+{
+  allocated_bytes += size;
+  if (void* pointer = std::malloc(size))
+  {
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+  allocated_bytes += size;
+  const auto align = static_cast<std::size_t>(alignment);
+  if (void* pointer = std::aligned_alloc(align, ((size + align - 1U) / align) * align))
+  {
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t /*size*/) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t /*alignment*/) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept
+{
+  std::free(pointer);
+}
+
+BENCHMARK_TEMPLATE(bm_ecs_iterate, HashMapWorld)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(bm_ecs_iterate, SparseSetWorld)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(bm_ecs_iterate, ArchetypeWorld)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(bm_ecs_churn, HashMapWorld)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(bm_ecs_churn, SparseSetWorld)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(bm_ecs_churn, ArchetypeWorld)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(bm_ecs_memory, HashMapComponents)->Unit(benchmark::kMillisecond)->Iterations(3);
+BENCHMARK_TEMPLATE(bm_ecs_memory, SparseSetComponents)->Unit(benchmark::kMillisecond)->Iterations(3);
+BENCHMARK_TEMPLATE(bm_ecs_memory, ArchetypeComponents)->Unit(benchmark::kMillisecond)->Iterations(3);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,147 @@
+#include "ecs/ecs.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Spawns 1M particles with a position and a velocity, once through one `create_entity` and two `emplace_component`
+// calls per entity and once through `create_entities` and two `emplace_components` over the whole batch, for the
+// sparse-set and the archetype backends. Eight systems are registered, two of which match the particles. Every
+// iteration spawns into a fresh manager, built with the timer paused, so the system sets start without tombstones.
+
+namespace
+{
+
+enum class ComponentType : std::uint8_t
+{
+  NONE = 0U,
+  POSITION = 1U << 0U,
+  VELOCITY = 1U << 1U,
+  HEALTH = 1U << 2U,
+  SPRITE = 1U << 3U,
+};
+
+struct Position : rtw::ecs::Component<ComponentType, ComponentType::POSITION>
+{
+  Position(const float x, const float y) : x{x}, y{y} {}
+  float x;
+  float y;
+};
+
+struct Velocity : rtw::ecs::Component<ComponentType, ComponentType::VELOCITY>
+{
+  Velocity(const float x, const float y) : x{x}, y{y} {}
+  float x;
+  float y;
+};
+
+struct Health : rtw::ecs::Component<ComponentType, ComponentType::HEALTH>
+{
+  explicit Health(const std::uint32_t value) : value{value} {}
+  std::uint32_t value;
+};
+
+struct Sprite : rtw::ecs::Component<ComponentType, ComponentType::SPRITE>
+{
+  explicit Sprite(const std::uint32_t id) : id{id} {}
+  std::uint32_t id;
+};
+
+constexpr std::size_t SPAWN_COUNT{1'000'000U};
+constexpr std::size_t MAX_NUMBER_OF_SYSTEMS{16U};
+constexpr std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP{1U};
+
+using SparseSetECS =
+    rtw::ecs::SparseSetECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Position, Velocity, Health, Sprite>;
+using ArchetypeECS =
+    rtw::ecs::ArchetypeECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Position, Velocity, Health, Sprite>;
+using Entity = rtw::ecs::Entity<ComponentType>;
+
+constexpr rtw::ecs::EntitySignature<ComponentType> PARTICLE{ComponentType::POSITION | ComponentType::VELOCITY};
+
+template <ComponentType... TYPES>
+struct BenchmarkSystem : rtw::ecs::System<ComponentType>
+{
+  BenchmarkSystem() noexcept
+      : System{rtw::ecs::SystemSignature<ComponentType>{(ComponentType::NONE | ... | TYPES)}, 2U * SPAWN_COUNT}
+  {
+  }
+};
+
+template <typename ECSManagerT>
+std::unique_ptr<ECSManagerT> make_world()
+{
+  auto ecs_manager = std::make_unique<ECSManagerT>(SPAWN_COUNT, MAX_NUMBER_OF_SYSTEMS);
+  ecs_manager->template create_system<BenchmarkSystem<ComponentType::POSITION, ComponentType::VELOCITY>>();
+  ecs_manager->template create_system<BenchmarkSystem<ComponentType::POSITION>>();
+  ecs_manager->template create_system<BenchmarkSystem<ComponentType::POSITION, ComponentType::HEALTH>>();
+  ecs_manager->template create_system<BenchmarkSystem<ComponentType::POSITION, ComponentType::SPRITE>>();
+  ecs_manager->template create_system<BenchmarkSystem<ComponentType::VELOCITY, ComponentType::HEALTH>>();
+  ecs_manager->template create_system<BenchmarkSystem<ComponentType::VELOCITY, ComponentType::SPRITE>>();
+  ecs_manager->template create_system<BenchmarkSystem<ComponentType::HEALTH>>();
+  ecs_manager->template create_system<BenchmarkSystem<ComponentType::HEALTH, ComponentType::SPRITE>>();
+  return ecs_manager;
+}
+
+Position make_position(const std::size_t index) { return Position{static_cast<float>(index % 1'024U), 0.0F}; }
+Velocity make_velocity(const std::size_t /*index*/) { return Velocity{1.0F, 10.0F}; }
+
+template <typename ECSManagerT>
+void bm_create_entity(benchmark::State& state)
+{
+  std::vector<Entity> spawned(SPAWN_COUNT);
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    auto ecs_manager = make_world<ECSManagerT>();
+    state.ResumeTiming();
+
+    for (std::size_t i = 0U; i < SPAWN_COUNT; ++i)
+    {
+      spawned[i] = ecs_manager->create_entity(PARTICLE);
+      ecs_manager->template emplace_component<Position>(spawned[i], make_position(i));
+      ecs_manager->template emplace_component<Velocity>(spawned[i], make_velocity(i));
+    }
+    benchmark::ClobberMemory();
+
+    state.PauseTiming();
+    ecs_manager.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * SPAWN_COUNT));
+}
+
+template <typename ECSManagerT>
+void bm_create_entities(benchmark::State& state)
+{
+  std::vector<Entity> spawned(SPAWN_COUNT);
+  const rtw::stl::Span<const Entity> batch{spawned.data(), spawned.size()};
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    auto ecs_manager = make_world<ECSManagerT>();
+    state.ResumeTiming();
+
+    ecs_manager->create_entities(SPAWN_COUNT, PARTICLE, rtw::stl::make_span(spawned));
+    ecs_manager->template emplace_components<Position>(batch, make_position);
+    ecs_manager->template emplace_components<Velocity>(batch, make_velocity);
+    benchmark::ClobberMemory();
+
+    state.PauseTiming();
+    ecs_manager.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * SPAWN_COUNT));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(bm_create_entity, SparseSetECS)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_create_entities, SparseSetECS)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_create_entity, ArchetypeECS)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_create_entities, ArchetypeECS)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,134 @@
+#include "ecs/ecs.h"
+#include "ecs/entity_command_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Every frame destroys the 100k entities spawned by the previous one and spawns 100k new ones with a position and a
+// velocity, once through direct calls on the manager and once recorded into an EntityCommandBuffer and played back,
+// for the sparse-set and the archetype backends. With the argument set, every spawned entity also gets a marker
+// component added and removed again, as a system would tag it and another untag it in the same frame: the direct
+// calls pay for both structural changes, the buffer coalesces them away. `commands` is the number of commands
+// recorded per frame.
+
+namespace
+{
+
+enum class ComponentType : std::uint8_t
+{
+  NONE = 0U,
+  POSITION = 1U << 0U,
+  VELOCITY = 1U << 1U,
+  MARKER = 1U << 2U,
+};
+
+struct Position : rtw::ecs::Component<ComponentType, ComponentType::POSITION>
+{
+  Position(const float x, const float y) : x{x}, y{y} {}
+  float x;
+  float y;
+};
+
+struct Velocity : rtw::ecs::Component<ComponentType, ComponentType::VELOCITY>
+{
+  Velocity(const float x, const float y) : x{x}, y{y} {}
+  float x;
+  float y;
+};
+
+struct Marker : rtw::ecs::Component<ComponentType, ComponentType::MARKER>
+{
+  explicit Marker(const std::uint32_t frame) : frame{frame} {}
+  std::uint32_t frame;
+};
+
+constexpr std::size_t SPAWN_COUNT{100'000U};
+constexpr std::size_t MAX_NUMBER_OF_SYSTEMS{1U};
+constexpr std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP{1U};
+
+using SparseSetECS =
+    rtw::ecs::SparseSetECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Position, Velocity, Marker>;
+using ArchetypeECS =
+    rtw::ecs::ArchetypeECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Position, Velocity, Marker>;
+
+constexpr rtw::ecs::EntitySignature<ComponentType> PARTICLE{ComponentType::POSITION | ComponentType::VELOCITY};
+
+/// Spawns a frame's entities through @p target, a manager or a command buffer with the same interface.
+template <typename TargetT, typename EntityT>
+void spawn(TargetT& target, std::vector<EntityT>& spawned, const bool churn)
+{
+  for (std::size_t i = 0U; i < SPAWN_COUNT; ++i)
+  {
+    const auto entity = target.create_entity(PARTICLE);
+    const auto offset = static_cast<float>(i % 1'024U);
+    target.template emplace_component<Position>(entity, offset, 0.0F);
+    target.template emplace_component<Velocity>(entity, 1.0F, 10.0F);
+    if (churn)
+    {
+      target.template emplace_component<Marker>(entity, 0U);
+      target.template remove_component<Marker>(entity);
+    }
+    spawned.push_back(entity);
+  }
+}
+
+template <typename ECSManagerT>
+void bm_direct(benchmark::State& state)
+{
+  const auto churn = state.range(0) != 0;
+  auto ecs_manager = std::make_unique<ECSManagerT>(2U * SPAWN_COUNT, MAX_NUMBER_OF_SYSTEMS);
+  std::vector<typename ECSManagerT::Entity> spawned;
+  spawned.reserve(SPAWN_COUNT);
+  for (auto _ : state)
+  {
+    for (const auto& entity : spawned)
+    {
+      ecs_manager->destroy_entity(entity);
+    }
+    spawned.clear();
+    spawn(*ecs_manager, spawned, churn);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * SPAWN_COUNT));
+}
+
+template <typename ECSManagerT>
+void bm_buffered(benchmark::State& state)
+{
+  const auto churn = state.range(0) != 0;
+  auto ecs_manager = std::make_unique<ECSManagerT>(2U * SPAWN_COUNT, MAX_NUMBER_OF_SYSTEMS);
+  rtw::ecs::EntityCommandBuffer<ECSManagerT> buffer{*ecs_manager};
+  std::vector<typename ECSManagerT::Entity> spawned;
+  spawned.reserve(SPAWN_COUNT);
+  std::vector<typename ECSManagerT::Entity> destroyed;
+  destroyed.reserve(SPAWN_COUNT);
+  std::size_t commands{0U};
+  for (auto _ : state)
+  {
+    destroyed.swap(spawned);
+    spawned.clear();
+    for (const auto& entity : destroyed)
+    {
+      buffer.destroy_entity(entity);
+    }
+    spawn(buffer, spawned, churn);
+    commands += buffer.size();
+    buffer.playback();
+    benchmark::ClobberMemory();
+  }
+  state.counters["commands"] = static_cast<double>(commands) / static_cast<double>(state.iterations());
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * SPAWN_COUNT));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(bm_direct, SparseSetECS)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_buffered, SparseSetECS)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_direct, ArchetypeECS)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_buffered, ArchetypeECS)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
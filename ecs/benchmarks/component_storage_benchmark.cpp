@@ -0,0 +1,155 @@
+#include "ecs/ecs.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Compares the two component storage policies at 1M entities: the hash-map indexed `ComponentStorage` and the
+// `SparseSetComponentStorage` indexed by `EntityId::index`. Lookups and removals visit the entities in a shuffled
+// order, as systems and gameplay code touch them, rather than in the order they were emplaced. Every emplace and
+// remove iteration starts from a freshly constructed storage: the hash map keeps the tombstones of removed keys, so
+// refilling the same storage would measure its degradation under churn rather than the operation itself.
+
+namespace
+{
+
+enum class ComponentType : std::uint8_t
+{
+  NONE = 0U,
+  TRANSFORM = 1U << 0U,
+};
+
+struct Transform : rtw::ecs::Component<ComponentType, ComponentType::TRANSFORM>
+{
+  Transform(const float x, const float y, const float z) : x{x}, y{y}, z{z} {}
+  float x;
+  float y;
+  float z;
+};
+
+using Entity = rtw::ecs::Entity<ComponentType>;
+using HashMapStorage = rtw::ecs::ComponentStorage<ComponentType, Transform>;
+using SparseSetStorage = rtw::ecs::SparseSetComponentStorage<ComponentType, Transform>;
+
+constexpr std::size_t ENTITY_COUNT{1'000'000U};
+
+/// Every entity index once, in a fixed shuffled order.
+std::vector<Entity> make_entities()
+{
+  std::vector<Entity> entities;
+  entities.reserve(ENTITY_COUNT);
+  for (std::size_t index = 0U; index < ENTITY_COUNT; ++index)
+  {
+    entities.emplace_back(rtw::ecs::EntityId{static_cast<rtw::ecs::EntityId::INDEX_TYPE>(index), 0U});
+  }
+  std::mt19937 generator{42U};
+  std::shuffle(entities.begin(), entities.end(), generator);
+  return entities;
+}
+
+template <typename StorageT>
+void fill(StorageT& storage, const std::vector<Entity>& entities)
+{
+  for (const auto& entity : entities)
+  {
+    storage.emplace(entity, 1.0F, 2.0F, 3.0F);
+  }
+}
+
+template <typename StorageT>
+void bm_component_storage_emplace(benchmark::State& state)
+{
+  const auto entities = make_entities();
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    auto storage = std::make_unique<StorageT>(ENTITY_COUNT);
+    state.ResumeTiming();
+
+    fill(*storage, entities);
+    benchmark::ClobberMemory();
+
+    state.PauseTiming();
+    storage.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * ENTITY_COUNT));
+}
+
+template <typename StorageT>
+void bm_component_storage_get(benchmark::State& state)
+{
+  auto entities = make_entities();
+  StorageT storage{ENTITY_COUNT};
+  fill(storage, entities);
+  std::shuffle(entities.begin(), entities.end(), std::mt19937{7U});
+  for (auto _ : state)
+  {
+    float sum = 0.0F;
+    for (const auto& entity : entities)
+    {
+      sum += storage.get(entity).x;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * ENTITY_COUNT));
+}
+
+template <typename StorageT>
+void bm_component_storage_remove(benchmark::State& state)
+{
+  auto entities = make_entities();
+  std::mt19937 generator{7U};
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    auto storage = std::make_unique<StorageT>(ENTITY_COUNT);
+    fill(*storage, entities);
+    std::shuffle(entities.begin(), entities.end(), generator);
+    state.ResumeTiming();
+
+    for (const auto& entity : entities)
+    {
+      storage->remove(entity);
+    }
+    benchmark::ClobberMemory();
+
+    state.PauseTiming();
+    storage.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * ENTITY_COUNT));
+}
+
+template <typename StorageT>
+void bm_component_storage_for_each(benchmark::State& state)
+{
+  const auto entities = make_entities();
+  StorageT storage{ENTITY_COUNT};
+  fill(storage, entities);
+  for (auto _ : state)
+  {
+    float sum = 0.0F;
+    storage.for_each([&sum](const rtw::ecs::EntityId& /*id*/, const Transform& transform) { sum += transform.x; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * ENTITY_COUNT));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(bm_component_storage_emplace, HashMapStorage)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_component_storage_emplace, SparseSetStorage)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_component_storage_get, HashMapStorage)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_component_storage_get, SparseSetStorage)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_component_storage_remove, HashMapStorage)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_component_storage_remove, SparseSetStorage)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_component_storage_for_each, HashMapStorage)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_component_storage_for_each, SparseSetStorage)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
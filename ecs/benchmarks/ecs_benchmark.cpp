@@ -0,0 +1,485 @@
+#include "ecs/ecs.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// The baseline of the ECS: every operation a game frame leans on, for the three component backends at 1k, 100k and
+// 1M entities. Entities are created and destroyed without components; Position is emplaced on, read from and removed
+// from entities holding the three other components; views iterate one to four components; tags and groups are looked
+// up through the entity manager; and views iterate worlds fragmented by random destruction and respawning (`churned`)
+// or by a third of the entities losing a component (`split`). Memory is counted by replacing the global allocation
+// functions in this binary: `bytes` is what building a world allocated, `entity_manager_bytes` what its entity
+// manager alone did, and `grouped_entity_manager_bytes` what one with groups of up to GROUP_CAPACITY entities did.
+
+namespace
+{
+
+std::size_t allocated_bytes{0U};
+
+enum class ComponentType : std::uint8_t
+{
+  NONE = 0U,
+  POSITION = 1U << 0U,
+  VELOCITY = 1U << 1U,
+  MASS = 1U << 2U,
+  COLOR = 1U << 3U,
+};
+
+struct Position : rtw::ecs::Component<ComponentType, ComponentType::POSITION>
+{
+  Position(const float x, const float y, const float z) : x{x}, y{y}, z{z} {}
+  float x;
+  float y;
+  float z;
+};
+
+struct Velocity : rtw::ecs::Component<ComponentType, ComponentType::VELOCITY>
+{
+  Velocity(const float x, const float y, const float z) : x{x}, y{y}, z{z} {}
+  float x;
+  float y;
+  float z;
+};
+
+struct Mass : rtw::ecs::Component<ComponentType, ComponentType::MASS>
+{
+  explicit Mass(const float value) : value{value} {}
+  float value;
+};
+
+struct Color : rtw::ecs::Component<ComponentType, ComponentType::COLOR>
+{
+  explicit Color(const std::uint32_t rgba) : rgba{rgba} {}
+  std::uint32_t rgba;
+};
+
+void touch(Position& position) { position.x += 1.0F; }
+void touch(Velocity& velocity) { velocity.x += 1.0F; }
+void touch(Mass& mass) { mass.value += 1.0F; }
+void touch(Color& color) { color.rgba ^= 1U; }
+
+constexpr std::size_t MAX_NUMBER_OF_SYSTEMS{1U};
+constexpr std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP{1U};
+constexpr std::size_t GROUP_CAPACITY{64U};
+constexpr std::size_t GROUP_SIZE{GROUP_CAPACITY / 2U}; ///< Half full, as the open addressing needs free slots.
+constexpr std::uint32_t SEED{0x9E37'79B9U};
+
+template <template <typename, std::size_t, typename...> class ECSManagerT>
+using World = ECSManagerT<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Position, Velocity, Mass, Color>;
+using HashMapWorld = World<rtw::ecs::ECSManager>;
+using SparseSetWorld = World<rtw::ecs::SparseSetECSManager>;
+using ArchetypeWorld = World<rtw::ecs::ArchetypeECSManager>;
+using GroupedWorld = rtw::ecs::SparseSetECSManager<ComponentType, GROUP_CAPACITY, Position, Velocity, Mass, Color>;
+using EntityManager = rtw::ecs::EntityManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP>;
+using GroupedEntityManager = rtw::ecs::EntityManager<ComponentType, GROUP_CAPACITY>;
+using Entity = rtw::ecs::Entity<ComponentType>;
+using Name = rtw::stl::InplaceStringSmall;
+using HashedName = rtw::stl::HashedString;
+
+constexpr rtw::ecs::EntitySignature<ComponentType> SIGNATURE{ComponentType::POSITION | ComponentType::VELOCITY
+                                                             | ComponentType::MASS | ComponentType::COLOR};
+
+enum class Fragmentation : std::uint8_t
+{
+  NONE = 0U,
+  CHURNED = 1U,
+  SPLIT = 2U,
+};
+
+std::size_t entity_count(const benchmark::State& state) { return static_cast<std::size_t>(state.range(0)); }
+
+template <typename WorldT>
+void emplace_all(WorldT& world, const Entity& entity, const std::size_t index, const bool with_position = true)
+{
+  if (with_position)
+  {
+    world.template emplace_component<Position>(entity, static_cast<float>(index), 0.0F, 0.0F);
+  }
+  world.template emplace_component<Velocity>(entity, 1.0F, 2.0F, 3.0F);
+  world.template emplace_component<Mass>(entity, 1.0F);
+  world.template emplace_component<Color>(entity, 0xFF'FF'FF'FFU);
+}
+
+/// Builds a world of @p count entities holding all four components, or all but Position, with room for
+/// @p headroom times as many.
+template <typename WorldT>
+std::unique_ptr<WorldT> make_world(const std::size_t count, std::vector<Entity>& entities,
+                                   const bool with_position = true, const std::size_t headroom = 1U)
+{
+  auto world = std::make_unique<WorldT>(headroom * count, MAX_NUMBER_OF_SYSTEMS);
+  entities.clear();
+  entities.reserve(count);
+  for (std::size_t i = 0U; i < count; ++i)
+  {
+    const auto entity = world->create_entity(SIGNATURE);
+    emplace_all(*world, entity, i, with_position);
+    entities.push_back(entity);
+  }
+  return world;
+}
+
+/// Destroys half the entities in random order and respawns as many, or removes Mass from every third entity.
+template <typename WorldT>
+void fragment(WorldT& world, std::vector<Entity>& entities, const Fragmentation fragmentation)
+{
+  if (fragmentation == Fragmentation::CHURNED)
+  {
+    std::shuffle(entities.begin(), entities.end(), std::mt19937{SEED});
+    const auto half = entities.size() / 2U;
+    for (std::size_t i = 0U; i < half; ++i)
+    {
+      world.destroy_entity(entities[i]);
+    }
+    for (std::size_t i = 0U; i < half; ++i)
+    {
+      entities[i] = world.create_entity(SIGNATURE);
+      emplace_all(world, entities[i], i);
+    }
+  }
+  else if (fragmentation == Fragmentation::SPLIT)
+  {
+    for (std::size_t i = 0U; i < entities.size(); i += 3U)
+    {
+      world.template remove_component<Mass>(entities[i]);
+    }
+  }
+}
+
+template <typename WorldT>
+void bm_create_destroy(benchmark::State& state)
+{
+  const auto count = entity_count(state);
+  auto world = std::make_unique<WorldT>(count, MAX_NUMBER_OF_SYSTEMS);
+  std::vector<Entity> entities(count);
+  for (auto _ : state)
+  {
+    for (auto& entity : entities)
+    {
+      entity = world->create_entity(SIGNATURE);
+    }
+    for (const auto& entity : entities)
+    {
+      world->destroy_entity(entity);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * 2U * count));
+}
+
+/// Emplaces Position on entities holding the three other components, in a world built with the timer paused.
+template <typename WorldT>
+void bm_emplace(benchmark::State& state)
+{
+  const auto count = entity_count(state);
+  std::vector<Entity> entities;
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    auto world = make_world<WorldT>(count, entities, false);
+    state.ResumeTiming();
+
+    for (std::size_t i = 0U; i < count; ++i)
+    {
+      world->template emplace_component<Position>(entities[i], static_cast<float>(i), 0.0F, 0.0F);
+    }
+    benchmark::ClobberMemory();
+
+    state.PauseTiming();
+    world.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+/// Reads Position of every entity in random order.
+template <typename WorldT>
+void bm_get(benchmark::State& state)
+{
+  const auto count = entity_count(state);
+  std::vector<Entity> entities;
+  const auto world = make_world<WorldT>(count, entities);
+  std::shuffle(entities.begin(), entities.end(), std::mt19937{SEED});
+  for (auto _ : state)
+  {
+    float sum{0.0F};
+    for (const auto& entity : entities)
+    {
+      sum += world->template get_component<Position>(entity).x;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+/// Removes Position from every entity, in a world built with the timer paused.
+template <typename WorldT>
+void bm_remove(benchmark::State& state)
+{
+  const auto count = entity_count(state);
+  std::vector<Entity> entities;
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    auto world = make_world<WorldT>(count, entities);
+    state.ResumeTiming();
+
+    for (const auto& entity : entities)
+    {
+      world->template remove_component<Position>(entity);
+    }
+    benchmark::ClobberMemory();
+
+    state.PauseTiming();
+    world.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+template <typename WorldT, typename... ComponentsT>
+void bm_iterate(benchmark::State& state)
+{
+  const auto count = entity_count(state);
+  std::vector<Entity> entities;
+  const auto world = make_world<WorldT>(count, entities);
+  for (auto _ : state)
+  {
+    world->template view<ComponentsT...>().each([](ComponentsT&... components) { (touch(components), ...); });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+/// Iterates Position and Velocity after the fragmentation given by the second argument. The world has room for
+/// twice its entities: a full hash map backend has no free slot left, and every insertion after the churn would
+/// probe all of it.
+template <typename WorldT>
+void bm_iterate_fragmented(benchmark::State& state)
+{
+  const auto count = entity_count(state);
+  std::vector<Entity> entities;
+  const auto before = allocated_bytes;
+  const auto world = make_world<WorldT>(count, entities, true, 2U);
+  fragment(*world, entities, static_cast<Fragmentation>(state.range(1)));
+  state.counters["bytes"] = static_cast<double>(allocated_bytes - before);
+  for (auto _ : state)
+  {
+    world->template view<Position, const Velocity>().each(
+        [](Position& position, const Velocity& velocity) { position.x += velocity.x; });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+template <typename WorldT>
+void bm_memory(benchmark::State& state)
+{
+  const auto count = entity_count(state);
+  std::vector<Entity> entities;
+  entities.reserve(count);
+  std::size_t bytes{0U};
+  std::size_t entity_manager_bytes{0U};
+  std::size_t grouped_entity_manager_bytes{0U};
+  for (auto _ : state)
+  {
+    auto before = allocated_bytes;
+    auto entity_manager = std::make_unique<EntityManager>(count);
+    entity_manager_bytes = allocated_bytes - before;
+    benchmark::DoNotOptimize(entity_manager);
+    entity_manager.reset();
+
+    before = allocated_bytes;
+    auto grouped_entity_manager = std::make_unique<GroupedEntityManager>(count);
+    grouped_entity_manager_bytes = allocated_bytes - before;
+    benchmark::DoNotOptimize(grouped_entity_manager);
+    grouped_entity_manager.reset();
+
+    before = allocated_bytes;
+    auto world = make_world<WorldT>(count, entities);
+    bytes = allocated_bytes - before;
+    benchmark::DoNotOptimize(world);
+  }
+  state.counters["bytes"] = static_cast<double>(bytes);
+  state.counters["bytes_per_entity"] = static_cast<double>(bytes) / static_cast<double>(count);
+  state.counters["entity_manager_bytes"] = static_cast<double>(entity_manager_bytes);
+  state.counters["grouped_entity_manager_bytes"] = static_cast<double>(grouped_entity_manager_bytes);
+}
+
+std::vector<Name> make_names(const char* prefix, const std::size_t count)
+{
+  std::vector<Name> names;
+  names.reserve(count);
+  for (std::size_t i = 0U; i < count; ++i)
+  {
+    names.emplace_back((prefix + std::to_string(i)).c_str());
+  }
+  return names;
+}
+
+/// Tags every other entity, as the open addressing needs free slots, and looks the tags up in random order. Names
+/// are passed as strings, hashed on every lookup, or as HashedStrings, hashed once as literals would be.
+template <typename NameT>
+void bm_tag_lookup(benchmark::State& state)
+{
+  const auto count = entity_count(state);
+  std::vector<Entity> entities;
+  const auto world = make_world<SparseSetWorld>(count, entities);
+  auto tags = make_names("entity_", count / 2U);
+  for (std::size_t i = 0U; i < tags.size(); ++i)
+  {
+    world->tag_entity(entities[2U * i], tags[i]);
+  }
+  std::shuffle(tags.begin(), tags.end(), std::mt19937{SEED});
+  const std::vector<NameT> lookups(tags.begin(), tags.end());
+  for (auto _ : state)
+  {
+    for (const auto& tag : lookups)
+    {
+      benchmark::DoNotOptimize(world->get_entity_by_tag(tag));
+    }
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * tags.size()));
+}
+
+/// Puts the entities into groups of GROUP_SIZE; `lookup` asks every entity for its group in random order, `iterate`
+/// visits every group.
+template <bool ITERATE, typename NameT>
+void bm_group(benchmark::State& state)
+{
+  const auto count = entity_count(state);
+  std::vector<Entity> entities;
+  const auto world = make_world<GroupedWorld>(count, entities);
+  const auto names = make_names("group_", count / GROUP_SIZE);
+  const std::vector<NameT> groups(names.begin(), names.end());
+  for (std::size_t i = 0U; i < groups.size() * GROUP_SIZE; ++i)
+  {
+    world->add_entity_to_group(entities[i], groups[i / GROUP_SIZE]);
+  }
+  std::vector<std::size_t> order(groups.size() * GROUP_SIZE);
+  for (std::size_t i = 0U; i < order.size(); ++i)
+  {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937{SEED});
+  for (auto _ : state)
+  {
+    std::size_t visited{0U};
+    if (ITERATE)
+    {
+      for (const auto& group : groups)
+      {
+        world->for_each_entity_in_group(group, [&visited](const Entity& /*entity*/) { ++visited; });
+      }
+    }
+    else
+    {
+      for (const auto index : order)
+      {
+        visited += world->is_entity_in_group(entities[index], groups[index / GROUP_SIZE]) ? 1U : 0U;
+      }
+    }
+    benchmark::DoNotOptimize(visited);
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * order.size()));
+}
+
+template <typename NameT>
+void bm_group_lookup(benchmark::State& state)
+{
+  bm_group<false, NameT>(state);
+}
+void bm_group_iterate(benchmark::State& state) { bm_group<true, Name>(state); }
+
+void entity_counts(benchmark::internal::Benchmark* benchmark)
+{
+  benchmark->Arg(1'000)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMicrosecond);
+}
+
+void fragmentations(benchmark::internal::Benchmark* benchmark)
+{
+  benchmark->ArgsProduct({{1'000, 100'000, 1'000'000}, {0, 1, 2}})->ArgNames({"entities", "fragmentation"});
+  benchmark->Unit(benchmark::kMicrosecond);
+}
+
+} // namespace
+
+void* operator new(const std::size_t size)
+{
+  allocated_bytes += size;
+  if (void* pointer = std::malloc(size))
+  {
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+  allocated_bytes += size;
+  const auto align = static_cast<std::size_t>(alignment);
+  if (void* pointer = std::aligned_alloc(align, ((size + align - 1U) / align) * align))
+  {
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t /*size*/) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t /*alignment*/) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept
+{
+  std::free(pointer);
+}
+
+BENCHMARK_TEMPLATE(bm_create_destroy, HashMapWorld)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_create_destroy, SparseSetWorld)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_create_destroy, ArchetypeWorld)->Apply(entity_counts);
+
+BENCHMARK_TEMPLATE(bm_emplace, HashMapWorld)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_emplace, SparseSetWorld)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_emplace, ArchetypeWorld)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_get, HashMapWorld)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_get, SparseSetWorld)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_get, ArchetypeWorld)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_remove, HashMapWorld)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_remove, SparseSetWorld)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_remove, ArchetypeWorld)->Apply(entity_counts);
+
+BENCHMARK_TEMPLATE(bm_iterate, HashMapWorld, Position)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_iterate, HashMapWorld, Position, Velocity)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_iterate, HashMapWorld, Position, Velocity, Mass)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_iterate, HashMapWorld, Position, Velocity, Mass, Color)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_iterate, SparseSetWorld, Position)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_iterate, SparseSetWorld, Position, Velocity)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_iterate, SparseSetWorld, Position, Velocity, Mass)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_iterate, SparseSetWorld, Position, Velocity, Mass, Color)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_iterate, ArchetypeWorld, Position)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_iterate, ArchetypeWorld, Position, Velocity)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_iterate, ArchetypeWorld, Position, Velocity, Mass)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_iterate, ArchetypeWorld, Position, Velocity, Mass, Color)->Apply(entity_counts);
+
+BENCHMARK_TEMPLATE(bm_iterate_fragmented, HashMapWorld)->Apply(fragmentations);
+BENCHMARK_TEMPLATE(bm_iterate_fragmented, SparseSetWorld)->Apply(fragmentations);
+BENCHMARK_TEMPLATE(bm_iterate_fragmented, ArchetypeWorld)->Apply(fragmentations);
+
+BENCHMARK_TEMPLATE(bm_tag_lookup, Name)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_tag_lookup, HashedName)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_group_lookup, Name)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(bm_group_lookup, HashedName)->Apply(entity_counts);
+BENCHMARK(bm_group_iterate)->Apply(entity_counts);
+
+BENCHMARK_TEMPLATE(bm_memory, HashMapWorld)->Apply(entity_counts)->Iterations(1);
+BENCHMARK_TEMPLATE(bm_memory, SparseSetWorld)->Apply(entity_counts)->Iterations(1);
+BENCHMARK_TEMPLATE(bm_memory, ArchetypeWorld)->Apply(entity_counts)->Iterations(1);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,122 @@
+#include "ecs/ecs.h"
+#include "ecs/work_stealing_pool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Integrates 1M particles (position += velocity * dt, velocity += gravity * dt) through `View::each` on the calling
+// thread and through `View::parallel_each` on a WorkStealingPool of 1 to 8 threads, for the sparse-set and the
+// archetype backends. The argument is the pool's thread count, the caller included, so scaling from one core to N
+// reads off the `parallel_each` rows directly; the 1-thread row against `each` is the cost of splitting into tasks.
+
+namespace
+{
+
+enum class ComponentType : std::uint8_t
+{
+  NONE = 0U,
+  POSITION = 1U << 0U,
+  VELOCITY = 1U << 1U,
+};
+
+struct Position : rtw::ecs::Component<ComponentType, ComponentType::POSITION>
+{
+  Position(const float x, const float y, const float z) : x{x}, y{y}, z{z} {}
+  float x;
+  float y;
+  float z;
+};
+
+struct Velocity : rtw::ecs::Component<ComponentType, ComponentType::VELOCITY>
+{
+  Velocity(const float x, const float y, const float z) : x{x}, y{y}, z{z} {}
+  float x;
+  float y;
+  float z;
+};
+
+constexpr std::size_t PARTICLE_COUNT{1'000'000U};
+constexpr std::size_t MAX_NUMBER_OF_SYSTEMS{1U};
+constexpr std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP{1U};
+constexpr float DT{1.0F / 60.0F};
+constexpr float GRAVITY{-9.81F};
+
+using SparseSetECS = rtw::ecs::SparseSetECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Position, Velocity>;
+using ArchetypeECS = rtw::ecs::ArchetypeECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Position, Velocity>;
+
+constexpr rtw::ecs::EntitySignature<ComponentType> PARTICLE{ComponentType::POSITION | ComponentType::VELOCITY};
+
+template <typename ECSManagerT>
+std::unique_ptr<ECSManagerT> make_world()
+{
+  auto ecs_manager = std::make_unique<ECSManagerT>(PARTICLE_COUNT, MAX_NUMBER_OF_SYSTEMS);
+  for (std::size_t i = 0U; i < PARTICLE_COUNT; ++i)
+  {
+    const auto entity = ecs_manager->create_entity(PARTICLE);
+    const auto offset = static_cast<float>(i % 1'024U);
+    ecs_manager->template emplace_component<Position>(entity, offset, 0.0F, -offset);
+    ecs_manager->template emplace_component<Velocity>(entity, 1.0F, 10.0F, 0.5F);
+  }
+  return ecs_manager;
+}
+
+void integrate(Position& position, Velocity& velocity)
+{
+  velocity.y += GRAVITY * DT;
+  position.x += velocity.x * DT;
+  position.y += velocity.y * DT;
+  position.z += velocity.z * DT;
+}
+
+template <typename ECSManagerT>
+void bm_each(benchmark::State& state)
+{
+  auto ecs_manager = make_world<ECSManagerT>();
+  const auto view = ecs_manager->template view<Position, Velocity>();
+  for (auto _ : state)
+  {
+    view.each(integrate);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * PARTICLE_COUNT));
+}
+
+template <typename ECSManagerT>
+void bm_parallel_each(benchmark::State& state)
+{
+  auto ecs_manager = make_world<ECSManagerT>();
+  rtw::ecs::WorkStealingPool pool{static_cast<std::size_t>(state.range(0))};
+  const auto view = ecs_manager->template view<Position, Velocity>();
+  const auto steals = pool.steals();
+  for (auto _ : state)
+  {
+    view.parallel_each(pool, integrate);
+    benchmark::ClobberMemory();
+  }
+  state.counters["steals"] = static_cast<double>(pool.steals() - steals) / static_cast<double>(state.iterations());
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * PARTICLE_COUNT));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(bm_each, SparseSetECS)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(bm_parallel_each, SparseSetECS)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(bm_each, ArchetypeECS)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(bm_parallel_each, ArchetypeECS)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
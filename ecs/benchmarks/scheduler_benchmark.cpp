@@ -0,0 +1,210 @@
+#include "ecs/ecs.h"
+#include "ecs/system_scheduler.h"
+#include "ecs/work_stealing_pool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Updates a world of 20 systems over 8 component types, once by calling the systems in registration order and once
+// through SystemScheduler on a WorkStealingPool of 1 to 8 threads. Every system writes one component from two
+// others it reads, so the access sets leave a few chains of conflicting systems and several systems that can run
+// alongside them. Next to the frame time, each scheduled run reports the trace of its frames: `parallelism` is the
+// achieved average number of systems running at once, `available` the most the graph allows with the measured
+// system times (their sum over the longest dependency chain), `concurrency` the peak number of systems running at
+// once and `steals` the tasks per frame a worker took from another's deque.
+
+namespace
+{
+
+enum class ComponentType : std::uint8_t
+{
+  NONE = 0U,
+  C0 = 1U << 0U,
+  C1 = 1U << 1U,
+  C2 = 1U << 2U,
+  C3 = 1U << 3U,
+  C4 = 1U << 4U,
+  C5 = 1U << 5U,
+  C6 = 1U << 6U,
+  C7 = 1U << 7U,
+};
+
+template <ComponentType TYPE>
+struct Value : rtw::ecs::Component<ComponentType, TYPE>
+{
+  explicit Value(const float value) : value{value} {}
+  float value;
+};
+
+constexpr std::size_t ENTITY_COUNT{20'000U};
+constexpr std::size_t MAX_NUMBER_OF_SYSTEMS{1U};
+constexpr std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP{1U};
+constexpr std::size_t MAX_NUMBER_OF_ENTITIES_PER_SYSTEM{1U};
+
+using ECS = rtw::ecs::SparseSetECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Value<ComponentType::C0>,
+                                          Value<ComponentType::C1>, Value<ComponentType::C2>, Value<ComponentType::C3>,
+                                          Value<ComponentType::C4>, Value<ComponentType::C5>, Value<ComponentType::C6>,
+                                          Value<ComponentType::C7>>;
+using System = rtw::ecs::System<ComponentType>;
+using Scheduler = rtw::ecs::SystemScheduler<ComponentType>;
+
+/// Writes W from R0 and R1; iterates the entities through a view, so its entity set stays empty.
+struct BlendSystem : System
+{
+  BlendSystem(const ComponentType write, const ComponentType read0, const ComponentType read1) noexcept
+      : System{rtw::ecs::SystemSignature<ComponentType>{write | read0 | read1},
+               rtw::ecs::SystemAccess<ComponentType>{read0 | read1, rtw::stl::Flags<ComponentType>{}},
+               MAX_NUMBER_OF_ENTITIES_PER_SYSTEM}
+  {
+  }
+};
+
+struct World
+{
+  std::unique_ptr<ECS> ecs;
+  std::vector<std::unique_ptr<BlendSystem>> systems;
+  std::vector<Scheduler::Job> jobs; ///< Indexed like `systems`.
+};
+
+template <ComponentType W, ComponentType R0, ComponentType R1>
+void add_system(World& world)
+{
+  world.systems.push_back(std::make_unique<BlendSystem>(W, R0, R1));
+  auto& ecs = *world.ecs;
+  world.jobs.emplace_back(
+      [&ecs]()
+      {
+        ecs.view<Value<W>, const Value<R0>, const Value<R1>>().each(
+            [](Value<W>& target, const Value<R0>& lhs, const Value<R1>& rhs)
+            { target.value = (0.5F * target.value) + (0.25F * (lhs.value + rhs.value)); });
+      });
+}
+
+World make_world()
+{
+  World world;
+  world.ecs = std::make_unique<ECS>(ENTITY_COUNT, MAX_NUMBER_OF_SYSTEMS);
+  constexpr rtw::ecs::EntitySignature<ComponentType> SIGNATURE{
+      ComponentType::C0 | ComponentType::C1 | ComponentType::C2 | ComponentType::C3 | ComponentType::C4
+      | ComponentType::C5 | ComponentType::C6 | ComponentType::C7};
+  for (std::size_t i = 0U; i < ENTITY_COUNT; ++i)
+  {
+    const auto entity = world.ecs->create_entity(SIGNATURE);
+    const auto value = static_cast<float>(i % 97U);
+    world.ecs->emplace_component<Value<ComponentType::C0>>(entity, value);
+    world.ecs->emplace_component<Value<ComponentType::C1>>(entity, value);
+    world.ecs->emplace_component<Value<ComponentType::C2>>(entity, value);
+    world.ecs->emplace_component<Value<ComponentType::C3>>(entity, value);
+    world.ecs->emplace_component<Value<ComponentType::C4>>(entity, value);
+    world.ecs->emplace_component<Value<ComponentType::C5>>(entity, value);
+    world.ecs->emplace_component<Value<ComponentType::C6>>(entity, value);
+    world.ecs->emplace_component<Value<ComponentType::C7>>(entity, value);
+  }
+
+  using T = ComponentType;
+  add_system<T::C0, T::C4, T::C5>(world);
+  add_system<T::C1, T::C4, T::C6>(world);
+  add_system<T::C2, T::C5, T::C6>(world);
+  add_system<T::C3, T::C4, T::C7>(world);
+  add_system<T::C0, T::C5, T::C7>(world);
+  add_system<T::C1, T::C6, T::C7>(world);
+  add_system<T::C2, T::C4, T::C5>(world);
+  add_system<T::C3, T::C5, T::C6>(world);
+  add_system<T::C4, T::C0, T::C1>(world);
+  add_system<T::C5, T::C2, T::C3>(world);
+  add_system<T::C6, T::C0, T::C2>(world);
+  add_system<T::C7, T::C1, T::C3>(world);
+  add_system<T::C0, T::C4, T::C6>(world);
+  add_system<T::C1, T::C5, T::C7>(world);
+  add_system<T::C2, T::C4, T::C7>(world);
+  add_system<T::C3, T::C5, T::C6>(world);
+  add_system<T::C4, T::C0, T::C3>(world);
+  add_system<T::C5, T::C1, T::C2>(world);
+  add_system<T::C6, T::C1, T::C3>(world);
+  add_system<T::C7, T::C0, T::C2>(world);
+  return world;
+}
+
+/// Sum of the system times over the longest chain of dependent systems in @p trace. Edges only point to later
+/// systems, so the registration order is a topological order.
+double available_parallelism(const Scheduler& scheduler, const rtw::ecs::FrameTrace& trace)
+{
+  const auto& graph = scheduler.get_graph();
+  std::vector<double> finish(scheduler.size(), 0.0);
+  double longest{0.0};
+  for (std::size_t system = 0U; system < scheduler.size(); ++system)
+  {
+    const auto& times = trace.systems[system];
+    finish[system] += std::chrono::duration<double>(times.end - times.begin).count();
+    longest = std::max(longest, finish[system]);
+    for (const auto& edge : graph.get_edges(rtw::stl::graph::VertexId{static_cast<std::uint32_t>(system)}))
+    {
+      finish[edge.to] = std::max(finish[edge.to], finish[system]);
+    }
+  }
+  const auto busy = std::chrono::duration<double>(trace.busy_time()).count();
+  return (longest > 0.0) ? busy / longest : 0.0;
+}
+
+void bm_serial(benchmark::State& state)
+{
+  auto world = make_world();
+  for (auto _ : state)
+  {
+    for (const auto& job : world.jobs)
+    {
+      job();
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * world.jobs.size()));
+}
+
+void bm_scheduled(benchmark::State& state)
+{
+  auto world = make_world();
+  rtw::ecs::WorkStealingPool pool{static_cast<std::size_t>(state.range(0))};
+  Scheduler scheduler{pool};
+  for (std::size_t system = 0U; system < world.systems.size(); ++system)
+  {
+    scheduler.add(*world.systems[system], world.jobs[system]);
+  }
+  if (!scheduler.build())
+  {
+    state.SkipWithError("the system graph has a cycle");
+    return;
+  }
+
+  double parallelism{0.0};
+  double available{0.0};
+  std::size_t concurrency{0U};
+  const auto steals = pool.steals();
+  for (auto _ : state)
+  {
+    scheduler.run();
+    benchmark::ClobberMemory();
+    const auto& trace = scheduler.get_trace();
+    parallelism += trace.parallelism();
+    available += available_parallelism(scheduler, trace);
+    concurrency = std::max(concurrency, trace.max_concurrency());
+  }
+  const auto frames = static_cast<double>(state.iterations());
+  state.counters["parallelism"] = parallelism / frames;
+  state.counters["available"] = available / frames;
+  state.counters["concurrency"] = static_cast<double>(concurrency);
+  state.counters["steals"] = static_cast<double>(pool.steals() - steals) / frames;
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * scheduler.size()));
+}
+
+} // namespace
+
+BENCHMARK(bm_serial)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(bm_scheduled)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+BENCHMARK_MAIN();
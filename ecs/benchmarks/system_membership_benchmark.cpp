@@ -0,0 +1,205 @@
+#include "ecs/ecs.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// 100k entities each carry a mix of 16 component types; every iteration removes one component type from all of them
+// and emplaces it again, with 0, 10 or 50 systems each requiring two or three component types. `incremental`
+// registers the systems with the manager, which updates only the systems whose signature holds the toggled type,
+// through its component-to-systems index. `rescan` keeps them outside the manager and offers the entity to every
+// system after each change, as a manager without the index would. `changes` is the number of system membership
+// changes per iteration, the same for both.
+
+namespace
+{
+
+enum class ComponentType : std::uint16_t
+{
+  NONE = 0U,
+};
+
+constexpr std::size_t NUMBER_OF_COMPONENT_TYPES{16U};
+constexpr std::size_t ENTITY_COUNT{100'000U};
+constexpr std::size_t SYSTEM_COUNT{50U};
+constexpr std::size_t MAX_NUMBER_OF_SYSTEMS{64U};
+constexpr std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP{1U};
+
+constexpr ComponentType component_type(const std::size_t bit)
+{
+  return static_cast<ComponentType>(std::uint16_t{1U} << bit);
+}
+
+template <std::size_t BIT>
+struct Data : rtw::ecs::Component<ComponentType, component_type(BIT)>
+{
+  Data() = default;
+  explicit Data(const std::uint32_t value) : value{value} {}
+  std::uint32_t value{0U};
+};
+
+template <typename>
+struct ManagerOf;
+
+template <std::size_t... BITS>
+struct ManagerOf<std::index_sequence<BITS...>>
+{
+  using Type = rtw::ecs::SparseSetECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Data<BITS>...>;
+};
+
+using ECS = ManagerOf<std::make_index_sequence<NUMBER_OF_COMPONENT_TYPES>>::Type;
+using Entity = ECS::Entity;
+using EntitySignature = ECS::EntitySignature;
+using System = rtw::ecs::System<ComponentType>;
+using Toggled = Data<0U>;
+
+/// Requires two or three component types picked from @p INDEX, so most systems share some with others.
+template <std::size_t INDEX>
+struct MembershipSystem : System
+{
+  static rtw::ecs::SystemSignature<ComponentType> make_signature()
+  {
+    rtw::ecs::SystemSignature<ComponentType> signature{};
+    signature.set(component_type(INDEX % NUMBER_OF_COMPONENT_TYPES));
+    signature.set(component_type((INDEX * 7U + 3U) % NUMBER_OF_COMPONENT_TYPES));
+    if ((INDEX % 3U) == 0U)
+    {
+      signature.set(component_type((INDEX * 5U + 1U) % NUMBER_OF_COMPONENT_TYPES));
+    }
+    return signature;
+  }
+
+  MembershipSystem() noexcept : System{make_signature(), ENTITY_COUNT} {}
+};
+
+struct World
+{
+  std::unique_ptr<ECS> ecs_manager;
+  std::vector<std::unique_ptr<System>> detached;
+  std::vector<System*> systems;
+  std::vector<Entity> entities; ///< With their current signatures, for the rescan.
+};
+
+template <std::size_t INDEX>
+void create_system(World& world, const bool rescan)
+{
+  if (rescan)
+  {
+    world.detached.push_back(std::make_unique<MembershipSystem<INDEX>>());
+    world.systems.push_back(world.detached.back().get());
+  }
+  else
+  {
+    world.systems.push_back(&world.ecs_manager->create_system<MembershipSystem<INDEX>>());
+  }
+}
+
+template <std::size_t... INDICES>
+void create_systems(World& world, const std::size_t count, const bool rescan, std::index_sequence<INDICES...>)
+{
+  ((INDICES < count ? create_system<INDICES>(world, rescan) : void()), ...);
+}
+
+template <std::size_t... BITS>
+void emplace_components(ECS& ecs_manager, Entity& entity, const std::uint32_t mask, std::index_sequence<BITS...>)
+{
+  const auto emplace = [&](auto component)
+  {
+    using ComponentT = decltype(component);
+    ecs_manager.emplace_component<ComponentT>(entity, mask);
+    entity.signature.set(ComponentT::TYPE);
+  };
+  ((((mask >> BITS) & 1U) != 0U ? emplace(Data<BITS>{}) : void()), ...);
+}
+
+World make_world(const std::size_t number_of_systems, const bool rescan)
+{
+  World world{std::make_unique<ECS>(ENTITY_COUNT, MAX_NUMBER_OF_SYSTEMS), {}, {}, {}};
+  create_systems(world, number_of_systems, rescan, std::make_index_sequence<SYSTEM_COUNT>{});
+  world.entities.reserve(ENTITY_COUNT);
+  std::uint32_t state{0x9E37'79B9U};
+  for (std::size_t i = 0U; i < ENTITY_COUNT; ++i)
+  {
+    state = state * 1'664'525U + 1'013'904'223U;
+    auto entity = world.ecs_manager->create_entity(EntitySignature{});
+    // Every entity has the toggled type; the others each with a probability of one half.
+    emplace_components(*world.ecs_manager, entity, (state >> 16U) | 1U,
+                       std::make_index_sequence<NUMBER_OF_COMPONENT_TYPES>{});
+    if (rescan)
+    {
+      for (auto* system : world.systems)
+      {
+        system->add_entity(entity);
+      }
+    }
+    world.entities.push_back(entity);
+  }
+  return world;
+}
+
+std::size_t number_of_members(const World& world)
+{
+  std::size_t count{0U};
+  for (const auto* system : world.systems)
+  {
+    count += system->size();
+  }
+  return count;
+}
+
+/// What a manager without the index does after a change: offer the entity to every system.
+void rescan(const World& world, const Entity& entity)
+{
+  for (auto* system : world.systems)
+  {
+    system->remove_entity(entity);
+    system->add_entity(entity);
+  }
+}
+
+void bm_toggle(benchmark::State& state, const bool with_rescan)
+{
+  auto world = make_world(static_cast<std::size_t>(state.range(0)), with_rescan);
+  auto& ecs_manager = *world.ecs_manager;
+  const auto members = number_of_members(world);
+  std::size_t changes{0U};
+  for (auto _ : state)
+  {
+    for (auto& entity : world.entities)
+    {
+      ecs_manager.remove_component<Toggled>(entity);
+      if (with_rescan)
+      {
+        entity.signature.set(Toggled::TYPE, false);
+        rescan(world, entity);
+      }
+    }
+    changes += 2U * (members - number_of_members(world));
+    for (auto& entity : world.entities)
+    {
+      ecs_manager.emplace_component<Toggled>(entity, 1U);
+      if (with_rescan)
+      {
+        entity.signature.set(Toggled::TYPE);
+        rescan(world, entity);
+      }
+    }
+    benchmark::ClobberMemory();
+  }
+  state.counters["changes"] = static_cast<double>(changes) / static_cast<double>(state.iterations());
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * 2U * ENTITY_COUNT));
+}
+
+void bm_incremental(benchmark::State& state) { bm_toggle(state, false); }
+void bm_rescan(benchmark::State& state) { bm_toggle(state, true); }
+
+} // namespace
+
+BENCHMARK(bm_incremental)->Arg(0)->Arg(10)->Arg(SYSTEM_COUNT)->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_rescan)->Arg(0)->Arg(10)->Arg(SYSTEM_COUNT)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
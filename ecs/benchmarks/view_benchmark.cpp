@@ -0,0 +1,126 @@
+#include "ecs/ecs.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Integrates positions of the entities that have both a Position and a Velocity, once through the pattern systems
+// use today (walk `ISystem::get_entities()` and fetch each component from the ECSManager) and once through
+// `ECSManager::view`. Every entity has a Position; the argument sets how many in a hundred also have a Velocity, so
+// the view's smallest-pool driving shows when the query is selective. Both storage policies are measured.
+
+namespace
+{
+
+enum class ComponentType : std::uint8_t
+{
+  NONE = 0U,
+  POSITION = 1U << 0U,
+  VELOCITY = 1U << 1U,
+};
+
+struct Position : rtw::ecs::Component<ComponentType, ComponentType::POSITION>
+{
+  Position(const float x, const float y) : x{x}, y{y} {}
+  float x;
+  float y;
+};
+
+struct Velocity : rtw::ecs::Component<ComponentType, ComponentType::VELOCITY>
+{
+  Velocity(const float x, const float y) : x{x}, y{y} {}
+  float x;
+  float y;
+};
+
+constexpr std::size_t ENTITY_COUNT{100'000U};
+constexpr std::size_t MAX_NUMBER_OF_SYSTEMS{1U};
+constexpr std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP{1U};
+constexpr float DT{1.0F / 60.0F};
+
+using HashMapECS = rtw::ecs::ECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Position, Velocity>;
+using SparseSetECS = rtw::ecs::SparseSetECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Position, Velocity>;
+
+constexpr rtw::ecs::SystemSignature<ComponentType> MOVEMENT_SIGNATURE{ComponentType::POSITION
+                                                                      | ComponentType::VELOCITY};
+constexpr rtw::ecs::EntitySignature<ComponentType> MOVING_ENTITY{ComponentType::POSITION | ComponentType::VELOCITY};
+constexpr rtw::ecs::EntitySignature<ComponentType> STATIC_ENTITY{
+    rtw::stl::Flags<ComponentType>{ComponentType::POSITION}};
+
+struct MovementSystem : rtw::ecs::System<ComponentType>
+{
+  MovementSystem() noexcept : System{MOVEMENT_SIGNATURE, ENTITY_COUNT} {}
+
+  template <typename ECSManagerT>
+  void update(ECSManagerT& ecs_manager)
+  {
+    for (const auto& entity : get_entities())
+    {
+      auto& position = ecs_manager.template get_component<Position>(entity);
+      const auto& velocity = ecs_manager.template get_component<Velocity>(entity);
+      position.x += velocity.x * DT;
+      position.y += velocity.y * DT;
+    }
+  }
+};
+
+/// @param[in] percent_moving How many entities in a hundred get a Velocity.
+template <typename ECSManagerT>
+std::unique_ptr<ECSManagerT> make_world(const std::size_t percent_moving)
+{
+  auto ecs_manager = std::make_unique<ECSManagerT>(ENTITY_COUNT, MAX_NUMBER_OF_SYSTEMS);
+  ecs_manager->template create_system<MovementSystem>();
+  for (std::size_t i = 0U; i < ENTITY_COUNT; ++i)
+  {
+    const bool moving = (i % 100U) < percent_moving;
+    const auto entity = ecs_manager->create_entity(moving ? MOVING_ENTITY : STATIC_ENTITY);
+    ecs_manager->template emplace_component<Position>(entity, static_cast<float>(i), 0.0F);
+    if (moving)
+    {
+      ecs_manager->template emplace_component<Velocity>(entity, 1.0F, 2.0F);
+    }
+  }
+  return ecs_manager;
+}
+
+template <typename ECSManagerT>
+void bm_system_entity_set(benchmark::State& state)
+{
+  auto ecs_manager = make_world<ECSManagerT>(static_cast<std::size_t>(state.range(0)));
+  auto& system = ecs_manager->template get_system<MovementSystem>();
+  for (auto _ : state)
+  {
+    system.update(*ecs_manager);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * system.size()));
+}
+
+template <typename ECSManagerT>
+void bm_view(benchmark::State& state)
+{
+  auto ecs_manager = make_world<ECSManagerT>(static_cast<std::size_t>(state.range(0)));
+  const auto count = ecs_manager->template get_number_of_components<Velocity>();
+  for (auto _ : state)
+  {
+    ecs_manager->template view<Position, const Velocity>().each(
+        [](Position& position, const Velocity& velocity)
+        {
+          position.x += velocity.x * DT;
+          position.y += velocity.y * DT;
+        });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * count));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(bm_system_entity_set, HashMapECS)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(bm_view, HashMapECS)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(bm_system_entity_set, SparseSetECS)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(bm_view, SparseSetECS)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -1,20 +1,35 @@
 #pragma once
 
+#include "ecs/work_stealing_pool.h"
+
 #include "stl/flags.h"
 #include "stl/heap_array.h"
 #include "stl/id.h"
 #include "stl/packed_buffer.h"
+#include "stl/span.h"
 #include "stl/static_flat_unordered_map.h"
 #include "stl/static_flat_unordered_set.h"
 #include "stl/static_queue.h"
 #include "stl/static_string.h"
+#include "stl/static_vector.h"
+#include "stl/string_interner.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <numeric>
 #include <optional>
+#include <tuple>
 #include <type_traits>
 #include <typeindex>
+#include <utility>
+#include <vector>
 
 namespace rtw::ecs
 {
@@ -25,6 +40,22 @@ namespace details
 /// @param[in] n The value (must be a power of 2 for meaningful results).
 /// @return The base-2 logarithm of n.
 constexpr std::uint8_t log2(const std::uint64_t n) noexcept { return n > 1U ? 1U + log2(n / 2U) : 0U; }
+
+/// @brief Calls @p func with the position of every set bit of @p mask, lowest first.
+template <typename FuncT>
+void for_each_bit(std::uint64_t mask, FuncT&& func) noexcept
+{
+  while (mask != 0U)
+  {
+    func(static_cast<std::size_t>(__builtin_ctzll(mask)));
+    mask &= mask - 1U;
+  }
+}
+
+/// Compile-time list of types.
+template <typename... T>
+struct TypeList
+{};
 } // namespace details
 
 /// Entity identifier consisting of an ID and a generation to prevent dangling references.
@@ -193,11 +224,29 @@ public:
     }
 
     const auto index = components_.size();
-    components_.push_back(std::forward<ArgsT>(args)...);
+    components_.emplace_back(std::forward<ArgsT>(args)...);
     entity_id_to_index_[entity.id] = index;
     index_to_entity_id_[index] = entity.id;
   }
 
+  /// Emplaces the component returned by @p generator(i) for every entities[i] that does not have one yet.
+  /// @param[in] entities The entities to attach the components to.
+  /// @param[in] generator Called with the index into @p entities; returns the component.
+  template <typename GeneratorT>
+  void emplace_n(const stl::Span<const Entity> entities, GeneratorT&& generator) noexcept
+  {
+    for (std::size_t i = 0U; i < entities.size(); ++i)
+    {
+      if (!contains(entities[i]))
+      {
+        const auto index = components_.size();
+        components_.emplace_back(generator(i));
+        entity_id_to_index_[entities[i].id] = index;
+        index_to_entity_id_[index] = entities[i].id;
+      }
+    }
+  }
+
   bool empty() const noexcept { return components_.empty(); }
   std::size_t size() const noexcept { return components_.size(); }
 
@@ -231,6 +280,20 @@ public:
   ComponentT& operator[](const Entity& entity) noexcept { return get(entity); }
   const ComponentT& operator[](const Entity& entity) const noexcept { return get(entity); }
 
+  /// @param[in] id The entity whose component to look up.
+  /// @return Pointer to the entity's component, or nullptr if it has none in this storage.
+  ComponentT* find(const EntityId& id) noexcept
+  {
+    auto it = entity_id_to_index_.find(id);
+    return (it != entity_id_to_index_.end()) ? &components_[it->second] : nullptr;
+  }
+
+  const ComponentT* find(const EntityId& id) const noexcept
+  {
+    auto it = entity_id_to_index_.find(id);
+    return (it != entity_id_to_index_.end()) ? &components_[it->second] : nullptr;
+  }
+
   /// Removes the component for the entity. No-op if the entity has no component in this storage.
   /// Uses swap-and-pop to maintain contiguous storage.
   /// @param[in] entity The entity whose component to remove.
@@ -262,30 +325,288 @@ public:
     index_to_entity_id_.erase(entity_to_replace_it);
   }
 
+  /// Invokes @p func(entity_id, component) for every stored component in dense order.
+  /// @note The storage must not be modified during iteration.
+  template <typename FuncT>
+  void for_each(FuncT&& func) noexcept
+  {
+    for_each(0U, components_.size(), func);
+  }
+
+  template <typename FuncT>
+  void for_each(FuncT&& func) const noexcept
+  {
+    for_each(0U, components_.size(), func);
+  }
+
+  /// Invokes @p func(entity_id, component) for the components at dense indices [first, last).
+  template <typename FuncT>
+  void for_each(const std::size_t first, const std::size_t last, FuncT&& func) noexcept
+  {
+    assert(last <= components_.size());
+    for (std::size_t index = first; index < last; ++index)
+    {
+      std::invoke(func, index_to_entity_id_.find(index)->second, components_[index]);
+    }
+  }
+
+  template <typename FuncT>
+  void for_each(const std::size_t first, const std::size_t last, FuncT&& func) const noexcept
+  {
+    assert(last <= components_.size());
+    for (std::size_t index = first; index < last; ++index)
+    {
+      std::invoke(func, index_to_entity_id_.find(index)->second, components_[index]);
+    }
+  }
+
 private:
   stl::PackedBuffer<ComponentT> components_;
   stl::StaticFlatUnorderedMap<EntityId, std::size_t> entity_id_to_index_;
   stl::StaticFlatUnorderedMap<std::size_t, EntityId> index_to_entity_id_;
 };
 
+/// Stores components of a specific type as a sparse set indexed by EntityId::index.
+///
+/// A paged sparse array maps an entity's index to its slot in two parallel dense arrays: the components in a
+/// PackedBuffer and the EntityIds owning them. Lookups index straight into the sparse page and compare the dense
+/// EntityId, so `contains`, `get` and `remove` cost no hashing or probing, and a stale handle (same index, older
+/// generation) is rejected by the comparison. Removal swaps the last slot into the hole, keeping both dense arrays
+/// contiguous for iteration.
+///
+/// The dense arrays are pre-allocated at construction. A sparse page is allocated the first time an index in its
+/// range gets a component and is kept until the storage is destroyed, so a component attached to few entities does
+/// not pay for a sparse entry per possible entity.
+///
+/// @tparam EnumT The component type enum.
+/// @tparam ComponentT The concrete component type (must derive from Component<EnumT, VALUE>).
+template <typename EnumT, typename ComponentT>
+class SparseSetComponentStorage final : public IComponentStorage
+{
+public:
+  using ComponentType = EnumT;
+  using Entity = Entity<ComponentType>;
+  using SlotType = EntityId::INDEX_TYPE;
+
+  constexpr static std::size_t PAGE_SIZE = 4'096U; ///< Sparse entries per page.
+  constexpr static SlotType NO_SLOT = std::numeric_limits<SlotType>::max();
+
+  static_assert(stl::details::IS_SCOPED_ENUM_V<EnumT>, "EnumT must be an enum type.");
+  static_assert(std::is_same_v<ComponentType, typename ComponentT::ComponentType>,
+                "ComponentT must have the same enum type as ComponentType.");
+
+  /// @param[in] max_number_of_entities Maximum entities this storage can hold; also bounds EntityId::index.
+  explicit SparseSetComponentStorage(const std::size_t max_number_of_entities) noexcept
+      : components_{max_number_of_entities}, entity_ids_{max_number_of_entities},
+        pages_{(max_number_of_entities + PAGE_SIZE - 1U) / PAGE_SIZE}
+  {
+  }
+
+  /// Emplaces a component for the given entity. No-op if the entity already has this component, or if its index
+  /// holds the component of another generation: the sparse slot has room for one, and the handle is stale.
+  /// @pre entity.id.index < max_number_of_entities.
+  /// @param[in] entity The entity to attach the component to.
+  /// @param[in] args Constructor arguments forwarded to the component.
+  template <typename... ArgsT>
+  void emplace(const Entity& entity, ArgsT&&... args) noexcept
+  {
+    auto& slot = sparse_slot(entity.id.index);
+    if (slot != NO_SLOT)
+    {
+      return;
+    }
+
+    slot = static_cast<SlotType>(components_.size());
+    components_.emplace_back(std::forward<ArgsT>(args)...);
+    entity_ids_.push_back(entity.id);
+  }
+
+  /// Emplaces the component returned by @p generator(i) for every entities[i] that does not have one yet, skipping
+  /// stale handles as `emplace()` does. The sparse page is looked up once per run of entities sharing it.
+  /// @param[in] entities The entities to attach the components to.
+  /// @param[in] generator Called with the index into @p entities; returns the component.
+  template <typename GeneratorT>
+  void emplace_n(const stl::Span<const Entity> entities, GeneratorT&& generator) noexcept
+  {
+    Page* page = nullptr;
+    auto page_index = pages_.size();
+    for (std::size_t i = 0U; i < entities.size(); ++i)
+    {
+      const auto& id = entities[i].id;
+      if ((id.index / PAGE_SIZE) != page_index)
+      {
+        page_index = id.index / PAGE_SIZE;
+        page = &page_at(page_index);
+      }
+      auto& slot = (*page)[id.index % PAGE_SIZE];
+      if (slot != NO_SLOT)
+      {
+        continue;
+      }
+      slot = static_cast<SlotType>(components_.size());
+      components_.emplace_back(generator(i));
+      entity_ids_.push_back(id);
+    }
+  }
+
+  bool empty() const noexcept { return components_.empty(); }
+  std::size_t size() const noexcept { return components_.size(); }
+
+  /// @param[in] entity The entity to check.
+  /// @return True if this storage contains a component for the entity.
+  bool contains(const Entity& entity) const noexcept
+  {
+    const auto slot = find_slot(entity.id.index);
+    return (slot != NO_SLOT) && (entity_ids_[slot] == entity.id);
+  }
+
+  /// @pre The entity must have a component in this storage.
+  /// @param[in] entity The entity whose component to retrieve.
+  /// @return Reference to the entity's component.
+  ComponentT& get(const Entity& entity) noexcept
+  {
+    assert(contains(entity));
+    return components_[find_slot(entity.id.index)];
+  }
+
+  /// @pre The entity must have a component in this storage.
+  /// @param[in] entity The entity whose component to retrieve.
+  /// @return Const reference to the entity's component.
+  const ComponentT& get(const Entity& entity) const noexcept
+  {
+    assert(contains(entity));
+    return components_[find_slot(entity.id.index)];
+  }
+
+  ComponentT& operator[](const Entity& entity) noexcept { return get(entity); }
+  const ComponentT& operator[](const Entity& entity) const noexcept { return get(entity); }
+
+  /// @param[in] id The entity whose component to look up.
+  /// @return Pointer to the entity's component, or nullptr if it has none in this storage.
+  ComponentT* find(const EntityId& id) noexcept
+  {
+    const auto slot = find_slot(id.index);
+    return ((slot != NO_SLOT) && (entity_ids_[slot] == id)) ? &components_[slot] : nullptr;
+  }
+
+  const ComponentT* find(const EntityId& id) const noexcept
+  {
+    const auto slot = find_slot(id.index);
+    return ((slot != NO_SLOT) && (entity_ids_[slot] == id)) ? &components_[slot] : nullptr;
+  }
+
+  /// Removes the component for the entity. No-op if the entity has no component in this storage.
+  /// Uses swap-and-pop on both dense arrays to keep them contiguous.
+  /// @param[in] entity The entity whose component to remove.
+  void remove(const Entity& entity) noexcept
+  {
+    if (!contains(entity))
+    {
+      return;
+    }
+
+    const auto slot = find_slot(entity.id.index);
+    const auto last_entity_id = entity_ids_.back();
+
+    components_.remove(slot);
+    entity_ids_.remove(slot);
+
+    sparse_slot(last_entity_id.index) = slot;
+    sparse_slot(entity.id.index) = NO_SLOT;
+  }
+
+  /// Invokes @p func(entity_id, component) for every stored component in dense order.
+  /// @note The storage must not be modified during iteration.
+  template <typename FuncT>
+  void for_each(FuncT&& func) noexcept
+  {
+    for_each(0U, components_.size(), func);
+  }
+
+  template <typename FuncT>
+  void for_each(FuncT&& func) const noexcept
+  {
+    for_each(0U, components_.size(), func);
+  }
+
+  /// Invokes @p func(entity_id, component) for the components in dense slots [first, last).
+  template <typename FuncT>
+  void for_each(const std::size_t first, const std::size_t last, FuncT&& func) noexcept
+  {
+    assert(last <= components_.size());
+    for (std::size_t slot = first; slot < last; ++slot)
+    {
+      std::invoke(func, entity_ids_[slot], components_[slot]);
+    }
+  }
+
+  template <typename FuncT>
+  void for_each(const std::size_t first, const std::size_t last, FuncT&& func) const noexcept
+  {
+    assert(last <= components_.size());
+    for (std::size_t slot = first; slot < last; ++slot)
+    {
+      std::invoke(func, entity_ids_[slot], components_[slot]);
+    }
+  }
+
+private:
+  using Page = std::array<SlotType, PAGE_SIZE>;
+
+  /// @return The dense slot of @p index, or NO_SLOT if its page was never allocated or the index has no component.
+  SlotType find_slot(const EntityId::INDEX_TYPE index) const noexcept
+  {
+    assert((index / PAGE_SIZE) < pages_.size());
+    const auto& page = pages_[index / PAGE_SIZE];
+    return (page != nullptr) ? (*page)[index % PAGE_SIZE] : NO_SLOT;
+  }
+
+  /// @return The sparse entry of @p index, allocating its page on first use.
+  SlotType& sparse_slot(const EntityId::INDEX_TYPE index) noexcept
+  {
+    return page_at(index / PAGE_SIZE)[index % PAGE_SIZE];
+  }
+
+  /// @return The sparse page @p page_index, allocating it on first use.
+  Page& page_at(const std::size_t page_index) noexcept
+  {
+    assert(page_index < pages_.size());
+    auto& page = pages_[page_index];
+    if (page == nullptr)
+    {
+      page = std::make_unique<Page>();
+      page->fill(NO_SLOT);
+    }
+    return *page;
+  }
+
+  stl::PackedBuffer<ComponentT> components_;
+  stl::PackedBuffer<EntityId> entity_ids_; ///< Owner of each component, parallel to components_.
+  stl::HeapArray<std::unique_ptr<Page>> pages_;
+};
+
 /// Manages all component storage for registered component types.
 /// Provides type-safe access to components via template methods.
 /// Enforces a maximum of 64 component types (bitmask-based signatures).
-template <typename EnumT, typename... ComponentsT>
-class ComponentManager
+/// @tparam ComponentStorageT The storage policy, ComponentStorage or SparseSetComponentStorage.
+/// @tparam EnumT The component type enum.
+/// @tparam ComponentsT List of component types to register.
+template <template <typename, typename> class ComponentStorageT, typename EnumT, typename... ComponentsT>
+class GenericComponentManager
 {
 public:
   using ComponentType = EnumT;
   using Entity = Entity<ComponentType>;
 
   constexpr static std::size_t NUMBER_OF_REGISTERED_COMPONENTS = sizeof...(ComponentsT);
+  constexpr static bool ITERATES_BY_ARCHETYPE = false;
 
   static_assert(stl::details::IS_SCOPED_ENUM_V<EnumT>, "EnumT must be an enum type.");
   static_assert((std::is_same_v<ComponentType, typename ComponentsT::ComponentType> && ...),
                 "All components must have the same enum type.");
   static_assert(sizeof...(ComponentsT) <= 64U, "Number of registered components must be less than or equal to 64.");
 
-  explicit ComponentManager(const std::size_t max_number_of_entities) noexcept
+  explicit GenericComponentManager(const std::size_t max_number_of_entities) noexcept
   {
     (allocate_storage<ComponentsT>(max_number_of_entities), ...);
   }
@@ -296,6 +617,13 @@ public:
     get_storage<ComponentT>().emplace(entity, std::forward<ArgsT>(args)...);
   }
 
+  /// Emplaces the component returned by @p generator(i) for every entities[i] that does not have one yet.
+  template <typename ComponentT, typename GeneratorT>
+  void emplace_n(const stl::Span<const Entity> entities, GeneratorT&& generator) noexcept
+  {
+    get_storage<ComponentT>().emplace_n(entities, std::forward<GeneratorT>(generator));
+  }
+
   template <typename ComponentT>
   std::size_t size() const noexcept
   {
@@ -330,9 +658,48 @@ public:
 
   void remove(const Entity& entity) noexcept { (remove<ComponentsT>(entity), ...); }
 
+  /// @return Pointer to the entity's component, or nullptr if it has none.
+  template <typename ComponentT>
+  ComponentT* find(const EntityId& id) noexcept
+  {
+    return get_storage<ComponentT>().find(id);
+  }
+
+  template <typename ComponentT>
+  const ComponentT* find(const EntityId& id) const noexcept
+  {
+    return get_storage<ComponentT>().find(id);
+  }
+
+  /// Invokes @p func(entity_id, component) for every component of type ComponentT in storage order.
+  template <typename ComponentT, typename FuncT>
+  void for_each(FuncT&& func) noexcept
+  {
+    get_storage<ComponentT>().for_each(std::forward<FuncT>(func));
+  }
+
+  template <typename ComponentT, typename FuncT>
+  void for_each(FuncT&& func) const noexcept
+  {
+    get_storage<ComponentT>().for_each(std::forward<FuncT>(func));
+  }
+
+  /// Invokes @p func(entity_id, component) for the components of type ComponentT at dense indices [first, last).
+  template <typename ComponentT, typename FuncT>
+  void for_each(const std::size_t first, const std::size_t last, FuncT&& func) noexcept
+  {
+    get_storage<ComponentT>().for_each(first, last, std::forward<FuncT>(func));
+  }
+
+  template <typename ComponentT, typename FuncT>
+  void for_each(const std::size_t first, const std::size_t last, FuncT&& func) const noexcept
+  {
+    get_storage<ComponentT>().for_each(first, last, std::forward<FuncT>(func));
+  }
+
 private:
   template <typename ComponentT>
-  using ComponentStorage = ComponentStorage<ComponentType, ComponentT>;
+  using ComponentStorage = ComponentStorageT<ComponentType, ComponentT>;
 
   template <typename ComponentT>
   void allocate_storage(const std::size_t max_number_of_entities) noexcept
@@ -373,169 +740,821 @@ private:
   ComponentsStorage components_storage_{};
 };
 
-/// Manages entity lifecycle, tags, and groups.
-/// Uses generational indices to detect stale entity references.
-/// Tags provide unique 1:1 entity naming; groups provide 1:N categorization.
+/// Component manager keeping each component type in a ComponentStorage (hash-map indexed).
+template <typename EnumT, typename... ComponentsT>
+using ComponentManager = GenericComponentManager<ComponentStorage, EnumT, ComponentsT...>;
+
+/// Component manager keeping each component type in a SparseSetComponentStorage (indexed by EntityId::index).
+template <typename EnumT, typename... ComponentsT>
+using SparseSetComponentManager = GenericComponentManager<SparseSetComponentStorage, EnumT, ComponentsT...>;
+
+/// Manages components in archetypes: all entities holding the same set of components live together in fixed-size
+/// chunks, each chunk holding one array per component (structure of arrays) plus the array of owning EntityIds.
 ///
-/// @note Each entity can belong to at most ONE group at a time.
-///       Adding an entity to a new group automatically removes it from its previous group.
+/// A system touching several components of an entity reads them from neighbouring arrays of one chunk instead of
+/// from one storage per component type, and a View walks the chunks of every matching archetype linearly without
+/// probing. Rows are packed: removing a row moves the archetype's last row into the hole. Emplacing or removing a
+/// component is a structural change that moves the entity's row to the archetype of its new component set; the
+/// transitions are cached per archetype, so repeated churn costs no archetype lookup.
+///
+/// The archetype of an entity follows the components it actually holds, which may differ from the EntitySignature
+/// it was created with. An entity without components is in no chunk. Chunks are allocated when an archetype grows;
+/// chunks emptied by removals go to a free list and are reused by any archetype, so steady-state churn allocates
+/// nothing.
 ///
+/// Provides the same interface as GenericComponentManager.
 /// @tparam EnumT The component type enum.
-/// @tparam MAX_NUMBER_OF_ENTITIES_PER_GROUP Maximum entities allowed in a single group.
-template <typename EnumT, std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP>
-class EntityManager
+/// @tparam ComponentsT List of component types to register; each must be nothrow move constructible.
+template <typename EnumT, typename... ComponentsT>
+class ArchetypeComponentManager
 {
 public:
-  static_assert(stl::details::IS_SCOPED_ENUM_V<EnumT>, "EnumT must be an enum type.");
-
   using ComponentType = EnumT;
   using Entity = Entity<ComponentType>;
-  using EntitySignature = typename Entity::EntitySignature;
-
-  /// @param[in] max_number_of_entities Maximum entities this manager can hold.
-  explicit EntityManager(const std::size_t max_number_of_entities) noexcept
-      : entities_{max_number_of_entities}, free_ids_{max_number_of_entities}, tag_to_entity_id_{max_number_of_entities},
-        entity_id_to_tag_{max_number_of_entities}, group_to_entity_ids_{max_number_of_entities},
-        entity_id_to_group_{max_number_of_entities}
-  {
-    for (EntityId::INDEX_TYPE id = 0U; id < max_number_of_entities; ++id)
-    {
-      free_ids_.emplace(id, 0U);
-    }
-  }
-
-  /// Creates a new entity with the given signature.
-  /// @pre The free entity pool must not be empty (asserts in debug).
-  /// @param[in] signature The component bitmask for the new entity.
-  /// @return The newly created entity handle.
-  Entity create(EntitySignature signature) noexcept
-  {
-    assert(!free_ids_.empty());
 
-    auto& entity = entities_[free_ids_.front().index];
-    entity.id = free_ids_.front();
-    entity.signature = std::move(signature);
+  constexpr static std::size_t NUMBER_OF_REGISTERED_COMPONENTS = sizeof...(ComponentsT);
+  constexpr static std::size_t CHUNK_SIZE = 16U * 1'024U; ///< Bytes per chunk.
+  constexpr static bool ITERATES_BY_ARCHETYPE = true;
 
-    free_ids_.pop();
+  static_assert(stl::details::IS_SCOPED_ENUM_V<EnumT>, "EnumT must be an enum type.");
+  static_assert((std::is_same_v<ComponentType, typename ComponentsT::ComponentType> && ...),
+                "All components must have the same enum type.");
+  static_assert(sizeof...(ComponentsT) <= 64U, "Number of registered components must be less than or equal to 64.");
+  static_assert((std::is_nothrow_move_constructible_v<ComponentsT> && ...),
+                "Components must be nothrow move constructible to move between archetypes.");
 
-    return entity;
+  /// @param[in] max_number_of_entities Maximum entities; bounds EntityId::index.
+  explicit ArchetypeComponentManager(const std::size_t max_number_of_entities) noexcept
+      : locations_{max_number_of_entities}
+  {
+    archetypes_.emplace_back(); // The empty archetype, holding no rows.
   }
 
-  /// Checks if the entity handle is still valid (not destroyed or recycled).
-  /// @param[in] entity The entity handle to validate.
-  /// @return True if the entity is alive and the generation matches.
-  bool is_valid(const Entity& entity) const noexcept
+  ArchetypeComponentManager(const ArchetypeComponentManager&) = delete;
+  ArchetypeComponentManager(ArchetypeComponentManager&&) = delete;
+  ArchetypeComponentManager& operator=(const ArchetypeComponentManager&) = delete;
+  ArchetypeComponentManager& operator=(ArchetypeComponentManager&&) = delete;
+
+  ~ArchetypeComponentManager()
   {
-    const auto index = entity.id.index;
-    return (index < entities_.size()) && (entities_[index].id.generation == entity.id.generation);
+    for (auto& archetype : archetypes_)
+    {
+      for (std::size_t row = 0U; row < archetype.size; ++row)
+      {
+        (destroy<ComponentsT>(archetype, row), ...);
+      }
+    }
   }
 
-  /// Destroys the entity, incrementing its generation and returning the slot to the free list.
-  /// Also removes the entity's tag and group membership. No-op if the entity is already invalid.
-  /// @param[in] entity The entity to destroy.
-  void destroy(const Entity& entity) noexcept
+  template <typename ComponentT, typename... ArgsT>
+  void emplace(const Entity& entity, ArgsT&&... args) noexcept
   {
-    assert(entity.id.index < entities_.size());
-
-    if (!is_valid(entity))
+    if (has<ComponentT>(entity))
     {
       return;
     }
 
-    untag(entity);
-    remove_from_group(entity);
+    const auto& location = locations_[entity.id.index];
+    const auto source = location.archetype;
+    assert((source == EMPTY_ARCHETYPE) || (entity_id_at(archetypes_[source], location.row) == entity.id));
+    const auto target = transition(source, get_component_id<ComponentT>(), true);
+    const auto row = move_row(entity.id, source, target);
+    new (component_at<ComponentT>(archetypes_[target], row)) ComponentT(std::forward<ArgsT>(args)...);
+    ++sizes_[get_component_id<ComponentT>()];
+  }
 
+  /// Emplaces the component returned by @p generator(i) for every entities[i] that does not have one yet, directly
+  /// into its new row. The transition is looked up once per run of entities coming from the same archetype.
+  template <typename ComponentT, typename GeneratorT>
+  void emplace_n(const stl::Span<const Entity> entities, GeneratorT&& generator) noexcept
+  {
+    auto source = NO_ARCHETYPE;
+    auto target = NO_ARCHETYPE;
+    for (std::size_t i = 0U; i < entities.size(); ++i)
     {
-      auto& e = entities_[entity.id.index];
-      ++e.id.generation; // Increment generation to invalidate existing references
-
+      const auto& entity = entities[i];
+      if (has<ComponentT>(entity))
+      {
+        continue;
+      }
+
+      const auto& location = locations_[entity.id.index];
+      assert((location.archetype == EMPTY_ARCHETYPE)
+             || (entity_id_at(archetypes_[location.archetype], location.row) == entity.id));
+      if (location.archetype != source)
+      {
+        source = location.archetype;
+        target = transition(source, get_component_id<ComponentT>(), true);
+      }
+      const auto row = move_row(entity.id, source, target);
+      new (component_at<ComponentT>(archetypes_[target], row)) ComponentT(generator(i));
+      ++sizes_[get_component_id<ComponentT>()];
+    }
+  }
+
+  template <typename ComponentT>
+  std::size_t size() const noexcept
+  {
+    return sizes_[get_component_id<ComponentT>()];
+  }
+
+  std::size_t total_size() const noexcept { return (size<ComponentsT>() + ...); }
+
+  template <typename ComponentT>
+  bool has(const Entity& entity) const noexcept
+  {
+    return find<ComponentT>(entity.id) != nullptr;
+  }
+
+  template <typename ComponentT>
+  ComponentT& get(const Entity& entity) noexcept
+  {
+    auto* component = find<ComponentT>(entity.id);
+    assert(component != nullptr);
+    return *component;
+  }
+
+  template <typename ComponentT>
+  const ComponentT& get(const Entity& entity) const noexcept
+  {
+    const auto* component = find<ComponentT>(entity.id);
+    assert(component != nullptr);
+    return *component;
+  }
+
+  /// Removes the component, moving the entity's row to the archetype without it. No-op if the entity lacks it.
+  template <typename ComponentT>
+  void remove(const Entity& entity) noexcept
+  {
+    if (!has<ComponentT>(entity))
+    {
+      return;
+    }
+
+    const auto source = locations_[entity.id.index].archetype;
+    const auto target = transition(source, get_component_id<ComponentT>(), false);
+    --sizes_[get_component_id<ComponentT>()];
+    move_row(entity.id, source, target);
+  }
+
+  /// Removes all components of the entity. No-op if it has none.
+  void remove(const Entity& entity) noexcept
+  {
+    const auto& location = locations_[entity.id.index];
+    const auto source = location.archetype;
+    if ((source == EMPTY_ARCHETYPE) || (entity_id_at(archetypes_[source], location.row) != entity.id))
+    {
+      return;
+    }
+
+    const auto mask = archetypes_[source].mask;
+    ((sizes_[get_component_id<ComponentsT>()] -= ((mask & bit<ComponentsT>()) != 0U) ? 1U : 0U), ...);
+    move_row(entity.id, source, EMPTY_ARCHETYPE);
+  }
+
+  /// @return Pointer to the entity's component, or nullptr if it has none.
+  template <typename ComponentT>
+  ComponentT* find(const EntityId& id) noexcept
+  {
+    return const_cast<ComponentT*>(std::as_const(*this).template find<ComponentT>(id));
+  }
+
+  template <typename ComponentT>
+  const ComponentT* find(const EntityId& id) const noexcept
+  {
+    assert(id.index < locations_.size());
+    const auto& location = locations_[id.index];
+    const auto& archetype = archetypes_[location.archetype];
+    if (((archetype.mask & bit<ComponentT>()) == 0U) || (entity_id_at(archetype, location.row) != id))
+    {
+      return nullptr;
+    }
+    return component_at<ComponentT>(archetype, location.row);
+  }
+
+  /// Invokes @p func(entity_id, component) for every component of type ComponentT, chunk by chunk.
+  template <typename ComponentT, typename FuncT>
+  void for_each(FuncT&& func) noexcept
+  {
+    for_each_row<details::TypeList<>, ComponentT>(func);
+  }
+
+  template <typename ComponentT, typename FuncT>
+  void for_each(FuncT&& func) const noexcept
+  {
+    for_each_row<details::TypeList<>, const ComponentT>(func);
+  }
+
+  /// Invokes @p func(entity_id, components&...) for every entity having all ViewComponentsT and none of the types in
+  /// ExcludeListT, walking the chunks of the matching archetypes linearly. Used by View.
+  template <typename ExcludeListT, typename... ViewComponentsT, typename FuncT>
+  void each(FuncT&& func) noexcept
+  {
+    for_each_row<ExcludeListT, ViewComponentsT...>(func);
+  }
+
+  template <typename ExcludeListT, typename... ViewComponentsT, typename FuncT>
+  void each(FuncT&& func) const noexcept
+  {
+    static_assert((std::is_const_v<ViewComponentsT> && ...), "A const manager only hands out const components.");
+    for_each_row<ExcludeListT, ViewComponentsT...>(func);
+  }
+
+  /// Like `each`, restricted to the chunks [first_chunk, last_chunk) of the matching archetypes, numbered in the
+  /// order `each` visits them. Lets several threads split one query chunk by chunk.
+  template <typename ExcludeListT, typename... ViewComponentsT, typename FuncT>
+  void each(const std::size_t first_chunk, const std::size_t last_chunk, FuncT&& func) noexcept
+  {
+    for_each_row<ExcludeListT, ViewComponentsT...>(func, first_chunk, last_chunk);
+  }
+
+  template <typename ExcludeListT, typename... ViewComponentsT, typename FuncT>
+  void each(const std::size_t first_chunk, const std::size_t last_chunk, FuncT&& func) const noexcept
+  {
+    static_assert((std::is_const_v<ViewComponentsT> && ...), "A const manager only hands out const components.");
+    for_each_row<ExcludeListT, ViewComponentsT...>(func, first_chunk, last_chunk);
+  }
+
+  /// @return The number of chunks `each<ExcludeListT, ViewComponentsT...>` visits.
+  template <typename ExcludeListT, typename... ViewComponentsT>
+  std::size_t number_of_chunks() const noexcept
+  {
+    std::size_t count = 0U;
+    for (const auto& archetype : archetypes_)
+    {
+      if (matches<ExcludeListT, ViewComponentsT...>(archetype))
+      {
+        count += archetype.chunks.size();
+      }
+    }
+    return count;
+  }
+
+  /// @return The number of archetypes created so far, including the empty one.
+  std::size_t number_of_archetypes() const noexcept { return archetypes_.size(); }
+
+  /// @return The number of chunks holding rows; emptied chunks waiting for reuse are not counted.
+  std::size_t number_of_chunks() const noexcept
+  {
+    std::size_t count = 0U;
+    for (const auto& archetype : archetypes_)
+    {
+      count += archetype.chunks.size();
+    }
+    return count;
+  }
+
+private:
+  using ArchetypeIndex = std::uint32_t;
+  using Mask = std::uint64_t;
+
+  constexpr static ArchetypeIndex EMPTY_ARCHETYPE = 0U;
+  constexpr static ArchetypeIndex NO_ARCHETYPE = std::numeric_limits<ArchetypeIndex>::max();
+  constexpr static std::size_t NO_OFFSET = std::numeric_limits<std::size_t>::max();
+
+  struct alignas(64) Chunk
+  {
+    std::array<std::byte, CHUNK_SIZE> bytes;
+  };
+
+  static_assert(((alignof(ComponentsT) <= alignof(Chunk)) && ...), "Component alignment exceeds the chunk alignment.");
+
+  struct Archetype
+  {
+    Archetype() noexcept
+    {
+      offsets.fill(NO_OFFSET);
+      add_edges.fill(NO_ARCHETYPE);
+      remove_edges.fill(NO_ARCHETYPE);
+    }
+
+    Mask mask{0U};
+    std::size_t rows_per_chunk{0U};
+    std::size_t size{0U};
+    std::array<std::size_t, NUMBER_OF_REGISTERED_COMPONENTS> offsets{}; ///< Byte offset of each component's array.
+    std::array<ArchetypeIndex, NUMBER_OF_REGISTERED_COMPONENTS> add_edges{};    ///< Archetype with a component added.
+    std::array<ArchetypeIndex, NUMBER_OF_REGISTERED_COMPONENTS> remove_edges{}; ///< Archetype with one removed.
+    std::vector<std::unique_ptr<Chunk>> chunks;
+  };
+
+  /// Where an entity's row lives; entities without components are in the empty archetype.
+  struct Location
+  {
+    ArchetypeIndex archetype{EMPTY_ARCHETYPE};
+    std::uint32_t row{0U};
+  };
+
+  template <typename ComponentT>
+  constexpr static ComponentId get_component_id() noexcept
+  {
+    static_assert((std::is_same_v<ComponentT, ComponentsT> || ...),
+                  "ComponentT must be one of the component types defined in ComponentsT.");
+    static_assert(ComponentT::COMPONENT_ID < NUMBER_OF_REGISTERED_COMPONENTS,
+                  "Component ID exceeds the number of registered components.");
+    return ComponentT::COMPONENT_ID;
+  }
+
+  template <typename ComponentT>
+  constexpr static Mask bit() noexcept
+  {
+    return Mask{1U} << get_component_id<ComponentT>();
+  }
+
+  static std::byte* chunk_bytes(const Archetype& archetype, const std::size_t row) noexcept
+  {
+    return archetype.chunks[row / archetype.rows_per_chunk]->bytes.data();
+  }
+
+  static EntityId& entity_id_at(const Archetype& archetype, const std::size_t row) noexcept
+  {
+    return *std::launder(reinterpret_cast<EntityId*>(chunk_bytes(archetype, row))
+                         + (row % archetype.rows_per_chunk));
+  }
+
+  template <typename ComponentT>
+  static ComponentT* component_at(const Archetype& archetype, const std::size_t row) noexcept
+  {
+    auto* bytes = chunk_bytes(archetype, row) + archetype.offsets[get_component_id<ComponentT>()];
+    return std::launder(reinterpret_cast<ComponentT*>(bytes + ((row % archetype.rows_per_chunk) * sizeof(ComponentT))));
+  }
+
+  template <typename ComponentT>
+  static void destroy(const Archetype& archetype, const std::size_t row) noexcept
+  {
+    if ((archetype.mask & bit<ComponentT>()) != 0U)
+    {
+      component_at<ComponentT>(archetype, row)->~ComponentT();
+    }
+  }
+
+  /// Moves ComponentT from @p source_row to @p target_row if the target archetype has it, then destroys the source.
+  template <typename ComponentT>
+  static void relocate(const Archetype& source, const std::size_t source_row, const Archetype& target,
+                       const std::size_t target_row) noexcept
+  {
+    if ((source.mask & bit<ComponentT>()) == 0U)
+    {
+      return;
+    }
+    auto* component = component_at<ComponentT>(source, source_row);
+    if ((target.mask & bit<ComponentT>()) != 0U)
+    {
+      new (component_at<ComponentT>(target, target_row)) ComponentT(std::move(*component));
+    }
+    component->~ComponentT();
+  }
+
+  /// Lays out an archetype's chunk: the EntityIds first, then one aligned array per component, with as many rows as
+  /// fit into CHUNK_SIZE.
+  static Archetype make_archetype(const Mask mask) noexcept
+  {
+    Archetype archetype;
+    archetype.mask = mask;
+    const std::size_t row_bytes =
+        sizeof(EntityId) + ((((mask & bit<ComponentsT>()) != 0U) ? sizeof(ComponentsT) : 0U) + ...);
+    for (auto rows = CHUNK_SIZE / row_bytes; rows > 0U; --rows)
+    {
+      std::size_t offset = sizeof(EntityId) * rows;
+      const auto place = [&](const ComponentId id, const std::size_t size, const std::size_t alignment)
+      {
+        offset = ((offset + alignment - 1U) / alignment) * alignment;
+        archetype.offsets[id] = offset;
+        offset += size * rows;
+      };
+      ((((mask & bit<ComponentsT>()) != 0U) ? place(get_component_id<ComponentsT>(), sizeof(ComponentsT),
+                                                    alignof(ComponentsT))
+                                            : void()),
+       ...);
+      if (offset <= CHUNK_SIZE)
+      {
+        archetype.rows_per_chunk = rows;
+        return archetype;
+      }
+    }
+    assert(false && "An entity's components do not fit into one chunk.");
+    return archetype;
+  }
+
+  /// @return The archetype reached from @p source by adding or removing component @p id; creates it on first use.
+  ArchetypeIndex transition(const ArchetypeIndex source, const ComponentId id, const bool add) noexcept
+  {
+    auto& edges = add ? archetypes_[source].add_edges : archetypes_[source].remove_edges;
+    if (edges[id] != NO_ARCHETYPE)
+    {
+      return edges[id];
+    }
+
+    const auto component_bit = Mask{1U} << id;
+    const auto mask = add ? (archetypes_[source].mask | component_bit) : (archetypes_[source].mask & ~component_bit);
+    auto target = EMPTY_ARCHETYPE;
+    while ((target < archetypes_.size()) && (archetypes_[target].mask != mask))
+    {
+      ++target;
+    }
+    if (target == archetypes_.size())
+    {
+      archetypes_.push_back(make_archetype(mask));
+    }
+
+    (add ? archetypes_[source].add_edges : archetypes_[source].remove_edges)[id] = target;
+    (add ? archetypes_[target].remove_edges : archetypes_[target].add_edges)[id] = source;
+    return target;
+  }
+
+  /// Moves the entity's row from @p source to @p target, carrying the components both share and destroying the
+  /// others, and updates its location. Components only the target has are left for the caller to construct.
+  /// @return The entity's row in @p target.
+  std::size_t move_row(const EntityId& id, const ArchetypeIndex source, const ArchetypeIndex target) noexcept
+  {
+    std::size_t target_row = 0U;
+    if (target != EMPTY_ARCHETYPE)
+    {
+      target_row = push_row(archetypes_[target], id);
+    }
+    if (source != EMPTY_ARCHETYPE)
+    {
+      const auto source_row = locations_[id.index].row;
+      (relocate<ComponentsT>(archetypes_[source], source_row, archetypes_[target], target_row), ...);
+      erase_row(archetypes_[source], source_row);
+    }
+    locations_[id.index] = Location{target, static_cast<std::uint32_t>(target_row)};
+    return target_row;
+  }
+
+  /// Appends a row for @p id, taking a chunk from the free list or allocating one when the last chunk is full.
+  std::size_t push_row(Archetype& archetype, const EntityId& id) noexcept
+  {
+    const auto row = archetype.size;
+    if ((row % archetype.rows_per_chunk) == 0U)
+    {
+      if (free_chunks_.empty())
+      {
+        archetype.chunks.push_back(std::make_unique<Chunk>());
+      }
+      else
+      {
+        archetype.chunks.push_back(std::move(free_chunks_.back()));
+        free_chunks_.pop_back();
+      }
+    }
+    ++archetype.size;
+    new (&entity_id_at(archetype, row)) EntityId{id};
+    return row;
+  }
+
+  /// Fills the hole at @p row, whose components were already moved out or destroyed, with the archetype's last row.
+  void erase_row(Archetype& archetype, const std::size_t row) noexcept
+  {
+    const auto last = archetype.size - 1U;
+    if (row != last)
+    {
+      (relocate<ComponentsT>(archetype, last, archetype, row), ...);
+      const auto moved_id = entity_id_at(archetype, last);
+      entity_id_at(archetype, row) = moved_id;
+      locations_[moved_id.index].row = static_cast<std::uint32_t>(row);
+    }
+    --archetype.size;
+    if ((archetype.size % archetype.rows_per_chunk) == 0U)
+    {
+      free_chunks_.push_back(std::move(archetype.chunks.back()));
+      archetype.chunks.pop_back();
+    }
+  }
+
+  template <typename ExcludeListT>
+  struct ExcludeMask;
+
+  template <typename... ExcludedT>
+  struct ExcludeMask<details::TypeList<ExcludedT...>>
+  {
+    constexpr static Mask VALUE = (Mask{0U} | ... | bit<ExcludedT>());
+  };
+
+  template <typename ExcludeListT, typename... ViewComponentsT>
+  static bool matches(const Archetype& archetype) noexcept
+  {
+    constexpr Mask REQUIRED = (bit<std::remove_const_t<ViewComponentsT>>() | ...);
+    constexpr Mask EXCLUDED = ExcludeMask<ExcludeListT>::VALUE;
+    return ((archetype.mask & REQUIRED) == REQUIRED) && ((archetype.mask & EXCLUDED) == 0U);
+  }
+
+  /// Visits the rows of the matching archetypes' chunks [first_chunk, last_chunk), numbered across archetypes.
+  template <typename ExcludeListT, typename... ViewComponentsT, typename FuncT>
+  void for_each_row(FuncT& func, const std::size_t first_chunk = 0U,
+                    const std::size_t last_chunk = std::numeric_limits<std::size_t>::max()) const noexcept
+  {
+    std::size_t chunk_base = 0U; // Number of the current archetype's first chunk.
+    for (const auto& archetype : archetypes_)
+    {
+      if (chunk_base >= last_chunk)
+      {
+        return;
+      }
+      if (!matches<ExcludeListT, ViewComponentsT...>(archetype))
+      {
+        continue;
+      }
+      const auto chunk_count = archetype.chunks.size();
+      const auto begin = std::max(first_chunk, chunk_base) - chunk_base;
+      const auto end = std::min(last_chunk - chunk_base, chunk_count);
+      chunk_base += chunk_count;
+      for (auto chunk = begin; chunk < end; ++chunk)
+      {
+        const auto first = chunk * archetype.rows_per_chunk;
+        const auto count = std::min(archetype.rows_per_chunk, archetype.size - first);
+        const auto* ids = &entity_id_at(archetype, first);
+        const std::tuple<ViewComponentsT*...> arrays{
+            component_at<std::remove_const_t<ViewComponentsT>>(archetype, first)...};
+        for (std::size_t row = 0U; row < count; ++row)
+        {
+          std::invoke(func, ids[row], std::get<ViewComponentsT*>(arrays)[row]...);
+        }
+      }
+    }
+  }
+
+  stl::HeapArray<Location> locations_;
+  std::vector<Archetype> archetypes_;
+  std::vector<std::unique_ptr<Chunk>> free_chunks_;
+  std::array<std::size_t, NUMBER_OF_REGISTERED_COMPONENTS> sizes_{};
+};
+
+/// Manages entity lifecycle, tags, and groups.
+/// Uses generational indices to detect stale entity references.
+/// Tags provide unique 1:1 entity naming; groups provide 1:N categorization.
+/// Tag and group names are interned into compact ids, so that lookups hash a name once (at compile time for
+/// `constexpr` names) and everything else indexes arrays. Each group keeps its members in a dense array, allocated
+/// on the group's first use; each entity knows its position in it, so removal swaps the last member in.
+///
+/// @note Each entity can belong to at most ONE group at a time.
+///       Adding an entity to a new group automatically removes it from its previous group.
+///
+/// @tparam EnumT The component type enum.
+/// @tparam MAX_NUMBER_OF_ENTITIES_PER_GROUP Maximum entities allowed in a single group.
+template <typename EnumT, std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP>
+class EntityManager
+{
+public:
+  static_assert(stl::details::IS_SCOPED_ENUM_V<EnumT>, "EnumT must be an enum type.");
+
+  using ComponentType = EnumT;
+  using Entity = Entity<ComponentType>;
+  using EntitySignature = typename Entity::EntitySignature;
+
+  /// @param[in] max_number_of_entities Maximum entities this manager can hold.
+  explicit EntityManager(const std::size_t max_number_of_entities) noexcept
+      : entities_{max_number_of_entities}, free_ids_{max_number_of_entities}, tag_names_{max_number_of_entities},
+        tagged_entities_{max_number_of_entities}, entity_tags_{max_number_of_entities, stl::StringInterner::INVALID_ID},
+        group_names_{max_number_of_entities}, group_members_{max_number_of_entities},
+        memberships_{max_number_of_entities, Membership{}}
+  {
+    for (EntityId::INDEX_TYPE id = 0U; id < max_number_of_entities; ++id)
+    {
+      free_ids_.emplace(id, 0U);
+    }
+  }
+
+  /// Creates a new entity with the given signature.
+  /// @pre The free entity pool must not be empty (asserts in debug).
+  /// @param[in] signature The component bitmask for the new entity.
+  /// @return The newly created entity handle.
+  Entity create(EntitySignature signature) noexcept
+  {
+    commit_reservations();
+    assert(!free_ids_.empty());
+
+    auto& entity = entities_[free_ids_.front().index];
+    entity.id = free_ids_.front();
+    entity.signature = std::move(signature);
+
+    free_ids_.pop();
+
+    return entity;
+  }
+
+  /// Creates `entities.size()` entities with the same signature, in the order `create()` would.
+  /// @pre The free entity pool must hold that many ids (asserts in debug).
+  /// @param[in] signature The component bitmask for the new entities.
+  /// @param[out] entities Receives the newly created entity handles.
+  void create(const EntitySignature& signature, stl::Span<Entity> entities) noexcept
+  {
+    commit_reservations();
+    assert(entities.size() <= free_ids_.size());
+
+    for (auto& created : entities)
+    {
+      auto& entity = entities_[free_ids_.front().index];
+      entity.id = free_ids_.front();
+      entity.signature = signature;
+      free_ids_.pop();
+      created = entity;
+    }
+  }
+
+  /// Reserves the id of an entity to be created later by `create(reserved, signature)`.
+  /// Reservations hand out the free ids in the order `create()` would, and may be taken from several threads at once
+  /// as long as nothing else modifies the manager meanwhile. The next `create()` commits all pending reservations:
+  /// from then on, a reserved id is a valid entity without components until it is created or destroyed.
+  /// @pre The free entity pool must hold an id for every pending reservation (asserts in debug).
+  /// @return The reserved id.
+  EntityId reserve() noexcept
+  {
+    const auto offset = reserved_.fetch_add(1U, std::memory_order_relaxed);
+    assert(offset < free_ids_.size());
+    return free_ids_[offset];
+  }
+
+  /// Creates the entity @p reserved was reserved for, with the given signature.
+  /// @pre @p reserved comes from `reserve()` and was neither created nor destroyed yet.
+  /// @param[in] reserved The id returned by `reserve()`.
+  /// @param[in] signature The component bitmask for the new entity.
+  /// @return The newly created entity handle.
+  Entity create(const EntityId& reserved, EntitySignature signature) noexcept
+  {
+    commit_reservations();
+    assert((reserved.index < entities_.size()) && (entities_[reserved.index].id == reserved));
+
+    auto& entity = entities_[reserved.index];
+    entity.signature = std::move(signature);
+    return entity;
+  }
+
+  /// Checks if the entity handle is still valid (not destroyed or recycled).
+  /// @param[in] entity The entity handle to validate.
+  /// @return True if the entity is alive and the generation matches.
+  bool is_valid(const Entity& entity) const noexcept
+  {
+    const auto index = entity.id.index;
+    return (index < entities_.size()) && (entities_[index].id.generation == entity.id.generation);
+  }
+
+  /// Destroys the entity, incrementing its generation and returning the slot to the free list.
+  /// Also removes the entity's tag and group membership. No-op if the entity is already invalid.
+  /// @param[in] entity The entity to destroy.
+  void destroy(const Entity& entity) noexcept
+  {
+    assert(entity.id.index < entities_.size());
+
+    if (!is_valid(entity))
+    {
+      return;
+    }
+
+    untag(entity);
+    remove_from_group(entity);
+
+    {
+      auto& e = entities_[entity.id.index];
+      ++e.id.generation; // Increment generation to invalidate existing references
+
       free_ids_.push(e.id);
     }
   }
 
+  /// @pre The entity must be alive.
+  /// @param[in] id The entity's identifier.
+  /// @return The entity, including its signature.
+  const Entity& get(const EntityId& id) const noexcept
+  {
+    assert((id.index < entities_.size()) && (entities_[id.index].id == id));
+    return entities_[id.index];
+  }
+
+  /// Replaces the signature of an alive entity.
+  /// @pre The entity must be alive.
+  /// @param[in] id The entity's identifier.
+  /// @param[in] signature The new component bitmask.
+  /// @return The previous signature.
+  EntitySignature set_signature(const EntityId& id, EntitySignature signature) noexcept
+  {
+    assert((id.index < entities_.size()) && (entities_[id.index].id == id));
+    return std::exchange(entities_[id.index].signature, std::move(signature));
+  }
+
   /// @return The number of currently alive entities.
   std::size_t size() const noexcept { return entities_.size() - free_ids_.size(); }
 
-  /// Assigns a unique tag (name) to an entity. Tags are 1:1 (one tag per entity, one entity per tag).
+  /// Assigns a unique tag (name) to an entity. Tags are 1:1 (one tag per entity, one entity per tag): the entity
+  /// loses its previous tag, and the tag its previous entity. No-op if the entity is not valid.
   /// @param[in] entity The entity to tag.
   /// @param[in] tag The tag name.
-  void tag(const Entity& entity, const stl::InplaceStringSmall& tag) noexcept
+  void tag(const Entity& entity, const stl::HashedString& tag) noexcept
   {
-    tag_to_entity_id_[tag] = entity.id;
-    entity_id_to_tag_[entity.id] = tag;
+    if (!is_valid(entity))
+    {
+      return;
+    }
+    untag(entity);
+
+    auto tag_id = tag_names_.find(tag);
+    if (tag_id == stl::StringInterner::INVALID_ID)
+    {
+      tag_id = tag_names_.intern(tag);
+    }
+    else
+    {
+      entity_tags_[tagged_entities_[tag_id].index] = stl::StringInterner::INVALID_ID;
+    }
+    tagged_entities_[tag_id] = entity.id;
+    entity_tags_[entity.id.index] = tag_id;
   }
 
   /// Removes the entity's tag. No-op if the entity has no tag.
   /// @param[in] entity The entity to untag.
   void untag(const Entity& entity) noexcept
   {
-    const auto it = entity_id_to_tag_.find(entity.id);
-    if (it != entity_id_to_tag_.end())
+    auto& tag_id = entity_tags_[entity.id.index];
+    if ((tag_id != stl::StringInterner::INVALID_ID) && (tagged_entities_[tag_id] == entity.id))
     {
-      tag_to_entity_id_.erase(it->second);
-      entity_id_to_tag_.erase(it);
+      tag_names_.release(tag_id);
+      tag_id = stl::StringInterner::INVALID_ID;
     }
   }
 
-  bool is_tagged(const Entity& entity, const stl::InplaceStringSmall& tag) const noexcept
+  bool is_tagged(const Entity& entity, const stl::HashedString& tag) const noexcept
   {
-    const auto it = tag_to_entity_id_.find(tag);
-    return (it != tag_to_entity_id_.end()) && (it->second == entity.id);
+    const auto tag_id = tag_names_.find(tag);
+    return (tag_id != stl::StringInterner::INVALID_ID) && (tagged_entities_[tag_id] == entity.id);
   }
 
-  std::optional<Entity> get_entity_by_tag(const stl::InplaceStringSmall& tag) const noexcept
+  std::optional<Entity> get_entity_by_tag(const stl::HashedString& tag) const noexcept
   {
-    const auto it = tag_to_entity_id_.find(tag);
-    if (it == tag_to_entity_id_.end())
+    const auto tag_id = tag_names_.find(tag);
+    if (tag_id == stl::StringInterner::INVALID_ID)
     {
       return std::nullopt;
     }
-    return entities_[it->second.index];
+    return entities_[tagged_entities_[tag_id].index];
   }
 
   template <typename FuncT>
-  void for_each_entity_with_tag(const stl::InplaceStringSmall& tag, FuncT&& func) const noexcept
+  void for_each_entity_with_tag(const stl::HashedString& tag, FuncT&& func) const noexcept
   {
-    if (auto it = tag_to_entity_id_.find(tag); it != tag_to_entity_id_.end())
+    if (const auto tag_id = tag_names_.find(tag); tag_id != stl::StringInterner::INVALID_ID)
     {
-      std::invoke(std::forward<FuncT>(func), entities_[it->second.index]);
+      std::invoke(std::forward<FuncT>(func), entities_[tagged_entities_[tag_id].index]);
     }
   }
 
   /// Adds the entity to a group. Each entity can belong to at most one group;
-  /// adding to a new group removes the entity from its previous group.
+  /// adding to a new group removes the entity from its previous group. No-op if the entity is not valid.
+  /// @pre The group holds fewer than MAX_NUMBER_OF_ENTITIES_PER_GROUP entities (asserts in debug).
   /// @param[in] entity The entity to add.
   /// @param[in] group The group name.
-  void add_to_group(const Entity& entity, const stl::InplaceStringSmall& group) noexcept
+  void add_to_group(const Entity& entity, const stl::HashedString& group) noexcept
   {
+    if (!is_valid(entity))
+    {
+      return;
+    }
     remove_from_group(entity);
 
-    group_to_entity_ids_[group].insert(entity.id);
-    entity_id_to_group_[entity.id] = group;
+    // Every member holds a reference to the group name, so an empty group releases its id.
+    const auto group_id = group_names_.intern(group);
+    auto& members = group_members_[group_id];
+    if (members == nullptr)
+    {
+      members = std::make_unique<GroupMembers>(MAX_NUMBER_OF_ENTITIES_PER_GROUP);
+    }
+    assert(!members->full() && "Group is full.");
+    memberships_[entity.id.index] =
+        Membership{group_id, static_cast<std::uint32_t>(members->size()), entity.id.generation};
+    members->push_back(entity.id);
   }
 
+  /// Removes the entity from its group, moving the group's last member into its place. No-op if the entity has no
+  /// group.
+  /// @param[in] entity The entity to remove.
   void remove_from_group(const Entity& entity) noexcept
   {
-    const auto it = entity_id_to_group_.find(entity.id);
-    if (it != entity_id_to_group_.end())
+    auto& membership = memberships_[entity.id.index];
+    if (!is_member(entity.id, membership))
     {
-      group_to_entity_ids_[it->second].erase(entity.id);
-      entity_id_to_group_.erase(it);
+      return;
     }
+
+    auto& members = *group_members_[membership.group];
+    const auto moved = members.back();
+    members[membership.position] = moved;
+    memberships_[moved.index].position = membership.position;
+    members.pop_back();
+
+    group_names_.release(membership.group);
+    membership = Membership{};
   }
 
-  bool is_in_group(const Entity& entity, const stl::InplaceStringSmall& group) const noexcept
+  bool is_in_group(const Entity& entity, const stl::HashedString& group) const noexcept
   {
-    const auto it = entity_id_to_group_.find(entity.id);
-    return (it != entity_id_to_group_.end()) && (it->second == group);
+    const auto& membership = memberships_[entity.id.index];
+    return is_member(entity.id, membership) && (membership.group == group_names_.find(group));
   }
 
   template <typename FuncT>
-  void for_each_entity_in_group(const stl::InplaceStringSmall& group, FuncT&& func) const noexcept
+  void for_each_entity_in_group(const stl::HashedString& group, FuncT&& func) const noexcept
   {
-    if (auto it = group_to_entity_ids_.find(group); it != group_to_entity_ids_.end())
+    if (const auto group_id = group_names_.find(group); group_id != stl::StringInterner::INVALID_ID)
     {
-      for (const auto& entity_id : it->second)
+      for (const auto& entity_id : *group_members_[group_id])
       {
         std::invoke(std::forward<FuncT>(func), entities_[entity_id.index]);
       }
@@ -543,14 +1562,43 @@ public:
   }
 
 private:
+  using GroupMembers = stl::StaticVector<EntityId>;
+
+  /// An entity's group and its position in the group's dense member array. The generation tells a stale handle
+  /// from the entity now holding its index.
+  struct Membership
+  {
+    stl::StringInterner::IdType group{stl::StringInterner::INVALID_ID};
+    std::uint32_t position{0U};
+    EntityId::GENERATION_TYPE generation{0U};
+  };
+
+  static bool is_member(const EntityId& id, const Membership& membership) noexcept
+  {
+    return (membership.group != stl::StringInterner::INVALID_ID) && (membership.generation == id.generation);
+  }
+
+  /// Takes the reserved ids off the free list, making them entities without signature.
+  void commit_reservations() noexcept
+  {
+    for (auto count = reserved_.exchange(0U, std::memory_order_relaxed); count > 0U; --count)
+    {
+      auto& entity = entities_[free_ids_.front().index];
+      entity.id = free_ids_.front();
+      entity.signature = EntitySignature{};
+      free_ids_.pop();
+    }
+  }
+
   stl::HeapArray<Entity> entities_;
   stl::StaticQueue<EntityId> free_ids_;
-  stl::StaticFlatUnorderedMap<stl::InplaceStringSmall, EntityId> tag_to_entity_id_;
-  stl::StaticFlatUnorderedMap<EntityId, stl::InplaceStringSmall> entity_id_to_tag_;
-  stl::StaticFlatUnorderedMap<stl::InplaceStringSmall,
-                              stl::InplaceStaticFlatUnorderedSet<EntityId, MAX_NUMBER_OF_ENTITIES_PER_GROUP>>
-      group_to_entity_ids_;
-  stl::StaticFlatUnorderedMap<EntityId, stl::InplaceStringSmall> entity_id_to_group_;
+  std::atomic<std::size_t> reserved_{0U}; ///< Ids at the front of `free_ids_` handed out by `reserve()`.
+  stl::StringInterner tag_names_;
+  stl::HeapArray<EntityId> tagged_entities_;                ///< By tag id.
+  stl::HeapArray<stl::StringInterner::IdType> entity_tags_; ///< By entity index.
+  stl::StringInterner group_names_;
+  stl::HeapArray<std::unique_ptr<GroupMembers>> group_members_; ///< By group id, allocated on first use.
+  stl::HeapArray<Membership> memberships_;                      ///< By entity index.
 };
 
 template <typename EnumT>
@@ -605,6 +1653,17 @@ private:
   stl::StaticFlatUnorderedSet<EntityId> entities_;
 };
 
+/// Explicit component access of a system, refining what its signature implies.
+/// Every component of the signature counts as written unless it is listed in `reads`. Both sets may name components
+/// outside the signature, e.g. ones a system looks up on entities it does not iterate.
+/// @tparam EnumT The component type enum.
+template <typename EnumT>
+struct SystemAccess
+{
+  stl::Flags<EnumT> reads{};  ///< Only read.
+  stl::Flags<EnumT> writes{}; ///< Written; takes precedence over `reads`.
+};
+
 /// Base class for user-defined systems.
 /// Derive from this class and implement update logic to process entities.
 template <typename EnumT>
@@ -615,20 +1674,49 @@ public:
 
   using ComponentType = EnumT;
   using SystemSignature = SystemSignature<ComponentType>;
+  using SystemAccess = SystemAccess<ComponentType>;
+  using ComponentMask = stl::Flags<ComponentType>;
 
   System(SystemSignature signature, const std::size_t max_number_of_entities) noexcept
-      : ISystem{max_number_of_entities}, signature_{std::move(signature)}
+      : System{std::move(signature), SystemAccess{}, max_number_of_entities}
+  {
+  }
+
+  System(SystemSignature signature, const SystemAccess& access, const std::size_t max_number_of_entities) noexcept
+      : ISystem{max_number_of_entities},
+        signature_{std::move(signature)},
+        writes_{access.writes | (signature_ & ~access.reads)},
+        reads_{access.reads & ~writes_}
   {
   }
 
   const SystemSignature& get_signature() const noexcept { return signature_; }
 
+  /// Components the system only reads.
+  const ComponentMask& get_reads() const noexcept { return reads_; }
+
+  /// Components the system writes.
+  const ComponentMask& get_writes() const noexcept { return writes_; }
+
+  /// Whether running this system and @p other concurrently is a data race: one of them writes a component the other
+  /// reads or writes.
+  bool conflicts_with(const System& other) const noexcept
+  {
+    return (writes_ & (other.reads_ | other.writes_)).any() || (other.writes_ & reads_).any();
+  }
+
 private:
   SystemSignature signature_;
+  ComponentMask writes_;
+  ComponentMask reads_;
 };
 
 /// Manages system registration and entity distribution.
-/// Automatically notifies all systems when entities are added or removed.
+/// Automatically notifies the systems when entities are added, removed or change signature.
+///
+/// Systems are indexed by the component types of their signature, so a notification only touches the systems that
+/// require a component type of the entity (on add and remove) or whose required component types changed (on a
+/// signature change). A system with an empty signature matches every entity and is always notified.
 template <typename EnumT>
 class SystemManager
 {
@@ -637,6 +1725,7 @@ public:
 
   using ComponentType = EnumT;
   using Entity = Entity<ComponentType>;
+  using EntitySignature = typename Entity::EntitySignature;
 
   explicit SystemManager(const std::size_t max_number_of_systems) noexcept : systems_{max_number_of_systems} {}
 
@@ -652,6 +1741,15 @@ public:
     auto system = std::make_unique<SystemT>(std::forward<ArgsT>(args)...);
     auto& system_ref = *system;
     systems_[type_index] = std::move(system);
+
+    const auto signature = to_mask(system_ref.get_signature());
+    if (signature == 0U)
+    {
+      unconstrained_systems_.push_back(&system_ref);
+    }
+    details::for_each_bit(signature,
+                          [this, &system_ref](const std::size_t bit)
+                          { systems_by_component_[bit].push_back(&system_ref); });
     return system_ref;
   }
 
@@ -679,28 +1777,411 @@ public:
     return static_cast<const SystemT&>(*it->second);
   }
 
+  /// Adds the entity to the systems its signature matches.
   void add_entity(const Entity& entity) noexcept
   {
-    for (auto it = systems_.begin(); it != systems_.end(); ++it)
+    for (auto* system : unconstrained_systems_)
     {
-      auto& system = it->second;
       system->add_entity(entity);
     }
+    for_each_system_of(to_mask(entity.signature),
+                       [&entity](System<ComponentType>& system) { system.add_entity(entity); });
+  }
+
+  /// Adds entities sharing @p signature to the systems it matches, matching the signature once for the whole batch.
+  /// @pre Every entity has @p signature.
+  void add_entities(const EntitySignature& signature, const stl::Span<const Entity> entities) noexcept
+  {
+    const auto add_all = [entities](System<ComponentType>& system)
+    {
+      for (const auto& entity : entities)
+      {
+        system.add_entity(entity);
+      }
+    };
+    for (auto* system : unconstrained_systems_)
+    {
+      add_all(*system);
+    }
+    const auto mask = to_mask(signature);
+    for_each_system_of(mask,
+                       [mask, &add_all](System<ComponentType>& system)
+                       {
+                         if (matches(mask, system))
+                         {
+                           add_all(system);
+                         }
+                       });
   }
 
+  /// Removes the entity from the systems its signature matches.
+  /// @param[in] entity The entity, with its current signature.
   void remove_entity(const Entity& entity) noexcept
   {
-    for (auto it = systems_.begin(); it != systems_.end(); ++it)
+    for (auto* system : unconstrained_systems_)
     {
-      auto& system = it->second;
       system->remove_entity(entity);
     }
+    const auto signature = to_mask(entity.signature);
+    for_each_system_of(signature,
+                       [&entity, signature](System<ComponentType>& system)
+                       {
+                         if (matches(signature, system))
+                         {
+                           system.remove_entity(entity);
+                         }
+                       });
+  }
+
+  /// Removes the entities from the systems their current signatures match, visiting each of those systems once for
+  /// the whole batch.
+  /// @param[in] entities The entity handles.
+  /// @param[in] current Returns the entity with its current signature for a handle, or nullptr to skip the handle.
+  template <typename CurrentT>
+  void remove_entities(const stl::Span<const Entity> entities, CurrentT&& current) noexcept
+  {
+    std::uint64_t mask{0U};
+    for (const auto& entity : entities)
+    {
+      if (const auto* alive = current(entity))
+      {
+        mask |= to_mask(alive->signature);
+      }
+    }
+    const auto remove_matching = [entities, &current](System<ComponentType>& system)
+    {
+      for (const auto& entity : entities)
+      {
+        const auto* alive = current(entity);
+        if ((alive != nullptr) && matches(to_mask(alive->signature), system))
+        {
+          system.remove_entity(*alive);
+        }
+      }
+    };
+    for (auto* system : unconstrained_systems_)
+    {
+      remove_matching(*system);
+    }
+    for_each_system_of(mask, remove_matching);
+  }
+
+  /// Adds the entities that gained the component @p type to the systems requiring it that they now match, visiting
+  /// each of those systems once for the whole batch. Entities a system already holds stay as they are.
+  /// @param[in] type The component type the entities gained.
+  /// @param[in] entities The entity handles.
+  /// @param[in] current Returns the entity with its current signature for a handle, or nullptr to skip the handle.
+  template <typename CurrentT>
+  void add_component_type(const ComponentType type, const stl::Span<const Entity> entities, CurrentT&& current) noexcept
+  {
+    for_each_system_of(to_mask(stl::Flags<ComponentType>{type}),
+                       [entities, &current](System<ComponentType>& system)
+                       {
+                         for (const auto& entity : entities)
+                         {
+                           if (const auto* alive = current(entity))
+                           {
+                             system.add_entity(*alive);
+                           }
+                         }
+                       });
+  }
+
+  /// Moves the entity between the systems whose match changed with its signature.
+  /// @param[in] entity The entity, with its new signature.
+  /// @param[in] previous The signature the entity had before.
+  void update_entity(const Entity& entity, const EntitySignature& previous) noexcept
+  {
+    const auto before = to_mask(previous);
+    const auto after = to_mask(entity.signature);
+    for_each_system_of(before ^ after,
+                       [&entity, before, after](System<ComponentType>& system)
+                       {
+                         const auto matched = matches(before, system);
+                         if (matched != matches(after, system))
+                         {
+                           if (matched)
+                           {
+                             system.remove_entity(entity);
+                           }
+                           else
+                           {
+                             system.add_entity(entity);
+                           }
+                         }
+                       });
   }
 
   std::size_t size() const noexcept { return systems_.size(); }
 
 private:
+  constexpr static std::size_t MAX_NUMBER_OF_COMPONENT_TYPES = sizeof(std::underlying_type_t<ComponentType>) * 8U;
+
+  static std::uint64_t to_mask(const stl::Flags<ComponentType>& flags) noexcept
+  {
+    return static_cast<std::uint64_t>(static_cast<std::underlying_type_t<ComponentType>>(flags));
+  }
+
+  static bool matches(const std::uint64_t signature, const System<ComponentType>& system) noexcept
+  {
+    const auto required = to_mask(system.get_signature());
+    return (signature & required) == required;
+  }
+
+  /// Calls @p func once for every system requiring at least one of the component types in @p mask.
+  /// A system is listed under each of its component types and visited under the lowest one it shares with @p mask.
+  template <typename FuncT>
+  void for_each_system_of(const std::uint64_t mask, FuncT&& func) const noexcept
+  {
+    details::for_each_bit(mask,
+                          [this, mask, &func](const std::size_t bit)
+                          {
+                            for (auto* system : systems_by_component_[bit])
+                            {
+                              const auto shared = to_mask(system->get_signature()) & mask;
+                              if ((shared & (~shared + 1U)) == (std::uint64_t{1U} << bit))
+                              {
+                                func(*system);
+                              }
+                            }
+                          });
+  }
+
   stl::StaticFlatUnorderedMap<std::type_index, std::unique_ptr<ISystem>> systems_;
+  std::array<std::vector<System<ComponentType>*>, MAX_NUMBER_OF_COMPONENT_TYPES> systems_by_component_;
+  std::vector<System<ComponentType>*> unconstrained_systems_;
+};
+
+/// Counts the parallel iterations in progress over the storage of a GenericECSManager. Structural changes move or
+/// destroy components, so the manager asserts that none happen while it is held.
+class StructuralLock
+{
+public:
+  void acquire() const noexcept { count_.fetch_add(1U, std::memory_order_acq_rel); }
+  void release() const noexcept { count_.fetch_sub(1U, std::memory_order_acq_rel); }
+  bool is_held() const noexcept { return count_.load(std::memory_order_acquire) != 0U; }
+
+  /// Holds a StructuralLock, if given one, for its own lifetime.
+  class Guard
+  {
+  public:
+    explicit Guard(const StructuralLock* lock) noexcept : lock_{lock}
+    {
+      if (lock_ != nullptr)
+      {
+        lock_->acquire();
+      }
+    }
+    Guard(const Guard&) = delete;
+    Guard(Guard&&) = delete;
+    Guard& operator=(const Guard&) = delete;
+    Guard& operator=(Guard&&) = delete;
+    ~Guard()
+    {
+      if (lock_ != nullptr)
+      {
+        lock_->release();
+      }
+    }
+
+  private:
+    const StructuralLock* lock_;
+  };
+
+private:
+  mutable std::atomic<std::uint32_t> count_{0U};
+};
+
+/// Iterates the entities that have every component in ComponentsT and none in ExcludedT, handing the components to
+/// a callback in lockstep.
+///
+/// `each()` walks the dense array of the smallest included storage and probes the other storages for each of its
+/// entities, so the cost scales with the rarest component rather than with the number of entities. With an
+/// ArchetypeComponentManager it instead walks the chunks of the matching archetypes, with no probing. Nothing is
+/// allocated. A component type listed as `const T` is passed as `const T&`; a view of a const ECSManager passes
+/// every component as const.
+///
+/// Obtain a view from `ECSManager::view<ComponentsT...>()`, optionally narrowed with `exclude<ExcludedT...>()`.
+///
+/// @note Components must not be emplaced or removed while `each()` runs; entities must not be created or destroyed.
+///
+/// @tparam ComponentManagerT The component manager, const-qualified for read-only views.
+/// @tparam EntityManagerT The entity manager.
+/// @tparam ExcludeListT details::TypeList of the component types an entity must not have.
+/// @tparam ComponentsT The component types an entity must have, optionally const-qualified.
+template <typename ComponentManagerT, typename EntityManagerT, typename ExcludeListT, typename... ComponentsT>
+class View;
+
+template <typename ComponentManagerT, typename EntityManagerT, typename... ExcludedT, typename... ComponentsT>
+class View<ComponentManagerT, EntityManagerT, details::TypeList<ExcludedT...>, ComponentsT...>
+{
+public:
+  using Entity = typename EntityManagerT::Entity;
+
+  static_assert(sizeof...(ComponentsT) > 0U, "A view must include at least one component type.");
+  static_assert(!std::is_const_v<ComponentManagerT> || (std::is_const_v<ComponentsT> && ...),
+                "A view of a const manager can only access const components.");
+
+  /// @param structural_lock Held during `parallel_each`; none for a view not obtained from a GenericECSManager.
+  View(ComponentManagerT& component_manager, const EntityManagerT& entity_manager,
+       const StructuralLock* structural_lock = nullptr) noexcept
+      : component_manager_{&component_manager}, entity_manager_{&entity_manager}, structural_lock_{structural_lock}
+  {
+  }
+
+  /// @return A view that additionally skips the entities having any of the MoreExcludedT components.
+  template <typename... MoreExcludedT>
+  View<ComponentManagerT, EntityManagerT, details::TypeList<ExcludedT..., MoreExcludedT...>, ComponentsT...>
+  exclude() const noexcept
+  {
+    return {*component_manager_, *entity_manager_, structural_lock_};
+  }
+
+  /// Invokes @p func for every matching entity, either as func(entity, components&...) or as func(components&...).
+  template <typename FuncT>
+  void each(FuncT&& func) const noexcept
+  {
+    if constexpr (std::remove_const_t<ComponentManagerT>::ITERATES_BY_ARCHETYPE)
+    {
+      component_manager_->template each<details::TypeList<ExcludedT...>, ComponentsT...>(
+          [this, &func](const EntityId& id, ComponentsT&... components) { invoke(func, id, components...); });
+    }
+    else
+    {
+      const std::array<std::size_t, sizeof...(ComponentsT)> sizes{
+          component_manager_->template size<std::remove_const_t<ComponentsT>>()...};
+      const auto driver = static_cast<std::size_t>(std::min_element(sizes.begin(), sizes.end()) - sizes.begin());
+      each_driven_by(driver, func, nullptr, std::index_sequence_for<ComponentsT...>{});
+    }
+  }
+
+  /// Like `each`, but splits the matching entities into chunks that run as tasks on @p pool, the calling thread
+  /// included, and returns when all have been visited. The archetype backend hands out one archetype chunk per task;
+  /// the others split the dense array of the smallest pool into slices of about the same size, a whole number of
+  /// cache lines long, so neighbouring tasks do not write the same line of it.
+  ///
+  /// @p func runs concurrently for different entities: it may write the components it is passed, but anything else
+  /// it shares needs synchronisation. Creating or destroying entities and adding or removing components would move
+  /// the components under the other tasks, so they must wait until `parallel_each` returns (the GenericECSManager
+  /// the view came from asserts that they do). It may be called from a task on @p pool, e.g. a job of a
+  /// SystemScheduler, which then helps with the chunks instead of blocking.
+  template <typename FuncT>
+  void parallel_each(WorkStealingPool& pool, FuncT&& func) const
+  {
+    const StructuralLock::Guard guard{structural_lock_};
+
+    if constexpr (std::remove_const_t<ComponentManagerT>::ITERATES_BY_ARCHETYPE)
+    {
+      using ExcludeList = details::TypeList<ExcludedT...>;
+      const auto chunks = component_manager_->template number_of_chunks<ExcludeList, ComponentsT...>();
+      pool.parallel_for(chunks,
+                        [this, &func](const std::size_t chunk)
+                        {
+                          component_manager_->template each<ExcludeList, ComponentsT...>(
+                              chunk, chunk + 1U,
+                              [this, &func](const EntityId& id, ComponentsT&... components)
+                              { invoke(func, id, components...); });
+                        });
+    }
+    else
+    {
+      const std::array<std::size_t, sizeof...(ComponentsT)> sizes{
+          component_manager_->template size<std::remove_const_t<ComponentsT>>()...};
+      const auto driver = static_cast<std::size_t>(std::min_element(sizes.begin(), sizes.end()) - sizes.begin());
+      each_driven_by(driver, func, &pool, std::index_sequence_for<ComponentsT...>{});
+    }
+  }
+
+private:
+  /// Bytes of the driving array per `parallel_each` task, as much as an archetype chunk holds.
+  constexpr static std::size_t BYTES_PER_TASK = 16U * 1'024U;
+  constexpr static std::size_t CACHE_LINE_SIZE = 64U;
+
+  /// @return Rows per `parallel_each` task for a driver of type DriverT: about BYTES_PER_TASK, in whole cache lines.
+  template <typename DriverT>
+  constexpr static std::size_t rows_per_task() noexcept
+  {
+    constexpr std::size_t ROWS_PER_LINE_MULTIPLE = CACHE_LINE_SIZE / std::gcd(CACHE_LINE_SIZE, sizeof(DriverT));
+    return std::max<std::size_t>(BYTES_PER_TASK / sizeof(DriverT) / ROWS_PER_LINE_MULTIPLE, 1U)
+           * ROWS_PER_LINE_MULTIPLE;
+  }
+
+  /// Iterates through the pool of the @p driver-th component, on @p pool if one is given.
+  template <typename FuncT, std::size_t... INDICES>
+  void each_driven_by(const std::size_t driver, FuncT& func, WorkStealingPool* pool,
+                      std::index_sequence<INDICES...> /*indices*/) const
+  {
+    ((driver == INDICES ? each_driven_by<std::tuple_element_t<INDICES, std::tuple<ComponentsT...>>>(func, pool)
+                        : void()),
+     ...);
+  }
+
+  template <typename DriverT, typename FuncT>
+  void each_driven_by(FuncT& func, WorkStealingPool* pool) const
+  {
+    using Driver = std::remove_const_t<DriverT>;
+    const auto visit = [this, &func](const EntityId& id, auto& driver_component)
+    {
+      if (((component_manager_->template find<ExcludedT>(id) != nullptr) || ...))
+      {
+        return;
+      }
+
+      const std::tuple<ComponentsT*...> components{probe<ComponentsT, DriverT>(id, driver_component)...};
+      if (((std::get<ComponentsT*>(components) == nullptr) || ...))
+      {
+        return;
+      }
+
+      invoke(func, id, *std::get<ComponentsT*>(components)...);
+    };
+
+    if (pool == nullptr)
+    {
+      component_manager_->template for_each<Driver>(visit);
+      return;
+    }
+
+    constexpr auto ROWS = rows_per_task<Driver>();
+    const auto size = component_manager_->template size<Driver>();
+    pool->parallel_for((size + ROWS - 1U) / ROWS,
+                       [this, &visit, size](const std::size_t task)
+                       {
+                         const auto first = task * ROWS;
+                         component_manager_->template for_each<Driver>(first, std::min(first + ROWS, size), visit);
+                       });
+  }
+
+  template <typename FuncT>
+  void invoke(FuncT& func, const EntityId& id, ComponentsT&... components) const noexcept
+  {
+    if constexpr (std::is_invocable_v<FuncT&, const Entity&, ComponentsT&...>)
+    {
+      std::invoke(func, entity_manager_->get(id), components...);
+    }
+    else
+    {
+      std::invoke(func, components...);
+    }
+  }
+
+  /// @return The driving component itself, or the result of probing ComponentT's storage.
+  template <typename ComponentT, typename DriverT, typename DriverComponentT>
+  ComponentT* probe(const EntityId& id, DriverComponentT& driver_component) const noexcept
+  {
+    if constexpr (std::is_same_v<std::remove_const_t<ComponentT>, std::remove_const_t<DriverT>>)
+    {
+      return &driver_component;
+    }
+    else
+    {
+      return component_manager_->template find<std::remove_const_t<ComponentT>>(id);
+    }
+  }
+
+  ComponentManagerT* component_manager_;
+  const EntityManagerT* entity_manager_;
+  const StructuralLock* structural_lock_;
 };
 
 /// High-level facade coordinating entities, components, and systems.
@@ -710,19 +2191,24 @@ private:
 /// the primary interface users should interact with rather than using the underlying managers
 /// directly.
 ///
+/// @tparam ComponentManagerT            Component backend: ComponentManager, SparseSetComponentManager or
+///                                      ArchetypeComponentManager.
 /// @tparam EnumT                        Power-of-2 enum for component type bitmask (max 64 types).
 /// @tparam MAX_NUMBER_OF_ENTITIES_PER_GROUP  Maximum entities allowed per group.
 /// @tparam ComponentsT                  List of component types to register.
-template <typename EnumT, std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP, typename... ComponentsT>
-class ECSManager
+template <template <typename, typename...> class ComponentManagerT, typename EnumT,
+          std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP, typename... ComponentsT>
+class GenericECSManager
 {
 public:
   using ComponentType = EnumT;
   using SystemSignature = SystemSignature<ComponentType>;
   using Entity = Entity<ComponentType>;
   using EntitySignature = typename Entity::EntitySignature;
+  using ComponentManagerType = ComponentManagerT<ComponentType, ComponentsT...>;
+  using EntityManagerType = EntityManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP>;
 
-  ECSManager(const std::size_t max_number_of_entities, const std::size_t max_number_of_systems) noexcept
+  GenericECSManager(const std::size_t max_number_of_entities, const std::size_t max_number_of_systems) noexcept
       : component_manager_{max_number_of_entities}, entity_manager_{max_number_of_entities},
         system_manager_{max_number_of_systems}
   {
@@ -748,67 +2234,171 @@ public:
 
   Entity create_entity(EntitySignature signature) noexcept
   {
+    assert(!structural_lock_.is_held() && "Structural change during parallel_each.");
     const auto entity = entity_manager_.create(std::move(signature));
     system_manager_.add_entity(entity);
     return entity;
   }
 
+  /// Reserves the id of an entity created later by `create_entity(reserved, signature)`; safe to call from several
+  /// threads at once, e.g. from `parallel_each` or scheduled systems, while no structural change happens.
+  EntityId reserve_entity() noexcept { return entity_manager_.reserve(); }
+
+  /// Creates the entity @p reserved was reserved for by `reserve_entity()`.
+  Entity create_entity(const EntityId& reserved, EntitySignature signature) noexcept
+  {
+    assert(!structural_lock_.is_held() && "Structural change during parallel_each.");
+    const auto entity = entity_manager_.create(reserved, std::move(signature));
+    system_manager_.add_entity(entity);
+    return entity;
+  }
+
+  /// Creates @p count entities with the same signature, written to the front of @p entities. The ids are taken off the
+  /// free list in one go and the systems are matched against the signature once for the whole batch.
+  /// @pre `count <= entities.size()`.
+  void create_entities(const std::size_t count, const EntitySignature& signature, stl::Span<Entity> entities) noexcept
+  {
+    assert(!structural_lock_.is_held() && "Structural change during parallel_each.");
+    assert(count <= entities.size());
+    const auto created = entities.first(count);
+    entity_manager_.create(signature, created);
+    system_manager_.add_entities(signature, created);
+  }
+
   bool is_entity_valid(const Entity& entity) const noexcept { return entity_manager_.is_valid(entity); }
 
   void destroy_entity(const Entity& entity) noexcept
   {
+    assert(!structural_lock_.is_held() && "Structural change during parallel_each.");
+    if (!entity_manager_.is_valid(entity))
+    {
+      return;
+    }
+    // The handle may predate component changes; the systems are found through the current signature.
+    system_manager_.remove_entity(entity_manager_.get(entity.id));
     entity_manager_.destroy(entity);
-    system_manager_.remove_entity(entity);
     component_manager_.remove(entity);
   }
 
+  /// Destroys every entity of @p entities, skipping the invalid ones. The systems are visited once for the whole batch;
+  /// the ids go back to the free list one by one, in the order of @p entities.
+  void destroy_entities(const stl::Span<const Entity> entities) noexcept
+  {
+    assert(!structural_lock_.is_held() && "Structural change during parallel_each.");
+    system_manager_.remove_entities(entities, [this](const Entity& entity) { return find_alive(entity); });
+    for (const auto& entity : entities)
+    {
+      if (entity_manager_.is_valid(entity))
+      {
+        entity_manager_.destroy(entity);
+        component_manager_.remove(entity);
+      }
+    }
+  }
+
   std::size_t get_number_of_entities() const noexcept { return entity_manager_.size(); }
 
-  void tag_entity(const Entity& entity, const stl::InplaceStringSmall& tag) noexcept
+  void tag_entity(const Entity& entity, const stl::HashedString& tag) noexcept
   {
     entity_manager_.tag(entity, tag);
   }
 
   void untag_entity(const Entity& entity) noexcept { entity_manager_.untag(entity); }
 
-  bool is_entity_tagged(const Entity& entity, const stl::InplaceStringSmall& tag) const noexcept
+  bool is_entity_tagged(const Entity& entity, const stl::HashedString& tag) const noexcept
   {
     return entity_manager_.is_tagged(entity, tag);
   }
 
-  std::optional<Entity> get_entity_by_tag(const stl::InplaceStringSmall& tag) const noexcept
+  std::optional<Entity> get_entity_by_tag(const stl::HashedString& tag) const noexcept
   {
     return entity_manager_.get_entity_by_tag(tag);
   }
 
   template <typename FuncT>
-  void for_each_entity_with_tag(const stl::InplaceStringSmall& tag, FuncT&& func) const noexcept
+  void for_each_entity_with_tag(const stl::HashedString& tag, FuncT&& func) const noexcept
   {
     entity_manager_.for_each_entity_with_tag(tag, std::forward<FuncT>(func));
   }
 
-  void add_entity_to_group(const Entity& entity, const stl::InplaceStringSmall& group) noexcept
+  void add_entity_to_group(const Entity& entity, const stl::HashedString& group) noexcept
   {
     entity_manager_.add_to_group(entity, group);
   }
 
   void remove_entity_from_group(const Entity& entity) noexcept { entity_manager_.remove_from_group(entity); }
 
-  bool is_entity_in_group(const Entity& entity, const stl::InplaceStringSmall& group) const noexcept
+  bool is_entity_in_group(const Entity& entity, const stl::HashedString& group) const noexcept
   {
     return entity_manager_.is_in_group(entity, group);
   }
 
   template <typename FuncT>
-  void for_each_entity_in_group(const stl::InplaceStringSmall& group, FuncT&& func) const noexcept
+  void for_each_entity_in_group(const stl::HashedString& group, FuncT&& func) const noexcept
   {
     entity_manager_.for_each_entity_in_group(group, std::forward<FuncT>(func));
   }
 
+  /// Adds the component to the entity and its type to the entity's signature, which adds the entity to the systems
+  /// it matches from now on. No-op if the entity already has the component or is not valid.
   template <typename ComponentT, typename... ArgsT>
   void emplace_component(const Entity& entity, ArgsT&&... args) noexcept
   {
+    assert(!structural_lock_.is_held() && "Structural change during parallel_each.");
+    if (!entity_manager_.is_valid(entity))
+    {
+      return;
+    }
     component_manager_.template emplace<ComponentT>(entity, std::forward<ArgsT>(args)...);
+    set_component_bit(entity, ComponentT::TYPE, true);
+  }
+
+  /// Emplaces the component returned by @p generator(i) for every entities[i] that does not have one yet, skipping the
+  /// invalid ones. The component is constructed from the returned value in the storage, one storage pass per run of
+  /// valid handles, and the systems requiring the component are visited once for the whole batch.
+  template <typename ComponentT, typename GeneratorT,
+            typename = std::enable_if_t<std::is_invocable_r_v<ComponentT, GeneratorT&, std::size_t>>>
+  void emplace_components(const stl::Span<const Entity> entities, GeneratorT&& generator) noexcept
+  {
+    assert(!structural_lock_.is_held() && "Structural change during parallel_each.");
+    std::size_t first = 0U;
+    while (first < entities.size())
+    {
+      if (!entity_manager_.is_valid(entities[first]))
+      {
+        ++first;
+        continue;
+      }
+      auto last = first + 1U;
+      while ((last < entities.size()) && entity_manager_.is_valid(entities[last]))
+      {
+        ++last;
+      }
+      // Only entities without the component can lack its bit, so the storage's pass updates the signatures too.
+      const auto run = entities.subspan(first, last - first);
+      component_manager_.template emplace_n<ComponentT>(run,
+                                                        [this, run, first, &generator](const std::size_t index)
+                                                        {
+                                                          const auto& id = run[index].id;
+                                                          auto signature = entity_manager_.get(id).signature;
+                                                          signature.set(ComponentT::TYPE);
+                                                          entity_manager_.set_signature(id, std::move(signature));
+                                                          return generator(first + index);
+                                                        });
+      first = last;
+    }
+    // Gaining a component only adds matches, and adding an entity a system holds already leaves it alone.
+    system_manager_.add_component_type(ComponentT::TYPE, entities,
+                                       [this](const Entity& entity) { return find_alive(entity); });
+  }
+
+  /// Emplaces a copy of values[i] for every entities[i] that does not have the component yet.
+  /// @pre `entities.size() <= values.size()`.
+  template <typename ComponentT>
+  void emplace_components(const stl::Span<const Entity> entities, const stl::Span<const ComponentT> values) noexcept
+  {
+    assert(entities.size() <= values.size());
+    emplace_components<ComponentT>(entities, [values](const std::size_t index) { return values[index]; });
   }
 
   template <typename ComponentT>
@@ -829,10 +2419,18 @@ public:
     return component_manager_.template get<ComponentT>(entity);
   }
 
+  /// Removes the component from the entity and its type from the entity's signature, which removes the entity from
+  /// the systems requiring it. No-op if the entity is not valid.
   template <typename ComponentT>
   void remove_component(const Entity& entity) noexcept
   {
+    assert(!structural_lock_.is_held() && "Structural change during parallel_each.");
+    if (!entity_manager_.is_valid(entity))
+    {
+      return;
+    }
     component_manager_.template remove<ComponentT>(entity);
+    set_component_bit(entity, ComponentT::TYPE, false);
   }
 
   template <typename ComponentT>
@@ -843,10 +2441,60 @@ public:
 
   std::size_t get_total_number_of_components() const noexcept { return component_manager_.total_size(); }
 
+  /// @return A View over the entities having all ViewComponentsT; list a type as `const T` for read-only access.
+  template <typename... ViewComponentsT>
+  View<ComponentManagerType, EntityManagerType, details::TypeList<>, ViewComponentsT...> view() noexcept
+  {
+    return {component_manager_, entity_manager_, &structural_lock_};
+  }
+
+  /// @return A read-only View over the entities having all ViewComponentsT.
+  template <typename... ViewComponentsT>
+  View<const ComponentManagerType, EntityManagerType, details::TypeList<>, const ViewComponentsT...>
+  view() const noexcept
+  {
+    return {component_manager_, entity_manager_, &structural_lock_};
+  }
+
 private:
-  ComponentManager<ComponentType, ComponentsT...> component_manager_;
-  EntityManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP> entity_manager_;
+  /// @return The entity @p entity refers to, with its current signature, or nullptr if the handle is not valid.
+  const Entity* find_alive(const Entity& entity) const noexcept
+  {
+    return entity_manager_.is_valid(entity) ? &entity_manager_.get(entity.id) : nullptr;
+  }
+
+  /// Keeps the entity's signature in step with its components and updates the systems whose match changed.
+  /// @pre @p entity is valid; the signature is looked up by index.
+  void set_component_bit(const Entity& entity, const ComponentType type, const bool enabled) noexcept
+  {
+    auto signature = entity_manager_.get(entity.id).signature;
+    if (signature.test(type) == enabled)
+    {
+      return;
+    }
+    signature.set(type, enabled);
+    const auto previous = entity_manager_.set_signature(entity.id, std::move(signature));
+    system_manager_.update_entity(entity_manager_.get(entity.id), previous);
+  }
+
+  ComponentManagerType component_manager_;
+  EntityManagerType entity_manager_;
   SystemManager<ComponentType> system_manager_;
+  StructuralLock structural_lock_;
 };
 
+/// ECS facade with hash-map indexed ComponentStorage.
+template <typename EnumT, std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP, typename... ComponentsT>
+using ECSManager = GenericECSManager<ComponentManager, EnumT, MAX_NUMBER_OF_ENTITIES_PER_GROUP, ComponentsT...>;
+
+/// ECS facade with SparseSetComponentStorage, indexed directly by EntityId::index.
+template <typename EnumT, std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP, typename... ComponentsT>
+using SparseSetECSManager =
+    GenericECSManager<SparseSetComponentManager, EnumT, MAX_NUMBER_OF_ENTITIES_PER_GROUP, ComponentsT...>;
+
+/// ECS facade storing components in archetype chunks.
+template <typename EnumT, std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP, typename... ComponentsT>
+using ArchetypeECSManager =
+    GenericECSManager<ArchetypeComponentManager, EnumT, MAX_NUMBER_OF_ENTITIES_PER_GROUP, ComponentsT...>;
+
 } // namespace rtw::ecs
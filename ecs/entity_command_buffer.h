@@ -0,0 +1,420 @@
+#pragma once
+
+#include "ecs/ecs.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace rtw::ecs
+{
+
+/// Records structural changes (creating and destroying entities, adding and removing components) to apply to an
+/// ECS manager later, at a sync point.
+///
+/// Systems running concurrently, through `View::parallel_each` or a SystemScheduler, must not change the structure
+/// of the world. Each thread records the changes into its own buffer instead: `create_entity()` reserves the new
+/// entity's id right away, so later commands can refer to it, and component payloads are constructed in pages owned
+/// by the buffer, so recording allocates only while the buffer grows past its largest frame so far.
+///
+/// `playback()` applies the commands to the manager and empties the buffer. The commands are first coalesced per
+/// entity: everything recorded for an entity the buffer destroys is dropped, and of the adds and removes of one
+/// component only those that change the outcome are kept. The survivors are then applied in batches: creations,
+/// destructions, then removals and additions grouped by component type, each sorted by entity index, so consecutive
+/// commands hit neighbouring slots of the same storage. The world ends up as the recorded calls would have left it.
+///
+/// @note A buffer is not thread-safe; use one per thread. Play back the buffers of all threads at the same sync
+/// point: the first playback turns every reserved id into an entity, which has no components until its own buffer
+/// plays back.
+template <typename ECSManagerT>
+class EntityCommandBuffer
+{
+public:
+  using ECSManagerType = ECSManagerT;
+  using Entity = typename ECSManagerType::Entity;
+  using EntitySignature = typename ECSManagerType::EntitySignature;
+
+  /// Payload bytes per page; a component must fit in one.
+  constexpr static std::size_t PAGE_SIZE = 16U * 1024U;
+
+  explicit EntityCommandBuffer(ECSManagerType& ecs_manager) noexcept : ecs_manager_{ecs_manager} {}
+  EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+  EntityCommandBuffer(EntityCommandBuffer&&) = delete;
+  EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+  EntityCommandBuffer& operator=(EntityCommandBuffer&&) = delete;
+  /// Destroys the payloads of commands not played back.
+  ~EntityCommandBuffer()
+  {
+    for (auto& command : commands_)
+    {
+      release(command);
+    }
+  }
+
+  /// Records the creation of an entity with @p signature.
+  /// @return The entity's handle, valid in later commands of this buffer and in the manager after playback.
+  Entity create_entity(EntitySignature signature)
+  {
+    const Entity entity{ecs_manager_.reserve_entity(), std::move(signature)};
+    const auto payload = allocate(sizeof(EntitySignature), alignof(EntitySignature));
+    new (payload_at(payload)) EntitySignature{entity.signature};
+    commands_.push_back(Command{entity.id, payload, Operation::CREATE, 0U});
+    return entity;
+  }
+
+  void destroy_entity(const Entity& entity)
+  {
+    commands_.push_back(Command{entity.id, NO_PAYLOAD, Operation::DESTROY, 0U});
+  }
+
+  /// Records adding a ComponentT constructed from @p args, which happens right away into the buffer's pages.
+  template <typename ComponentT, typename... ArgsT>
+  void emplace_component(const Entity& entity, ArgsT&&... args)
+  {
+    static_assert((sizeof(ComponentT) <= PAGE_SIZE) && (alignof(ComponentT) <= alignof(Page)),
+                  "The component does not fit in a payload page.");
+    const auto payload = allocate(sizeof(ComponentT), alignof(ComponentT));
+    new (payload_at(payload)) ComponentT(std::forward<ArgsT>(args)...);
+    emplacers_[component_of<ComponentT>()] = &EntityCommandBuffer::apply_emplace<ComponentT>;
+    commands_.push_back(Command{entity.id, payload, Operation::EMPLACE, component_of<ComponentT>()});
+  }
+
+  template <typename ComponentT>
+  void remove_component(const Entity& entity)
+  {
+    removers_[component_of<ComponentT>()] = &EntityCommandBuffer::apply_remove<ComponentT>;
+    commands_.push_back(Command{entity.id, NO_PAYLOAD, Operation::REMOVE, component_of<ComponentT>()});
+  }
+
+  /// Number of commands recorded since the last playback.
+  std::size_t size() const noexcept { return commands_.size(); }
+  bool empty() const noexcept { return commands_.empty(); }
+
+  /// Applies the recorded commands to the manager, coalesced and batched, and empties the buffer.
+  /// @pre Called at a sync point: no `parallel_each` or scheduled system is running.
+  void playback()
+  {
+    sort_by_entity();
+    coalesce();
+    batch();
+
+    for (auto& command : commands_)
+    {
+      const Entity entity{command.entity, EntitySignature{}};
+      switch (command.operation)
+      {
+        case Operation::CREATE:
+          ecs_manager_.create_entity(command.entity, signature_at(command.payload));
+          break;
+        case Operation::DESTROY:
+          ecs_manager_.destroy_entity(entity);
+          break;
+        case Operation::REMOVE:
+          // Another buffer may have destroyed the entity meanwhile.
+          if (ecs_manager_.is_entity_valid(entity))
+          {
+            removers_[command.component](ecs_manager_, entity);
+          }
+          break;
+        case Operation::EMPLACE:
+          emplacers_[command.component](ecs_manager_.is_entity_valid(entity) ? &ecs_manager_ : nullptr, entity,
+                                        payload_at(command.payload));
+          break;
+      }
+    }
+
+    commands_.clear();
+    used_pages_ = 0U;
+    offset_ = 0U;
+  }
+
+private:
+  /// In playback order.
+  enum class Operation : std::uint8_t
+  {
+    CREATE,
+    DESTROY,
+    REMOVE,
+    EMPLACE,
+  };
+
+  /// Adds the component in @p payload to @p entity if @p ecs_manager is given, and destroys the payload either way.
+  using Emplacer = void (*)(ECSManagerType* ecs_manager, const Entity& entity, void* payload);
+  using Remover = void (*)(ECSManagerType& ecs_manager, const Entity& entity);
+
+  /// Payloads are addressed by their offset from the start of the first page, which keeps a command at 16 bytes:
+  /// the passes over the commands in `playback()` are bound by the bytes they move.
+  using PayloadOffset = std::uint32_t;
+  constexpr static PayloadOffset NO_PAYLOAD = std::numeric_limits<PayloadOffset>::max();
+
+  struct Command
+  {
+    EntityId entity;
+    PayloadOffset payload;  ///< The signature of a CREATE, the component of an EMPLACE, NO_PAYLOAD otherwise.
+    Operation operation;
+    std::uint8_t component; ///< ComponentId of a REMOVE or an EMPLACE.
+  };
+
+  struct alignas(64) Page
+  {
+    std::array<std::byte, PAGE_SIZE> bytes;
+  };
+
+  /// CREATE, DESTROY, then a REMOVE and an EMPLACE batch per component id.
+  constexpr static std::size_t MAX_NUMBER_OF_COMPONENTS = 64U;
+  constexpr static std::size_t NUMBER_OF_BATCHES = 2U + (2U * MAX_NUMBER_OF_COMPONENTS);
+  constexpr static std::size_t NO_COMMAND = std::numeric_limits<std::size_t>::max();
+
+  template <typename ComponentT>
+  constexpr static std::uint8_t component_of() noexcept
+  {
+    static_assert(ComponentT::COMPONENT_ID < MAX_NUMBER_OF_COMPONENTS, "Component ids must be less than 64.");
+    return static_cast<std::uint8_t>(ComponentT::COMPONENT_ID);
+  }
+
+  template <typename ComponentT>
+  static void apply_emplace(ECSManagerType* ecs_manager, const Entity& entity, void* payload)
+  {
+    auto* component = std::launder(static_cast<ComponentT*>(payload));
+    if (ecs_manager != nullptr)
+    {
+      ecs_manager->template emplace_component<ComponentT>(entity, std::move(*component));
+    }
+    component->~ComponentT();
+  }
+
+  template <typename ComponentT>
+  static void apply_remove(ECSManagerType& ecs_manager, const Entity& entity)
+  {
+    ecs_manager.template remove_component<ComponentT>(entity);
+  }
+
+  static std::size_t batch_of(const Command& command) noexcept
+  {
+    switch (command.operation)
+    {
+      case Operation::CREATE:
+        return 0U;
+      case Operation::DESTROY:
+        return 1U;
+      case Operation::REMOVE:
+        return 2U + command.component;
+      case Operation::EMPLACE:
+        break;
+    }
+    return 2U + MAX_NUMBER_OF_COMPONENTS + command.component;
+  }
+
+  /// Destroys the component payload of @p command, if it has one.
+  void release(Command& command)
+  {
+    if ((command.operation == Operation::EMPLACE) && (command.payload != NO_PAYLOAD))
+    {
+      emplacers_[command.component](nullptr, Entity{command.entity, EntitySignature{}}, payload_at(command.payload));
+      command.payload = NO_PAYLOAD;
+    }
+  }
+
+  PayloadOffset allocate(const std::size_t size, const std::size_t alignment)
+  {
+    auto offset = (offset_ + alignment - 1U) & ~(alignment - 1U);
+    if ((used_pages_ == 0U) || ((offset + size) > PAGE_SIZE))
+    {
+      if (used_pages_ == pages_.size())
+      {
+        pages_.push_back(std::make_unique<Page>());
+      }
+      ++used_pages_;
+      offset = 0U;
+    }
+    offset_ = offset + size;
+    return static_cast<PayloadOffset>(((used_pages_ - 1U) * PAGE_SIZE) + offset);
+  }
+
+  void* payload_at(const PayloadOffset payload) const noexcept
+  {
+    return pages_[payload / PAGE_SIZE]->bytes.data() + (payload % PAGE_SIZE);
+  }
+
+  EntitySignature& signature_at(const PayloadOffset payload) const noexcept
+  {
+    return *std::launder(static_cast<EntitySignature*>(payload_at(payload)));
+  }
+
+  /// Copies the commands to `sorted_`, ordered by entity, with the entity's CREATE and DESTROY in front of its
+  /// component commands and those ordered by component; recording order is kept otherwise. A counting sort by entity
+  /// index, as the indices are dense, then an insertion sort of the few commands of each index. Moving the commands
+  /// themselves rather than sorting indices keeps the passes that follow sequential.
+  void sort_by_entity()
+  {
+    sorted_size_ = commands_.size();
+    if (sorted_.size() < sorted_size_)
+    {
+      sorted_.resize(sorted_size_);
+    }
+    if (commands_.empty())
+    {
+      return;
+    }
+
+    auto lowest = std::numeric_limits<EntityId::INDEX_TYPE>::max();
+    EntityId::INDEX_TYPE highest{0U};
+    for (const auto& command : commands_)
+    {
+      lowest = std::min(lowest, command.entity.index);
+      highest = std::max(highest, command.entity.index);
+    }
+    counts_.assign(static_cast<std::size_t>(highest - lowest) + 1U, 0U);
+    for (const auto& command : commands_)
+    {
+      ++counts_[command.entity.index - lowest];
+    }
+    std::exclusive_scan(counts_.begin(), counts_.end(), counts_.begin(), 0U);
+    for (const auto& command : commands_)
+    {
+      sorted_[counts_[command.entity.index - lowest]++] = command;
+    }
+
+    const auto by_key = [](const Command& lhs, const Command& rhs)
+    {
+      return std::make_tuple(lhs.entity.generation, lhs.operation >= Operation::REMOVE, lhs.component)
+             < std::make_tuple(rhs.entity.generation, rhs.operation >= Operation::REMOVE, rhs.component);
+    };
+    const auto end = sorted_.begin() + static_cast<std::ptrdiff_t>(sorted_size_);
+    auto first = sorted_.begin();
+    while (first != end)
+    {
+      auto last = first + 1;
+      for (; (last != end) && (last->entity.index == first->entity.index); ++last)
+      {
+        if (by_key(*last, *(last - 1)))
+        {
+          std::rotate(std::upper_bound(first, last, *last, by_key), last, last + 1);
+        }
+      }
+      first = last;
+    }
+  }
+
+  /// Fills `kept_` with the positions in `sorted_` of the commands that change the outcome and destroys the payloads
+  /// of the others.
+  ///
+  /// A destroyed entity keeps its DESTROY only, plus its CREATE, with an empty signature, if this buffer created it:
+  /// the reserved id must still be created to be recycled. Commands recorded after the DESTROY name a stale handle
+  /// and the ones before it are undone by it. Otherwise, of the commands on one component, the last REMOVE decides
+  /// whether the entity lost it, or at least the component's bit of the signature it was created with, and the first
+  /// EMPLACE after it whether it gained it: adding a component the entity has is a no-op.
+  void coalesce()
+  {
+    kept_.clear();
+    std::size_t next = 0U;
+    while (next < sorted_size_)
+    {
+      const auto entity = sorted_[next].entity;
+      std::size_t create = NO_COMMAND;
+      std::size_t destroy = NO_COMMAND;
+      for (; (next < sorted_size_) && (sorted_[next].entity == entity) && (sorted_[next].operation < Operation::REMOVE);
+           ++next)
+      {
+        auto& slot = (sorted_[next].operation == Operation::CREATE) ? create : destroy;
+        slot = std::min(slot, next);
+      }
+      if (create != NO_COMMAND)
+      {
+        kept_.push_back(static_cast<std::uint32_t>(create));
+      }
+      if (destroy != NO_COMMAND)
+      {
+        kept_.push_back(static_cast<std::uint32_t>(destroy));
+        if (create != NO_COMMAND)
+        {
+          signature_at(sorted_[create].payload) = EntitySignature{};
+        }
+      }
+
+      while ((next < sorted_size_) && (sorted_[next].entity == entity))
+      {
+        const auto component = sorted_[next].component;
+        auto last = next + 1U;
+        while ((last < sorted_size_) && (sorted_[last].entity == entity) && (sorted_[last].component == component))
+        {
+          ++last;
+        }
+        keep_component_commands(next, last, destroy != NO_COMMAND);
+        next = last;
+      }
+    }
+  }
+
+  /// Keeps the commands among `sorted_[first, last)`, all on one component of one entity, that change the outcome.
+  void keep_component_commands(const std::size_t first, const std::size_t last, const bool destroyed)
+  {
+    std::size_t remove = NO_COMMAND;
+    std::size_t emplace = NO_COMMAND;
+    if (!destroyed)
+    {
+      for (auto position = first; position < last; ++position)
+      {
+        if (sorted_[position].operation == Operation::REMOVE)
+        {
+          remove = position;
+          emplace = NO_COMMAND;
+        }
+        else if (emplace == NO_COMMAND)
+        {
+          emplace = position;
+        }
+      }
+    }
+    for (auto position = first; position < last; ++position)
+    {
+      if ((position == remove) || (position == emplace))
+      {
+        kept_.push_back(static_cast<std::uint32_t>(position));
+      }
+      else
+      {
+        release(sorted_[position]);
+      }
+    }
+  }
+
+  /// Copies the kept commands back to `commands_` in playback order: a stable counting sort by batch, so the
+  /// entities of each batch stay in index order.
+  void batch()
+  {
+    std::array<std::uint32_t, NUMBER_OF_BATCHES> counts{};
+    for (const auto position : kept_)
+    {
+      ++counts[batch_of(sorted_[position])];
+    }
+    std::exclusive_scan(counts.begin(), counts.end(), counts.begin(), 0U);
+    commands_.resize(kept_.size());
+    for (const auto position : kept_)
+    {
+      commands_[counts[batch_of(sorted_[position])]++] = sorted_[position];
+    }
+  }
+
+  ECSManagerType& ecs_manager_;
+  std::vector<Command> commands_; ///< In recording order, then in playback order once batched.
+  std::vector<Command> sorted_;   ///< By entity while coalescing; only grows, the first `sorted_size_` are in use.
+  std::size_t sorted_size_{0U};
+  std::vector<std::uint32_t> kept_;
+  std::vector<std::uint32_t> counts_;
+  std::array<Emplacer, MAX_NUMBER_OF_COMPONENTS> emplacers_{}; ///< By ComponentId, set when first recorded.
+  std::array<Remover, MAX_NUMBER_OF_COMPONENTS> removers_{};   ///< By ComponentId, set when first recorded.
+  std::vector<std::unique_ptr<Page>> pages_;
+  std::size_t used_pages_{0U}; ///< Pages holding payloads of the recorded commands; the rest are kept for reuse.
+  std::size_t offset_{0U};     ///< First free byte of the last used page.
+};
+
+} // namespace rtw::ecs
@@ -0,0 +1,253 @@
+#pragma once
+
+#include "ecs/ecs.h"
+#include "ecs/work_stealing_pool.h"
+
+#include "stl/graph.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace rtw::ecs
+{
+
+/// When and where a system ran during a frame.
+struct SystemTrace
+{
+  std::size_t worker{WorkStealingPool::NO_WORKER};
+  std::chrono::steady_clock::time_point begin{};
+  std::chrono::steady_clock::time_point end{};
+};
+
+/// What a SystemScheduler did during one frame.
+struct FrameTrace
+{
+  std::chrono::steady_clock::time_point begin{};
+  std::chrono::steady_clock::time_point end{};
+  std::vector<SystemTrace> systems; ///< Indexed like the scheduler's systems.
+
+  /// Time spent in systems, summed over all workers.
+  std::chrono::steady_clock::duration busy_time() const
+  {
+    std::chrono::steady_clock::duration result{};
+    for (const auto& system : systems)
+    {
+      result += system.end - system.begin;
+    }
+    return result;
+  }
+
+  /// Achieved parallelism: the average number of systems running at once, 1 for a serial frame.
+  double parallelism() const
+  {
+    const auto wall_time = end - begin;
+    return (wall_time.count() > 0) ? static_cast<double>(busy_time().count()) / static_cast<double>(wall_time.count())
+                                   : 0.0;
+  }
+
+  /// Largest number of systems that were running at the same instant.
+  std::size_t max_concurrency() const
+  {
+    std::vector<std::pair<std::chrono::steady_clock::time_point, int>> events;
+    events.reserve(systems.size() * 2U);
+    for (const auto& system : systems)
+    {
+      events.emplace_back(system.begin, 1);
+      events.emplace_back(system.end, -1);
+    }
+    // Ends sort before begins at the same instant, so back-to-back systems do not count as overlapping.
+    std::sort(events.begin(), events.end());
+    std::size_t result{0U};
+    int running{0};
+    for (const auto& event : events)
+    {
+      running += event.second;
+      result = std::max(result, static_cast<std::size_t>(std::max(running, 0)));
+    }
+    return result;
+  }
+};
+
+/// Runs the systems of a frame concurrently where their component accesses allow it.
+///
+/// Each registered system brings the read and write sets of its System (its signature plus explicit SystemAccess)
+/// and a job that updates it. `build()` turns them into a dependency DAG: a system depends on every system
+/// registered before it whose access conflicts with its own, so conflicting systems keep their registration order,
+/// the order a serial loop would run them in, and any two systems without a path between them touch disjoint data
+/// or only read what they share. Explicit dependencies add ordering that the component sets cannot express, e.g.
+/// through a resource outside the ECS; a cycle among them fails the build.
+///
+/// `run()` executes one frame on a WorkStealingPool: the systems without dependencies are submitted first, and the
+/// last dependency of a system to finish submits it on its own worker. Every frame is traced (which worker ran
+/// each system, and when) to measure the parallelism achieved.
+///
+/// @note Systems touching the same components of disjoint entities are still serialized; the sets are per component
+/// type. Structural changes (creating or destroying entities, adding or removing components) are data races with
+/// every other system and must not happen inside a scheduled job.
+template <typename EnumT>
+class SystemScheduler
+{
+public:
+  static_assert(stl::details::IS_SCOPED_ENUM_V<EnumT>, "EnumT must be an enum type.");
+
+  using ComponentType = EnumT;
+  using SystemType = System<ComponentType>;
+  using Job = std::function<void()>;
+
+  explicit SystemScheduler(WorkStealingPool& pool) noexcept : pool_{pool}, graph_{1U} {}
+  SystemScheduler(const SystemScheduler&) = delete;
+  SystemScheduler(SystemScheduler&&) = delete;
+  SystemScheduler& operator=(const SystemScheduler&) = delete;
+  SystemScheduler& operator=(SystemScheduler&&) = delete;
+  ~SystemScheduler() = default;
+
+  /// Registers @p system, updated by @p job each frame; returns its index. Invalidates the built graph.
+  std::size_t add(const SystemType& system, Job job)
+  {
+    nodes_.push_back(Node{&system, std::move(job)});
+    built_ = false;
+    return nodes_.size() - 1U;
+  }
+
+  /// Makes the system @p after wait for the system @p before, whatever their accesses. Invalidates the built graph.
+  void add_dependency(const std::size_t before, const std::size_t after)
+  {
+    assert((before < nodes_.size()) && (after < nodes_.size()) && (before != after));
+    dependencies_.emplace_back(before, after);
+    built_ = false;
+  }
+
+  /// Builds the dependency graph from the systems' accesses and the explicit dependencies.
+  /// @return False, leaving the scheduler unbuilt, if the explicit dependencies form a cycle.
+  bool build()
+  {
+    const auto count = nodes_.size();
+    std::vector<std::uint8_t> ordered(count * count, 0U);
+    for (std::size_t after = 0U; after < count; ++after)
+    {
+      for (std::size_t before = 0U; before < after; ++before)
+      {
+        if (nodes_[before].system->conflicts_with(*nodes_[after].system))
+        {
+          ordered[(before * count) + after] = 1U;
+        }
+      }
+    }
+    for (const auto& [before, after] : dependencies_)
+    {
+      ordered[(before * count) + after] = 1U;
+    }
+
+    graph_ = stl::graph::DirectedGraph{std::max<std::size_t>(count, 1U)};
+    for (std::size_t system = 0U; system < count; ++system)
+    {
+      graph_.add_vertex();
+    }
+    in_degrees_.assign(count, 0U);
+    for (std::size_t before = 0U; before < count; ++before)
+    {
+      for (std::size_t after = 0U; after < count; ++after)
+      {
+        if (ordered[(before * count) + after] != 0U)
+        {
+          graph_.add_edge(vertex(before), vertex(after));
+          ++in_degrees_[after];
+        }
+      }
+    }
+
+    built_ = graph_.empty() || !stl::graph::has_cycle_bfs(graph_);
+    if (built_)
+    {
+      remaining_ = std::vector<std::atomic<std::uint32_t>>(count);
+      trace_.systems.assign(count, SystemTrace{});
+    }
+    return built_;
+  }
+
+  /// Updates every system once, concurrently where the graph allows, and returns when all have finished.
+  /// @pre `build()` succeeded after the last change.
+  void run()
+  {
+    assert(built_ && "build() the scheduler first");
+    const auto count = nodes_.size();
+    trace_.begin = std::chrono::steady_clock::now();
+    for (std::size_t system = 0U; system < count; ++system)
+    {
+      remaining_[system].store(in_degrees_[system], std::memory_order_relaxed);
+    }
+    pending_.store(count, std::memory_order_release);
+    for (std::size_t system = 0U; system < count; ++system)
+    {
+      if (in_degrees_[system] == 0U)
+      {
+        pool_.submit(PoolTask{&SystemScheduler::execute, this, system});
+      }
+    }
+    pool_.wait(pending_);
+    trace_.end = std::chrono::steady_clock::now();
+  }
+
+  std::size_t size() const noexcept { return nodes_.size(); }
+
+  /// The dependency graph of the last `build()`; vertex i is the i-th system added.
+  const stl::graph::DirectedGraph& get_graph() const noexcept { return graph_; }
+
+  /// The trace of the last `run()`.
+  const FrameTrace& get_trace() const noexcept { return trace_; }
+
+private:
+  struct Node
+  {
+    const SystemType* system{nullptr};
+    Job job;
+  };
+
+  static stl::graph::VertexId vertex(const std::size_t system) noexcept
+  {
+    return stl::graph::VertexId{static_cast<stl::graph::VertexId::ID_TYPE>(system)};
+  }
+
+  static void execute(void* context, const std::size_t system)
+  {
+    static_cast<SystemScheduler*>(context)->run_system(system);
+  }
+
+  void run_system(const std::size_t system)
+  {
+    auto& trace = trace_.systems[system];
+    trace.worker = pool_.current_worker();
+    trace.begin = std::chrono::steady_clock::now();
+    nodes_[system].job();
+    trace.end = std::chrono::steady_clock::now();
+
+    for (const auto& edge : graph_.get_edges(vertex(system)))
+    {
+      if (remaining_[edge.to].fetch_sub(1U, std::memory_order_acq_rel) == 1U)
+      {
+        pool_.submit(PoolTask{&SystemScheduler::execute, this, edge.to});
+      }
+    }
+    // Last, so `run()` cannot return while this system is still submitting its successors.
+    pending_.fetch_sub(1U, std::memory_order_acq_rel);
+  }
+
+  WorkStealingPool& pool_;
+  std::vector<Node> nodes_;
+  std::vector<std::pair<std::size_t, std::size_t>> dependencies_;
+  stl::graph::DirectedGraph graph_;
+  std::vector<std::uint32_t> in_degrees_;
+  std::vector<std::atomic<std::uint32_t>> remaining_;
+  std::atomic<std::size_t> pending_{0U};
+  FrameTrace trace_;
+  bool built_{false};
+};
+
+} // namespace rtw::ecs
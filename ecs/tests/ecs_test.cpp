@@ -1,7 +1,13 @@
 #include "ecs/ecs.h"
+#include "ecs/work_stealing_pool.h"
 
 #include <gtest/gtest.h>
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
 namespace
 {
 
@@ -799,6 +805,64 @@ TEST(EcsTest, for_each_entity_with_tag)
   EXPECT_EQ(count_none, 0U);
 }
 
+TEST(EcsTest, retagging_and_group_removal)
+{
+  using namespace rtw::stl::string_literals;
+  constexpr auto PLAYER = "Player"_hs;
+  constexpr auto ENEMIES = "Enemies"_hs;
+  constexpr std::size_t POOL = 3U; // So that a destroyed index is the next one created.
+  ECSManager ecs_manager{POOL, MAX_NUMBER_OF_SYSTEMS};
+
+  const auto first = ecs_manager.create_entity(DEFAULT_ENTITY_SIGNATURE);
+  const auto second = ecs_manager.create_entity(DEFAULT_ENTITY_SIGNATURE);
+  const auto third = ecs_manager.create_entity(DEFAULT_ENTITY_SIGNATURE);
+
+  // A tag moves to the last entity tagged with it, and an entity keeps only its last tag.
+  ecs_manager.tag_entity(first, PLAYER);
+  ecs_manager.tag_entity(second, PLAYER);
+  EXPECT_FALSE(ecs_manager.is_entity_tagged(first, PLAYER));
+  EXPECT_EQ(ecs_manager.get_entity_by_tag(PLAYER)->id, second.id);
+  ecs_manager.tag_entity(second, "Hero");
+  EXPECT_FALSE(ecs_manager.get_entity_by_tag(PLAYER).has_value());
+  EXPECT_TRUE(ecs_manager.is_entity_tagged(second, "Hero"));
+
+  // Removing a member keeps the others in the group.
+  ecs_manager.add_entity_to_group(first, ENEMIES);
+  ecs_manager.add_entity_to_group(second, ENEMIES);
+  ecs_manager.add_entity_to_group(third, ENEMIES);
+  ecs_manager.remove_entity_from_group(first);
+  std::vector<rtw::ecs::EntityId> members;
+  ecs_manager.for_each_entity_in_group(ENEMIES, [&](const Entity& entity) { members.push_back(entity.id); });
+  ASSERT_EQ(members.size(), 2U);
+  EXPECT_TRUE(ecs_manager.is_entity_in_group(second, ENEMIES));
+  EXPECT_TRUE(ecs_manager.is_entity_in_group(third, ENEMIES));
+  EXPECT_FALSE(ecs_manager.is_entity_in_group(first, ENEMIES));
+
+  // A stale handle is neither tagged nor grouped, even when its index is reused.
+  ecs_manager.destroy_entity(third);
+  const auto reused = ecs_manager.create_entity(DEFAULT_ENTITY_SIGNATURE);
+  ASSERT_EQ(reused.id.index, third.id.index);
+  ecs_manager.tag_entity(reused, "Boss");
+  ecs_manager.add_entity_to_group(reused, ENEMIES);
+  EXPECT_FALSE(ecs_manager.is_entity_tagged(third, "Boss"));
+  EXPECT_FALSE(ecs_manager.is_entity_in_group(third, ENEMIES));
+  ecs_manager.untag_entity(third);
+  ecs_manager.remove_entity_from_group(third);
+  EXPECT_TRUE(ecs_manager.is_entity_tagged(reused, "Boss"));
+  EXPECT_TRUE(ecs_manager.is_entity_in_group(reused, ENEMIES));
+
+  // Tagging or grouping through a stale handle leaves the entity reusing its index alone.
+  ecs_manager.tag_entity(third, PLAYER);
+  ecs_manager.add_entity_to_group(third, "Allies");
+  EXPECT_FALSE(ecs_manager.get_entity_by_tag(PLAYER).has_value());
+  EXPECT_TRUE(ecs_manager.is_entity_tagged(reused, "Boss"));
+  EXPECT_TRUE(ecs_manager.is_entity_in_group(reused, ENEMIES));
+  EXPECT_FALSE(ecs_manager.is_entity_in_group(reused, "Allies"));
+  members.clear();
+  ecs_manager.for_each_entity_in_group(ENEMIES, [&](const Entity& entity) { members.push_back(entity.id); });
+  EXPECT_EQ(members.size(), 2U);
+}
+
 // --- Death tests ---
 
 TEST(EcsTest, create_entity_when_pool_exhausted_death)
@@ -940,3 +1004,652 @@ TEST(EcsTest, multiple_systems_different_signatures)
   EXPECT_EQ(render.size(), 2U);
   EXPECT_EQ(combat.size(), 2U);
 }
+
+TEST(EcsTest, system_membership_follows_components)
+{
+  ECSManager ecs_manager{MAX_NUMBER_OF_ENTITIES, MAX_NUMBER_OF_SYSTEMS};
+  auto& physics = ecs_manager.create_system<PhysicsSystem>();
+  auto& render = ecs_manager.create_system<RenderSystem>();
+  auto& combat = ecs_manager.create_system<CombatSystem>();
+
+  const auto entity = ecs_manager.create_entity(rtw::ecs::EntitySignature<ComponentType>{});
+  ecs_manager.emplace_component<Transform>(entity, 1U);
+  EXPECT_EQ(physics.size(), 0U);
+
+  // Completing a system's signature adds the entity to it, and only to it.
+  ecs_manager.emplace_component<Rigidbody>(entity, 2U);
+  EXPECT_TRUE(physics.get_entities().contains(entity.id));
+  EXPECT_EQ(render.size(), 0U);
+  ecs_manager.emplace_component<Sprite>(entity, 3U);
+  EXPECT_EQ(physics.size(), 1U);
+  EXPECT_EQ(render.size(), 1U);
+
+  // Removing a shared component removes the entity from both; adding it again restores both.
+  ecs_manager.remove_component<Transform>(entity);
+  EXPECT_EQ(physics.size(), 0U);
+  EXPECT_EQ(render.size(), 0U);
+  ecs_manager.remove_component<Transform>(entity);
+  ecs_manager.emplace_component<Transform>(entity, 4U);
+  EXPECT_EQ(physics.size(), 1U);
+  EXPECT_EQ(render.size(), 1U);
+
+  // A component declared at creation but removed before being emplaced leaves the system too.
+  const rtw::ecs::EntitySignature<ComponentType> combat_signature{ComponentType::HEALTH | ComponentType::DAMAGE};
+  const auto fighter = ecs_manager.create_entity(combat_signature);
+  EXPECT_EQ(combat.size(), 1U);
+  ecs_manager.remove_component<Damage>(fighter);
+  EXPECT_EQ(combat.size(), 0U);
+
+  // Destroying through a handle older than the signature still leaves every system.
+  ecs_manager.destroy_entity(entity);
+  EXPECT_EQ(physics.size(), 0U);
+  EXPECT_EQ(render.size(), 0U);
+}
+
+TEST(EcsTest, stale_handle_leaves_the_recycled_entity_alone)
+{
+  ECSManager ecs_manager{1U, MAX_NUMBER_OF_SYSTEMS};
+  auto& physics = ecs_manager.create_system<PhysicsSystem>();
+  const rtw::ecs::EntitySignature<ComponentType> empty_signature{};
+
+  const auto stale = ecs_manager.create_entity(empty_signature);
+  ecs_manager.destroy_entity(stale);
+  const auto live = ecs_manager.create_entity(empty_signature);
+  ASSERT_EQ(live.id.index, stale.id.index);
+  ecs_manager.emplace_component<Transform>(live, 1U);
+
+  // Neither the components nor the signature nor the systems of the entity reusing the index change.
+  ecs_manager.emplace_component<Rigidbody>(stale, 2U);
+  ecs_manager.remove_component<Transform>(stale);
+  EXPECT_FALSE(ecs_manager.has_component<Rigidbody>(live));
+  EXPECT_EQ(ecs_manager.get_component<Transform>(live).data, 1U);
+  EXPECT_EQ(physics.size(), 0U);
+  ecs_manager.emplace_component<Rigidbody>(live, 3U);
+  EXPECT_TRUE(physics.get_entities().contains(live.id));
+}
+
+// --- Component storage policies ---
+
+namespace
+{
+template <typename StorageT>
+class ComponentStorageTest : public ::testing::Test
+{};
+using ComponentStorageTypes = ::testing::Types<rtw::ecs::ComponentStorage<ComponentType, Transform>,
+                                               rtw::ecs::SparseSetComponentStorage<ComponentType, Transform>>;
+TYPED_TEST_SUITE(ComponentStorageTest, ComponentStorageTypes, );
+
+using SparseSetStorage = rtw::ecs::SparseSetComponentStorage<ComponentType, Transform>;
+using SparseSetECSManager = rtw::ecs::SparseSetECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Transform,
+                                                          Rigidbody, Collider, Sprite, Mesh, Debug, Health, Damage>;
+using ArchetypeECSManager = rtw::ecs::ArchetypeECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Transform,
+                                                          Rigidbody, Collider, Sprite, Mesh, Debug, Health, Damage>;
+} // namespace
+
+TYPED_TEST(ComponentStorageTest, emplace_get_remove)
+{
+  TypeParam storage{MAX_NUMBER_OF_ENTITIES};
+  EntityManager entity_manager{MAX_NUMBER_OF_ENTITIES};
+
+  std::vector<Entity> entities;
+  for (std::uint32_t i = 0U; i < 5U; ++i)
+  {
+    entities.push_back(entity_manager.create(DEFAULT_ENTITY_SIGNATURE));
+    storage.emplace(entities.back(), 10U + i);
+  }
+  EXPECT_EQ(storage.size(), 5U);
+
+  // Emplacing twice keeps the first component.
+  storage.emplace(entities[0U], 99U);
+  EXPECT_EQ(storage.size(), 5U);
+  EXPECT_EQ(storage.get(entities[0U]).data, 10U);
+
+  // Swap-and-pop moves the last component into the hole; every other entity still finds its own.
+  storage.remove(entities[1U]);
+  EXPECT_FALSE(storage.contains(entities[1U]));
+  EXPECT_EQ(storage.size(), 4U);
+  for (const auto i : {0U, 2U, 3U, 4U})
+  {
+    ASSERT_TRUE(storage.contains(entities[i]));
+    EXPECT_EQ(storage[entities[i]].data, 10U + i);
+  }
+
+  storage.remove(entities[4U]);
+  storage.remove(entities[4U]);
+  EXPECT_EQ(storage.size(), 3U);
+
+  std::vector<std::uint32_t> visited;
+  storage.for_each(
+      [&](const rtw::ecs::EntityId& id, const Transform& transform)
+      {
+        EXPECT_EQ(transform.data, 10U + id.index);
+        visited.push_back(transform.data);
+      });
+  std::sort(visited.begin(), visited.end());
+  EXPECT_EQ(visited, (std::vector<std::uint32_t>{10U, 12U, 13U}));
+}
+
+TYPED_TEST(ComponentStorageTest, stale_handle_is_not_found)
+{
+  TypeParam storage{MAX_NUMBER_OF_ENTITIES};
+  EntityManager entity_manager{1U};
+
+  const auto stale = entity_manager.create(DEFAULT_ENTITY_SIGNATURE);
+  storage.emplace(stale, 1U);
+  storage.remove(stale);
+  entity_manager.destroy(stale);
+
+  // The recycled entity shares the index but not the generation.
+  const auto recycled = entity_manager.create(DEFAULT_ENTITY_SIGNATURE);
+  ASSERT_EQ(recycled.id.index, stale.id.index);
+  storage.emplace(recycled, 2U);
+  EXPECT_TRUE(storage.contains(recycled));
+  EXPECT_FALSE(storage.contains(stale));
+  storage.remove(stale);
+  EXPECT_EQ(storage.get(recycled).data, 2U);
+}
+
+TEST(EcsTest, sparse_set_storage_spans_pages)
+{
+  constexpr std::size_t CAPACITY = (3U * SparseSetStorage::PAGE_SIZE) + 1U;
+  SparseSetStorage storage{CAPACITY};
+
+  // Indices on the first and last page; the pages in between are never touched.
+  const Entity first{rtw::ecs::EntityId{0U, 0U}};
+  const Entity last{rtw::ecs::EntityId{static_cast<std::uint32_t>(CAPACITY - 1U), 0U}};
+  const Entity untouched{rtw::ecs::EntityId{static_cast<std::uint32_t>(SparseSetStorage::PAGE_SIZE + 7U), 0U}};
+  storage.emplace(first, 1U);
+  storage.emplace(last, 2U);
+  EXPECT_FALSE(storage.contains(untouched));
+  EXPECT_EQ(storage.get(first).data, 1U);
+  EXPECT_EQ(storage.get(last).data, 2U);
+
+  storage.remove(first);
+  EXPECT_FALSE(storage.contains(first));
+  EXPECT_EQ(storage.get(last).data, 2U);
+}
+
+TEST(EcsTest, sparse_set_storage_ignores_stale_emplace)
+{
+  SparseSetStorage storage{MAX_NUMBER_OF_ENTITIES};
+  EntityManager entity_manager{1U};
+
+  const auto stale = entity_manager.create(DEFAULT_ENTITY_SIGNATURE);
+  entity_manager.destroy(stale);
+  const auto recycled = entity_manager.create(DEFAULT_ENTITY_SIGNATURE);
+  ASSERT_EQ(recycled.id.index, stale.id.index);
+  storage.emplace(recycled, 2U);
+
+  // The stale handle must not take over the slot of the live entity.
+  storage.emplace(stale, 1U);
+  const std::array<Entity, 1U> stale_entities{stale};
+  storage.emplace_n(rtw::stl::make_span(stale_entities), [](const std::size_t /*index*/) { return Transform{3U}; });
+  EXPECT_EQ(storage.size(), 1U);
+  EXPECT_FALSE(storage.contains(stale));
+  ASSERT_TRUE(storage.contains(recycled));
+  EXPECT_EQ(storage.get(recycled).data, 2U);
+}
+
+TEST(EcsTest, sparse_set_ecs_manager)
+{
+  SparseSetECSManager ecs_manager{MAX_NUMBER_OF_ENTITIES, MAX_NUMBER_OF_SYSTEMS};
+
+  const auto first = ecs_manager.create_entity(DEFAULT_ENTITY_SIGNATURE);
+  const auto second = ecs_manager.create_entity(DEFAULT_ENTITY_SIGNATURE);
+  ecs_manager.emplace_component<Transform>(first, 1U);
+  ecs_manager.emplace_component<Transform>(second, 2U);
+  ecs_manager.emplace_component<Health>(second, 3U);
+  EXPECT_EQ(ecs_manager.get_total_number_of_components(), 3U);
+
+  ecs_manager.destroy_entity(first);
+  EXPECT_EQ(ecs_manager.get_number_of_components<Transform>(), 1U);
+  EXPECT_EQ(ecs_manager.get_component<Transform>(second).data, 2U);
+  EXPECT_EQ(ecs_manager.get_component<Health>(second).data, 3U);
+
+  // The destroyed slot is reused with a new generation and starts without components.
+  const auto third = ecs_manager.create_entity(DEFAULT_ENTITY_SIGNATURE);
+  EXPECT_FALSE(ecs_manager.has_component<Transform>(third));
+  EXPECT_FALSE(ecs_manager.has_component<Transform>(first));
+}
+
+TEST(EcsTest, sparse_set_get_component_missing_entity_death)
+{
+  SparseSetECSManager ecs_manager{MAX_NUMBER_OF_ENTITIES, MAX_NUMBER_OF_SYSTEMS};
+
+  const auto entity = ecs_manager.create_entity(DEFAULT_ENTITY_SIGNATURE);
+  EXPECT_DEATH(ecs_manager.get_component<Transform>(entity), "");
+}
+
+// --- Views ---
+
+namespace
+{
+template <typename ECSManagerT>
+class ViewTest : public ::testing::Test
+{};
+using ECSManagerTypes = ::testing::Types<ECSManager, SparseSetECSManager, ArchetypeECSManager>;
+TYPED_TEST_SUITE(ViewTest, ECSManagerTypes, );
+} // namespace
+
+TYPED_TEST(ViewTest, each_visits_entities_with_all_components)
+{
+  TypeParam ecs_manager{MAX_NUMBER_OF_ENTITIES, MAX_NUMBER_OF_SYSTEMS};
+
+  // Every entity has a Transform, every second a Rigidbody, every third a Health.
+  std::vector<Entity> entities;
+  for (std::uint32_t i = 0U; i < 12U; ++i)
+  {
+    entities.push_back(ecs_manager.create_entity(DEFAULT_ENTITY_SIGNATURE));
+    ecs_manager.template emplace_component<Transform>(entities.back(), i);
+    if ((i % 2U) == 0U)
+    {
+      ecs_manager.template emplace_component<Rigidbody>(entities.back(), 100U + i);
+    }
+    if ((i % 3U) == 0U)
+    {
+      ecs_manager.template emplace_component<Health>(entities.back(), 200U + i);
+    }
+  }
+
+  std::vector<std::uint32_t> visited;
+  ecs_manager.template view<Transform, Rigidbody>().each(
+      [&](const Entity& entity, Transform& transform, Rigidbody& rigidbody)
+      {
+        EXPECT_EQ(entity.signature, DEFAULT_ENTITY_SIGNATURE);
+        EXPECT_EQ(rigidbody.data, 100U + transform.data);
+        EXPECT_EQ(&transform, &ecs_manager.template get_component<Transform>(entity));
+        visited.push_back(transform.data);
+        rigidbody.data = 0U;
+      });
+  std::sort(visited.begin(), visited.end());
+  EXPECT_EQ(visited, (std::vector<std::uint32_t>{0U, 2U, 4U, 6U, 8U, 10U}));
+  EXPECT_EQ(ecs_manager.template get_component<Rigidbody>(entities[4U]).data, 0U);
+
+  // Three components, without the entity argument.
+  visited.clear();
+  ecs_manager.template view<Transform, Rigidbody, Health>().each(
+      [&](Transform& transform, Rigidbody& /*rigidbody*/, Health& /*health*/) { visited.push_back(transform.data); });
+  std::sort(visited.begin(), visited.end());
+  EXPECT_EQ(visited, (std::vector<std::uint32_t>{0U, 6U}));
+}
+
+TYPED_TEST(ViewTest, exclude_skips_entities)
+{
+  TypeParam ecs_manager{MAX_NUMBER_OF_ENTITIES, MAX_NUMBER_OF_SYSTEMS};
+
+  for (std::uint32_t i = 0U; i < 6U; ++i)
+  {
+    const auto entity = ecs_manager.create_entity(DEFAULT_ENTITY_SIGNATURE);
+    ecs_manager.template emplace_component<Transform>(entity, i);
+    if (i < 2U)
+    {
+      ecs_manager.template emplace_component<Debug>(entity, i);
+    }
+    if (i == 5U)
+    {
+      ecs_manager.template emplace_component<Damage>(entity, i);
+    }
+  }
+
+  std::vector<std::uint32_t> visited;
+  ecs_manager.template view<Transform>().template exclude<Debug>().template exclude<Damage>().each(
+      [&](const Transform& transform) { visited.push_back(transform.data); });
+  std::sort(visited.begin(), visited.end());
+  EXPECT_EQ(visited, (std::vector<std::uint32_t>{2U, 3U, 4U}));
+}
+
+TYPED_TEST(ViewTest, const_access)
+{
+  TypeParam ecs_manager{MAX_NUMBER_OF_ENTITIES, MAX_NUMBER_OF_SYSTEMS};
+  const auto entity = ecs_manager.create_entity(DEFAULT_ENTITY_SIGNATURE);
+  ecs_manager.template emplace_component<Transform>(entity, 1U);
+  ecs_manager.template emplace_component<Rigidbody>(entity, 2U);
+
+  std::size_t count = 0U;
+  ecs_manager.template view<const Transform, Rigidbody>().each(
+      [&](auto& transform, auto& rigidbody)
+      {
+        static_assert(std::is_const_v<std::remove_reference_t<decltype(transform)>>);
+        static_assert(!std::is_const_v<std::remove_reference_t<decltype(rigidbody)>>);
+        rigidbody.data += transform.data;
+        ++count;
+      });
+
+  const auto& const_ecs_manager = ecs_manager;
+  const_ecs_manager.template view<Transform, Rigidbody>().each(
+      [&](auto& transform, auto& rigidbody)
+      {
+        static_assert(std::is_const_v<std::remove_reference_t<decltype(transform)>>);
+        static_assert(std::is_const_v<std::remove_reference_t<decltype(rigidbody)>>);
+        EXPECT_EQ(rigidbody.data, 3U);
+        EXPECT_EQ(transform.data, 1U);
+        ++count;
+      });
+  EXPECT_EQ(count, 2U);
+}
+
+TYPED_TEST(ViewTest, parallel_each_visits_every_entity_once)
+{
+  // Enough entities for several tasks under every backend.
+  constexpr std::size_t COUNT = 12'000U;
+  auto ecs_manager = std::make_unique<TypeParam>(2U * COUNT, MAX_NUMBER_OF_SYSTEMS);
+  std::vector<Entity> entities;
+  for (std::uint32_t i = 0U; i < COUNT; ++i)
+  {
+    entities.push_back(ecs_manager->create_entity(DEFAULT_ENTITY_SIGNATURE));
+    ecs_manager->template emplace_component<Transform>(entities.back(), i);
+    if ((i % 2U) == 0U)
+    {
+      ecs_manager->template emplace_component<Rigidbody>(entities.back(), 0U);
+    }
+    if ((i % 10U) == 0U)
+    {
+      ecs_manager->template emplace_component<Debug>(entities.back(), i);
+    }
+  }
+
+  rtw::ecs::WorkStealingPool pool{4U};
+  std::atomic<std::size_t> visits{0U};
+  std::atomic<std::size_t> mismatches{0U};
+  const auto view = ecs_manager->template view<const Transform, Rigidbody>().template exclude<Debug>();
+  for (std::uint32_t pass = 1U; pass <= 2U; ++pass)
+  {
+    view.parallel_each(pool,
+                       [&](const Entity& entity, const Transform& transform, Rigidbody& rigidbody)
+                       {
+                         if (entity.id != entities[transform.data].id)
+                         {
+                           ++mismatches;
+                         }
+                         rigidbody.data += transform.data;
+                         ++visits;
+                       });
+  }
+
+  EXPECT_EQ(visits.load(), 2U * (COUNT / 2U - COUNT / 10U));
+  EXPECT_EQ(mismatches.load(), 0U);
+  for (std::uint32_t i = 0U; i < COUNT; i += 2U)
+  {
+    const auto expected = ((i % 10U) == 0U) ? 0U : 2U * i;
+    ASSERT_EQ(ecs_manager->template get_component<Rigidbody>(entities[i]).data, expected);
+  }
+
+  // Structural changes are allowed again once it has returned.
+  ecs_manager->template remove_component<Rigidbody>(entities[2U]);
+  EXPECT_FALSE(ecs_manager->template has_component<Rigidbody>(entities[2U]));
+}
+
+// --- Bulk creation and destruction ---
+
+namespace
+{
+template <typename ECSManagerT>
+class BulkTest : public ::testing::Test
+{};
+TYPED_TEST_SUITE(BulkTest, ECSManagerTypes, );
+} // namespace
+
+TYPED_TEST(BulkTest, create_emplace_and_destroy_in_bulk)
+{
+  auto ecs_manager = std::make_unique<TypeParam>(MAX_NUMBER_OF_ENTITIES, MAX_NUMBER_OF_SYSTEMS);
+  auto& physics = ecs_manager->template create_system<PhysicsSystem>();
+  auto& render = ecs_manager->template create_system<RenderSystem>();
+  const auto single = ecs_manager->create_entity(DEFAULT_ENTITY_SIGNATURE);
+
+  std::array<Entity, 8U> entities{};
+  const rtw::ecs::EntitySignature<ComponentType> physics_signature{ComponentType::TRANSFORM
+                                                                   | ComponentType::RIGID_BODY};
+  ecs_manager->create_entities(6U, physics_signature, rtw::stl::make_span(entities));
+  const auto created = rtw::stl::Span<const Entity>{entities.data(), 6U};
+  EXPECT_EQ(ecs_manager->get_number_of_entities(), 7U);
+  EXPECT_EQ(physics.size(), 7U);
+  EXPECT_EQ(render.size(), 1U);
+  for (const auto& entity : created)
+  {
+    EXPECT_TRUE(ecs_manager->is_entity_valid(entity));
+    EXPECT_EQ(entity.signature, physics_signature);
+    EXPECT_NE(entity.id, single.id);
+  }
+  EXPECT_EQ(entities[6U].id, rtw::ecs::EntityId{});
+
+  // From a generator and from a span of values; entities having the component keep theirs.
+  ecs_manager->template emplace_component<Transform>(created[1U], 100U);
+  ecs_manager->template emplace_components<Transform>(
+      created, [](const std::size_t index) { return Transform{static_cast<std::uint32_t>(10U * index)}; });
+  const std::array<Rigidbody, 6U> rigidbodies{Rigidbody{0U}, Rigidbody{1U}, Rigidbody{2U},
+                                              Rigidbody{3U}, Rigidbody{4U}, Rigidbody{5U}};
+  ecs_manager->template emplace_components<Rigidbody>(created, rtw::stl::make_span(rigidbodies));
+  EXPECT_EQ(ecs_manager->template get_number_of_components<Transform>(), 6U);
+  EXPECT_EQ(ecs_manager->template get_component<Transform>(created[1U]).data, 100U);
+  for (std::uint32_t i = 0U; i < created.size(); ++i)
+  {
+    EXPECT_EQ(ecs_manager->template get_component<Rigidbody>(created[i]).data, i);
+    if (i != 1U)
+    {
+      EXPECT_EQ(ecs_manager->template get_component<Transform>(created[i]).data, 10U * i);
+    }
+  }
+
+  // A bulk emplace extends the signatures like single ones do.
+  ecs_manager->template emplace_components<Sprite>(created.first(3U), [](std::size_t) { return Sprite{7U}; });
+  EXPECT_EQ(render.size(), 4U);
+
+  // Invalid handles are skipped.
+  ecs_manager->destroy_entity(created[0U]);
+  ecs_manager->destroy_entities(created.first(4U));
+  EXPECT_EQ(ecs_manager->get_number_of_entities(), 3U);
+  EXPECT_EQ(physics.size(), 3U);
+  EXPECT_EQ(render.size(), 1U);
+  EXPECT_EQ(ecs_manager->template get_number_of_components<Rigidbody>(), 2U);
+  EXPECT_FALSE(ecs_manager->is_entity_valid(created[3U]));
+  EXPECT_TRUE(ecs_manager->is_entity_valid(created[4U]));
+
+  // A handle listed twice is destroyed once.
+  const std::array<Entity, 3U> twice{created[4U], created[4U], created[2U]};
+  ecs_manager->destroy_entities(rtw::stl::make_span(twice));
+  EXPECT_EQ(ecs_manager->get_number_of_entities(), 2U);
+  EXPECT_EQ(physics.size(), 2U);
+  EXPECT_EQ(render.size(), 1U);
+  EXPECT_EQ(ecs_manager->template get_number_of_components<Rigidbody>(), 1U);
+  EXPECT_TRUE(ecs_manager->is_entity_valid(created[5U]));
+
+  // A bulk emplace skips the destroyed handles, and the generator still sees the index into the whole span.
+  ecs_manager->template emplace_components<Collider>(
+      created, [](const std::size_t index) { return Collider{static_cast<std::uint32_t>(index)}; });
+  EXPECT_EQ(ecs_manager->template get_number_of_components<Collider>(), 1U);
+  EXPECT_EQ(ecs_manager->template get_component<Collider>(created[5U]).data, 5U);
+  EXPECT_EQ(ecs_manager->get_number_of_entities(), 2U);
+}
+
+TEST(EcsTest, structural_change_during_parallel_each_death)
+{
+  ECSManager ecs_manager{MAX_NUMBER_OF_ENTITIES, MAX_NUMBER_OF_SYSTEMS};
+  const auto entity = ecs_manager.create_entity(DEFAULT_ENTITY_SIGNATURE);
+  ecs_manager.emplace_component<Transform>(entity, 1U);
+
+  EXPECT_DEATH(
+      {
+        rtw::ecs::WorkStealingPool pool{1U};
+        ecs_manager.view<Transform>().parallel_each(
+            pool, [&](const Entity& visited, Transform& /*transform*/)
+            { ecs_manager.emplace_component<Rigidbody>(visited, 2U); });
+      },
+      "");
+}
+
+TEST(EcsTest, structural_lock_guard_releases_on_unwind)
+{
+  const rtw::ecs::StructuralLock lock;
+  EXPECT_THROW(
+      {
+        const rtw::ecs::StructuralLock::Guard guard{&lock};
+        EXPECT_TRUE(lock.is_held());
+        throw std::runtime_error{"stop"};
+      },
+      std::runtime_error);
+  EXPECT_FALSE(lock.is_held());
+
+  // A view not obtained from a GenericECSManager has no lock to hold.
+  const rtw::ecs::StructuralLock::Guard guard{nullptr};
+}
+
+// --- Archetype backend ---
+
+namespace
+{
+using ArchetypeComponentManager =
+    rtw::ecs::ArchetypeComponentManager<ComponentType, Transform, Rigidbody, Collider, Sprite, Mesh, Debug, Health,
+                                        Damage>;
+
+enum class ResourceType : std::uint8_t
+{
+  NONE = 0U,
+  HANDLE = 1U << 0U,
+  LABEL = 1U << 1U,
+};
+
+/// Owns a shared resource, so leaked or doubly destroyed components show in its use count.
+struct Handle : rtw::ecs::Component<ResourceType, ResourceType::HANDLE>
+{
+  explicit Handle(std::shared_ptr<int> resource) : resource{std::move(resource)} {}
+  std::shared_ptr<int> resource;
+};
+
+struct Label : rtw::ecs::Component<ResourceType, ResourceType::LABEL>
+{
+  explicit Label(const std::uint32_t data) : data{data} {}
+  std::uint32_t data;
+};
+
+Entity make_entity(const std::uint32_t index) { return Entity{rtw::ecs::EntityId{index, 0U}}; }
+} // namespace
+
+TEST(EcsTest, archetype_moves_rows_between_archetypes)
+{
+  ArchetypeComponentManager component_manager{MAX_NUMBER_OF_ENTITIES};
+
+  std::vector<Entity> entities;
+  for (std::uint32_t i = 0U; i < 4U; ++i)
+  {
+    entities.push_back(make_entity(i));
+    component_manager.emplace<Transform>(entities.back(), i);
+  }
+  EXPECT_EQ(component_manager.number_of_archetypes(), 2U);
+
+  // Adding components moves the row to a new archetype and keeps the values it had.
+  component_manager.emplace<Rigidbody>(entities[1U], 11U);
+  component_manager.emplace<Health>(entities[1U], 21U);
+  EXPECT_EQ(component_manager.number_of_archetypes(), 4U);
+  EXPECT_EQ(component_manager.get<Transform>(entities[1U]).data, 1U);
+  EXPECT_EQ(component_manager.get<Rigidbody>(entities[1U]).data, 11U);
+  EXPECT_EQ(component_manager.get<Health>(entities[1U]).data, 21U);
+
+  // The entity moved into the hole it left behind is still found.
+  for (const auto i : {0U, 2U, 3U})
+  {
+    EXPECT_EQ(component_manager.get<Transform>(entities[i]).data, i);
+    EXPECT_FALSE(component_manager.has<Rigidbody>(entities[i]));
+  }
+
+  // Removing a component takes a cached edge back to a smaller archetype.
+  component_manager.remove<Rigidbody>(entities[1U]);
+  EXPECT_FALSE(component_manager.has<Rigidbody>(entities[1U]));
+  EXPECT_EQ(component_manager.get<Health>(entities[1U]).data, 21U);
+  EXPECT_EQ(component_manager.number_of_archetypes(), 5U);
+  component_manager.emplace<Rigidbody>(entities[1U], 12U);
+  EXPECT_EQ(component_manager.number_of_archetypes(), 5U);
+  EXPECT_EQ(component_manager.get<Rigidbody>(entities[1U]).data, 12U);
+
+  EXPECT_EQ(component_manager.size<Transform>(), 4U);
+  EXPECT_EQ(component_manager.size<Rigidbody>(), 1U);
+  EXPECT_EQ(component_manager.total_size(), 6U);
+
+  component_manager.remove(entities[1U]);
+  EXPECT_FALSE(component_manager.has<Transform>(entities[1U]));
+  EXPECT_EQ(component_manager.total_size(), 3U);
+}
+
+TEST(EcsTest, archetype_fills_and_recycles_chunks)
+{
+  constexpr std::size_t COUNT = 5'000U;
+  ArchetypeComponentManager component_manager{COUNT};
+
+  for (std::uint32_t i = 0U; i < COUNT; ++i)
+  {
+    component_manager.emplace<Transform>(make_entity(i), i);
+    component_manager.emplace<Rigidbody>(make_entity(i), i + 1U);
+  }
+  const auto chunks = component_manager.number_of_chunks();
+  EXPECT_GT(chunks, 1U);
+
+  std::size_t visited = 0U;
+  component_manager.each<rtw::ecs::details::TypeList<>, Transform, const Rigidbody>(
+      [&](const rtw::ecs::EntityId& id, Transform& transform, const Rigidbody& rigidbody)
+      {
+        EXPECT_EQ(transform.data, id.index);
+        EXPECT_EQ(rigidbody.data, id.index + 1U);
+        ++visited;
+      });
+  EXPECT_EQ(visited, COUNT);
+
+  // Removing every other entity shrinks the archetype; the moved rows keep their components.
+  for (std::uint32_t i = 0U; i < COUNT; i += 2U)
+  {
+    component_manager.remove(make_entity(i));
+  }
+  EXPECT_LT(component_manager.number_of_chunks(), chunks);
+  for (std::uint32_t i = 1U; i < COUNT; i += 2U)
+  {
+    ASSERT_EQ(component_manager.get<Transform>(make_entity(i)).data, i);
+    ASSERT_EQ(component_manager.get<Rigidbody>(make_entity(i)).data, i + 1U);
+  }
+
+  for (std::uint32_t i = 1U; i < COUNT; i += 2U)
+  {
+    component_manager.remove(make_entity(i));
+  }
+  EXPECT_EQ(component_manager.number_of_chunks(), 0U);
+  EXPECT_EQ(component_manager.total_size(), 0U);
+}
+
+TEST(EcsTest, archetype_stale_handle_is_not_found)
+{
+  ArchetypeComponentManager component_manager{MAX_NUMBER_OF_ENTITIES};
+  const Entity stale{rtw::ecs::EntityId{3U, 0U}};
+  const Entity recycled{rtw::ecs::EntityId{3U, 1U}};
+
+  component_manager.emplace<Transform>(stale, 1U);
+  component_manager.remove(stale);
+  component_manager.emplace<Transform>(recycled, 2U);
+
+  EXPECT_FALSE(component_manager.has<Transform>(stale));
+  component_manager.remove(stale);
+  component_manager.remove<Transform>(stale);
+  EXPECT_EQ(component_manager.get<Transform>(recycled).data, 2U);
+}
+
+TEST(EcsTest, archetype_moves_and_destroys_components)
+{
+  const auto resource = std::make_shared<int>(42);
+  {
+    rtw::ecs::ArchetypeComponentManager<ResourceType, Handle, Label> component_manager{16U};
+    const rtw::ecs::Entity<ResourceType> first{rtw::ecs::EntityId{0U, 0U}};
+    const rtw::ecs::Entity<ResourceType> second{rtw::ecs::EntityId{1U, 0U}};
+
+    component_manager.emplace<Handle>(first, resource);
+    component_manager.emplace<Handle>(second, resource);
+    EXPECT_EQ(resource.use_count(), 3);
+
+    // Moving rows between archetypes and into holes neither copies nor leaks the resource.
+    component_manager.emplace<Label>(first, 1U);
+    component_manager.emplace<Label>(second, 2U);
+    component_manager.remove<Label>(first);
+    EXPECT_EQ(resource.use_count(), 3);
+    EXPECT_EQ(*component_manager.get<Handle>(second).resource, 42);
+
+    component_manager.remove<Handle>(second);
+    EXPECT_EQ(resource.use_count(), 2);
+  }
+  // The manager destroys the components it still holds.
+  EXPECT_EQ(resource.use_count(), 1);
+}
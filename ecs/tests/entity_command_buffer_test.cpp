@@ -0,0 +1,259 @@
+#include "ecs/entity_command_buffer.h"
+
+#include "ecs/ecs.h"
+#include "ecs/work_stealing_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+enum class ComponentType : std::uint8_t
+{
+  NONE = 0U,
+  POSITION = 1U << 0U,
+  HEALTH = 1U << 1U,
+  TRACKED = 1U << 2U,
+};
+
+struct Position : rtw::ecs::Component<ComponentType, ComponentType::POSITION>
+{
+  explicit Position(const std::uint32_t value) : value{value} {}
+  std::uint32_t value;
+};
+
+struct Health : rtw::ecs::Component<ComponentType, ComponentType::HEALTH>
+{
+  explicit Health(const std::uint32_t value) : value{value} {}
+  std::uint32_t value;
+};
+
+/// Shares a token, to check that every payload is destroyed exactly once.
+struct Tracked : rtw::ecs::Component<ComponentType, ComponentType::TRACKED>
+{
+  Tracked() = default;
+  Tracked(const std::uint32_t value, std::shared_ptr<int> token) : value{value}, token{std::move(token)} {}
+  std::uint32_t value{0U};
+  std::shared_ptr<int> token;
+};
+
+constexpr std::size_t MAX_NUMBER_OF_ENTITIES = 20'000U;
+constexpr std::size_t MAX_NUMBER_OF_ENTITIES_PER_GROUP = 1U;
+constexpr std::size_t MAX_NUMBER_OF_ENTITIES_PER_SYSTEM = MAX_NUMBER_OF_ENTITIES;
+constexpr std::size_t MAX_NUMBER_OF_SYSTEMS = 1U;
+
+using ECSManager = rtw::ecs::ECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Position, Health, Tracked>;
+using SparseSetECSManager =
+    rtw::ecs::SparseSetECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Position, Health, Tracked>;
+using ArchetypeECSManager =
+    rtw::ecs::ArchetypeECSManager<ComponentType, MAX_NUMBER_OF_ENTITIES_PER_GROUP, Position, Health, Tracked>;
+using Entity = rtw::ecs::Entity<ComponentType>;
+using EntitySignature = rtw::ecs::EntitySignature<ComponentType>;
+
+constexpr EntitySignature UNIT_SIGNATURE{ComponentType::POSITION | ComponentType::HEALTH};
+
+struct UnitSystem : rtw::ecs::System<ComponentType>
+{
+  UnitSystem() noexcept
+      : System{rtw::ecs::SystemSignature<ComponentType>{ComponentType::POSITION | ComponentType::HEALTH},
+               MAX_NUMBER_OF_ENTITIES_PER_SYSTEM}
+  {
+  }
+};
+
+template <typename T>
+class EntityCommandBufferTest : public ::testing::Test
+{};
+using ECSManagerTypes = ::testing::Types<ECSManager, SparseSetECSManager, ArchetypeECSManager>;
+TYPED_TEST_SUITE(EntityCommandBufferTest, ECSManagerTypes, );
+
+} // namespace
+
+TYPED_TEST(EntityCommandBufferTest, playback_applies_recorded_commands)
+{
+  auto ecs_manager = std::make_unique<TypeParam>(MAX_NUMBER_OF_ENTITIES, MAX_NUMBER_OF_SYSTEMS);
+  const auto& system = ecs_manager->template create_system<UnitSystem>();
+  const auto doomed = ecs_manager->create_entity(UNIT_SIGNATURE);
+  const auto survivor = ecs_manager->create_entity(UNIT_SIGNATURE);
+  ecs_manager->template emplace_component<Position>(survivor, 1U);
+  ecs_manager->template emplace_component<Health>(survivor, 10U);
+
+  rtw::ecs::EntityCommandBuffer<TypeParam> buffer{*ecs_manager};
+  const auto spawned = buffer.create_entity(UNIT_SIGNATURE);
+  buffer.template emplace_component<Position>(spawned, 2U);
+  buffer.template emplace_component<Health>(spawned, 20U);
+  buffer.destroy_entity(doomed);
+  buffer.template remove_component<Health>(survivor);
+  EXPECT_EQ(buffer.size(), 5U);
+
+  // Nothing changes before playback.
+  EXPECT_EQ(ecs_manager->get_number_of_entities(), 2U);
+  EXPECT_EQ(ecs_manager->template get_number_of_components<Position>(), 1U);
+  EXPECT_TRUE(ecs_manager->is_entity_valid(doomed));
+
+  buffer.playback();
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_EQ(ecs_manager->get_number_of_entities(), 2U);
+  EXPECT_FALSE(ecs_manager->is_entity_valid(doomed));
+  ASSERT_TRUE(ecs_manager->is_entity_valid(spawned));
+  EXPECT_EQ(ecs_manager->template get_component<Position>(spawned).value, 2U);
+  EXPECT_EQ(ecs_manager->template get_component<Health>(spawned).value, 20U);
+  EXPECT_TRUE(ecs_manager->template has_component<Position>(survivor));
+  EXPECT_FALSE(ecs_manager->template has_component<Health>(survivor));
+  EXPECT_EQ(system.size(), 1U);
+  EXPECT_TRUE(system.get_entities().contains(spawned.id));
+  EXPECT_FALSE(system.get_entities().contains(doomed.id));
+  EXPECT_FALSE(system.get_entities().contains(survivor.id));
+
+  // The buffer is reusable after playback.
+  buffer.destroy_entity(spawned);
+  buffer.playback();
+  EXPECT_FALSE(ecs_manager->is_entity_valid(spawned));
+  EXPECT_EQ(ecs_manager->template get_number_of_components<Position>(), 1U);
+}
+
+TYPED_TEST(EntityCommandBufferTest, playback_coalesces_redundant_commands)
+{
+  auto ecs_manager = std::make_unique<TypeParam>(MAX_NUMBER_OF_ENTITIES, MAX_NUMBER_OF_SYSTEMS);
+  const auto existing = ecs_manager->create_entity(UNIT_SIGNATURE);
+  ecs_manager->template emplace_component<Position>(existing, 1U);
+  const auto token = std::make_shared<int>(0);
+
+  {
+    rtw::ecs::EntityCommandBuffer<TypeParam> buffer{*ecs_manager};
+
+    // Created and destroyed within the buffer: only the reserved id is recycled.
+    const auto transient = buffer.create_entity(UNIT_SIGNATURE);
+    buffer.template emplace_component<Tracked>(transient, 1U, token);
+    buffer.destroy_entity(transient);
+
+    // Adding a component the entity has is a no-op, as with direct calls; a remove before the last add resets it.
+    buffer.template emplace_component<Position>(existing, 2U);
+    buffer.template emplace_component<Tracked>(existing, 3U, token);
+    buffer.template emplace_component<Tracked>(existing, 4U, token);
+    buffer.template remove_component<Tracked>(existing);
+    buffer.template emplace_component<Tracked>(existing, 5U, nullptr);
+    buffer.template emplace_component<Tracked>(existing, 6U, token);
+
+    // Removing what was added to a new entity leaves it without.
+    const auto created = buffer.create_entity(UNIT_SIGNATURE);
+    buffer.template emplace_component<Tracked>(created, 7U, token);
+    buffer.template remove_component<Tracked>(created);
+    buffer.template emplace_component<Health>(created, 8U);
+    EXPECT_EQ(token.use_count(), 6);
+
+    // Only the payload without token is played back; the others are destroyed.
+    buffer.playback();
+    EXPECT_FALSE(ecs_manager->is_entity_valid(transient));
+    EXPECT_EQ(ecs_manager->template get_component<Position>(existing).value, 1U);
+    EXPECT_EQ(ecs_manager->template get_component<Tracked>(existing).value, 5U);
+    EXPECT_FALSE(ecs_manager->template has_component<Tracked>(created));
+    EXPECT_EQ(ecs_manager->template get_component<Health>(created).value, 8U);
+    EXPECT_EQ(ecs_manager->get_number_of_entities(), 2U);
+    EXPECT_EQ(token.use_count(), 1);
+
+    // Payloads never played back are destroyed with the buffer.
+    buffer.template emplace_component<Tracked>(created, 9U, token);
+    EXPECT_EQ(token.use_count(), 2);
+  }
+  EXPECT_EQ(token.use_count(), 1);
+}
+
+TYPED_TEST(EntityCommandBufferTest, reserved_ids_survive_direct_creation)
+{
+  auto ecs_manager = std::make_unique<TypeParam>(MAX_NUMBER_OF_ENTITIES, MAX_NUMBER_OF_SYSTEMS);
+  rtw::ecs::EntityCommandBuffer<TypeParam> buffer{*ecs_manager};
+  const auto reserved = buffer.create_entity(UNIT_SIGNATURE);
+  buffer.template emplace_component<Position>(reserved, 1U);
+
+  // A direct creation before playback gets another id, and commits the reservation as an entity without components.
+  const auto direct = ecs_manager->create_entity(UNIT_SIGNATURE);
+  EXPECT_NE(direct.id, reserved.id);
+  EXPECT_TRUE(ecs_manager->is_entity_valid(reserved));
+  EXPECT_FALSE(ecs_manager->template has_component<Position>(reserved));
+
+  buffer.playback();
+  EXPECT_EQ(ecs_manager->template get_component<Position>(reserved).value, 1U);
+  EXPECT_EQ(ecs_manager->get_number_of_entities(), 2U);
+}
+
+TYPED_TEST(EntityCommandBufferTest, removing_from_a_created_entity_matches_direct_calls)
+{
+  // Removing a component the entity lacks still clears its bit, so the entity leaves the systems requiring it.
+  auto direct_manager = std::make_unique<TypeParam>(MAX_NUMBER_OF_ENTITIES, MAX_NUMBER_OF_SYSTEMS);
+  const auto& direct_system = direct_manager->template create_system<UnitSystem>();
+  const auto direct = direct_manager->create_entity(UNIT_SIGNATURE);
+  direct_manager->template remove_component<Health>(direct);
+  direct_manager->template emplace_component<Position>(direct, 1U);
+
+  auto buffered_manager = std::make_unique<TypeParam>(MAX_NUMBER_OF_ENTITIES, MAX_NUMBER_OF_SYSTEMS);
+  const auto& buffered_system = buffered_manager->template create_system<UnitSystem>();
+  rtw::ecs::EntityCommandBuffer<TypeParam> buffer{*buffered_manager};
+  const auto buffered = buffer.create_entity(UNIT_SIGNATURE);
+  buffer.template remove_component<Health>(buffered);
+  buffer.template emplace_component<Position>(buffered, 1U);
+  buffer.playback();
+
+  EXPECT_EQ(direct_system.size(), 0U);
+  EXPECT_EQ(buffered_system.size(), direct_system.size());
+  EXPECT_EQ(buffered_manager->template get_component<Position>(buffered).value, 1U);
+}
+
+TYPED_TEST(EntityCommandBufferTest, per_thread_buffers_record_during_parallel_each)
+{
+  constexpr std::uint32_t COUNT = 8'000U;
+  auto ecs_manager = std::make_unique<TypeParam>(MAX_NUMBER_OF_ENTITIES, MAX_NUMBER_OF_SYSTEMS);
+  for (std::uint32_t i = 0U; i < COUNT; ++i)
+  {
+    const auto entity = ecs_manager->create_entity(UNIT_SIGNATURE);
+    ecs_manager->template emplace_component<Position>(entity, i);
+    ecs_manager->template emplace_component<Health>(entity, i % 4U);
+  }
+
+  // Every entity out of health is replaced by a new one at the same position.
+  rtw::ecs::WorkStealingPool pool{4U};
+  std::vector<std::unique_ptr<rtw::ecs::EntityCommandBuffer<TypeParam>>> buffers;
+  for (std::size_t worker = 0U; worker < pool.thread_count(); ++worker)
+  {
+    buffers.push_back(std::make_unique<rtw::ecs::EntityCommandBuffer<TypeParam>>(*ecs_manager));
+  }
+  ecs_manager->template view<const Position, const Health>().parallel_each(
+      pool,
+      [&](const Entity& entity, const Position& position, const Health& health)
+      {
+        if (health.value == 0U)
+        {
+          auto& buffer = *buffers[pool.current_worker()];
+          buffer.destroy_entity(entity);
+          const auto spawned = buffer.create_entity(UNIT_SIGNATURE);
+          buffer.template emplace_component<Position>(spawned, position.value);
+          buffer.template emplace_component<Health>(spawned, 100U);
+        }
+      });
+  for (auto& buffer : buffers)
+  {
+    buffer->playback();
+  }
+
+  EXPECT_EQ(ecs_manager->get_number_of_entities(), COUNT);
+  std::vector<std::uint32_t> positions(COUNT, 0U);
+  std::size_t respawned{0U};
+  ecs_manager->template view<const Position, const Health>().each(
+      [&](const Position& position, const Health& health)
+      {
+        ++positions[position.value];
+        respawned += (health.value == 100U) ? 1U : 0U;
+        EXPECT_NE(health.value, 0U);
+      });
+  EXPECT_EQ(respawned, COUNT / 4U);
+  for (const auto count : positions)
+  {
+    ASSERT_EQ(count, 1U);
+  }
+}
@@ -0,0 +1,313 @@
+#include "ecs/system_scheduler.h"
+
+#include "ecs/ecs.h"
+#include "ecs/work_stealing_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+enum class ComponentType : std::uint8_t
+{
+  NONE = 0U,
+  POSITION = 1U << 0U,
+  VELOCITY = 1U << 1U,
+  HEALTH = 1U << 2U,
+  SPRITE = 1U << 3U,
+};
+
+using System = rtw::ecs::System<ComponentType>;
+using SystemAccess = rtw::ecs::SystemAccess<ComponentType>;
+using SystemSignature = rtw::ecs::SystemSignature<ComponentType>;
+using SystemScheduler = rtw::ecs::SystemScheduler<ComponentType>;
+using ComponentMask = rtw::stl::Flags<ComponentType>;
+
+constexpr std::size_t MAX_NUMBER_OF_ENTITIES_PER_SYSTEM = 16U;
+
+struct TestSystem : public System
+{
+  TestSystem(const SystemSignature signature, const SystemAccess& access = SystemAccess{}) noexcept
+      : System{signature, access, MAX_NUMBER_OF_ENTITIES_PER_SYSTEM}
+  {
+  }
+};
+
+/// Moves: writes positions, reads velocities.
+TestSystem make_movement_system()
+{
+  return TestSystem{SystemSignature{ComponentType::POSITION | ComponentType::VELOCITY},
+                    SystemAccess{ComponentMask{ComponentType::VELOCITY}, ComponentMask{}}};
+}
+
+/// Draws: only reads positions and sprites.
+TestSystem make_render_system()
+{
+  return TestSystem{SystemSignature{ComponentType::POSITION | ComponentType::SPRITE},
+                    SystemAccess{ComponentType::POSITION | ComponentType::SPRITE, ComponentMask{}}};
+}
+
+/// Regenerates: writes health only.
+TestSystem make_health_system() { return TestSystem{SystemSignature{ComponentMask{ComponentType::HEALTH}}}; }
+
+/// Spins until @p arrived reaches @p count or a second has passed; true if everyone arrived.
+bool rendezvous(std::atomic<std::size_t>& arrived, const std::size_t count)
+{
+  ++arrived;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+  while (arrived.load() < count)
+  {
+    if (std::chrono::steady_clock::now() > deadline)
+    {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+} // namespace
+
+TEST(SystemSchedulerTest, access_is_derived_from_the_signature)
+{
+  const auto movement = make_movement_system();
+  EXPECT_EQ(movement.get_writes(), ComponentType::POSITION);
+  EXPECT_EQ(movement.get_reads(), ComponentType::VELOCITY);
+
+  const auto health = make_health_system();
+  EXPECT_EQ(health.get_writes(), ComponentType::HEALTH);
+  EXPECT_TRUE(health.get_reads().none());
+
+  // Explicit access may reach outside the signature, and a write wins over a read.
+  const TestSystem damage{SystemSignature{ComponentMask{ComponentType::HEALTH}},
+                          SystemAccess{ComponentType::POSITION | ComponentType::SPRITE,
+                                       ComponentType::SPRITE | ComponentType::VELOCITY}};
+  EXPECT_EQ(damage.get_writes(), ComponentType::HEALTH | ComponentType::SPRITE | ComponentType::VELOCITY);
+  EXPECT_EQ(damage.get_reads(), ComponentType::POSITION);
+}
+
+TEST(SystemSchedulerTest, conflicts_need_a_write)
+{
+  const auto movement = make_movement_system();
+  const auto render = make_render_system();
+  const auto health = make_health_system();
+
+  EXPECT_TRUE(movement.conflicts_with(render));
+  EXPECT_TRUE(render.conflicts_with(movement));
+  EXPECT_TRUE(movement.conflicts_with(movement));
+  EXPECT_FALSE(render.conflicts_with(render));
+  EXPECT_FALSE(movement.conflicts_with(health));
+  EXPECT_FALSE(render.conflicts_with(health));
+}
+
+TEST(SystemSchedulerTest, build_orders_conflicting_systems_by_registration)
+{
+  rtw::ecs::WorkStealingPool pool{1U};
+  SystemScheduler scheduler{pool};
+  const auto movement = make_movement_system();
+  const auto render = make_render_system();
+  const auto health = make_health_system();
+  const auto first = scheduler.add(movement, []() {});
+  const auto second = scheduler.add(health, []() {});
+  const auto third = scheduler.add(render, []() {});
+  ASSERT_TRUE(scheduler.build());
+
+  const auto& graph = scheduler.get_graph();
+  ASSERT_EQ(graph.size(), 3U);
+  const auto& edges = graph.get_edges(rtw::stl::graph::VertexId{static_cast<std::uint32_t>(first)});
+  ASSERT_EQ(edges.size(), 1U);
+  EXPECT_EQ(static_cast<std::size_t>(edges[0].to), third);
+  EXPECT_TRUE(graph.get_edges(rtw::stl::graph::VertexId{static_cast<std::uint32_t>(second)}).empty());
+  EXPECT_TRUE(graph.get_edges(rtw::stl::graph::VertexId{static_cast<std::uint32_t>(third)}).empty());
+}
+
+TEST(SystemSchedulerTest, build_rejects_cyclic_dependencies)
+{
+  rtw::ecs::WorkStealingPool pool{1U};
+  SystemScheduler scheduler{pool};
+  EXPECT_TRUE(scheduler.build());
+
+  const auto movement = make_movement_system();
+  const auto render = make_render_system();
+  const auto health = make_health_system();
+  const auto first = scheduler.add(movement, []() {});
+  const auto second = scheduler.add(render, []() {});
+  const auto third = scheduler.add(health, []() {});
+  scheduler.add_dependency(second, third);
+  EXPECT_TRUE(scheduler.build());
+
+  // The access conflict orders first before second; this closes the loop.
+  scheduler.add_dependency(third, first);
+  EXPECT_FALSE(scheduler.build());
+}
+
+TEST(SystemSchedulerTest, run_respects_dependencies)
+{
+  rtw::ecs::WorkStealingPool pool{4U};
+  SystemScheduler scheduler{pool};
+  const auto movement = make_movement_system();
+  const auto render = make_render_system();
+  const auto health = make_health_system();
+
+  std::atomic<std::size_t> clock{0U};
+  std::vector<std::size_t> ticks(4U, 0U);
+  const auto record = [&](const std::size_t slot) { return [&, slot]() { ticks[slot] = ++clock; }; };
+  scheduler.add(movement, record(0U));
+  scheduler.add(render, record(1U));
+  scheduler.add(health, record(2U));
+  scheduler.add(movement, record(3U));
+  ASSERT_TRUE(scheduler.build());
+
+  for (std::size_t frame = 0U; frame < 100U; ++frame)
+  {
+    clock = 0U;
+    scheduler.run();
+    EXPECT_LT(ticks[0], ticks[1]);
+    EXPECT_LT(ticks[1], ticks[3]);
+    EXPECT_NE(ticks[2], 0U);
+
+    const auto& trace = scheduler.get_trace();
+    ASSERT_EQ(trace.systems.size(), 4U);
+    EXPECT_LE(trace.systems[0].end, trace.systems[1].begin);
+    EXPECT_LE(trace.systems[1].end, trace.systems[3].begin);
+    for (const auto& system : trace.systems)
+    {
+      EXPECT_LT(system.worker, pool.thread_count());
+      EXPECT_LE(trace.begin, system.begin);
+      EXPECT_LE(system.end, trace.end);
+    }
+  }
+}
+
+TEST(SystemSchedulerTest, independent_systems_run_concurrently)
+{
+  rtw::ecs::WorkStealingPool pool{2U};
+  SystemScheduler scheduler{pool};
+  const auto movement = make_movement_system();
+  const auto health = make_health_system();
+
+  // Each waits for the other to start, which only succeeds if both run at the same time.
+  std::atomic<std::size_t> arrived{0U};
+  std::atomic<std::size_t> met{0U};
+  const auto job = [&]()
+  {
+    if (rendezvous(arrived, 2U))
+    {
+      ++met;
+    }
+  };
+  scheduler.add(movement, job);
+  scheduler.add(health, job);
+  ASSERT_TRUE(scheduler.build());
+  scheduler.run();
+
+  EXPECT_EQ(met.load(), 2U);
+  const auto& trace = scheduler.get_trace();
+  EXPECT_NE(trace.systems[0].worker, trace.systems[1].worker);
+  EXPECT_EQ(trace.max_concurrency(), 2U);
+}
+
+TEST(SystemSchedulerTest, a_single_thread_runs_serially_on_the_caller)
+{
+  rtw::ecs::WorkStealingPool pool{1U};
+  SystemScheduler scheduler{pool};
+  const auto movement = make_movement_system();
+  const auto health = make_health_system();
+  std::size_t runs{0U};
+  scheduler.add(movement, [&]() { ++runs; });
+  scheduler.add(health, [&]() { ++runs; });
+  ASSERT_TRUE(scheduler.build());
+  scheduler.run();
+
+  EXPECT_EQ(runs, 2U);
+  const auto& trace = scheduler.get_trace();
+  EXPECT_EQ(trace.systems[0].worker, 0U);
+  EXPECT_EQ(trace.systems[1].worker, 0U);
+  EXPECT_EQ(trace.max_concurrency(), 1U);
+  EXPECT_LE(trace.parallelism(), 1.0);
+}
+
+TEST(WorkStealingPoolTest, tasks_may_wait_for_tasks_they_submit)
+{
+  rtw::ecs::WorkStealingPool pool{3U};
+  EXPECT_EQ(pool.thread_count(), 3U);
+  EXPECT_EQ(pool.current_worker(), rtw::ecs::WorkStealingPool::NO_WORKER);
+
+  struct Context
+  {
+    rtw::ecs::WorkStealingPool* pool;
+    std::atomic<std::size_t> sum{0U};
+    std::atomic<std::size_t> pending{0U};
+  } context{&pool};
+
+  // Every outer task fans out into inner tasks and waits for them on its own worker.
+  constexpr std::size_t OUTER{8U};
+  constexpr std::size_t INNER{16U};
+  const auto inner = [](void* data, const std::size_t value)
+  {
+    auto& self = *static_cast<Context*>(data);
+    self.sum += value;
+    --self.pending;
+  };
+  const auto outer = [](void* data, const std::size_t /*index*/)
+  {
+    auto& self = *static_cast<Context*>(data);
+    std::atomic<std::size_t> children{INNER};
+    struct Child
+    {
+      Context* parent;
+      std::atomic<std::size_t>* children;
+    } child{&self, &children};
+    const auto run_child = [](void* child_data, const std::size_t value)
+    {
+      auto& that = *static_cast<Child*>(child_data);
+      that.parent->sum += value;
+      --*that.children;
+    };
+    for (std::size_t value = 1U; value <= INNER; ++value)
+    {
+      self.pool->submit(rtw::ecs::PoolTask{run_child, &child, value});
+    }
+    self.pool->wait(children);
+    --self.pending;
+  };
+
+  context.pending = OUTER + 1U;
+  pool.submit(rtw::ecs::PoolTask{inner, &context, 1000U});
+  for (std::size_t task = 0U; task < OUTER; ++task)
+  {
+    pool.submit(rtw::ecs::PoolTask{outer, &context, task});
+  }
+  pool.wait(context.pending);
+
+  EXPECT_EQ(context.sum.load(), 1000U + (OUTER * (INNER * (INNER + 1U) / 2U)));
+  EXPECT_EQ(pool.current_worker(), rtw::ecs::WorkStealingPool::NO_WORKER);
+}
+
+TEST(WorkStealingPoolTest, queues_grow_past_their_initial_capacity)
+{
+  // Both the caller and the pool's thread queue more tasks than a deque holds initially; stealing walks the rings
+  // from the front while their owners pop from the back.
+  rtw::ecs::WorkStealingPool pool{2U};
+  constexpr std::size_t COUNT{(4U * rtw::ecs::WorkStealingPool::QUEUE_CAPACITY) + 3U};
+  std::vector<std::atomic<std::size_t>> runs(COUNT);
+  pool.parallel_for(2U,
+                    [&pool, &runs](const std::size_t half)
+                    {
+                      pool.parallel_for(COUNT / 2U,
+                                        [&runs, half](const std::size_t index) { ++runs[(2U * index) + half]; });
+                    });
+  pool.parallel_for(COUNT, [&runs](const std::size_t index) { ++runs[index]; });
+
+  for (std::size_t index = 0U; index < COUNT; ++index)
+  {
+    EXPECT_EQ(runs[index].load(), (index < (2U * (COUNT / 2U))) ? 2U : 1U) << index;
+  }
+}
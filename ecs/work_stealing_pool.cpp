@@ -0,0 +1,182 @@
+#include "ecs/work_stealing_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace rtw::ecs
+{
+
+namespace
+{
+
+/// The pool and worker the current thread executes tasks for, if any.
+thread_local const WorkStealingPool* current_pool{nullptr};
+thread_local std::size_t current_worker_index{WorkStealingPool::NO_WORKER};
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(const std::size_t thread_count)
+{
+  const auto count = std::max<std::size_t>(thread_count, 1U);
+  queues_.reserve(count);
+  for (std::size_t worker = 0U; worker < count; ++worker)
+  {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  workers_.reserve(count - 1U);
+  for (std::size_t worker = 1U; worker < count; ++worker)
+  {
+    workers_.emplace_back(&WorkStealingPool::work, this, worker);
+  }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+  {
+    const std::lock_guard<std::mutex> lock{sleep_mutex_};
+    stopping_ = true;
+  }
+  work_condition_.notify_all();
+  for (auto& worker : workers_)
+  {
+    worker.join();
+  }
+}
+
+void WorkStealingPool::submit(const PoolTask& task)
+{
+  const auto worker = (current_pool == this) ? current_worker_index : 0U;
+  {
+    auto& queue = *queues_[worker];
+    const std::lock_guard<std::mutex> lock{queue.mutex};
+    // Counted before it can be popped, whose decrement holds the same lock, so the count never wraps below zero.
+    queued_.fetch_add(1U, std::memory_order_release);
+    queue.push_back(task);
+  }
+  if (!workers_.empty())
+  {
+    // Taking the lock orders the increment before a sleeping worker's check of its wake-up condition.
+    {
+      const std::lock_guard<std::mutex> lock{sleep_mutex_};
+    }
+    work_condition_.notify_one();
+  }
+}
+
+void WorkStealingPool::wait(const std::atomic<std::size_t>& pending)
+{
+  const auto* previous_pool = current_pool;
+  const auto previous_worker = current_worker_index;
+  const auto worker = (current_pool == this) ? current_worker_index : 0U;
+  current_pool = this;
+  current_worker_index = worker;
+
+  while (pending.load(std::memory_order_acquire) != 0U)
+  {
+    PoolTask task;
+    if (try_pop(worker, task))
+    {
+      task.function(task.context, task.index);
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  current_pool = previous_pool;
+  current_worker_index = previous_worker;
+}
+
+std::size_t WorkStealingPool::current_worker() const
+{
+  return (current_pool == this) ? current_worker_index : NO_WORKER;
+}
+
+void WorkStealingPool::work(const std::size_t worker)
+{
+  current_pool = this;
+  current_worker_index = worker;
+  while (true)
+  {
+    PoolTask task;
+    if (try_pop(worker, task))
+    {
+      task.function(task.context, task.index);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock{sleep_mutex_};
+    work_condition_.wait(lock, [this]() { return stopping_ || (queued_.load(std::memory_order_acquire) > 0U); });
+    if (stopping_)
+    {
+      return;
+    }
+  }
+}
+
+void WorkStealingPool::Queue::push_back(const PoolTask& task)
+{
+  if (size == tasks.size())
+  {
+    std::vector<PoolTask> grown(2U * tasks.size());
+    for (std::size_t i = 0U; i < size; ++i)
+    {
+      grown[i] = tasks[(front + i) & (tasks.size() - 1U)];
+    }
+    tasks = std::move(grown);
+    front = 0U;
+  }
+  tasks[(front + size) & (tasks.size() - 1U)] = task;
+  ++size;
+}
+
+PoolTask WorkStealingPool::Queue::pop_back()
+{
+  --size;
+  return tasks[(front + size) & (tasks.size() - 1U)];
+}
+
+PoolTask WorkStealingPool::Queue::pop_front()
+{
+  const auto task = tasks[front];
+  front = (front + 1U) & (tasks.size() - 1U);
+  --size;
+  return task;
+}
+
+bool WorkStealingPool::try_pop(const std::size_t worker, PoolTask& task)
+{
+  if (queued_.load(std::memory_order_acquire) == 0U)
+  {
+    return false;
+  }
+
+  {
+    auto& queue = *queues_[worker];
+    const std::lock_guard<std::mutex> lock{queue.mutex};
+    if (queue.size != 0U)
+    {
+      task = queue.pop_back();
+      queued_.fetch_sub(1U, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+  const auto count = queues_.size();
+  for (std::size_t offset = 1U; offset < count; ++offset)
+  {
+    auto& victim = *queues_[(worker + offset) % count];
+    const std::lock_guard<std::mutex> lock{victim.mutex};
+    if (victim.size != 0U)
+    {
+      task = victim.pop_front();
+      queued_.fetch_sub(1U, std::memory_order_relaxed);
+      steals_.fetch_add(1U, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace rtw::ecs
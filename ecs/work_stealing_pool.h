@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace rtw::ecs
+{
+
+/// A unit of work of a WorkStealingPool: a function and its arguments, so a task needs no storage of its own.
+struct PoolTask
+{
+  void (*function)(void* context, std::size_t index){nullptr};
+  void* context{nullptr};
+  std::size_t index{0U};
+};
+
+/// Thread pool whose workers each own a deque of tasks.
+///
+/// Each deque is a ring buffer of QUEUE_CAPACITY tasks allocated with the pool. It doubles when a submission finds
+/// it full and never shrinks, so submitting allocates only when a worker's backlog reaches a new high.
+///
+/// A worker pushes the tasks it submits to the back of its own deque and pops them from there, so a task that
+/// unblocks another one usually runs it next on the same core while its data is still in cache. A worker whose
+/// deque is empty steals from the front of the others', which hands the oldest (and typically largest) pending work
+/// to idle threads without a shared queue every submission contends on. Workers with nothing to steal sleep until a
+/// task is submitted.
+///
+/// The thread calling `wait()` is worker 0 and executes tasks too, so a pool of `thread_count()` threads starts one
+/// thread less; a pool of one thread runs everything on the caller of `wait()`.
+///
+/// @note `wait()` may be called by one thread outside the pool at a time, and by tasks running on the pool, which
+/// then help with the pending work instead of blocking their worker.
+class WorkStealingPool
+{
+public:
+  constexpr static std::size_t NO_WORKER = std::numeric_limits<std::size_t>::max();
+  /// Tasks each worker's deque holds before it grows; a power of two.
+  constexpr static std::size_t QUEUE_CAPACITY{256U};
+  static_assert((QUEUE_CAPACITY & (QUEUE_CAPACITY - 1U)) == 0U, "QUEUE_CAPACITY must be a power of two.");
+
+  /// @param thread_count Threads executing tasks, the caller of `wait()` included; at least one.
+  explicit WorkStealingPool(std::size_t thread_count = std::thread::hardware_concurrency());
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool(WorkStealingPool&&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(WorkStealingPool&&) = delete;
+  /// Joins the workers. Tasks still queued are dropped.
+  ~WorkStealingPool();
+
+  std::size_t thread_count() const { return queues_.size(); }
+
+  /// Queues @p task on the deque of the worker running the calling task, or on worker 0's when called from
+  /// outside the pool.
+  void submit(const PoolTask& task);
+
+  /// Executes tasks on the calling thread until @p pending is zero. The tasks decrement it themselves; the ones
+  /// that are neither queued nor running when it reaches zero must not touch it any more.
+  void wait(const std::atomic<std::size_t>& pending);
+
+  /// Runs @p function(0) ... @p function(count - 1) as tasks on the pool and returns when all have finished.
+  template <typename FunctionT>
+  void parallel_for(const std::size_t count, FunctionT&& function)
+  {
+    struct Context
+    {
+      std::remove_reference_t<FunctionT>* function;
+      std::atomic<std::size_t> pending;
+    } context{&function, {count}};
+
+    const auto run = [](void* data, const std::size_t index)
+    {
+      auto& self = *static_cast<Context*>(data);
+      (*self.function)(index);
+      self.pending.fetch_sub(1U, std::memory_order_acq_rel);
+    };
+    // The submitting worker pops from the back of its deque, so queueing the tasks in reverse lets it walk the
+    // range front to back, as a serial loop would, while thieves take the far end.
+    for (std::size_t index = count; index > 0U; --index)
+    {
+      submit(PoolTask{run, &context, index - 1U});
+    }
+    wait(context.pending);
+  }
+
+  /// Worker executing the calling task: 0 for the thread in `wait()`, 1 ... `thread_count() - 1` for the pool's
+  /// threads and NO_WORKER outside any task of this pool.
+  std::size_t current_worker() const;
+
+  /// Tasks executed by a worker other than the one that queued them, since the pool was created.
+  std::size_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+  /// Ring buffer of tasks with a power-of-two capacity, guarded by its mutex.
+  struct alignas(64) Queue
+  {
+    std::mutex mutex;
+    std::vector<PoolTask> tasks = std::vector<PoolTask>(QUEUE_CAPACITY);
+    std::size_t front{0U};
+    std::size_t size{0U};
+
+    void push_back(const PoolTask& task);
+    PoolTask pop_back();
+    PoolTask pop_front();
+  };
+
+  void work(std::size_t worker);
+  bool try_pop(std::size_t worker, PoolTask& task);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::atomic<std::size_t> queued_{0U};
+  std::atomic<std::size_t> steals_{0U};
+
+  std::mutex sleep_mutex_;
+  std::condition_variable work_condition_;
+  bool stopping_{false};
+  std::vector<std::thread> workers_;
+};
+
+} // namespace rtw::ecs
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "math/point.h"
 #include "multiprecision/fixed_point.h"
 
 #include <type_traits>
@@ -22,4 +23,18 @@ using BoundingBoxD = BoundingBox<double>;
 using BoundingBoxQ16 = BoundingBox<multiprecision::FixedPoint16>;
 using BoundingBoxQ32 = BoundingBox<multiprecision::FixedPoint32>;
 
+/// An axis-aligned 3D bounding box given by its minimum and maximum corners.
+/// A default-constructed box is the degenerate box at the origin.
+template <typename T, typename = std::enable_if_t<multiprecision::IS_ARITHMETIC_V<T>>>
+struct BoundingBox3
+{
+  Point3<T> min{};
+  Point3<T> max{};
+};
+
+using BoundingBox3F = BoundingBox3<float>;
+using BoundingBox3D = BoundingBox3<double>;
+using BoundingBox3Q16 = BoundingBox3<multiprecision::FixedPoint16>;
+using BoundingBox3Q32 = BoundingBox3<multiprecision::FixedPoint32>;
+
 } // namespace rtw::math
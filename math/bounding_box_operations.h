@@ -0,0 +1,137 @@
+#pragma once
+
+#include "math/bounding_box.h"
+#include "math/frustum.h"
+#include "math/matrix.h"
+#include "math/point.h"
+#include "math/vector_operations.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace rtw::math
+{
+
+/// The smallest box enclosing both boxes.
+/// @tparam T The type of the box elements.
+/// @param[in] lhs The first box.
+/// @param[in] rhs The second box.
+/// @return The union of the boxes.
+template <typename T>
+constexpr BoundingBox3<T> merge(const BoundingBox3<T>& lhs, const BoundingBox3<T>& rhs) noexcept
+{
+  BoundingBox3<T> result;
+  for (std::uint16_t i = 0U; i < 3U; ++i)
+  {
+    result.min[i] = std::min(lhs.min[i], rhs.min[i]);
+    result.max[i] = std::max(lhs.max[i], rhs.max[i]);
+  }
+  return result;
+}
+
+/// The centre of the box.
+/// @tparam T The type of the box elements.
+/// @param[in] box The box.
+/// @return The centre point.
+template <typename T>
+constexpr Point3<T> center(const BoundingBox3<T>& box) noexcept
+{
+  return Point3<T>{(box.min.x() + box.max.x()) / T{2}, (box.min.y() + box.max.y()) / T{2},
+                   (box.min.z() + box.max.z()) / T{2}};
+}
+
+/// The surface area of the box, the cost metric of the surface area heuristic (SAH).
+/// @tparam T The type of the box elements.
+/// @param[in] box The box.
+/// @return The surface area.
+template <typename T>
+constexpr T surface_area(const BoundingBox3<T>& box) noexcept
+{
+  const auto extent = box.max - box.min;
+  return T{2} * ((extent.x() * extent.y()) + (extent.y() * extent.z()) + (extent.z() * extent.x()));
+}
+
+/// Transforms a box by an affine transformation (column-vector convention, translation in the last column) and
+/// returns the axis-aligned box enclosing the result.
+/// Uses Arvo's method: each output extent is the sum of the per-axis minima/maxima of the linear part applied to
+/// the input extents, so only 9 multiply pairs are needed instead of transforming the 8 corners.
+/// @tparam T The type of the box elements.
+/// @param[in] matrix The affine transformation.
+/// @param[in] box The box to transform.
+/// @return The enclosing box of the transformed box.
+template <typename T, MemoryOrder MEMORY_ORDER>
+constexpr BoundingBox3<T> transform(const Matrix4x4<T, MEMORY_ORDER>& matrix, const BoundingBox3<T>& box) noexcept
+{
+  BoundingBox3<T> result;
+  for (std::uint16_t row = 0U; row < 3U; ++row)
+  {
+    result.min[row] = matrix(row, 3U);
+    result.max[row] = matrix(row, 3U);
+    for (std::uint16_t col = 0U; col < 3U; ++col)
+    {
+      const auto a = matrix(row, col) * box.min[col];
+      const auto b = matrix(row, col) * box.max[col];
+      result.min[row] += std::min(a, b);
+      result.max[row] += std::max(a, b);
+    }
+  }
+  return result;
+}
+
+/// The squared distance from a point to the closest point of the box (0 if the point is inside).
+/// @tparam T The type of the box elements.
+/// @param[in] point The point.
+/// @param[in] box The box.
+/// @return The squared distance.
+template <typename T>
+constexpr T distance_squared(const Point3<T>& point, const BoundingBox3<T>& box) noexcept
+{
+  T result{0};
+  for (std::uint16_t i = 0U; i < 3U; ++i)
+  {
+    const auto d = std::max({box.min[i] - point[i], T{0}, point[i] - box.max[i]});
+    result += d * d;
+  }
+  return result;
+}
+
+/// The result of a frustum-versus-volume test.
+enum class Containment : std::uint8_t
+{
+  OUTSIDE,
+  INTERSECTING,
+  INSIDE,
+};
+
+/// Classifies a box against a frustum whose plane normals point inwards (see `Frustum3`).
+/// For every plane only the box corner furthest along the normal (the "positive vertex") and the one furthest
+/// against it (the "negative vertex") are tested. The test is conservative: a box near a frustum corner may be
+/// reported as intersecting while being outside.
+/// @tparam T The type of the elements.
+/// @param[in] frustum The frustum.
+/// @param[in] box The box.
+/// @return OUTSIDE if the box is behind any plane, INSIDE if it is in front of all planes, INTERSECTING otherwise.
+template <typename T>
+constexpr Containment classify(const Frustum3<T>& frustum, const BoundingBox3<T>& box) noexcept
+{
+  auto result = Containment::INSIDE;
+  for (const auto& plane : frustum.planes())
+  {
+    const auto& n = plane.normal;
+    const Vector3<T> positive{n.x() >= T{0} ? box.max.x() : box.min.x(), n.y() >= T{0} ? box.max.y() : box.min.y(),
+                              n.z() >= T{0} ? box.max.z() : box.min.z()};
+    if ((dot(n, positive) + plane.distance) < T{0})
+    {
+      return Containment::OUTSIDE;
+    }
+    const Vector3<T> negative{n.x() >= T{0} ? box.min.x() : box.max.x(), n.y() >= T{0} ? box.min.y() : box.max.y(),
+                              n.z() >= T{0} ? box.min.z() : box.max.z()};
+    if ((dot(n, negative) + plane.distance) < T{0})
+    {
+      result = Containment::INTERSECTING;
+    }
+  }
+  return result;
+}
+
+} // namespace rtw::math
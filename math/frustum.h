@@ -198,19 +198,22 @@ constexpr Frustum3<T> extract_frustum(const Matrix4x4<T, MEMORY_ORDER>& matrix)
   const auto near = column3 + column2;
   const auto far = column3 - column2;
 
+  // Both the normal and the distance are divided by the length of the normal, so that signed_distance() yields a
+  // true Euclidean distance (required e.g. for sphere-vs-frustum tests).
+  const auto make_plane = [](const Vector4<T>& coefficients)
+  {
+    const auto normal = coefficients.xyz();
+    const auto length = norm(normal);
+    return Plane3<T>{normal / length, coefficients.w() / length};
+  };
+
   Frustum3<T> frustum;
-  frustum.left().normal = normalize(left.xyz());
-  frustum.left().distance = left.w();
-  frustum.right().normal = normalize(right.xyz());
-  frustum.right().distance = right.w();
-  frustum.top().normal = normalize(top.xyz());
-  frustum.top().distance = top.w();
-  frustum.bottom().normal = normalize(bottom.xyz());
-  frustum.bottom().distance = bottom.w();
-  frustum.near().normal = normalize(near.xyz());
-  frustum.near().distance = near.w();
-  frustum.far().normal = normalize(far.xyz());
-  frustum.far().distance = far.w();
+  frustum.left() = make_plane(left);
+  frustum.right() = make_plane(right);
+  frustum.top() = make_plane(top);
+  frustum.bottom() = make_plane(bottom);
+  frustum.near() = make_plane(near);
+  frustum.far() = make_plane(far);
   return frustum;
 }
 
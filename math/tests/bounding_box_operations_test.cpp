@@ -0,0 +1,86 @@
+#include "math/bounding_box_operations.h"
+#include "math/frustum.h"
+#include "math/matrix_operations.h"
+#include "math/transform3.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+constexpr float EPSILON = 1e-5F;
+
+rtw::math::BoundingBox3F make_box(const float min_x, const float min_y, const float min_z, const float max_x,
+                                  const float max_y, const float max_z)
+{
+  return rtw::math::BoundingBox3F{rtw::math::Point3F{min_x, min_y, min_z}, rtw::math::Point3F{max_x, max_y, max_z}};
+}
+
+void expect_box_near(const rtw::math::BoundingBox3F& actual, const rtw::math::BoundingBox3F& expected)
+{
+  for (std::uint16_t i = 0U; i < 3U; ++i)
+  {
+    EXPECT_NEAR(actual.min[i], expected.min[i], EPSILON) << "min[" << i << "]";
+    EXPECT_NEAR(actual.max[i], expected.max[i], EPSILON) << "max[" << i << "]";
+  }
+}
+
+} // namespace
+
+TEST(BoundingBox3, merge_encloses_both_boxes)
+{
+  const auto merged = rtw::math::merge(make_box(0.0F, 0.0F, 0.0F, 1.0F, 1.0F, 1.0F),
+                                       make_box(-1.0F, 0.5F, 2.0F, 0.5F, 3.0F, 4.0F));
+  expect_box_near(merged, make_box(-1.0F, 0.0F, 0.0F, 1.0F, 3.0F, 4.0F));
+}
+
+TEST(BoundingBox3, center_and_surface_area)
+{
+  const auto box = make_box(0.0F, 0.0F, 0.0F, 1.0F, 2.0F, 3.0F);
+  const auto c = rtw::math::center(box);
+  EXPECT_NEAR(c.x(), 0.5F, EPSILON);
+  EXPECT_NEAR(c.y(), 1.0F, EPSILON);
+  EXPECT_NEAR(c.z(), 1.5F, EPSILON);
+  EXPECT_NEAR(rtw::math::surface_area(box), 2.0F * (2.0F + 6.0F + 3.0F), EPSILON);
+}
+
+TEST(BoundingBox3, transform_translates_and_rotates)
+{
+  using namespace rtw::math::angle_literals;
+  const auto box = make_box(-1.0F, -2.0F, -3.0F, 1.0F, 2.0F, 3.0F);
+
+  auto translation = rtw::math::Matrix4x4F::identity();
+  translation(0U, 3U) = 10.0F;
+  translation(2U, 3U) = -5.0F;
+  expect_box_near(rtw::math::transform(translation, box), make_box(9.0F, -2.0F, -8.0F, 11.0F, 2.0F, -2.0F));
+
+  // A 90 degree rotation around z swaps the x and y extents.
+  const auto rotation = rtw::math::transform3::make_homogeneous(rtw::math::transform3::make_rotation_z(90.0_degF));
+  expect_box_near(rtw::math::transform(rotation, box), make_box(-2.0F, -1.0F, -3.0F, 2.0F, 1.0F, 3.0F));
+}
+
+TEST(BoundingBox3, distance_squared_to_point)
+{
+  const auto box = make_box(0.0F, 0.0F, 0.0F, 1.0F, 1.0F, 1.0F);
+  EXPECT_NEAR(rtw::math::distance_squared(rtw::math::Point3F{0.5F, 0.5F, 0.5F}, box), 0.0F, EPSILON);
+  EXPECT_NEAR(rtw::math::distance_squared(rtw::math::Point3F{3.0F, 0.5F, 0.5F}, box), 4.0F, EPSILON);
+  EXPECT_NEAR(rtw::math::distance_squared(rtw::math::Point3F{-1.0F, -1.0F, 0.5F}, box), 2.0F, EPSILON);
+}
+
+TEST(BoundingBox3, classify_against_frustum)
+{
+  using namespace rtw::math::angle_literals;
+  const auto params = rtw::math::make_perspective_parameters(90.0_degF, 1.0F, 0.1F, 100.0F);
+  // The projection multiplies column vectors; extract_frustum reads the planes from columns, hence the transpose.
+  const auto projection = rtw::math::make_perspective_projection_matrix(params);
+  const auto frustum = rtw::math::extract_frustum(rtw::math::transpose(projection));
+
+  EXPECT_EQ(rtw::math::classify(frustum, make_box(-1.0F, -1.0F, -11.0F, 1.0F, 1.0F, -9.0F)),
+            rtw::math::Containment::INSIDE);
+  EXPECT_EQ(rtw::math::classify(frustum, make_box(-1.0F, -1.0F, 1.0F, 1.0F, 1.0F, 2.0F)),
+            rtw::math::Containment::OUTSIDE);
+  EXPECT_EQ(rtw::math::classify(frustum, make_box(20.0F, -1.0F, -11.0F, 22.0F, 1.0F, -9.0F)),
+            rtw::math::Containment::OUTSIDE);
+  EXPECT_EQ(rtw::math::classify(frustum, make_box(8.0F, -1.0F, -11.0F, 12.0F, 1.0F, -9.0F)),
+            rtw::math::Containment::INTERSECTING);
+}
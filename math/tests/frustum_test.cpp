@@ -151,6 +151,26 @@ TEST(Frustum, extract_frustum_from_identity_matrix)
   EXPECT_NEAR(rtw::math::norm(frustum.far().normal), 1.0F, EPSILON);
 }
 
+TEST(Frustum, extract_frustum_distances_are_euclidean)
+{
+  // Scaling the matrix scales the raw plane coefficients; after normalisation every plane of the [-1, 1]^3 cube
+  // must still lie at distance 1 from the origin.
+  // clang-format off
+  const rtw::math::Matrix4x4F scaled{rtw::math::FROM_ROW_MAJOR,
+    2.0F, 0.0F, 0.0F, 0.0F,
+    0.0F, 2.0F, 0.0F, 0.0F,
+    0.0F, 0.0F, 2.0F, 0.0F,
+    0.0F, 0.0F, 0.0F, 2.0F,
+  };
+  // clang-format on
+  const auto frustum = rtw::math::extract_frustum(scaled);
+
+  for (const auto& plane : frustum.planes())
+  {
+    EXPECT_NEAR(plane.distance, 1.0F, EPSILON);
+  }
+}
+
 TEST(Frustum, extract_frustum_from_column_major_matrix)
 {
   using namespace rtw::math::angle_literals;
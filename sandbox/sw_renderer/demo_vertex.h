@@ -0,0 +1,111 @@
+#pragma once
+
+#include "sw_renderer/mesh.h"
+#include "sw_renderer/programmable_pipeline/builtin_shaders.h"
+#include "sw_renderer/programmable_pipeline/vertex_layout.h"
+#include "sw_renderer/types.h"
+
+#include "math/vector_operations.h"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace rtw::sw_renderer::demo
+{
+
+/// Interleaved, GPU-style vertex consumed by the programmable pipeline.
+///
+/// The pipeline reads attributes from raw bytes through a `VertexLayout`, so the members are plain
+/// `std::array<float, N>` (a standard-layout type) addressed by the hard-coded byte offsets below.
+/// Keeping the storage as `float`/`FLOAT32` is deliberate: the vertex buffer stays the same in the
+/// fixed-point build, where the decoder converts each `FLOAT32` component to `single_precision`.
+struct DemoVertex
+{
+  std::array<float, 4> position;
+  std::array<float, 4> normal;
+  std::array<float, 2> uv;
+  std::array<float, 4> color;
+};
+
+static_assert(sizeof(DemoVertex) == 56U, "DemoVertex must be tightly packed for the byte-offset layout");
+static_assert(offsetof(DemoVertex, position) == 0U, "position attribute offset mismatch");
+static_assert(offsetof(DemoVertex, normal) == 16U, "normal attribute offset mismatch");
+static_assert(offsetof(DemoVertex, uv) == 32U, "uv attribute offset mismatch");
+static_assert(offsetof(DemoVertex, color) == 40U, "color attribute offset mismatch");
+
+/// The layout describing how `DemoVertex` maps onto the built-in shader attribute locations.
+inline rtw::sw_renderer::VertexLayout make_demo_layout()
+{
+  return rtw::sw_renderer::VertexLayout{
+      {
+          rtw::sw_renderer::VertexAttribute{rtw::sw_renderer::attribute_location::POSITION, 0U,
+                                            rtw::sw_renderer::ComponentType::FLOAT32, 4U},
+          rtw::sw_renderer::VertexAttribute{rtw::sw_renderer::attribute_location::NORMAL, 16U,
+                                            rtw::sw_renderer::ComponentType::FLOAT32, 4U},
+          rtw::sw_renderer::VertexAttribute{rtw::sw_renderer::attribute_location::UV, 32U,
+                                            rtw::sw_renderer::ComponentType::FLOAT32, 2U},
+          rtw::sw_renderer::VertexAttribute{rtw::sw_renderer::attribute_location::COLOR, 40U,
+                                            rtw::sw_renderer::ComponentType::FLOAT32, 4U},
+      },
+      sizeof(DemoVertex)};
+}
+
+/// Expand the index-based `Mesh` into a flat, three-vertices-per-triangle stream.
+///
+/// The OBJ loader stores separate vertex / texture / normal index arrays; the programmable pipeline
+/// wants one interleaved record per corner. The per-vertex colour is derived from object-space
+/// position (`p * 0.5 + 0.5`) so the `VertexColorShader` shows a recognisable RGB cube, and the V
+/// texture coordinate is flipped because OBJ places the origin bottom-left while textures are top-left.
+inline std::vector<DemoVertex> build_interleaved(const rtw::sw_renderer::Mesh& mesh)
+{
+  const auto to_float = [](const rtw::sw_renderer::single_precision value) { return static_cast<float>(value); };
+
+  std::vector<DemoVertex> vertices;
+  vertices.reserve(mesh.faces.size() * 3U);
+
+  for (const auto& face : mesh.faces)
+  {
+    const auto& a = mesh.vertices[face.vertex_indices[0U]];
+    const auto& b = mesh.vertices[face.vertex_indices[1U]];
+    const auto& c = mesh.vertices[face.vertex_indices[2U]];
+    const rtw::sw_renderer::Vector3F edge_ab{b.x() - a.x(), b.y() - a.y(), b.z() - a.z()};
+    const rtw::sw_renderer::Vector3F edge_ac{c.x() - a.x(), c.y() - a.y(), c.z() - a.z()};
+    const auto face_normal = rtw::math::normalize(rtw::math::cross(edge_ab, edge_ac));
+
+    const bool has_normals = face.normal_indices.has_value() && !mesh.normals.empty();
+    const bool has_uvs = face.texture_indices.has_value() && !mesh.tex_coords.empty();
+
+    for (std::size_t i = 0U; i < 3U; ++i)
+    {
+      const auto& position = mesh.vertices[face.vertex_indices[i]];
+
+      auto normal = face_normal;
+      if (has_normals)
+      {
+        normal = mesh.normals[(*face.normal_indices)[i]];
+      }
+
+      float u = 0.0F;
+      float v = 0.0F;
+      if (has_uvs)
+      {
+        const auto& tex_coord = mesh.tex_coords[(*face.texture_indices)[i]];
+        u = to_float(tex_coord.u());
+        v = 1.0F - to_float(tex_coord.v());
+      }
+
+      DemoVertex vertex{};
+      vertex.position = {to_float(position.x()), to_float(position.y()), to_float(position.z()), 1.0F};
+      vertex.normal = {to_float(normal.x()), to_float(normal.y()), to_float(normal.z()), 0.0F};
+      vertex.uv = {u, v};
+      vertex.color = {(to_float(position.x()) * 0.5F) + 0.5F, (to_float(position.y()) * 0.5F) + 0.5F,
+                      (to_float(position.z()) * 0.5F) + 0.5F, 1.0F};
+      vertices.push_back(vertex);
+    }
+  }
+
+  return vertices;
+}
+
+} // namespace rtw::sw_renderer::demo
@@ -32,7 +32,7 @@ constexpr std::size_t DRAW_HISTORY_SIZE = 120U;
 class Application
 {
 public:
-  Application(const std::size_t width, const std::size_t height, const bool uncapped);
+  Application(const std::size_t width, const std::size_t height, const bool uncapped, const std::size_t thread_count);
   Application(const Application&) = delete;
   Application(Application&&) = delete;
   Application& operator=(const Application&) = delete;
@@ -74,9 +74,11 @@ private:
   std::size_t draw_ms_cursor_{0U};
 };
 
-Application::Application(const std::size_t width, const std::size_t height, const bool uncapped)
+Application::Application(const std::size_t width, const std::size_t height, const bool uncapped,
+                         const std::size_t thread_count)
     : sw_renderer_(width, height), uncapped_(uncapped)
 {
+  sw_renderer_.set_thread_count(thread_count);
   draw_ms_history_.assign(DRAW_HISTORY_SIZE, 0.0F);
 }
 
@@ -333,6 +335,13 @@ void Application::render_imgui()
   ImGui::PlotLines("##draw_ms", draw_ms_history_.data(), static_cast<int>(DRAW_HISTORY_SIZE),
                    static_cast<int>(draw_ms_cursor_), nullptr, 0.0F, *draw_ms_minmax.second, ImVec2(0.0F, 40.0F));
 
+  auto thread_count = static_cast<int>(sw_renderer_.thread_count());
+  const auto max_threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  if (ImGui::SliderInt("Threads", &thread_count, 1, max_threads))
+  {
+    sw_renderer_.set_thread_count(static_cast<std::size_t>(thread_count));
+  }
+
   bool enabled = sw_renderer_.face_culling_enabled();
   if (ImGui::Checkbox("Face Culling", &enabled))
   {
@@ -463,10 +472,15 @@ int main(int argc, char* argv[]) // NOLINT(bugprone-exception-escape)
   bool uncapped = false;
   cli_app.add_flag("--uncapped", uncapped, "Disable vsync and the frame-rate limiter (uncapped FPS for benchmarking)");
 
+  std::size_t thread_count = 1U;
+  cli_app.add_option("-j,--threads", thread_count, "Threads used by Renderer::draw_mesh")
+      ->check(CLI::PositiveNumber)
+      ->default_val(std::max(std::thread::hardware_concurrency(), 1U));
+
   CLI11_PARSE(cli_app, argc, argv);
 
   //  Application app(800, 600);
-  Application app(320, 240, uncapped);
+  Application app(320, 240, uncapped, thread_count);
   //  Application app(1024, 768);
 
   if (!app.init())
@@ -0,0 +1,297 @@
+#include "sandbox/sw_renderer/demo_vertex.h"
+
+#include "constants/math_constants.h"
+#include "constants/time_constants.h"
+#include "stl/span.h"
+#include "sw_renderer/camera.h"
+#include "sw_renderer/color.h"
+#include "sw_renderer/color_buffer.h"
+#include "sw_renderer/fixed_pipeline/renderer.h"
+#include "sw_renderer/image_io.h"
+#include "sw_renderer/mesh.h"
+#include "sw_renderer/obj_loader.h"
+#include "sw_renderer/programmable_pipeline/builtin_shaders.h"
+#include "sw_renderer/programmable_pipeline/frame_buffer.h"
+#include "sw_renderer/programmable_pipeline/pipeline.h"
+#include "sw_renderer/programmable_pipeline/pipeline_state.h"
+#include "sw_renderer/programmable_pipeline/vertex_stream.h"
+#include "sw_renderer/render_stats.h"
+#include "sw_renderer/types.h"
+
+#include "math/matrix_operations.h"
+#include "math/vector_operations.h"
+
+#include <CLI/CLI.hpp>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace rtw::sw_renderer::angle_literals;
+
+namespace
+{
+
+constexpr auto GREY = rtw::sw_renderer::Color{0x80'80'80'FF};
+
+struct Options
+{
+  std::filesystem::path mesh_path;
+  std::filesystem::path output_dir;
+  std::string pipeline{"programmable"};
+  std::size_t width{640U};
+  std::size_t height{480U};
+  std::size_t frames{120U};
+  std::size_t warmup{5U};
+  std::size_t threads{1U};
+  bool verbose{false};
+};
+
+/// Radius of the sphere around the origin that encloses every vertex of the mesh.
+float mesh_radius(const rtw::sw_renderer::Mesh& mesh)
+{
+  float radius_squared = 0.0F;
+  for (const auto& vertex : mesh.vertices)
+  {
+    const auto x = static_cast<float>(vertex.x());
+    const auto y = static_cast<float>(vertex.y());
+    const auto z = static_cast<float>(vertex.z());
+    radius_squared = std::max(radius_squared, (x * x) + (y * y) + (z * z));
+  }
+  return std::max(std::sqrt(radius_squared), 0.01F);
+}
+
+/// The scripted camera path: one full orbit around the origin over `frame_count` frames, slightly above the
+/// equator. The path only depends on the frame index, so two runs render exactly the same images.
+rtw::sw_renderer::Matrix4x4F make_orbit_view(const std::size_t frame, const std::size_t frame_count,
+                                             const float radius)
+{
+  const auto angle = 2.0F * rtw::math_constants::PI<float> * static_cast<float>(frame) / static_cast<float>(frame_count);
+  const auto distance = 3.0F * radius;
+  const rtw::sw_renderer::Point3F eye{distance * std::sin(angle), 0.4F * distance, distance * std::cos(angle)};
+  return rtw::sw_renderer::make_look_at(eye, rtw::sw_renderer::Point3F{0.0F, 0.0F, 0.0F});
+}
+
+/// Renders frames through the programmable `Pipeline` with the `StandardShader` (vertex colour and lighting).
+class ProgrammableTarget
+{
+public:
+  ProgrammableTarget(const Options& options, const rtw::sw_renderer::Mesh& mesh)
+      : framebuffer_(options.width, options.height), vertices_(rtw::sw_renderer::demo::build_interleaved(mesh))
+  {
+    const auto aspect_ratio = static_cast<rtw::sw_renderer::single_precision>(framebuffer_.aspect_ratio());
+    const auto frustum_params = rtw::math::make_perspective_parameters(
+        60.0_degF, aspect_ratio, rtw::sw_renderer::single_precision{0.1F}, rtw::sw_renderer::single_precision{100.0F});
+    projection_matrix_ = rtw::math::make_perspective_projection_matrix(frustum_params);
+
+    state_.viewport = rtw::sw_renderer::Viewport{0, 0, static_cast<std::int32_t>(options.width),
+                                                 static_cast<std::int32_t>(options.height)};
+    state_.cull_mode = rtw::sw_renderer::CullMode::BACK;
+    state_.front_face = rtw::sw_renderer::FrontFace::COUNTER_CLOCKWISE;
+    state_.depth_test_enabled = true;
+    state_.depth_write_enabled = true;
+
+    shader_.set_base_color(rtw::sw_renderer::Vector4F{1.0F, 1.0F, 1.0F, 1.0F});
+    shader_.set_use_texture(false);
+    shader_.set_use_vertex_color(true);
+    shader_.set_use_lighting(true);
+    shader_.set_light_direction(rtw::math::normalize(rtw::sw_renderer::Vector3F{0.0F, -1.0F, -1.0F}));
+  }
+
+  const rtw::sw_renderer::ColorBuffer& render(const rtw::sw_renderer::Matrix4x4F& view_matrix)
+  {
+    framebuffer_.clear(GREY, 1.0F);
+    stats_.reset();
+
+    shader_.set_mvp_matrix(projection_matrix_ * view_matrix);
+    shader_.set_normal_matrix(view_matrix);
+
+    const rtw::sw_renderer::RawVertexStream stream{layout_, rtw::stl::as_bytes(rtw::stl::make_span(vertices_))};
+    pipeline_.draw_arrays(shader_, stream, state_, framebuffer_, stats_);
+    return framebuffer_.color_buffer();
+  }
+
+  const rtw::sw_renderer::RenderStats& stats() const noexcept { return stats_; }
+
+private:
+  rtw::sw_renderer::FrameBuffer framebuffer_;
+  rtw::sw_renderer::Pipeline pipeline_;
+  rtw::sw_renderer::PipelineState state_;
+  rtw::sw_renderer::StandardShader shader_;
+  rtw::sw_renderer::RenderStats stats_;
+  rtw::sw_renderer::Matrix4x4F projection_matrix_;
+  rtw::sw_renderer::VertexLayout layout_{rtw::sw_renderer::demo::make_demo_layout()};
+  std::vector<rtw::sw_renderer::demo::DemoVertex> vertices_;
+};
+
+/// Renders frames through the fixed-function `Renderer` (flat shading and lighting, no texture).
+class FixedTarget
+{
+public:
+  FixedTarget(const Options& options, const rtw::sw_renderer::Mesh& mesh)
+      : renderer_(options.width, options.height), mesh_(mesh)
+  {
+    renderer_.set_render_mode(rtw::sw_renderer::RenderMode::FACE_CULLING | rtw::sw_renderer::RenderMode::SHADING
+                              | rtw::sw_renderer::RenderMode::LIGHT | rtw::sw_renderer::RenderMode::STATS);
+    renderer_.set_thread_count(options.threads);
+  }
+
+  const rtw::sw_renderer::ColorBuffer& render(const rtw::sw_renderer::Matrix4x4F& view_matrix)
+  {
+    renderer_.clear(GREY);
+    renderer_.draw_mesh(mesh_, view_matrix);
+    return renderer_.color_buffer();
+  }
+
+  const rtw::sw_renderer::RenderStats& stats() const noexcept { return renderer_.stats(); }
+
+private:
+  rtw::sw_renderer::Renderer renderer_;
+  const rtw::sw_renderer::Mesh& mesh_;
+};
+
+void accumulate(rtw::sw_renderer::RenderStats& total, const rtw::sw_renderer::RenderStats& frame)
+{
+  total.triangles_submitted += frame.triangles_submitted;
+  total.triangles_clipped += frame.triangles_clipped;
+  total.triangles_culled += frame.triangles_culled;
+  total.triangles_rendered += frame.triangles_rendered;
+  total.meshlets_submitted += frame.meshlets_submitted;
+  total.meshlets_culled += frame.meshlets_culled;
+  total.fragments_shaded += frame.fragments_shaded;
+  total.draws_skipped += frame.draws_skipped;
+}
+
+void print_stats(const char* label, const rtw::sw_renderer::RenderStats& stats)
+{
+  fmt::print("{:<10} submitted {:>10}  clipped {:>10}  culled {:>10}  rendered {:>10}\n", label,
+             stats.triangles_submitted, stats.triangles_clipped, stats.triangles_culled, stats.triangles_rendered);
+}
+
+/// Nearest-rank percentile of an ascending sequence.
+float percentile(const std::vector<float>& sorted, const float p)
+{
+  const auto rank = static_cast<std::size_t>(std::ceil(p / 100.0F * static_cast<float>(sorted.size())));
+  return sorted[std::clamp<std::size_t>(rank, 1U, sorted.size()) - 1U];
+}
+
+/// Renders `options.warmup` untimed frames, then `options.frames` timed ones along the orbit, optionally dumping
+/// each timed frame, and prints the timing distribution, the render stats and a checksum of all frames.
+template <typename TargetT>
+int run(TargetT& target, const Options& options, const float radius)
+{
+  for (std::size_t i = 0U; i < options.warmup; ++i)
+  {
+    std::ignore = target.render(make_orbit_view(i, options.frames, radius));
+  }
+
+  std::vector<float> frame_ms;
+  frame_ms.reserve(options.frames);
+  rtw::sw_renderer::RenderStats total;
+  auto checksum = rtw::sw_renderer::CHECKSUM_SEED;
+  for (std::size_t i = 0U; i < options.frames; ++i)
+  {
+    const auto view_matrix = make_orbit_view(i, options.frames, radius);
+    const auto start = std::chrono::steady_clock::now();
+    const auto& image = target.render(view_matrix);
+    const rtw::time_constants::Milliseconds elapsed = std::chrono::steady_clock::now() - start;
+
+    frame_ms.push_back(elapsed.count());
+    accumulate(total, target.stats());
+    checksum = rtw::sw_renderer::checksum(image, checksum);
+
+    if (options.verbose)
+    {
+      fmt::print("frame {:>5}: {:8.3f} ms, {} triangles rendered\n", i, elapsed.count(),
+                 target.stats().triangles_rendered);
+    }
+
+    if (!options.output_dir.empty())
+    {
+      const auto path = options.output_dir / fmt::format("frame_{:04}.ppm", i);
+      if (!rtw::sw_renderer::write_ppm(path, image))
+      {
+        fmt::print(stderr, "Failed to write {}\n", path.string());
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  const auto mean = std::accumulate(frame_ms.begin(), frame_ms.end(), 0.0F) / static_cast<float>(frame_ms.size());
+  std::sort(frame_ms.begin(), frame_ms.end());
+
+  fmt::print("{} frames, {}x{}, {} pipeline\n", options.frames, options.width, options.height, options.pipeline);
+  fmt::print("frame time [ms]: min {:.3f}  p50 {:.3f}  p90 {:.3f}  p99 {:.3f}  max {:.3f}  mean {:.3f}\n",
+             frame_ms.front(), percentile(frame_ms, 50.0F), percentile(frame_ms, 90.0F), percentile(frame_ms, 99.0F),
+             frame_ms.back(), mean);
+  print_stats("last frame", target.stats());
+  print_stats("total", total);
+  fmt::print("checksum: {:016x}\n", checksum);
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+/// Offline, windowless driver for the software renderers.
+///
+/// Loads a mesh, renders a fixed number of frames along a scripted camera orbit into an off-screen buffer and
+/// reports per-frame timing percentiles and `RenderStats`. Frames can be dumped as PPM images; the printed
+/// checksum covers every frame, so it detects output changes between two builds without keeping the images.
+int main(int argc, char* argv[]) // NOLINT(bugprone-exception-escape)
+{
+  CLI::App cli_app{"Headless Software Renderer"};
+
+  Options options;
+  cli_app.add_option("-m,--mesh", options.mesh_path, "Mesh file path")
+      ->check(CLI::ExistingFile)
+      ->default_val("sw_renderer/resources/textured_cube.obj");
+  cli_app.add_option("-p,--pipeline", options.pipeline, "Renderer to drive")
+      ->check(CLI::IsMember({"programmable", "fixed"}))
+      ->default_val("programmable");
+  cli_app.add_option("-n,--frames", options.frames, "Number of timed frames")
+      ->check(CLI::PositiveNumber)
+      ->default_val(120U);
+  cli_app.add_option("--warmup", options.warmup, "Number of untimed frames rendered first")->default_val(5U);
+  cli_app.add_option("--width", options.width, "Frame width")->check(CLI::PositiveNumber)->default_val(640U);
+  cli_app.add_option("--height", options.height, "Frame height")->check(CLI::PositiveNumber)->default_val(480U);
+  cli_app.add_option("-j,--threads", options.threads, "Threads used by the fixed pipeline")
+      ->check(CLI::PositiveNumber)
+      ->default_val(1U);
+  cli_app.add_option("-o,--output-dir", options.output_dir, "Write every timed frame as frame_NNNN.ppm here");
+  cli_app.add_flag("-v,--verbose", options.verbose, "Print the time of every frame");
+
+  CLI11_PARSE(cli_app, argc, argv);
+
+  if (!options.output_dir.empty())
+  {
+    std::filesystem::create_directories(options.output_dir);
+  }
+
+  const auto maybe_mesh = rtw::sw_renderer::load_obj(options.mesh_path);
+  if (!maybe_mesh.has_value())
+  {
+    fmt::print(stderr, "Failed to load mesh: {}\n", options.mesh_path.string());
+    return EXIT_FAILURE;
+  }
+  const auto& mesh = *maybe_mesh;
+  const auto radius = mesh_radius(mesh);
+
+  if (options.pipeline == "fixed")
+  {
+    FixedTarget target{options, mesh};
+    return run(target, options, radius);
+  }
+
+  ProgrammableTarget target{options, mesh};
+  return run(target, options, radius);
+}
@@ -1,11 +1,16 @@
+#include "sandbox/sw_renderer/demo_vertex.h"
+
 #include "constants/time_constants.h"
 #include "stl/span.h"
 #include "sw_renderer/camera.h"
 #include "sw_renderer/color.h"
+#include "sw_renderer/color_buffer.h"
 #include "sw_renderer/mesh.h"
 #include "sw_renderer/obj_loader.h"
 #include "sw_renderer/programmable_pipeline/builtin_shaders.h"
+#include "sw_renderer/programmable_pipeline/dynamic_resolution.h"
 #include "sw_renderer/programmable_pipeline/frame_buffer.h"
+#include "sw_renderer/programmable_pipeline/frame_ring.h"
 #include "sw_renderer/programmable_pipeline/pipeline.h"
 #include "sw_renderer/programmable_pipeline/pipeline_state.h"
 #include "sw_renderer/programmable_pipeline/sampler.h"
@@ -14,6 +19,7 @@
 #include "sw_renderer/programmable_pipeline/vertex_stream.h"
 #include "sw_renderer/render_stats.h"
 #include "sw_renderer/texture.h"
+#include "sw_renderer/texture_manager.h"
 #include "sw_renderer/types.h"
 
 #include "math/matrix_operations.h"
@@ -36,14 +42,20 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
+#include <limits>
 #include <numeric>
+#include <optional>
 #include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
 
 using namespace rtw::sw_renderer::angle_literals;
+using rtw::sw_renderer::demo::build_interleaved;
+using rtw::sw_renderer::demo::DemoVertex;
+using rtw::sw_renderer::demo::make_demo_layout;
 
 namespace
 {
@@ -51,98 +63,41 @@ namespace
 /// Rolling window of recent draw-call timings (milliseconds) backing the on-screen pipeline-cost readout.
 constexpr std::size_t DRAW_HISTORY_SIZE = 120U;
 
-/// Interleaved, GPU-style vertex consumed by the programmable pipeline.
-///
-/// The pipeline reads attributes from raw bytes through a `VertexLayout`, so the members are plain
-/// `std::array<float, N>` (a standard-layout type) addressed by the hard-coded byte offsets below.
-/// Keeping the storage as `float`/`FLOAT32` is deliberate: the vertex buffer stays the same in the
-/// fixed-point build, where the decoder converts each `FLOAT32` component to `single_precision`.
-struct DemoVertex
-{
-  std::array<float, 4> position;
-  std::array<float, 4> normal;
-  std::array<float, 2> uv;
-  std::array<float, 4> color;
-};
-
-static_assert(sizeof(DemoVertex) == 56U, "DemoVertex must be tightly packed for the byte-offset layout");
-static_assert(offsetof(DemoVertex, position) == 0U, "position attribute offset mismatch");
-static_assert(offsetof(DemoVertex, normal) == 16U, "normal attribute offset mismatch");
-static_assert(offsetof(DemoVertex, uv) == 32U, "uv attribute offset mismatch");
-static_assert(offsetof(DemoVertex, color) == 40U, "color attribute offset mismatch");
-
-/// The layout describing how `DemoVertex` maps onto the built-in shader attribute locations.
-rtw::sw_renderer::VertexLayout make_demo_layout()
-{
-  return rtw::sw_renderer::VertexLayout{
-      {
-          rtw::sw_renderer::VertexAttribute{rtw::sw_renderer::attribute_location::POSITION, 0U,
-                                            rtw::sw_renderer::ComponentType::FLOAT32, 4U},
-          rtw::sw_renderer::VertexAttribute{rtw::sw_renderer::attribute_location::NORMAL, 16U,
-                                            rtw::sw_renderer::ComponentType::FLOAT32, 4U},
-          rtw::sw_renderer::VertexAttribute{rtw::sw_renderer::attribute_location::UV, 32U,
-                                            rtw::sw_renderer::ComponentType::FLOAT32, 2U},
-          rtw::sw_renderer::VertexAttribute{rtw::sw_renderer::attribute_location::COLOR, 40U,
-                                            rtw::sw_renderer::ComponentType::FLOAT32, 4U},
-      },
-      sizeof(DemoVertex)};
-}
+/// Rolling window of frame-to-frame times (milliseconds) and the bins of its on-screen histogram.
+constexpr std::size_t FRAME_HISTORY_SIZE = 240U;
+constexpr std::size_t FRAME_HISTOGRAM_BINS = 32U;
 
-/// Expand the index-based `Mesh` into a flat, three-vertices-per-triangle stream.
-///
-/// The OBJ loader stores separate vertex / texture / normal index arrays; the programmable pipeline
-/// wants one interleaved record per corner. The per-vertex colour is derived from object-space
-/// position (`p * 0.5 + 0.5`) so the `VertexColorShader` shows a recognisable RGB cube, and the V
-/// texture coordinate is flipped because OBJ places the origin bottom-left while textures are top-left.
-std::vector<DemoVertex> build_interleaved(const rtw::sw_renderer::Mesh& mesh)
+/// Fallback decoder of the TextureManager for the formats SDL_image reads (the sample cube's texture is a PNG). Runs
+/// on the manager's workers; the converted surface is copied into the image once, row by row.
+std::optional<rtw::sw_renderer::Image> decode_with_sdl(const std::filesystem::path& path)
 {
-  const auto to_float = [](const rtw::sw_renderer::single_precision value) { return static_cast<float>(value); };
-
-  std::vector<DemoVertex> vertices;
-  vertices.reserve(mesh.faces.size() * 3U);
-
-  for (const auto& face : mesh.faces)
+  SDL_Surface* surface = IMG_Load(path.c_str());
+  if (surface == nullptr)
   {
-    const auto& a = mesh.vertices[face.vertex_indices[0U]];
-    const auto& b = mesh.vertices[face.vertex_indices[1U]];
-    const auto& c = mesh.vertices[face.vertex_indices[2U]];
-    const rtw::sw_renderer::Vector3F edge_ab{b.x() - a.x(), b.y() - a.y(), b.z() - a.z()};
-    const rtw::sw_renderer::Vector3F edge_ac{c.x() - a.x(), c.y() - a.y(), c.z() - a.z()};
-    const auto face_normal = rtw::math::normalize(rtw::math::cross(edge_ab, edge_ac));
-
-    const bool has_normals = face.normal_indices.has_value() && !mesh.normals.empty();
-    const bool has_uvs = face.texture_indices.has_value() && !mesh.tex_coords.empty();
-
-    for (std::size_t i = 0U; i < 3U; ++i)
-    {
-      const auto& position = mesh.vertices[face.vertex_indices[i]];
-
-      auto normal = face_normal;
-      if (has_normals)
-      {
-        normal = mesh.normals[(*face.normal_indices)[i]];
-      }
-
-      float u = 0.0F;
-      float v = 0.0F;
-      if (has_uvs)
-      {
-        const auto& tex_coord = mesh.tex_coords[(*face.texture_indices)[i]];
-        u = to_float(tex_coord.u());
-        v = 1.0F - to_float(tex_coord.v());
-      }
+    fmt::print("Could not load texture {}: {}\n", path.string(), IMG_GetError());
+    return std::nullopt;
+  }
 
-      DemoVertex vertex{};
-      vertex.position = {to_float(position.x()), to_float(position.y()), to_float(position.z()), 1.0F};
-      vertex.normal = {to_float(normal.x()), to_float(normal.y()), to_float(normal.z()), 0.0F};
-      vertex.uv = {u, v};
-      vertex.color = {(to_float(position.x()) * 0.5F) + 0.5F, (to_float(position.y()) * 0.5F) + 0.5F,
-                      (to_float(position.z()) * 0.5F) + 0.5F, 1.0F};
-      vertices.push_back(vertex);
-    }
+  SDL_Surface* converted_surface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA8888, 0);
+  SDL_FreeSurface(surface);
+  if (converted_surface == nullptr)
+  {
+    fmt::print("Could not convert texture {}: {}\n", path.string(), SDL_GetError());
+    return std::nullopt;
   }
 
-  return vertices;
+  const auto width = static_cast<std::size_t>(converted_surface->w);
+  const auto height = static_cast<std::size_t>(converted_surface->h);
+  rtw::sw_renderer::Image image{width, height, std::vector<std::uint32_t>(width * height)};
+  const auto* const pixels = static_cast<const std::uint8_t*>(converted_surface->pixels);
+  for (std::size_t y = 0U; y < height; ++y)
+  {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::memcpy(&image.texels[y * width], pixels + (y * static_cast<std::size_t>(converted_surface->pitch)),
+                width * sizeof(std::uint32_t));
+  }
+  SDL_FreeSurface(converted_surface);
+  return image;
 }
 
 } // namespace
@@ -152,10 +107,17 @@ std::vector<DemoVertex> build_interleaved(const rtw::sw_renderer::Mesh& mesh)
 /// Mirrors the SDL2 + Dear ImGui scaffolding of the fixed-function demo (`main.cpp`) but drives a
 /// `Pipeline` with selectable built-in shaders and live render-state toggles instead of the
 /// monolithic `Renderer`.
+///
+/// Frames go through a `FrameRing`: the pipeline renders frame N+1 on the ring's worker thread while the main
+/// thread uploads and presents frame N, so rasterisation and presentation overlap.
+///
+/// With dynamic resolution enabled, each frame renders into a smaller viewport chosen by `DynamicResolution` from
+/// the render times of the frames before it, and is upscaled to the window size before the upload.
 class Application
 {
 public:
-  Application(const std::size_t width, const std::size_t height, const bool uncapped);
+  Application(const std::size_t width, const std::size_t height, const std::size_t frames_in_flight,
+              const bool uncapped);
   Application(const Application&) = delete;
   Application(Application&&) = delete;
   Application& operator=(const Application&) = delete;
@@ -168,17 +130,22 @@ public:
 
 private:
   void init_imgui();
-  static bool load_textures(const std::filesystem::path& resources_folder, rtw::sw_renderer::Mesh& mesh);
+  bool load_textures(const std::filesystem::path& resources_folder);
   void process_events(bool& is_running, const rtw::time_constants::Seconds& delta_time);
   void update(const rtw::time_constants::Seconds& delta_time);
   void render_imgui();
   void polygon_radio(const char* label, rtw::sw_renderer::PolygonMode mode);
   void cull_radio(const char* label, rtw::sw_renderer::CullMode mode);
+  void upscale_radio(const char* label, rtw::sw_renderer::UpscaleFilter filter);
+  void shading_rate_radio(const char* label, rtw::sw_renderer::ShadingRate rate);
+  void render_dynamic_resolution_controls();
   rtw::sw_renderer::Vector4F object_color() const;
   rtw::sw_renderer::Vector3F light_direction() const;
   void configure_state();
   void configure_program();
-  void draw_active_shader(const rtw::sw_renderer::RawVertexStream& stream);
+  void submit_frame();
+  void record_frame_times(const rtw::sw_renderer::FrameRing::Frame& frame);
+  void render_frame_time_histogram();
   void render();
 
 private:
@@ -186,14 +153,29 @@ private:
   SDL_Renderer* sdl_renderer_{nullptr};
   SDL_Texture* sdl_texture_{nullptr};
 
+  // Only the ring's worker touches pipeline_ and frame_stats_[i] for the frames it renders; the main thread reads
+  // a frame's stats after acquiring it. vertices_ is read-only once the mesh is loaded.
   rtw::sw_renderer::Pipeline pipeline_;
-  rtw::sw_renderer::FrameBuffer framebuffer_;
+  rtw::sw_renderer::FrameRing frame_ring_;
   rtw::sw_renderer::PipelineState state_;
+  std::array<rtw::sw_renderer::RenderStats, rtw::sw_renderer::FrameRing::MAX_FRAMES> frame_stats_{};
   rtw::sw_renderer::RenderStats stats_;
 
+  // The main thread owns the controller; frame_viewports_[i] remembers the viewport slot i was submitted with, since
+  // the controller has moved on by the time the frame is presented.
+  rtw::sw_renderer::DynamicResolution dynamic_resolution_;
+  rtw::sw_renderer::ColorBuffer presentation_buffer_;
+  std::array<rtw::sw_renderer::Viewport, rtw::sw_renderer::FrameRing::MAX_FRAMES> frame_viewports_{};
+  rtw::sw_renderer::UpscaleFilter upscale_filter_{rtw::sw_renderer::UpscaleFilter::BILINEAR};
+  bool dynamic_resolution_enabled_{false};
+  float target_frame_ms_{16.6F};
+
   rtw::sw_renderer::StandardShader standard_shader_;
 
   rtw::sw_renderer::Mesh mesh_;
+  // Decodes the mesh's textures in parallel at start-up. The frame ring's worker samples them while the main thread
+  // runs, so the manager is never updated after loading and has no budget to enforce.
+  rtw::sw_renderer::TextureManager texture_manager_;
   std::vector<DemoVertex> vertices_;
   rtw::sw_renderer::VertexLayout layout_{make_demo_layout()};
   const rtw::sw_renderer::Texture* diffuse_texture_{nullptr};
@@ -213,6 +195,7 @@ private:
   rtw::sw_renderer::PolygonMode polygon_mode_{rtw::sw_renderer::PolygonMode::FILL};
   float point_size_{4.0F};
   rtw::sw_renderer::CullMode cull_mode_{rtw::sw_renderer::CullMode::BACK};
+  rtw::sw_renderer::ShadingRate shading_rate_{rtw::sw_renderer::ShadingRate::RATE_1X1};
   rtw::sw_renderer::FilterMode filter_mode_{rtw::sw_renderer::FilterMode::NEAREST};
   std::array<float, 4> color_{1.0F, 1.0F, 1.0F, 1.0F};
   std::array<float, 3> light_{0.3F, -0.5F, -1.0F};
@@ -224,15 +207,27 @@ private:
   bool show_demo_window_{false};
   bool uncapped_{false};
 
+  std::size_t width_{0U};
+  std::size_t height_{0U};
+
   std::vector<float> draw_ms_history_;
   std::size_t draw_ms_cursor_{0U};
+  std::vector<float> frame_ms_history_;
+  std::size_t frame_ms_cursor_{0U};
+  std::chrono::steady_clock::time_point last_present_{};
 };
 
-Application::Application(const std::size_t width, const std::size_t height, const bool uncapped)
-    : framebuffer_(width, height), uncapped_(uncapped)
+Application::Application(const std::size_t width, const std::size_t height, const std::size_t frames_in_flight,
+                         const bool uncapped)
+    : frame_ring_(frames_in_flight, width, height), dynamic_resolution_(width, height),
+      presentation_buffer_(width, height),
+      texture_manager_(rtw::sw_renderer::TextureManagerConfig{2U, 0U, decode_with_sdl}), uncapped_(uncapped),
+      width_(width), height_(height)
 {
   draw_ms_history_.assign(DRAW_HISTORY_SIZE, 0.0F);
-  const auto aspect_ratio = static_cast<rtw::sw_renderer::single_precision>(framebuffer_.aspect_ratio());
+  frame_ms_history_.assign(FRAME_HISTORY_SIZE, 0.0F);
+  const auto aspect_ratio = static_cast<rtw::sw_renderer::single_precision>(static_cast<float>(width_)
+                                                                             / static_cast<float>(height_));
   const auto fov_y = 60.0_degF;
   const auto frustum_params = rtw::math::make_perspective_parameters(
       fov_y, aspect_ratio, rtw::sw_renderer::single_precision{0.1F}, rtw::sw_renderer::single_precision{100.0F});
@@ -241,6 +236,7 @@ Application::Application(const std::size_t width, const std::size_t height, cons
 
 Application::~Application()
 {
+  frame_ring_.wait_idle();
   {
     ImGui_ImplSDLRenderer2_Shutdown();
     ImGui_ImplSDL2_Shutdown();
@@ -296,8 +292,7 @@ bool Application::init()
   }
 
   sdl_texture_ = SDL_CreateTexture(sdl_renderer_, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING,
-                                   static_cast<std::int32_t>(framebuffer_.width()),
-                                   static_cast<std::int32_t>(framebuffer_.height()));
+                                   static_cast<std::int32_t>(width_), static_cast<std::int32_t>(height_));
 
   if (sdl_texture_ == nullptr)
   {
@@ -320,16 +315,12 @@ bool Application::load_mesh(const std::filesystem::path& mesh_path)
   }
 
   mesh_ = std::move(maybe_mesh.value());
-  if (!load_textures(resources_folder, mesh_))
+  if (!load_textures(resources_folder))
   {
     return false;
   }
 
   vertices_ = build_interleaved(mesh_);
-  if (!mesh_.textures.empty())
-  {
-    diffuse_texture_ = &mesh_.textures.begin()->second;
-  }
   return true;
 }
 
@@ -352,35 +343,32 @@ void Application::init_imgui()
   ImGui_ImplSDLRenderer2_Init(sdl_renderer_);
 }
 
-bool Application::load_textures(const std::filesystem::path& resources_folder, rtw::sw_renderer::Mesh& mesh)
+bool Application::load_textures(const std::filesystem::path& resources_folder)
 {
-  for (auto& [name, texture] : mesh.textures)
+  std::vector<rtw::sw_renderer::TextureHandle> handles;
+  for (const auto& entry : mesh_.textures)
+  {
+    handles.push_back(texture_manager_.load(resources_folder / entry.first));
+  }
+  texture_manager_.wait_idle();
+
+  auto handle = handles.begin();
+  for (const auto& entry : mesh_.textures)
   {
-    const auto texture_path = resources_folder / name;
-    SDL_Surface* surface = IMG_Load(texture_path.c_str());
-    if (surface == nullptr)
+    const auto* texture = texture_manager_.texture(*handle);
+    if (texture == nullptr)
     {
-      fmt::print("Could not load texture {}: {}\n", name, IMG_GetError());
+      fmt::print("Could not load texture {}\n", entry.first);
       return false;
     }
-
-    SDL_Surface* converted_surface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA8888, 0);
-    SDL_FreeSurface(surface);
-
-    if (converted_surface == nullptr)
+    const auto latency = std::chrono::duration<float, std::milli>(texture_manager_.load_latency(*handle));
+    fmt::print("Texture {}: {}x{}, {} mip levels, loaded in {:.1f} ms.\n", entry.first, texture->width(),
+               texture->height(), texture_manager_.level_count(*handle), latency.count());
+    if (diffuse_texture_ == nullptr)
     {
-      fmt::print("Could not convert texture {}: {}\n", name, SDL_GetError());
-      return false;
+      diffuse_texture_ = texture;
     }
-
-    fmt::print("Texture {}: {}x{}, loaded.\n", name, converted_surface->w, converted_surface->h);
-
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-    texture = rtw::sw_renderer::Texture{reinterpret_cast<std::uint32_t*>(converted_surface->pixels),
-                                        static_cast<std::size_t>(converted_surface->w),
-                                        static_cast<std::size_t>(converted_surface->h)};
-
-    SDL_FreeSurface(converted_surface);
+    ++handle;
   }
   return true;
 }
@@ -490,6 +478,47 @@ void Application::cull_radio(const char* label, const rtw::sw_renderer::CullMode
   }
 }
 
+void Application::shading_rate_radio(const char* label, const rtw::sw_renderer::ShadingRate rate)
+{
+  if (ImGui::RadioButton(label, shading_rate_ == rate))
+  {
+    shading_rate_ = rate;
+  }
+}
+
+void Application::upscale_radio(const char* label, const rtw::sw_renderer::UpscaleFilter filter)
+{
+  if (ImGui::RadioButton(label, upscale_filter_ == filter))
+  {
+    upscale_filter_ = filter;
+  }
+}
+
+void Application::render_dynamic_resolution_controls()
+{
+  ImGui::Separator();
+  if (ImGui::Checkbox("Dynamic resolution", &dynamic_resolution_enabled_) && !dynamic_resolution_enabled_)
+  {
+    dynamic_resolution_.set_scale(1.0F);
+  }
+  if (!dynamic_resolution_enabled_)
+  {
+    return;
+  }
+
+  if (ImGui::SliderFloat("Target draw ms", &target_frame_ms_, 1.0F, 33.0F, "%.1f"))
+  {
+    dynamic_resolution_.set_target_ms(target_frame_ms_);
+  }
+  upscale_radio("Nearest", rtw::sw_renderer::UpscaleFilter::NEAREST);
+  ImGui::SameLine();
+  upscale_radio("Bilinear", rtw::sw_renderer::UpscaleFilter::BILINEAR);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg, hicpp-vararg)
+  ImGui::Text("scale %.0f%%  %zux%zu  smoothed %.2f ms", dynamic_resolution_.scale() * 100.0F,
+              dynamic_resolution_.render_width(), dynamic_resolution_.render_height(),
+              dynamic_resolution_.smoothed_ms());
+}
+
 rtw::sw_renderer::Vector4F Application::object_color() const
 {
   return rtw::sw_renderer::Vector4F{
@@ -559,6 +588,14 @@ void Application::render_imgui()
   cull_radio("Cull front", rtw::sw_renderer::CullMode::FRONT);
   ImGui::Checkbox("Depth test", &depth_test_enabled_);
   ImGui::Checkbox("Alpha blending (src-over)", &blend_enabled_);
+  ImGui::TextUnformatted("Shading rate");
+  shading_rate_radio("1x1", rtw::sw_renderer::ShadingRate::RATE_1X1);
+  ImGui::SameLine();
+  shading_rate_radio("2x1", rtw::sw_renderer::ShadingRate::RATE_2X1);
+  ImGui::SameLine();
+  shading_rate_radio("2x2", rtw::sw_renderer::ShadingRate::RATE_2X2);
+  ImGui::SameLine();
+  shading_rate_radio("4x4", rtw::sw_renderer::ShadingRate::RATE_4X4);
 
   ImGui::Separator();
   ImGui::TextUnformatted("Statistics");
@@ -566,6 +603,8 @@ void Application::render_imgui()
   ImGui::Text("submitted %zu  clipped %zu", stats_.triangles_submitted, stats_.triangles_clipped);
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg, hicpp-vararg)
   ImGui::Text("culled %zu  rendered %zu", stats_.triangles_culled, stats_.triangles_rendered);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg, hicpp-vararg)
+  ImGui::Text("fragment shader invocations %zu", stats_.fragments_shaded);
 
   const auto draw_ms_minmax = std::minmax_element(draw_ms_history_.begin(), draw_ms_history_.end());
   const auto draw_ms_avg =
@@ -576,6 +615,8 @@ void Application::render_imgui()
               *draw_ms_minmax.second);
   ImGui::PlotLines("##draw_ms", draw_ms_history_.data(), static_cast<int>(DRAW_HISTORY_SIZE),
                    static_cast<int>(draw_ms_cursor_), nullptr, 0.0F, *draw_ms_minmax.second, ImVec2(0.0F, 40.0F));
+  render_frame_time_histogram();
+  render_dynamic_resolution_controls();
 
   ImGui::Separator();
   ImGui::Checkbox("ImGui demo window", &show_demo_window_);
@@ -589,13 +630,16 @@ void Application::render_imgui()
 
 void Application::configure_state()
 {
-  state_.viewport = rtw::sw_renderer::Viewport{0, 0, static_cast<std::int32_t>(framebuffer_.width()),
-                                               static_cast<std::int32_t>(framebuffer_.height())};
+  state_.viewport =
+      dynamic_resolution_enabled_
+          ? dynamic_resolution_.viewport()
+          : rtw::sw_renderer::Viewport{0, 0, static_cast<std::int32_t>(width_), static_cast<std::int32_t>(height_)};
   state_.cull_mode = cull_mode_;
   state_.front_face = rtw::sw_renderer::FrontFace::COUNTER_CLOCKWISE;
   state_.polygon_mode = polygon_mode_;
   state_.depth_test_enabled = depth_test_enabled_;
   state_.depth_write_enabled = true;
+  state_.shading_rate = shading_rate_;
 
   state_.blend.enabled = blend_enabled_;
   state_.blend.src_rgb = rtw::sw_renderer::BlendFactor::SRC_ALPHA;
@@ -632,17 +676,80 @@ void Application::configure_program()
   standard_shader_.set_point_size(static_cast<rtw::sw_renderer::single_precision>(point_size_));
 }
 
-void Application::draw_active_shader(const rtw::sw_renderer::RawVertexStream& stream)
+void Application::submit_frame()
+{
+  configure_state();
+  configure_program();
+
+  // The frame renders on the ring's worker while this thread presents the previous one, so it captures copies of
+  // the state and the shader as they are now; later UI changes only affect later frames.
+  const auto frame_index = frame_ring_.submit(
+      [this, state = state_, shader = standard_shader_](rtw::sw_renderer::FrameBuffer& framebuffer,
+                                                          const std::uint64_t frame)
+      {
+        constexpr auto GREY = rtw::sw_renderer::Color{0x80'80'80'FF};
+        framebuffer.clear(GREY, 1.0F);
+
+        auto& stats = frame_stats_[frame % frame_ring_.frame_count()];
+        stats.reset();
+        if (!vertices_.empty())
+        {
+          const rtw::sw_renderer::RawVertexStream stream{layout_,
+                                                         rtw::stl::as_bytes(rtw::stl::make_span(vertices_))};
+          pipeline_.draw_arrays(shader, stream, state, framebuffer, stats);
+        }
+      });
+  frame_viewports_[frame_index % frame_ring_.frame_count()] = state_.viewport;
+}
+
+void Application::record_frame_times(const rtw::sw_renderer::FrameRing::Frame& frame)
 {
-  const auto draw_start = std::chrono::steady_clock::now();
-  pipeline_.draw_arrays(standard_shader_, stream, state_, framebuffer_, stats_);
-  const rtw::time_constants::Milliseconds draw_ms = std::chrono::steady_clock::now() - draw_start;
+  const rtw::time_constants::Milliseconds draw_ms = frame.render_time;
   draw_ms_history_[draw_ms_cursor_] = draw_ms.count();
   draw_ms_cursor_ = (draw_ms_cursor_ + 1U) % DRAW_HISTORY_SIZE;
+
+  const auto now = std::chrono::steady_clock::now();
+  if (last_present_ != std::chrono::steady_clock::time_point{})
+  {
+    const rtw::time_constants::Milliseconds frame_ms = now - last_present_;
+    frame_ms_history_[frame_ms_cursor_] = frame_ms.count();
+    frame_ms_cursor_ = (frame_ms_cursor_ + 1U) % FRAME_HISTORY_SIZE;
+  }
+  last_present_ = now;
+}
+
+void Application::render_frame_time_histogram()
+{
+  const auto max_ms = std::max(*std::max_element(frame_ms_history_.begin(), frame_ms_history_.end()), 1.0F);
+  std::array<float, FRAME_HISTOGRAM_BINS> bins{};
+  for (const auto ms : frame_ms_history_)
+  {
+    if (ms > 0.0F)
+    {
+      const auto bin = static_cast<std::size_t>(ms / max_ms * static_cast<float>(FRAME_HISTOGRAM_BINS - 1U));
+      bins[bin] += 1.0F;
+    }
+  }
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg, hicpp-vararg)
+  ImGui::Text("frame time histogram, 0 .. %.1f ms (%zu frames in flight)", max_ms, frame_ring_.frame_count());
+  ImGui::PlotHistogram("##frame_ms", bins.data(), static_cast<int>(FRAME_HISTOGRAM_BINS), 0, nullptr, 0.0F,
+                       std::numeric_limits<float>::max(), ImVec2(0.0F, 60.0F));
 }
 
 void Application::render()
 {
+  // Queue the next frame first, so the worker rasterises it while this thread presents the oldest one.
+  submit_frame();
+  const auto frame = frame_ring_.acquire();
+  stats_ = frame_stats_[frame.index % frame_ring_.frame_count()];
+  record_frame_times(frame);
+  if (dynamic_resolution_enabled_)
+  {
+    const rtw::time_constants::Milliseconds draw_ms = frame.render_time;
+    dynamic_resolution_.update(draw_ms.count(), stats_);
+  }
+
   {
     // Start the Dear ImGui frame
     ImGui_ImplSDLRenderer2_NewFrame();
@@ -660,21 +767,16 @@ void Application::render()
   SDL_SetRenderDrawColor(sdl_renderer_, 0, 0xFF, 0, 0xFF);
   SDL_RenderClear(sdl_renderer_);
 
-  constexpr auto GREY = rtw::sw_renderer::Color{0x80'80'80'FF};
-  framebuffer_.clear(GREY, 1.0F);
-
-  configure_state();
-  configure_program();
-  stats_.reset();
-
-  if (!vertices_.empty())
+  const auto& viewport = frame_viewports_[frame.index % frame_ring_.frame_count()];
+  const auto* color_buffer = &frame.framebuffer->color_buffer();
+  if ((static_cast<std::size_t>(viewport.width) != width_) || (static_cast<std::size_t>(viewport.height) != height_))
   {
-    const rtw::sw_renderer::RawVertexStream stream{layout_, rtw::stl::as_bytes(rtw::stl::make_span(vertices_))};
-    draw_active_shader(stream);
+    rtw::sw_renderer::upscale(*color_buffer, static_cast<std::size_t>(viewport.width),
+                              static_cast<std::size_t>(viewport.height), presentation_buffer_, upscale_filter_);
+    color_buffer = &presentation_buffer_;
   }
-
-  SDL_UpdateTexture(sdl_texture_, nullptr, framebuffer_.color_buffer().data(),
-                    static_cast<std::int32_t>(framebuffer_.color_buffer().pitch()));
+  SDL_UpdateTexture(sdl_texture_, nullptr, color_buffer->data(), static_cast<std::int32_t>(color_buffer->pitch()));
+  frame_ring_.release();
   SDL_RenderCopy(sdl_renderer_, sdl_texture_, nullptr, nullptr);
 
   {
@@ -690,6 +792,9 @@ void Application::run()
   constexpr rtw::time_constants::Milliseconds TARGET_FRAME_TIME{1000.0F / TARGET_FRAME_RATE};
   auto last_frame_time = std::chrono::system_clock::now();
 
+  // Prime the ring: from here on every render() submits one frame and presents the one before it.
+  submit_frame();
+
   bool is_running = true;
   while (is_running)
   {
@@ -724,9 +829,14 @@ int main(int argc, char* argv[]) // NOLINT(bugprone-exception-escape)
   bool uncapped = false;
   cli_app.add_flag("--uncapped", uncapped, "Disable vsync and the frame-rate limiter (uncapped FPS for benchmarking)");
 
+  std::size_t frames_in_flight = 2U;
+  cli_app.add_option("--frames-in-flight", frames_in_flight, "Frame buffers in the render/present ring")
+      ->check(CLI::Range(rtw::sw_renderer::FrameRing::MIN_FRAMES, rtw::sw_renderer::FrameRing::MAX_FRAMES))
+      ->default_val(2U);
+
   CLI11_PARSE(cli_app, argc, argv);
 
-  Application app(640, 480, uncapped);
+  Application app(640, 480, frames_in_flight, uncapped);
 
   if (!app.init())
   {
@@ -18,7 +18,7 @@ namespace rtw::stl
 /// Complexity:
 ///   - push / emplace: O(1)
 ///   - pop: O(1)
-///   - front / back: O(1)
+///   - front / back / operator[]: O(1)
 ///   - size / empty / capacity: O(1)
 template <typename T, typename StorageT = StaticContiguousStorage<T>>
 class GenericStaticQueue
@@ -110,6 +110,22 @@ public:
     return storage_[(head_ + size() - 1U) % capacity()];
   }
 
+  /// @brief Returns the element @p offset positions behind the front, without removing anything.
+  /// @pre offset < size()
+  constexpr reference operator[](const size_type offset) noexcept
+  {
+    assert(offset < size());
+    return storage_[(head_ + offset) % capacity()];
+  }
+
+  /// @brief Returns the element @p offset positions behind the front, without removing anything.
+  /// @pre offset < size()
+  constexpr const_reference operator[](const size_type offset) const noexcept
+  {
+    assert(offset < size());
+    return storage_[(head_ + offset) % capacity()];
+  }
+
   /// @brief Destroys all elements and resets the head index.
   constexpr void clear() noexcept
   {
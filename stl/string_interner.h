@@ -0,0 +1,189 @@
+#pragma once
+
+#include "stl/heap_array.h"
+#include "stl/inplace_string.h"
+#include "stl/static_flat_unordered_set.h"
+#include "stl/static_stack.h"
+#include "stl/string_view.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace rtw::stl
+{
+
+/// @brief 64-bit FNV-1a hash of a string, usable in constant expressions.
+/// @param[in] str The string to hash.
+/// @return The hash of @p str.
+constexpr std::uint64_t hash_string(const StringView str) noexcept
+{
+  std::uint64_t hash{0xCBF2'9CE4'8422'2325U};
+  for (StringView::size_type i = 0U; i < str.size(); ++i)
+  {
+    hash = (hash ^ static_cast<std::uint8_t>(str[i])) * 0x0000'0100'0000'01B3U;
+  }
+  return hash;
+}
+
+/// @brief A non-owning name paired with its hash.
+///
+/// Hashes the name once, on construction, so that containers keyed by names probe and compare hashes only. In a
+/// constant expression (`constexpr HashedString PLAYER{"Player"};` or `"Player"_hs`) the hash is computed at
+/// compile time. Converts implicitly from string literals, StringView and the static strings, so it can replace
+/// them as a parameter type.
+class HashedString
+{
+public:
+  // NOLINTBEGIN(google-explicit-constructor, hicpp-explicit-conversions)
+  constexpr HashedString(const StringView name) noexcept : name_{name}, hash_{hash_string(name)} {}
+  constexpr HashedString(const char* name) noexcept : HashedString{StringView{name}} {}
+
+  template <typename DerivedT>
+  constexpr HashedString(const GenericStaticString<DerivedT>& name) noexcept
+      : HashedString{StringView{name.data(), name.size()}}
+  {
+  }
+  // NOLINTEND(google-explicit-constructor, hicpp-explicit-conversions)
+
+  constexpr StringView name() const noexcept { return name_; }
+  constexpr std::uint64_t hash() const noexcept { return hash_; }
+
+private:
+  StringView name_;
+  std::uint64_t hash_{0U};
+};
+
+namespace string_literals
+{
+
+constexpr HashedString operator""_hs(const char* str, const std::size_t size) noexcept
+{
+  return HashedString{StringView{str, size}};
+}
+
+} // namespace string_literals
+
+/// @brief Maps names to compact, reference-counted ids.
+///
+/// Every interned name gets an id below `capacity()`, so that arrays indexed by id can replace maps keyed by strings.
+/// Names are looked up by their HashedString hash, in a set of hash and id pairs; the interner keeps a copy of each
+/// name, truncated to InplaceStringSmall, for `name()` and to catch hash collisions in debug builds. `intern()` adds a
+/// reference to the id and `release()` drops one: an id without references is forgotten and handed out again.
+///
+/// @note The set has twice the capacity of the interner, as open addressing needs free slots to end its probes.
+///
+/// Complexity:
+///   - intern / find / release: O(1) average
+///   - name / size / capacity: O(1)
+class StringInterner
+{
+public:
+  using IdType = std::uint32_t;
+
+  constexpr static IdType INVALID_ID = std::numeric_limits<IdType>::max();
+
+  /// @param[in] capacity Maximum number of names interned at once.
+  explicit StringInterner(const std::size_t capacity) noexcept
+      : ids_{2U * capacity}, names_{capacity, Name{}}, free_ids_{capacity}
+  {
+    assert(capacity < INVALID_ID);
+    for (auto id = static_cast<IdType>(capacity); id > 0U; --id)
+    {
+      free_ids_.push(id - 1U);
+    }
+  }
+
+  /// @brief Adds a reference to the id of @p name, interning the name if it is new.
+  /// @pre A new name needs a free id (asserts in debug).
+  /// @param[in] name The name to intern.
+  /// @return The id of @p name.
+  IdType intern(const HashedString& name) noexcept
+  {
+    auto id = find(name);
+    if (id == INVALID_ID)
+    {
+      assert(!free_ids_.empty() && "StringInterner is full.");
+      id = free_ids_.top();
+      free_ids_.pop();
+      [[maybe_unused]] const auto inserted = ids_.insert(HashedId{name.hash(), id});
+      assert(inserted);
+      names_[id] = Name{InplaceStringSmall{name.name()}, name.hash(), 0U};
+    }
+    ++names_[id].references;
+    return id;
+  }
+
+  /// @param[in] name The name to look up.
+  /// @return The id of @p name, or INVALID_ID if it is not interned. Adds no reference.
+  IdType find(const HashedString& name) const noexcept
+  {
+    const auto it = ids_.find(HashedId{name.hash(), INVALID_ID});
+    if (it == ids_.end())
+    {
+      return INVALID_ID;
+    }
+    assert((names_[it->id].name == InplaceStringSmall{name.name()}) && "Hash collision between two names.");
+    return it->id;
+  }
+
+  /// @brief Drops a reference to @p id. The last one forgets the name and recycles the id.
+  /// @pre @p id is interned.
+  /// @param[in] id The id to release.
+  void release(const IdType id) noexcept
+  {
+    assert((id < names_.size()) && (names_[id].references > 0U));
+    if (--names_[id].references == 0U)
+    {
+      ids_.erase(HashedId{names_[id].hash, id});
+      free_ids_.push(id);
+    }
+  }
+
+  /// @pre @p id is interned.
+  /// @return The name of @p id, truncated to InplaceStringSmall.
+  StringView name(const IdType id) const noexcept
+  {
+    assert((id < names_.size()) && (names_[id].references > 0U));
+    return StringView{names_[id].name.data(), names_[id].name.size()};
+  }
+
+  /// @return The number of references to @p id, zero if it is not interned.
+  std::uint32_t references(const IdType id) const noexcept { return names_[id].references; }
+
+  std::size_t size() const noexcept { return ids_.size(); }
+  bool empty() const noexcept { return ids_.empty(); }
+  std::size_t capacity() const noexcept { return names_.size(); }
+
+private:
+  /// The set's element: hashed and compared by the hash alone, so that a lookup builds one from the hash.
+  struct HashedId
+  {
+    std::uint64_t hash;
+    IdType id;
+
+    constexpr bool operator==(const HashedId& other) const noexcept { return hash == other.hash; }
+  };
+
+  struct Hash
+  {
+    constexpr std::size_t operator()(const HashedId& hashed_id) const noexcept
+    {
+      return static_cast<std::size_t>(hashed_id.hash);
+    }
+  };
+
+  struct Name
+  {
+    InplaceStringSmall name;
+    std::uint64_t hash;
+    std::uint32_t references;
+  };
+
+  StaticFlatUnorderedSet<HashedId, Hash> ids_;
+  HeapArray<Name> names_;
+  StaticStack<IdType> free_ids_;
+};
+
+} // namespace rtw::stl
@@ -113,3 +113,26 @@ TEST(QueueTest, emplace_pop)
 
   EXPECT_DEATH(queue.pop(), ".*");
 }
+
+TEST(QueueTest, index_from_front)
+{
+  StaticQueue queue{4U};
+  for (std::size_t i = 0U; i < queue.capacity(); ++i)
+  {
+    queue.emplace(static_cast<float>(i), static_cast<std::int32_t>(i), static_cast<std::uint8_t>(i));
+  }
+  queue.pop();
+  queue.pop();
+  queue.emplace(4.0F, 4, 4U);
+
+  // The storage has wrapped around; indices still count from the front.
+  ASSERT_EQ(queue.size(), 3U);
+  EXPECT_EQ(queue[0U], (Struct{2.0F, 2, 2U}));
+  EXPECT_EQ(queue[1U], (Struct{3.0F, 3, 3U}));
+  EXPECT_EQ(queue[2U], (Struct{4.0F, 4, 4U}));
+
+  const auto& const_queue = queue;
+  EXPECT_EQ(const_queue[2U], queue.back());
+
+  EXPECT_DEATH(queue[3U], ".*");
+}
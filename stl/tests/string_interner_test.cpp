@@ -0,0 +1,91 @@
+#include "stl/string_interner.h"
+
+#include <gtest/gtest.h>
+
+using namespace rtw::stl::string_literals;
+
+namespace
+{
+
+constexpr rtw::stl::HashedString PLAYER{"Player"};
+
+// The hash of a constexpr name is a constant expression.
+static_assert(PLAYER.hash() == rtw::stl::hash_string("Player"));
+static_assert("Player"_hs.hash() == PLAYER.hash());
+static_assert(rtw::stl::hash_string("") == 0xCBF2'9CE4'8422'2325U);
+static_assert(rtw::stl::hash_string("a") == 0xAF63'DC4C'8601'EC8CU);
+
+using StringInterner = rtw::stl::StringInterner;
+
+} // namespace
+
+TEST(HashedStringTest, conversions)
+{
+  const rtw::stl::InplaceStringSmall inplace{"Player"};
+  const rtw::stl::HashedString from_inplace{inplace};
+  const rtw::stl::HashedString from_pointer{"Player"};
+  const rtw::stl::HashedString from_view{rtw::stl::StringView{"Player Two", 6U}};
+
+  EXPECT_EQ(from_inplace.hash(), PLAYER.hash());
+  EXPECT_EQ(from_pointer.hash(), PLAYER.hash());
+  EXPECT_EQ(from_view.hash(), PLAYER.hash());
+  EXPECT_EQ(from_view.name(), "Player");
+  EXPECT_NE("Enemy"_hs.hash(), PLAYER.hash());
+}
+
+TEST(StringInternerTest, intern)
+{
+  StringInterner interner{4U};
+  EXPECT_TRUE(interner.empty());
+  EXPECT_EQ(interner.capacity(), 4U);
+  EXPECT_EQ(interner.find(PLAYER), StringInterner::INVALID_ID);
+
+  const auto player = interner.intern(PLAYER);
+  const auto enemy = interner.intern("Enemy");
+  EXPECT_EQ(player, 0U);
+  EXPECT_EQ(enemy, 1U);
+  EXPECT_EQ(interner.size(), 2U);
+  EXPECT_EQ(interner.find("Player"), player);
+  EXPECT_EQ(interner.find(rtw::stl::InplaceStringSmall{"Enemy"}), enemy);
+  EXPECT_EQ(interner.name(player), "Player");
+  EXPECT_EQ(interner.name(enemy), "Enemy");
+
+  // Interning a name again adds a reference to its id.
+  EXPECT_EQ(interner.intern("Player"_hs), player);
+  EXPECT_EQ(interner.references(player), 2U);
+  EXPECT_EQ(interner.references(enemy), 1U);
+  EXPECT_EQ(interner.size(), 2U);
+}
+
+TEST(StringInternerTest, release)
+{
+  StringInterner interner{2U};
+  const auto player = interner.intern(PLAYER);
+  interner.intern(PLAYER);
+  const auto enemy = interner.intern("Enemy");
+
+  interner.release(player);
+  EXPECT_EQ(interner.find(PLAYER), player);
+  interner.release(player);
+  EXPECT_EQ(interner.find(PLAYER), StringInterner::INVALID_ID);
+  EXPECT_EQ(interner.references(player), 0U);
+  EXPECT_EQ(interner.size(), 1U);
+
+  // The released id is handed out again.
+  EXPECT_EQ(interner.intern("Boss"), player);
+  EXPECT_EQ(interner.name(player), "Boss");
+  EXPECT_EQ(interner.find("Enemy"), enemy);
+
+  EXPECT_DEATH(interner.intern("Full"), ".*");
+}
+
+TEST(StringInternerTest, long_names)
+{
+  // Names are hashed in full but kept truncated to InplaceStringSmall.
+  StringInterner interner{2U};
+  const auto first = interner.intern("a name longer than thirty-two characters, one");
+  const auto second = interner.intern("a name longer than thirty-two characters, two");
+  EXPECT_NE(first, second);
+  EXPECT_EQ(interner.find("a name longer than thirty-two characters, one"), first);
+  EXPECT_EQ(interner.name(first).size(), 32U);
+}
@@ -0,0 +1,634 @@
+#include "constants/math_constants.h"
+#include "sw_renderer/color.h"
+#include "sw_renderer/color_buffer.h"
+#include "sw_renderer/fixed_pipeline/renderer.h"
+#include "sw_renderer/image_io.h"
+#include "sw_renderer/mesh.h"
+#include "sw_renderer/obj_loader.h"
+#include "sw_renderer/programmable_pipeline/builtin_shaders.h"
+#include "sw_renderer/programmable_pipeline/frame_buffer.h"
+#include "sw_renderer/programmable_pipeline/pipeline.h"
+#include "sw_renderer/programmable_pipeline/pipeline_state.h"
+#include "sw_renderer/programmable_pipeline/sampler.h"
+#include "sw_renderer/programmable_pipeline/vertex_layout.h"
+#include "sw_renderer/programmable_pipeline/vertex_stream.h"
+#include "sw_renderer/render_stats.h"
+#include "sw_renderer/texture.h"
+#include "sw_renderer/types.h"
+
+#include "math/matrix_operations.h"
+#include "math/transform3.h"
+#include "math/vector_operations.h"
+
+#include "stl/span.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <optional>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// End-to-end scenes with a correctness check: every benchmark renders its scene repeatedly for timing, then
+// compares the last frame against a golden image stored in sw_renderer/benchmarks/golden. A mismatch beyond the
+// tolerance marks the benchmark as failed and makes the binary exit with a non-zero status.
+//
+// The goldens are per precision (float and RTW_USE_FIXED_POINT render slightly different images). To regenerate
+// them after an intended change of the output:
+//   RTW_UPDATE_GOLDEN=1 bazel run -c opt //sw_renderer/benchmarks:golden_scene_benchmark
+//   RTW_UPDATE_GOLDEN=1 bazel run -c opt //sw_renderer/benchmarks:golden_scene_benchmark_fp
+
+namespace
+{
+
+using rtw::sw_renderer::single_precision;
+
+constexpr std::size_t WIDTH{160U};
+constexpr std::size_t HEIGHT{120U};
+
+/// Largest per-channel difference that still counts as a match. Absorbs rounding differences between compilers
+/// (e.g. FMA contraction) along triangle edges.
+constexpr std::uint8_t CHANNEL_TOLERANCE{8U};
+/// Largest fraction of pixels allowed to differ by more than `CHANNEL_TOLERANCE`.
+constexpr double MAX_DIFFERING_FRACTION{0.005};
+
+constexpr const char* GOLDEN_DIR{"sw_renderer/benchmarks/golden"};
+#ifdef RTW_USE_FIXED_POINT
+constexpr const char* GOLDEN_SUFFIX{"_fp"};
+#else
+constexpr const char* GOLDEN_SUFFIX{""};
+#endif
+
+constexpr auto CLEAR_COLOR = rtw::sw_renderer::Color{0x20'20'30'FFU};
+
+std::size_t golden_failures{0U}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+/// Compares @p image with the golden image of @p scene_name, or overwrites the golden when RTW_UPDATE_GOLDEN is
+/// set. `bazel run` starts in the runfiles tree, so updates go to BUILD_WORKSPACE_DIRECTORY when it is available.
+void check_golden(benchmark::State& state, const std::string& scene_name, const rtw::sw_renderer::ColorBuffer& image)
+{
+  const auto file_name = scene_name + GOLDEN_SUFFIX + ".ppm";
+
+  if (std::getenv("RTW_UPDATE_GOLDEN") != nullptr) // NOLINT(concurrency-mt-unsafe)
+  {
+    const auto* const workspace = std::getenv("BUILD_WORKSPACE_DIRECTORY"); // NOLINT(concurrency-mt-unsafe)
+    const auto directory = std::filesystem::path{(workspace != nullptr) ? workspace : "."} / GOLDEN_DIR;
+    std::filesystem::create_directories(directory);
+    if (!rtw::sw_renderer::write_ppm(directory / file_name, image))
+    {
+      ++golden_failures;
+      state.SkipWithError("cannot write the golden image");
+    }
+    return;
+  }
+
+  const auto golden = rtw::sw_renderer::read_ppm(std::filesystem::path{GOLDEN_DIR} / file_name);
+  if (!golden.has_value() || (golden->width() != image.width()) || (golden->height() != image.height()))
+  {
+    ++golden_failures;
+    state.SkipWithError("golden image is missing or has the wrong size");
+    return;
+  }
+
+  const auto difference = rtw::sw_renderer::compare(*golden, image, CHANNEL_TOLERANCE);
+  state.counters["differing_pixels"] = static_cast<double>(difference.differing_pixels);
+  state.counters["max_channel_delta"] = static_cast<double>(difference.max_channel_delta);
+  const auto allowed = MAX_DIFFERING_FRACTION * static_cast<double>(image.width() * image.height());
+  if (static_cast<double>(difference.differing_pixels) > allowed)
+  {
+    ++golden_failures;
+    state.SkipWithError("output differs from the golden image");
+  }
+}
+
+// --- Geometry ---------------------------------------------------------------
+
+struct SceneVertex
+{
+  std::array<float, 4> position;
+  std::array<float, 3> normal;
+  std::array<float, 2> uv;
+  std::array<float, 4> color;
+};
+
+rtw::sw_renderer::VertexLayout make_layout()
+{
+  using rtw::sw_renderer::ComponentType;
+  using rtw::sw_renderer::VertexAttribute;
+  namespace loc = rtw::sw_renderer::attribute_location;
+  return rtw::sw_renderer::VertexLayout{
+      {VertexAttribute{loc::POSITION, offsetof(SceneVertex, position), ComponentType::FLOAT32, 4U},
+       VertexAttribute{loc::NORMAL, offsetof(SceneVertex, normal), ComponentType::FLOAT32, 3U},
+       VertexAttribute{loc::UV, offsetof(SceneVertex, uv), ComponentType::FLOAT32, 2U},
+       VertexAttribute{loc::COLOR, offsetof(SceneVertex, color), ComponentType::FLOAT32, 4U}},
+      sizeof(SceneVertex)};
+}
+
+std::vector<std::uint32_t> make_checker(const std::size_t size)
+{
+  std::vector<std::uint32_t> texels(size * size);
+  for (std::size_t y = 0U; y < size; ++y)
+  {
+    for (std::size_t x = 0U; x < size; ++x)
+    {
+      const bool even = ((x ^ y) & 0x8U) == 0U;
+      texels[(y * size) + x] = even ? 0xE0'E0'E0'FFU : 0x30'60'C0'FFU;
+    }
+  }
+  return texels;
+}
+
+rtw::sw_renderer::Matrix4x4F make_projection()
+{
+  const auto params = rtw::math::make_perspective_parameters(
+      rtw::sw_renderer::AngleF{rtw::math::DEG, 60.0F},
+      static_cast<single_precision>(static_cast<float>(WIDTH) / static_cast<float>(HEIGHT)), single_precision{0.1F},
+      single_precision{100.0F});
+  return rtw::math::make_perspective_projection_matrix(params);
+}
+
+/// The model-view matrix shared by the scenes drawn from a mesh: the mesh turned towards the camera and pushed
+/// down the -Z axis.
+rtw::sw_renderer::Matrix4x4F make_model_view(const float distance)
+{
+  using namespace rtw::sw_renderer::angle_literals;
+  return rtw::math::transform3::make_transform(rtw::sw_renderer::Vector3F{1.0F, 1.0F, 1.0F},
+                                               rtw::sw_renderer::EulerAnglesF{25.0_degF, 40.0_degF, 0.0_degF},
+                                               rtw::sw_renderer::Vector3F{0.0F, 0.0F, -distance});
+}
+
+/// Expands the OBJ faces into three vertices per triangle; the V coordinate is flipped because OBJ places the
+/// texture origin bottom-left.
+std::vector<SceneVertex> interleave(const rtw::sw_renderer::Mesh& mesh)
+{
+  std::vector<SceneVertex> vertices;
+  vertices.reserve(mesh.faces.size() * 3U);
+  for (const auto& face : mesh.faces)
+  {
+    for (std::size_t i = 0U; i < 3U; ++i)
+    {
+      const auto& p = mesh.vertices[face.vertex_indices[i]];
+      SceneVertex vertex{{static_cast<float>(p.x()), static_cast<float>(p.y()), static_cast<float>(p.z()), 1.0F},
+                         {0.0F, 0.0F, 1.0F},
+                         {0.0F, 0.0F},
+                         {1.0F, 1.0F, 1.0F, 1.0F}};
+      if (face.normal_indices.has_value())
+      {
+        const auto& n = mesh.normals[(*face.normal_indices)[i]];
+        vertex.normal = {static_cast<float>(n.x()), static_cast<float>(n.y()), static_cast<float>(n.z())};
+      }
+      if (face.texture_indices.has_value())
+      {
+        const auto& uv = mesh.tex_coords[(*face.texture_indices)[i]];
+        vertex.uv = {static_cast<float>(uv.u()), 1.0F - static_cast<float>(uv.v())};
+      }
+      vertices.push_back(vertex);
+    }
+  }
+  return vertices;
+}
+
+/// A unit UV sphere with (stacks * slices * 2) outward, counter-clockwise triangles, coloured by its normal.
+/// Quads are emitted in 7x7 tiles so consecutive triangles are spatially coherent.
+struct SphereMesh
+{
+  std::vector<SceneVertex> vertices;
+  std::vector<std::uint32_t> indices;
+};
+
+SphereMesh make_sphere(const std::uint32_t stacks, const std::uint32_t slices)
+{
+  SphereMesh mesh;
+  mesh.vertices.reserve(static_cast<std::size_t>(stacks + 1U) * (slices + 1U));
+  for (std::uint32_t i = 0U; i <= stacks; ++i)
+  {
+    const auto theta = rtw::math_constants::PI<float> * static_cast<float>(i) / static_cast<float>(stacks);
+    for (std::uint32_t j = 0U; j <= slices; ++j)
+    {
+      const auto phi = 2.0F * rtw::math_constants::PI<float> * static_cast<float>(j) / static_cast<float>(slices);
+      const std::array<float, 3> n{std::sin(theta) * std::sin(phi), std::cos(theta), std::sin(theta) * std::cos(phi)};
+      mesh.vertices.push_back(SceneVertex{{n[0U], n[1U], n[2U], 1.0F},
+                                          n,
+                                          {0.0F, 0.0F},
+                                          {(n[0U] * 0.5F) + 0.5F, (n[1U] * 0.5F) + 0.5F, (n[2U] * 0.5F) + 0.5F, 1.0F}});
+    }
+  }
+
+  constexpr std::uint32_t TILE{7U};
+  const auto row = slices + 1U;
+  mesh.indices.reserve(static_cast<std::size_t>(stacks) * slices * 6U);
+  for (std::uint32_t ti = 0U; ti < stacks; ti += TILE)
+  {
+    for (std::uint32_t tj = 0U; tj < slices; tj += TILE)
+    {
+      for (std::uint32_t i = ti; i < std::min(ti + TILE, stacks); ++i)
+      {
+        for (std::uint32_t j = tj; j < std::min(tj + TILE, slices); ++j)
+        {
+          const auto a = (i * row) + j;
+          const auto b = ((i + 1U) * row) + j;
+          mesh.indices.insert(mesh.indices.end(), {a, b, b + 1U, a, b + 1U, a + 1U});
+        }
+      }
+    }
+  }
+  return mesh;
+}
+
+/// 500 x 1000 x 2 = 1M triangles.
+constexpr std::uint32_t DENSE_STACKS{500U};
+constexpr std::uint32_t DENSE_SLICES{1000U};
+
+/// Appends an axis-aligned clip-space quad (w = 1) as two counter-clockwise triangles.
+void append_quad(std::vector<SceneVertex>& vertices, const float x0, const float y0, const float x1, const float y1,
+                 const float z, const std::array<float, 4>& color)
+{
+  const auto corner = [&](const float x, const float y, const float u, const float v)
+  { return SceneVertex{{x, y, z, 1.0F}, {0.0F, 0.0F, 1.0F}, {u, v}, color}; };
+  vertices.insert(vertices.end(), {corner(x0, y0, 0.0F, 1.0F), corner(x1, y0, 1.0F, 1.0F), corner(x1, y1, 1.0F, 0.0F),
+                                   corner(x0, y0, 0.0F, 1.0F), corner(x1, y1, 1.0F, 0.0F), corner(x0, y1, 0.0F, 0.0F)});
+}
+
+// --- Scenes -----------------------------------------------------------------
+
+/// State shared by the programmable-pipeline scenes.
+class ProgrammableScene
+{
+public:
+  ProgrammableScene() : framebuffer_(WIDTH, HEIGHT)
+  {
+    state_.viewport =
+        rtw::sw_renderer::Viewport{0, 0, static_cast<std::int32_t>(WIDTH), static_cast<std::int32_t>(HEIGHT)};
+  }
+
+  const rtw::sw_renderer::ColorBuffer& image() const { return framebuffer_.color_buffer(); }
+  const rtw::sw_renderer::RenderStats& stats() const noexcept { return stats_; }
+
+protected:
+  void begin_frame()
+  {
+    framebuffer_.clear(CLEAR_COLOR, single_precision{1});
+    stats_.reset();
+  }
+
+  void draw(const rtw::sw_renderer::StandardShader& shader, const std::vector<SceneVertex>& vertices)
+  {
+    const rtw::sw_renderer::RawVertexStream stream{layout_, rtw::stl::as_bytes(rtw::stl::make_span(vertices))};
+    pipeline_.draw_arrays(shader, stream, state_, framebuffer_, stats_);
+  }
+
+  rtw::sw_renderer::FrameBuffer framebuffer_;
+  rtw::sw_renderer::Pipeline pipeline_;
+  rtw::sw_renderer::PipelineState state_;
+  rtw::sw_renderer::RenderStats stats_;
+  rtw::sw_renderer::VertexLayout layout_{make_layout()};
+};
+
+/// The textured cube resource, sampled with a procedural checker (the PNG needs SDL_image), lit, back-face culled.
+class TexturedCubeScene : public ProgrammableScene
+{
+public:
+  TexturedCubeScene()
+  {
+    const auto mesh = rtw::sw_renderer::load_obj(std::filesystem::path{"sw_renderer/resources/textured_cube.obj"});
+    if (mesh.has_value())
+    {
+      vertices_ = interleave(*mesh);
+    }
+
+    auto texels = make_checker(64U);
+    texture_ = rtw::sw_renderer::Texture{texels.data(), 64U, 64U};
+
+    state_.cull_mode = rtw::sw_renderer::CullMode::BACK;
+    const auto model_view = make_model_view(3.0F);
+    shader_.set_mvp_matrix(make_projection() * model_view);
+    shader_.set_normal_matrix(model_view);
+    shader_.set_use_texture(true);
+    shader_.set_sampler(rtw::sw_renderer::Sampler2D{texture_, rtw::sw_renderer::WrapMode::REPEAT,
+                                                    rtw::sw_renderer::FilterMode::LINEAR});
+    shader_.set_use_lighting(true);
+    shader_.set_light_direction(rtw::math::normalize(rtw::sw_renderer::Vector3F{0.0F, -0.5F, -1.0F}));
+  }
+
+  bool valid() const noexcept { return !vertices_.empty(); }
+
+  void render()
+  {
+    begin_frame();
+    draw(shader_, vertices_);
+  }
+
+private:
+  std::vector<SceneVertex> vertices_;
+  rtw::sw_renderer::Texture texture_;
+  rtw::sw_renderer::StandardShader shader_;
+};
+
+/// 32 nearly full-screen quads drawn back to front with depth testing on: every layer passes the depth test, so
+/// each pixel is shaded and written 32 times.
+class OverdrawStackScene : public ProgrammableScene
+{
+public:
+  static constexpr std::size_t LAYER_COUNT{32U};
+
+  OverdrawStackScene()
+  {
+    for (std::size_t i = 0U; i < LAYER_COUNT; ++i)
+    {
+      const auto t = static_cast<float>(i) / static_cast<float>(LAYER_COUNT - 1U);
+      const auto inset = 0.02F * static_cast<float>(i);
+      append_quad(vertices_, -0.98F + inset, -0.98F + inset, 0.98F - (inset * 0.5F), 0.98F - (inset * 0.5F),
+                  0.9F - (1.8F * t), {t, 0.5F, 1.0F - t, 1.0F});
+    }
+    shader_.set_use_vertex_color(true);
+  }
+
+  bool valid() const noexcept { return true; }
+
+  void render()
+  {
+    begin_frame();
+    draw(shader_, vertices_);
+  }
+
+private:
+  std::vector<SceneVertex> vertices_;
+  rtw::sw_renderer::StandardShader shader_;
+};
+
+/// Two fans of 1024 one-third-of-a-degree slivers each: almost every triangle covers a handful of pixels or none,
+/// so the cost is dominated by setup and the fill rules on shared edges.
+class SliverFansScene : public ProgrammableScene
+{
+public:
+  static constexpr std::size_t SLIVERS_PER_FAN{1024U};
+
+  SliverFansScene()
+  {
+    for (const auto center_x : {-0.45F, 0.45F})
+    {
+      for (std::size_t i = 0U; i < SLIVERS_PER_FAN; ++i)
+      {
+        const auto step = 2.0F * rtw::math_constants::PI<float> / static_cast<float>(SLIVERS_PER_FAN);
+        const auto a0 = step * static_cast<float>(i);
+        const auto a1 = a0 + step;
+        const auto t = static_cast<float>(i) / static_cast<float>(SLIVERS_PER_FAN);
+        const std::array<float, 4> color{t, 1.0F - t, (i % 2U == 0U) ? 1.0F : 0.2F, 1.0F};
+        const auto vertex = [&](const float x, const float y)
+        { return SceneVertex{{x, y, 0.0F, 1.0F}, {0.0F, 0.0F, 1.0F}, {0.0F, 0.0F}, color}; };
+        vertices_.insert(vertices_.end(), {vertex(center_x, 0.0F),
+                                           vertex(center_x + (0.42F * std::cos(a0)), 0.9F * std::sin(a0)),
+                                           vertex(center_x + (0.42F * std::cos(a1)), 0.9F * std::sin(a1))});
+      }
+    }
+    shader_.set_use_vertex_color(true);
+  }
+
+  bool valid() const noexcept { return true; }
+
+  void render()
+  {
+    begin_frame();
+    draw(shader_, vertices_);
+  }
+
+private:
+  std::vector<SceneVertex> vertices_;
+  rtw::sw_renderer::StandardShader shader_;
+};
+
+/// 4096 small translucent quads with source-over blending and no depth test, drawn in a fixed pseudo-random
+/// order: the read-modify-write blend path.
+class BlendedParticlesScene : public ProgrammableScene
+{
+public:
+  static constexpr std::size_t PARTICLE_COUNT{4096U};
+
+  BlendedParticlesScene()
+  {
+    std::mt19937 rng{1234U};
+    std::uniform_real_distribution<float> position{-1.0F, 1.0F};
+    std::uniform_real_distribution<float> size{0.03F, 0.12F};
+    std::uniform_real_distribution<float> channel{0.2F, 1.0F};
+    for (std::size_t i = 0U; i < PARTICLE_COUNT; ++i)
+    {
+      const auto x = position(rng);
+      const auto y = position(rng);
+      const auto half = size(rng);
+      const std::array<float, 4> color{channel(rng), channel(rng), channel(rng), 0.25F};
+      append_quad(vertices_, x - half, y - half, x + half, y + half, 0.0F, color);
+    }
+
+    state_.depth_test_enabled = false;
+    state_.depth_write_enabled = false;
+    state_.blend.enabled = true;
+    state_.blend.src_rgb = rtw::sw_renderer::BlendFactor::SRC_ALPHA;
+    state_.blend.dst_rgb = rtw::sw_renderer::BlendFactor::ONE_MINUS_SRC_ALPHA;
+    state_.blend.src_alpha = rtw::sw_renderer::BlendFactor::ONE;
+    state_.blend.dst_alpha = rtw::sw_renderer::BlendFactor::ONE_MINUS_SRC_ALPHA;
+    shader_.set_use_vertex_color(true);
+  }
+
+  bool valid() const noexcept { return true; }
+
+  void render()
+  {
+    begin_frame();
+    draw(shader_, vertices_);
+  }
+
+private:
+  std::vector<SceneVertex> vertices_;
+  rtw::sw_renderer::StandardShader shader_;
+};
+
+/// A 1M-triangle lit sphere drawn with indices: vertex throughput, with most triangles smaller than a pixel.
+class DenseMeshScene : public ProgrammableScene
+{
+public:
+  DenseMeshScene() : mesh_(make_sphere(DENSE_STACKS, DENSE_SLICES)), indices_(mesh_.indices)
+  {
+    state_.cull_mode = rtw::sw_renderer::CullMode::BACK;
+    const auto model_view = make_model_view(2.5F);
+    shader_.set_mvp_matrix(make_projection() * model_view);
+    shader_.set_normal_matrix(model_view);
+    shader_.set_use_vertex_color(true);
+    shader_.set_use_lighting(true);
+    shader_.set_light_direction(rtw::math::normalize(rtw::sw_renderer::Vector3F{0.0F, -0.5F, -1.0F}));
+  }
+
+  bool valid() const noexcept { return true; }
+
+  void render()
+  {
+    begin_frame();
+    const rtw::sw_renderer::RawVertexStream stream{layout_, rtw::stl::as_bytes(rtw::stl::make_span(mesh_.vertices))};
+    pipeline_.draw_elements(shader_, stream, indices_, state_, framebuffer_, stats_);
+  }
+
+private:
+  SphereMesh mesh_;
+  rtw::sw_renderer::IndexBuffer indices_;
+  rtw::sw_renderer::StandardShader shader_;
+};
+
+/// State shared by the fixed-function `Renderer` scenes, which draw a `Mesh` with the renderer's own projection.
+class FixedScene
+{
+public:
+  FixedScene() : renderer_(WIDTH, HEIGHT)
+  {
+    renderer_.set_render_mode(rtw::sw_renderer::RenderMode::FACE_CULLING | rtw::sw_renderer::RenderMode::LIGHT
+                              | rtw::sw_renderer::RenderMode::STATS);
+  }
+
+  bool valid() const noexcept { return !mesh_.faces.empty(); }
+
+  void set_thread_count(const std::size_t count) { renderer_.set_thread_count(count); }
+
+  void render()
+  {
+    renderer_.clear(CLEAR_COLOR);
+    renderer_.draw_mesh(mesh_, model_view_);
+  }
+
+  const rtw::sw_renderer::ColorBuffer& image() const { return renderer_.color_buffer(); }
+  const rtw::sw_renderer::RenderStats& stats() const noexcept { return renderer_.stats(); }
+
+protected:
+  rtw::sw_renderer::Renderer renderer_;
+  rtw::sw_renderer::Mesh mesh_;
+  rtw::sw_renderer::Matrix4x4F model_view_;
+};
+
+/// The textured cube resource through the fixed-function renderer, with the procedural checker substituted for the
+/// PNG diffuse map.
+class FixedTexturedCubeScene : public FixedScene
+{
+public:
+  FixedTexturedCubeScene()
+  {
+    auto mesh = rtw::sw_renderer::load_obj(std::filesystem::path{"sw_renderer/resources/textured_cube.obj"});
+    if (!mesh.has_value())
+    {
+      return;
+    }
+    mesh_ = std::move(*mesh);
+
+    auto texels = make_checker(64U);
+    for (const auto& [name, material] : mesh_.materials)
+    {
+      if (!material.diffuse_texture.empty())
+      {
+        mesh_.textures[material.diffuse_texture] = rtw::sw_renderer::Texture{texels.data(), 64U, 64U};
+      }
+    }
+    renderer_.set_texture_enabled(true);
+    model_view_ = make_model_view(3.0F);
+  }
+};
+
+/// The 1M-triangle sphere through the fixed-function renderer, flat shaded.
+class FixedDenseMeshScene : public FixedScene
+{
+public:
+  FixedDenseMeshScene()
+  {
+    const auto sphere = make_sphere(DENSE_STACKS, DENSE_SLICES);
+    mesh_.vertices.reserve(sphere.vertices.size());
+    mesh_.normals.reserve(sphere.vertices.size());
+    for (const auto& vertex : sphere.vertices)
+    {
+      mesh_.vertices.emplace_back(vertex.position[0U], vertex.position[1U], vertex.position[2U]);
+      mesh_.normals.emplace_back(vertex.normal[0U], vertex.normal[1U], vertex.normal[2U]);
+    }
+
+    rtw::sw_renderer::Material material;
+    material.name = "sphere";
+    material.diffuse = rtw::sw_renderer::Color{0xD0'A0'60'FFU};
+    mesh_.materials[material.name] = material;
+
+    mesh_.faces.reserve(sphere.indices.size() / 3U);
+    for (std::size_t i = 0U; i < sphere.indices.size(); i += 3U)
+    {
+      const rtw::sw_renderer::Index index{sphere.indices[i], sphere.indices[i + 1U], sphere.indices[i + 2U]};
+      mesh_.faces.push_back(rtw::sw_renderer::Face{index, std::nullopt, index, material.name});
+    }
+
+    renderer_.set_shading_enabled(true);
+    model_view_ = make_model_view(2.5F);
+  }
+};
+
+template <typename SceneT>
+void run_scene(benchmark::State& state, const std::string& scene_name)
+{
+  SceneT scene;
+  if (!scene.valid())
+  {
+    ++golden_failures;
+    state.SkipWithError("cannot set up the scene (missing resources?)");
+    return;
+  }
+  if constexpr (std::is_base_of_v<FixedScene, SceneT>)
+  {
+    // The parallel draw must reproduce the serial image, so every thread count checks against the same golden.
+    scene.set_thread_count(static_cast<std::size_t>(state.range(0)));
+  }
+
+  for (auto _ : state)
+  {
+    scene.render();
+    benchmark::DoNotOptimize(scene.image().data());
+    benchmark::ClobberMemory();
+  }
+  state.counters["triangles_rendered"] = static_cast<double>(scene.stats().triangles_rendered);
+  check_golden(state, scene_name, scene.image());
+}
+
+void bm_golden_textured_cube(benchmark::State& state) { run_scene<TexturedCubeScene>(state, "textured_cube"); }
+void bm_golden_overdraw_stack(benchmark::State& state) { run_scene<OverdrawStackScene>(state, "overdraw_stack"); }
+void bm_golden_sliver_fans(benchmark::State& state) { run_scene<SliverFansScene>(state, "sliver_fans"); }
+void bm_golden_blended_particles(benchmark::State& state)
+{
+  run_scene<BlendedParticlesScene>(state, "blended_particles");
+}
+void bm_golden_dense_mesh(benchmark::State& state) { run_scene<DenseMeshScene>(state, "dense_mesh"); }
+
+void bm_golden_fixed_textured_cube(benchmark::State& state)
+{
+  run_scene<FixedTexturedCubeScene>(state, "fixed_textured_cube");
+}
+void bm_golden_fixed_dense_mesh(benchmark::State& state) { run_scene<FixedDenseMeshScene>(state, "fixed_dense_mesh"); }
+
+} // namespace
+
+BENCHMARK(bm_golden_textured_cube)->Unit(benchmark::kMicrosecond);
+BENCHMARK(bm_golden_overdraw_stack)->Unit(benchmark::kMicrosecond);
+BENCHMARK(bm_golden_sliver_fans)->Unit(benchmark::kMicrosecond);
+BENCHMARK(bm_golden_blended_particles)->Unit(benchmark::kMicrosecond);
+BENCHMARK(bm_golden_dense_mesh)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(bm_golden_fixed_textured_cube)->ArgName("threads")->Arg(1)->Arg(4)->Unit(benchmark::kMicrosecond);
+BENCHMARK(bm_golden_fixed_dense_mesh)->ArgName("threads")->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+  {
+    return EXIT_FAILURE;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return (golden_failures == 0U) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
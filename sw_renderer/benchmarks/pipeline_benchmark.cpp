@@ -1,10 +1,19 @@
+#include "constants/math_constants.h"
 #include "sw_renderer/color.h"
+#include "sw_renderer/color_buffer.h"
 #include "sw_renderer/fixed_pipeline/renderer.h"
 #include "sw_renderer/programmable_pipeline/builtin_shaders.h"
+#include "sw_renderer/programmable_pipeline/deferred_lighting.h"
+#include "sw_renderer/programmable_pipeline/dynamic_resolution.h"
 #include "sw_renderer/programmable_pipeline/frame_buffer.h"
+#include "sw_renderer/programmable_pipeline/meshlet.h"
+#include "sw_renderer/programmable_pipeline/multisample.h"
+#include "sw_renderer/programmable_pipeline/occlusion_query.h"
 #include "sw_renderer/programmable_pipeline/pipeline.h"
 #include "sw_renderer/programmable_pipeline/pipeline_state.h"
+#include "sw_renderer/programmable_pipeline/point_light.h"
 #include "sw_renderer/programmable_pipeline/sampler.h"
+#include "sw_renderer/programmable_pipeline/shading_rate.h"
 #include "sw_renderer/programmable_pipeline/vertex_layout.h"
 #include "sw_renderer/programmable_pipeline/vertex_stream.h"
 #include "sw_renderer/render_stats.h"
@@ -12,13 +21,19 @@
 #include "sw_renderer/types.h"
 #include "sw_renderer/vertex.h"
 
+#include "math/frustum.h"
+
 #include "stl/span.h"
 
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdlib>
 #include <cstddef>
 #include <cstdint>
+#include <utility>
 #include <vector>
 
 namespace
@@ -179,6 +194,617 @@ void bm_pipeline_standard_textured_lit(benchmark::State& state)
   run(state, shader, false);
 }
 
+/// A dense UV sphere (outward, counter-clockwise triangles) whose quads are emitted in 7x7 tiles so that
+/// consecutive triangles are spatially coherent, as a mesh-optimised asset would be.
+struct DenseMesh
+{
+  std::vector<BenchVertex> vertices;
+  std::vector<std::uint32_t> indices;
+};
+
+DenseMesh make_dense_sphere(const std::uint32_t stacks, const std::uint32_t slices)
+{
+  DenseMesh mesh;
+  mesh.vertices.reserve(static_cast<std::size_t>(stacks + 1U) * (slices + 1U));
+  for (std::uint32_t i = 0U; i <= stacks; ++i)
+  {
+    const auto theta = rtw::math_constants::PI<float> * static_cast<float>(i) / static_cast<float>(stacks);
+    for (std::uint32_t j = 0U; j <= slices; ++j)
+    {
+      const auto phi = 2.0F * rtw::math_constants::PI<float> * static_cast<float>(j) / static_cast<float>(slices);
+      const std::array<float, 3> n{std::sin(theta) * std::sin(phi), std::cos(theta), std::sin(theta) * std::cos(phi)};
+      mesh.vertices.push_back(BenchVertex{{n[0U], n[1U], n[2U], 1.0F}, n, {0.0F, 0.0F}});
+    }
+  }
+
+  constexpr std::uint32_t TILE{7U};
+  const auto row = slices + 1U;
+  mesh.indices.reserve(static_cast<std::size_t>(stacks) * slices * 6U);
+  for (std::uint32_t ti = 0U; ti < stacks; ti += TILE)
+  {
+    for (std::uint32_t tj = 0U; tj < slices; tj += TILE)
+    {
+      for (std::uint32_t i = ti; i < std::min(ti + TILE, stacks); ++i)
+      {
+        for (std::uint32_t j = tj; j < std::min(tj + TILE, slices); ++j)
+        {
+          const auto a = (i * row) + j;
+          const auto b = ((i + 1U) * row) + j;
+          mesh.indices.insert(mesh.indices.end(), {a, b, b + 1U, a, b + 1U, a + 1U});
+        }
+      }
+    }
+  }
+  return mesh;
+}
+
+/// A perspective view of the unit sphere shifted right so that roughly half of it hangs off the screen.
+rtw::sw_renderer::Matrix4x4F make_offscreen_mvp()
+{
+  using rtw::sw_renderer::single_precision;
+  const auto params = rtw::math::make_perspective_parameters(rtw::sw_renderer::AngleF{rtw::math::DEG, 60.0F},
+                                                             single_precision{1}, single_precision{0.1F},
+                                                             single_precision{100.0F});
+  auto model = rtw::sw_renderer::Matrix4x4F::identity();
+  model(0U, 3U) = single_precision{1.2F};
+  model(2U, 3U) = single_precision{-2.5F};
+  return rtw::math::make_perspective_projection_matrix(params) * model;
+}
+
+/// Dense mesh, partially off-screen, back-face culling on: the baseline shades every vertex and clips/culls
+/// triangle by triangle; the meshlet path rejects whole clusters before the vertex shader runs.
+void run_dense_mesh(benchmark::State& state, const bool meshlets)
+{
+  const auto mesh = make_dense_sphere(192U, 384U);
+  const rtw::sw_renderer::RawVertexStream stream{make_layout(),
+                                                 rtw::stl::as_bytes(rtw::stl::make_span(mesh.vertices))};
+  const rtw::sw_renderer::IndexBuffer indices{mesh.indices};
+  const auto meshlet_mesh = rtw::sw_renderer::build_meshlets(stream, indices);
+
+  auto pipeline_state = make_state();
+  pipeline_state.depth_test_enabled = true;
+  pipeline_state.cull_mode = rtw::sw_renderer::CullMode::BACK;
+  auto shader = make_flat_shader();
+  shader.set_mvp_matrix(make_offscreen_mvp());
+
+  rtw::sw_renderer::FrameBuffer framebuffer{WIDTH, HEIGHT};
+  rtw::sw_renderer::Pipeline pipeline;
+  rtw::sw_renderer::RenderStats stats;
+  for (auto _ : state)
+  {
+    stats.reset();
+    framebuffer.clear(rtw::sw_renderer::Color{}, single_precision{1});
+    if (meshlets)
+    {
+      pipeline.draw_meshlets(shader, stream, meshlet_mesh, pipeline_state, framebuffer, stats);
+    }
+    else
+    {
+      pipeline.draw_elements(shader, stream, indices, pipeline_state, framebuffer, stats);
+    }
+    benchmark::DoNotOptimize(framebuffer.color_buffer().data());
+    benchmark::ClobberMemory();
+  }
+  state.counters["triangles_submitted"] = static_cast<double>(stats.triangles_submitted);
+  state.counters["meshlets_culled"] = static_cast<double>(stats.meshlets_culled);
+  state.counters["meshlets"] = static_cast<double>(meshlet_mesh.meshlets.size());
+}
+
+constexpr std::size_t OVERDRAW_LAYERS{8U};
+
+/// OVERDRAW_LAYERS full-screen triangles at increasing depth, flat shaded, with the depth test on. Drawn front to
+/// back (range(1) == 0) all but the first layer fail the test, so the depth reads dominate; back to front every
+/// layer passes and writes depth. range(0) selects the DepthFormat; reversed-Z (range(2)) swaps the depth range,
+/// the test and the clear value.
+void bm_pipeline_overdraw(benchmark::State& state)
+{
+  const auto format = static_cast<rtw::sw_renderer::DepthFormat>(state.range(0));
+  const bool back_to_front = state.range(1) != 0;
+  const bool reversed_z = state.range(2) != 0;
+
+  std::vector<std::vector<BenchVertex>> layers;
+  for (std::size_t layer = 0U; layer < OVERDRAW_LAYERS; ++layer)
+  {
+    const auto depth = -0.9F + (1.8F * static_cast<float>(back_to_front ? (OVERDRAW_LAYERS - 1U - layer) : layer)
+                                / static_cast<float>(OVERDRAW_LAYERS));
+    auto vertices = full_screen_triangle();
+    for (auto& vertex : vertices)
+    {
+      vertex.position[2U] = depth;
+    }
+    layers.push_back(std::move(vertices));
+  }
+  std::vector<rtw::sw_renderer::RawVertexStream> streams;
+  for (const auto& layer : layers)
+  {
+    streams.emplace_back(make_layout(), rtw::stl::as_bytes(rtw::stl::make_span(layer)));
+  }
+
+  auto pipeline_state = make_state();
+  pipeline_state.depth_test_enabled = true;
+  if (reversed_z)
+  {
+    pipeline_state.depth_range = rtw::sw_renderer::DepthRange::reversed();
+    pipeline_state.depth_func = rtw::sw_renderer::DepthFunc::GREATER;
+  }
+  const auto clear_depth = reversed_z ? single_precision{0} : single_precision{1};
+  const auto shader = make_flat_shader();
+
+  rtw::sw_renderer::FrameBuffer framebuffer{WIDTH, HEIGHT, format};
+  rtw::sw_renderer::Pipeline pipeline;
+  rtw::sw_renderer::RenderStats stats;
+  for (auto _ : state)
+  {
+    framebuffer.clear(rtw::sw_renderer::Color{}, clear_depth);
+    for (const auto& stream : streams)
+    {
+      pipeline.draw_arrays(shader, stream, pipeline_state, framebuffer, stats);
+    }
+    benchmark::DoNotOptimize(framebuffer.color_buffer().data());
+    benchmark::ClobberMemory();
+  }
+  state.counters["depth_bytes"] = static_cast<double>(framebuffer.depth_buffer().bytes_per_depth());
+}
+
+/// Anti-aliasing modes of bm_pipeline_antialiasing.
+enum class AntiAliasing : std::uint8_t
+{
+  NONE = 0U,
+  MSAA_4X,
+  SSAA_4X, ///< Render at twice the width and height, then average 2x2 blocks.
+};
+
+/// A lit sphere, partially off-screen, with the depth test on, rendered with range(0) as the AntiAliasing mode.
+/// Each iteration includes the clear and the resolve (the MSAA resolve or the SSAA 2x2 downsample), so the numbers
+/// compare whole frames.
+void bm_pipeline_antialiasing(benchmark::State& state)
+{
+  const auto mode = static_cast<AntiAliasing>(state.range(0));
+  const auto mesh = make_dense_sphere(12U, 24U);
+  const rtw::sw_renderer::RawVertexStream stream{make_layout(),
+                                                 rtw::stl::as_bytes(rtw::stl::make_span(mesh.vertices))};
+  const rtw::sw_renderer::IndexBuffer indices{mesh.indices};
+
+  const std::size_t scale = (mode == AntiAliasing::SSAA_4X) ? 2U : 1U;
+  auto pipeline_state = make_state();
+  pipeline_state.viewport = rtw::sw_renderer::Viewport{0, 0, static_cast<std::int32_t>(WIDTH * scale),
+                                                       static_cast<std::int32_t>(HEIGHT * scale)};
+  pipeline_state.depth_test_enabled = true;
+  pipeline_state.cull_mode = rtw::sw_renderer::CullMode::BACK;
+  auto shader = make_lit_shader();
+  shader.set_mvp_matrix(make_offscreen_mvp());
+
+  rtw::sw_renderer::FrameBuffer framebuffer{WIDTH * scale, HEIGHT * scale, rtw::sw_renderer::DepthFormat::D32F,
+                                            (mode == AntiAliasing::MSAA_4X) ? rtw::sw_renderer::SampleCount::X4
+                                                                            : rtw::sw_renderer::SampleCount::X1};
+  rtw::sw_renderer::ColorBuffer downsampled{WIDTH, HEIGHT};
+  rtw::sw_renderer::Pipeline pipeline;
+  rtw::sw_renderer::RenderStats stats;
+  for (auto _ : state)
+  {
+    framebuffer.clear(rtw::sw_renderer::Color{}, single_precision{1});
+    pipeline.draw_elements(shader, stream, indices, pipeline_state, framebuffer, stats);
+    framebuffer.resolve();
+    if (mode == AntiAliasing::SSAA_4X)
+    {
+      const auto& source = framebuffer.color_buffer();
+      for (std::size_t y = 0U; y < HEIGHT; ++y)
+      {
+        for (std::size_t x = 0U; x < WIDTH; ++x)
+        {
+          const std::array<std::uint32_t, 4U> block{
+              source.pixel(2U * x, 2U * y).rgba, source.pixel((2U * x) + 1U, 2U * y).rgba,
+              source.pixel(2U * x, (2U * y) + 1U).rgba, source.pixel((2U * x) + 1U, (2U * y) + 1U).rgba};
+          std::uint32_t resolved = 0U;
+          for (std::uint32_t shift = 0U; shift < 32U; shift += 8U)
+          {
+            std::uint32_t sum = 2U;
+            for (const auto rgba : block)
+            {
+              sum += (rgba >> shift) & 0xFFU;
+            }
+            resolved |= (sum / 4U) << shift;
+          }
+          downsampled.set_pixel(x, y, rtw::sw_renderer::Color{resolved});
+        }
+      }
+      benchmark::DoNotOptimize(downsampled.data());
+    }
+    benchmark::DoNotOptimize(framebuffer.color_buffer().data());
+    benchmark::ClobberMemory();
+  }
+  std::size_t expanded = 0U;
+  if (framebuffer.is_multisampled())
+  {
+    for (std::size_t y = 0U; y < HEIGHT; ++y)
+    {
+      for (std::size_t x = 0U; x < WIDTH; ++x)
+      {
+        expanded += framebuffer.is_expanded(x, y) ? 1U : 0U;
+      }
+    }
+  }
+  state.counters["expanded_pixels"] = static_cast<double>(expanded);
+}
+
+/// Mean absolute per-channel difference of two equally sized colour buffers, in 8-bit steps.
+double mean_channel_error(const rtw::sw_renderer::ColorBuffer& lhs, const rtw::sw_renderer::ColorBuffer& rhs)
+{
+  std::uint64_t sum = 0U;
+  for (std::size_t y = 0U; y < lhs.height(); ++y)
+  {
+    for (std::size_t x = 0U; x < lhs.width(); ++x)
+    {
+      const auto a = lhs.pixel(x, y).rgba;
+      const auto b = rhs.pixel(x, y).rgba;
+      for (std::uint32_t shift = 0U; shift < 32U; shift += 8U)
+      {
+        const auto ca = static_cast<std::int32_t>((a >> shift) & 0xFFU);
+        const auto cb = static_cast<std::int32_t>((b >> shift) & 0xFFU);
+        sum += static_cast<std::uint64_t>(std::abs(ca - cb));
+      }
+    }
+  }
+  return static_cast<double>(sum) / static_cast<double>(lhs.size() * 4U);
+}
+
+/// A full-screen, bilinearly textured and lit triangle (fragment-bound, with detail for the upscale to lose)
+/// rendered at a reduced resolution and upscaled to WIDTH x HEIGHT. range(0) is the scale in percent, or 0 to let a
+/// Mode::DETERMINISTIC controller pick it for a budget of half the full-resolution cost; range(1) is the
+/// UpscaleFilter. Each iteration includes the clear, the draw and the upscale; `error` is the mean per-channel
+/// difference from the full-resolution frame.
+void bm_pipeline_dynamic_resolution(benchmark::State& state)
+{
+  const auto vertices = full_screen_triangle();
+  const rtw::sw_renderer::RawVertexStream stream{make_layout(), rtw::stl::as_bytes(rtw::stl::make_span(vertices))};
+  auto pipeline_state = make_state();
+  const auto texels = make_checker(64U);
+  rtw::sw_renderer::Texture texture{const_cast<std::uint32_t*>(texels.data()), 64U, 64U};
+  rtw::sw_renderer::StandardShader shader;
+  shader.set_use_texture(true);
+  shader.set_sampler(
+      rtw::sw_renderer::Sampler2D{texture, rtw::sw_renderer::WrapMode::REPEAT, rtw::sw_renderer::FilterMode::LINEAR});
+  shader.set_use_lighting(true);
+  shader.set_light_direction(rtw::sw_renderer::Vector3F{0.0F, 0.0F, -1.0F});
+
+  rtw::sw_renderer::FrameBuffer framebuffer{WIDTH, HEIGHT};
+  rtw::sw_renderer::Pipeline pipeline;
+  rtw::sw_renderer::RenderStats stats;
+  const auto render = [&](const rtw::sw_renderer::Viewport& viewport)
+  {
+    stats.reset();
+    pipeline_state.viewport = viewport;
+    framebuffer.clear(rtw::sw_renderer::Color{}, single_precision{1});
+    pipeline.draw_arrays(shader, stream, pipeline_state, framebuffer, stats);
+  };
+
+  // The full-resolution frame is the quality reference and, in controller mode, sets the budget.
+  rtw::sw_renderer::DynamicResolution controller{WIDTH, HEIGHT, rtw::sw_renderer::DynamicResolution::Config{},
+                                                 rtw::sw_renderer::DynamicResolution::Mode::DETERMINISTIC};
+  render(controller.viewport());
+  rtw::sw_renderer::ColorBuffer reference{WIDTH, HEIGHT};
+  rtw::sw_renderer::upscale(framebuffer.color_buffer(), WIDTH, HEIGHT, reference,
+                            rtw::sw_renderer::UpscaleFilter::NEAREST);
+
+  const auto percent = state.range(0);
+  if (percent == 0)
+  {
+    controller.set_target_ms(controller.modelled_ms(stats) * 0.5F);
+  }
+  else
+  {
+    controller.set_scale(static_cast<float>(percent) / 100.0F);
+  }
+
+  const auto filter = static_cast<rtw::sw_renderer::UpscaleFilter>(state.range(1));
+  rtw::sw_renderer::ColorBuffer presentation{WIDTH, HEIGHT};
+  for (auto _ : state)
+  {
+    render(controller.viewport());
+    rtw::sw_renderer::upscale(framebuffer.color_buffer(), controller.render_width(), controller.render_height(),
+                              presentation, filter);
+    if (percent == 0)
+    {
+      controller.update(0.0F, stats);
+    }
+    benchmark::DoNotOptimize(presentation.data());
+    benchmark::ClobberMemory();
+  }
+  state.counters["scale"] = static_cast<double>(controller.scale());
+  state.counters["fragments"] = static_cast<double>(stats.fragments_shaded);
+  state.counters["error"] = mean_channel_error(presentation, reference);
+}
+
+/// Shading rates of bm_pipeline_shading_rate; FOVEATED uses a ShadingRateImage.
+enum class ShadingRateMode : std::uint8_t
+{
+  RATE_1X1 = 0U,
+  RATE_2X1,
+  RATE_2X2,
+  RATE_4X4,
+  FOVEATED, ///< 1x1 in the central quarter of the screen, 2x2 around it and 4x4 in the corners.
+};
+
+/// The textured, lit full-screen pass of bm_pipeline_dynamic_resolution at full resolution with range(0) as the
+/// ShadingRateMode. `error` is the mean per-channel difference from the 1x1 frame.
+void bm_pipeline_shading_rate(benchmark::State& state)
+{
+  const auto vertices = full_screen_triangle();
+  const rtw::sw_renderer::RawVertexStream stream{make_layout(), rtw::stl::as_bytes(rtw::stl::make_span(vertices))};
+  const auto texels = make_checker(64U);
+  rtw::sw_renderer::Texture texture{const_cast<std::uint32_t*>(texels.data()), 64U, 64U};
+  rtw::sw_renderer::StandardShader shader;
+  shader.set_use_texture(true);
+  shader.set_sampler(
+      rtw::sw_renderer::Sampler2D{texture, rtw::sw_renderer::WrapMode::REPEAT, rtw::sw_renderer::FilterMode::LINEAR});
+  shader.set_use_lighting(true);
+  shader.set_light_direction(rtw::sw_renderer::Vector3F{0.0F, 0.0F, -1.0F});
+
+  rtw::sw_renderer::ShadingRateImage foveated{WIDTH, HEIGHT};
+  for (std::size_t y = 0U; y < foveated.tiles_y(); ++y)
+  {
+    for (std::size_t x = 0U; x < foveated.tiles_x(); ++x)
+    {
+      // Chebyshev distance of the tile from the centre, in quarters of the screen.
+      const auto dx = std::abs((2 * static_cast<std::int64_t>(x)) + 1 - static_cast<std::int64_t>(foveated.tiles_x()));
+      const auto dy = std::abs((2 * static_cast<std::int64_t>(y)) + 1 - static_cast<std::int64_t>(foveated.tiles_y()));
+      const auto ring = (std::max(dx, dy) * 4) / static_cast<std::int64_t>(foveated.tiles_x());
+      foveated.set_tile_rate(x, y,
+                             (ring < 1)   ? rtw::sw_renderer::ShadingRate::RATE_1X1
+                             : (ring < 3) ? rtw::sw_renderer::ShadingRate::RATE_2X2
+                                          : rtw::sw_renderer::ShadingRate::RATE_4X4);
+    }
+  }
+
+  auto pipeline_state = make_state();
+  rtw::sw_renderer::FrameBuffer framebuffer{WIDTH, HEIGHT};
+  rtw::sw_renderer::Pipeline pipeline;
+  rtw::sw_renderer::RenderStats stats;
+  const auto render = [&]
+  {
+    stats.reset();
+    framebuffer.clear(rtw::sw_renderer::Color{}, single_precision{1});
+    pipeline.draw_arrays(shader, stream, pipeline_state, framebuffer, stats);
+  };
+
+  render();
+  rtw::sw_renderer::ColorBuffer reference{WIDTH, HEIGHT};
+  rtw::sw_renderer::upscale(framebuffer.color_buffer(), WIDTH, HEIGHT, reference,
+                            rtw::sw_renderer::UpscaleFilter::NEAREST);
+
+  const auto mode = static_cast<ShadingRateMode>(state.range(0));
+  if (mode == ShadingRateMode::FOVEATED)
+  {
+    pipeline_state.shading_rate_image = &foveated;
+  }
+  else
+  {
+    pipeline_state.shading_rate = static_cast<rtw::sw_renderer::ShadingRate>(mode);
+  }
+  for (auto _ : state)
+  {
+    render();
+    benchmark::DoNotOptimize(framebuffer.color_buffer().data());
+    benchmark::ClobberMemory();
+  }
+  state.counters["fragments"] = static_cast<double>(stats.fragments_shaded);
+  state.counters["error"] = mean_channel_error(framebuffer.color_buffer(), reference);
+}
+
+/// The 12 triangles of the [-1, 1]^3 cube bounding the unit sphere, as an occlusion query proxy.
+std::vector<BenchVertex> bounding_box_proxy()
+{
+  const auto corner = [](const std::uint32_t bits)
+  {
+    return BenchVertex{{((bits & 1U) != 0U) ? 1.0F : -1.0F, ((bits & 2U) != 0U) ? 1.0F : -1.0F,
+                        ((bits & 4U) != 0U) ? 1.0F : -1.0F, 1.0F},
+                       {0.0F, 0.0F, 0.0F},
+                       {0.0F, 0.0F}};
+  };
+  constexpr std::array<std::array<std::uint32_t, 4U>, 6U> FACES{{
+      {0U, 1U, 3U, 2U},
+      {4U, 5U, 7U, 6U},
+      {0U, 1U, 5U, 4U},
+      {2U, 3U, 7U, 6U},
+      {0U, 2U, 6U, 4U},
+      {1U, 3U, 7U, 5U},
+  }};
+  std::vector<BenchVertex> vertices;
+  for (const auto& face : FACES)
+  {
+    for (const auto index : {face[0U], face[1U], face[2U], face[0U], face[2U], face[3U]})
+    {
+      vertices.push_back(corner(index));
+    }
+  }
+  return vertices;
+}
+
+/// A lit dense sphere in the middle of the screen, behind a full-screen wall when range(1) != 0. range(0) == 0
+/// draws the sphere directly; range(0) == 1 first draws its bounding box into an occlusion query, with colour and
+/// depth writes off, and draws the sphere under conditional rendering. Hidden, the sphere is skipped before any of
+/// its vertices is shaded; visible, the proxy is the overhead.
+void bm_pipeline_occlusion_query(benchmark::State& state)
+{
+  const bool use_query = state.range(0) != 0;
+  const bool occluded = state.range(1) != 0;
+
+  const auto mesh = make_dense_sphere(192U, 384U);
+  const rtw::sw_renderer::RawVertexStream sphere{make_layout(), rtw::stl::as_bytes(rtw::stl::make_span(mesh.vertices))};
+  const rtw::sw_renderer::IndexBuffer indices{mesh.indices};
+  const auto proxy_vertices = bounding_box_proxy();
+  const rtw::sw_renderer::RawVertexStream proxy{make_layout(),
+                                                rtw::stl::as_bytes(rtw::stl::make_span(proxy_vertices))};
+  // Already in clip space at NDC z 0, i.e. well in front of the sphere.
+  const auto wall_vertices = full_screen_triangle();
+  const rtw::sw_renderer::RawVertexStream wall{make_layout(), rtw::stl::as_bytes(rtw::stl::make_span(wall_vertices))};
+
+  const auto params = rtw::math::make_perspective_parameters(rtw::sw_renderer::AngleF{rtw::math::DEG, 60.0F},
+                                                             single_precision{1}, single_precision{0.1F},
+                                                             single_precision{100.0F});
+  auto model = rtw::sw_renderer::Matrix4x4F::identity();
+  model(2U, 3U) = single_precision{-4.0F};
+  const auto mvp = rtw::math::make_perspective_projection_matrix(params) * model;
+  auto sphere_shader = make_lit_shader();
+  sphere_shader.set_mvp_matrix(mvp);
+  auto proxy_shader = make_flat_shader();
+  proxy_shader.set_mvp_matrix(mvp);
+  const auto wall_shader = make_flat_shader();
+
+  auto pipeline_state = make_state();
+  pipeline_state.depth_test_enabled = true;
+  pipeline_state.cull_mode = rtw::sw_renderer::CullMode::BACK;
+  auto proxy_state = pipeline_state;
+  proxy_state.cull_mode = rtw::sw_renderer::CullMode::NONE;
+  proxy_state.color_mask = rtw::sw_renderer::ColorMask{false, false, false, false};
+  proxy_state.depth_write_enabled = false;
+
+  rtw::sw_renderer::FrameBuffer framebuffer{WIDTH, HEIGHT};
+  rtw::sw_renderer::Pipeline pipeline;
+  rtw::sw_renderer::RenderStats stats;
+  rtw::sw_renderer::OcclusionQuery query;
+  for (auto _ : state)
+  {
+    stats.reset();
+    framebuffer.clear(rtw::sw_renderer::Color{}, single_precision{1});
+    if (occluded)
+    {
+      pipeline.draw_arrays(wall_shader, wall, pipeline_state, framebuffer, stats);
+    }
+    if (use_query)
+    {
+      pipeline.begin_query(query);
+      pipeline.draw_arrays(proxy_shader, proxy, proxy_state, framebuffer, stats);
+      pipeline.end_query();
+      pipeline.begin_conditional_render(query);
+    }
+    pipeline.draw_elements(sphere_shader, sphere, indices, pipeline_state, framebuffer, stats);
+    if (use_query)
+    {
+      pipeline.end_conditional_render();
+    }
+    benchmark::DoNotOptimize(framebuffer.color_buffer().data());
+    benchmark::ClobberMemory();
+  }
+  state.counters["samples_passed"] = static_cast<double>(query.samples_passed);
+  state.counters["draws_skipped"] = static_cast<double>(stats.draws_skipped);
+  state.counters["triangles_submitted"] = static_cast<double>(stats.triangles_submitted);
+}
+
+/// @p count point lights of radius 1.5 scattered over the view volume of bm_pipeline_deferred_lighting's scene.
+std::vector<rtw::sw_renderer::PointLight> make_point_lights(const std::size_t count)
+{
+  std::vector<rtw::sw_renderer::PointLight> lights;
+  std::uint32_t seed{12345U};
+  const auto next = [&seed]()
+  {
+    seed = (seed * 1664525U) + 1013904223U;
+    return static_cast<float>(seed >> 8U) / static_cast<float>(1U << 24U);
+  };
+  for (std::size_t i = 0U; i < count; ++i)
+  {
+    const auto z = -2.5F - (4.0F * next());
+    const auto extent = -0.55F * z;
+    const auto x = extent * ((2.0F * next()) - 1.0F);
+    const auto y = extent * ((2.0F * next()) - 1.0F);
+    lights.push_back(rtw::sw_renderer::PointLight{{x, y, z}, {next(), next(), next()}, single_precision{1.5F}});
+  }
+  return lights;
+}
+
+constexpr std::size_t DEFERRED_SPHERES{6U};
+
+/// DEFERRED_SPHERES overlapping dense spheres drawn back to front in front of a wall, with the depth test on, lit by
+/// range(0) point lights. range(1) == 0 shades forward: PointLitShader loops over every light in every fragment,
+/// including the ones later overdrawn. range(1) == 1 shades deferred: GBufferShader writes albedo and normals
+/// (octahedral 2x16), then DeferredLighting lights each visible pixel once with the lights culled per 16x16 tile.
+void bm_pipeline_deferred_lighting(benchmark::State& state)
+{
+  const auto light_count = static_cast<std::size_t>(state.range(0));
+  const bool deferred = state.range(1) != 0;
+
+  const auto mesh = make_dense_sphere(24U, 48U);
+  const rtw::sw_renderer::RawVertexStream sphere{make_layout(), rtw::stl::as_bytes(rtw::stl::make_span(mesh.vertices))};
+  const rtw::sw_renderer::IndexBuffer indices{mesh.indices};
+  const auto lights = make_point_lights(light_count);
+
+  const auto params = rtw::math::make_perspective_parameters(rtw::sw_renderer::AngleF{rtw::math::DEG, 60.0F},
+                                                             single_precision{1}, single_precision{0.1F},
+                                                             single_precision{100.0F});
+  const auto projection = rtw::math::make_perspective_projection_matrix(params);
+  // The wall is a sphere too, scaled up far behind; the others approach the camera, each in front of the last.
+  std::vector<rtw::sw_renderer::Matrix4x4F> model_views;
+  auto wall = rtw::sw_renderer::Matrix4x4F::identity();
+  wall(0U, 0U) = wall(1U, 1U) = wall(2U, 2U) = single_precision{6.0F};
+  wall(2U, 3U) = single_precision{-14.0F};
+  model_views.push_back(wall);
+  for (std::size_t i = 0U; i < DEFERRED_SPHERES; ++i)
+  {
+    auto model_view = rtw::sw_renderer::Matrix4x4F::identity();
+    const auto t = static_cast<float>(i) / static_cast<float>(DEFERRED_SPHERES - 1U);
+    model_view(0U, 3U) = single_precision{-0.8F + (1.6F * t)};
+    model_view(1U, 3U) = single_precision{0.4F - (0.8F * t)};
+    model_view(2U, 3U) = single_precision{-6.0F + (2.5F * t)};
+    model_views.push_back(model_view);
+  }
+
+  const rtw::sw_renderer::Vector4F albedo{0.8F, 0.8F, 0.8F, 1.0F};
+  rtw::sw_renderer::PointLitShader forward_shader;
+  forward_shader.set_base_color(albedo);
+  forward_shader.set_ambient(rtw::sw_renderer::DeferredLightingConfig{}.ambient);
+  forward_shader.set_lights(rtw::stl::make_span(lights));
+  rtw::sw_renderer::GBufferShader gbuffer_shader;
+  gbuffer_shader.set_base_color(albedo);
+  rtw::sw_renderer::DeferredLighting lighting;
+
+  auto pipeline_state = make_state();
+  pipeline_state.depth_test_enabled = true;
+  pipeline_state.cull_mode = rtw::sw_renderer::CullMode::BACK;
+
+  rtw::sw_renderer::FrameBuffer framebuffer{WIDTH, HEIGHT};
+  if (deferred)
+  {
+    framebuffer.attach_normal_buffer(rtw::sw_renderer::NormalEncoding::OCTAHEDRAL_2X16);
+  }
+  rtw::sw_renderer::Pipeline pipeline;
+  rtw::sw_renderer::RenderStats stats;
+  for (auto _ : state)
+  {
+    stats.reset();
+    framebuffer.clear(rtw::sw_renderer::Color{}, single_precision{1});
+    for (const auto& model_view : model_views)
+    {
+      // Rigid transforms and a uniform scale: the model-view matrix transforms normals as well.
+      if (deferred)
+      {
+        gbuffer_shader.set_mvp_matrix(projection * model_view);
+        gbuffer_shader.set_normal_matrix(model_view);
+        pipeline.draw_elements(gbuffer_shader, sphere, indices, pipeline_state, framebuffer, stats);
+      }
+      else
+      {
+        forward_shader.set_mvp_matrix(projection * model_view);
+        forward_shader.set_model_view_matrix(model_view);
+        forward_shader.set_normal_matrix(model_view);
+        pipeline.draw_elements(forward_shader, sphere, indices, pipeline_state, framebuffer, stats);
+      }
+    }
+    if (deferred)
+    {
+      lighting.shade(framebuffer, projection, pipeline_state, rtw::stl::make_span(lights), framebuffer.color_buffer());
+    }
+    benchmark::DoNotOptimize(framebuffer.color_buffer().data());
+    benchmark::ClobberMemory();
+  }
+  state.counters["fragments_shaded"] = static_cast<double>(stats.fragments_shaded);
+  state.counters["lights_per_tile"] =
+      deferred ? static_cast<double>(lighting.lights_shaded_per_tile()) / ((WIDTH / 16.0) * (HEIGHT / 16.0))
+               : static_cast<double>(light_count);
+}
+
+void bm_pipeline_dense_mesh_elements(benchmark::State& state) { run_dense_mesh(state, false); }
+void bm_pipeline_dense_mesh_meshlets(benchmark::State& state) { run_dense_mesh(state, true); }
+
 std::array<rtw::sw_renderer::VertexF, 4U> fullscreen_quad()
 {
   constexpr float MAX_X = static_cast<float>(WIDTH) - 1.0F;
@@ -205,6 +831,29 @@ void bm_fixed_clear_only(benchmark::State& state)
   }
 }
 
+/// A 4K frame with one small triangle: clearing and presenting the buffers dominate. With lazy clears only the
+/// tiles under the triangle are filled eagerly; `data()` streams the clear colour into the rest.
+void bm_fixed_sparse_scene(benchmark::State& state)
+{
+  constexpr std::size_t SPARSE_WIDTH{3840U};
+  constexpr std::size_t SPARSE_HEIGHT{2160U};
+  rtw::sw_renderer::Renderer renderer{SPARSE_WIDTH, SPARSE_HEIGHT};
+
+  using rtw::sw_renderer::Point4F;
+  using rtw::sw_renderer::VertexF;
+  const VertexF v0{Point4F{1900.0F, 1000.0F, 1.0F, 1.0F}};
+  const VertexF v1{Point4F{1980.0F, 1000.0F, 1.0F, 1.0F}};
+  const VertexF v2{Point4F{1940.0F, 1080.0F, 1.0F, 1.0F}};
+  constexpr auto COLOR = rtw::sw_renderer::Color{0xFF'80'33'FFU};
+  for (auto _ : state)
+  {
+    renderer.clear(rtw::sw_renderer::Color{});
+    renderer.fill_triangle_bbox(v0, v1, v2, COLOR, 1.0F);
+    benchmark::DoNotOptimize(renderer.data());
+    benchmark::ClobberMemory();
+  }
+}
+
 void bm_fixed_flat(benchmark::State& state)
 {
   rtw::sw_renderer::Renderer renderer{WIDTH, HEIGHT};
@@ -236,6 +885,72 @@ void bm_fixed_textured_nearest(benchmark::State& state)
   }
 }
 
+void bm_fixed_flat_spans(benchmark::State& state)
+{
+  rtw::sw_renderer::Renderer renderer{WIDTH, HEIGHT};
+  const auto quad = fullscreen_quad();
+  constexpr auto COLOR = rtw::sw_renderer::Color{0xFF'80'33'FFU};
+  for (auto _ : state)
+  {
+    renderer.clear(rtw::sw_renderer::Color{});
+    renderer.fill_triangle_spans(quad[0U], quad[1U], quad[2U], COLOR, 1.0F);
+    renderer.fill_triangle_spans(quad[0U], quad[2U], quad[3U], COLOR, 1.0F);
+    benchmark::DoNotOptimize(renderer.data());
+    benchmark::ClobberMemory();
+  }
+}
+
+void bm_fixed_textured_nearest_spans(benchmark::State& state)
+{
+  const auto texels = make_checker(64U);
+  rtw::sw_renderer::Texture texture{const_cast<std::uint32_t*>(texels.data()), 64U, 64U};
+  rtw::sw_renderer::Renderer renderer{WIDTH, HEIGHT};
+  const auto quad = fullscreen_quad();
+  for (auto _ : state)
+  {
+    renderer.clear(rtw::sw_renderer::Color{});
+    renderer.fill_triangle_spans(quad[0U], quad[1U], quad[2U], texture, 1.0F);
+    renderer.fill_triangle_spans(quad[0U], quad[2U], quad[3U], texture, 1.0F);
+    benchmark::DoNotOptimize(renderer.data());
+    benchmark::ClobberMemory();
+  }
+}
+
+/// Fixed-pipeline counterpart of bm_pipeline_overdraw: OVERDRAW_LAYERS full-screen quads front to back (range(1)
+/// == 0) or back to front, in the DepthFormat given by range(0).
+void bm_fixed_overdraw(benchmark::State& state)
+{
+  rtw::sw_renderer::Renderer renderer{WIDTH, HEIGHT};
+  renderer.set_depth_format(static_cast<rtw::sw_renderer::DepthFormat>(state.range(0)));
+  const bool back_to_front = state.range(1) != 0;
+
+  std::vector<std::array<rtw::sw_renderer::VertexF, 4U>> layers;
+  for (std::size_t layer = 0U; layer < OVERDRAW_LAYERS; ++layer)
+  {
+    // VertexF::point.w holds 1/w; the layers sit between 2 and 9 units from the camera.
+    const auto w = 2.0F + static_cast<float>(back_to_front ? (OVERDRAW_LAYERS - 1U - layer) : layer);
+    auto quad = fullscreen_quad();
+    for (auto& vertex : quad)
+    {
+      vertex.point.w() = 1.0F / w;
+    }
+    layers.push_back(quad);
+  }
+
+  constexpr auto COLOR = rtw::sw_renderer::Color{0xFF'80'33'FFU};
+  for (auto _ : state)
+  {
+    renderer.clear(rtw::sw_renderer::Color{});
+    for (const auto& quad : layers)
+    {
+      renderer.fill_triangle_bbox(quad[0U], quad[1U], quad[2U], COLOR, 1.0F);
+      renderer.fill_triangle_bbox(quad[0U], quad[2U], quad[3U], COLOR, 1.0F);
+    }
+    benchmark::DoNotOptimize(renderer.data());
+    benchmark::ClobberMemory();
+  }
+}
+
 } // namespace
 
 BENCHMARK(bm_pipeline_lit_virtual);
@@ -246,9 +961,50 @@ BENCHMARK(bm_pipeline_flat_templated);
 BENCHMARK(bm_pipeline_textured_nearest_templated);
 BENCHMARK(bm_pipeline_standard_textured_nearest);
 BENCHMARK(bm_pipeline_standard_textured_lit);
+BENCHMARK(bm_pipeline_dense_mesh_elements)->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_pipeline_dense_mesh_meshlets)->Unit(benchmark::kMillisecond);
+// Formats: 0 = D32F, 1 = D24_UNORM, 2 = D16_UNORM.
+BENCHMARK(bm_pipeline_overdraw)
+    ->ArgNames({"format", "back_to_front", "reversed_z"})
+    ->ArgsProduct({{0, 1, 2}, {0, 1}, {0}})
+    ->Args({0, 0, 1})
+    ->Args({2, 0, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+// Modes: 0 = no anti-aliasing, 1 = 4x MSAA, 2 = 4x SSAA.
+BENCHMARK(bm_pipeline_antialiasing)->ArgName("mode")->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+// Scales in percent (0 = deterministic controller at half the full-resolution budget); filters: 0 = nearest,
+// 1 = bilinear.
+BENCHMARK(bm_pipeline_dynamic_resolution)
+    ->ArgNames({"scale", "filter"})
+    ->ArgsProduct({{100, 75, 50, 0}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Modes: 0 = 1x1, 1 = 2x1, 2 = 2x2, 3 = 4x4, 4 = foveated ShadingRateImage.
+BENCHMARK(bm_pipeline_shading_rate)->ArgName("mode")->DenseRange(0, 4)->Unit(benchmark::kMicrosecond);
+
+// Occluded sphere drawn directly vs. behind a bounding-box occlusion query, and the query's overhead when visible.
+BENCHMARK(bm_pipeline_occlusion_query)
+    ->ArgNames({"query", "occluded"})
+    ->ArgsProduct({{0, 1}, {1, 0}})
+    ->Unit(benchmark::kMillisecond);
+
+// Paths: 0 = forward PointLitShader, 1 = G-buffer + tiled DeferredLighting.
+BENCHMARK(bm_pipeline_deferred_lighting)
+    ->ArgNames({"lights", "path"})
+    ->ArgsProduct({{1, 16, 256}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
 
 BENCHMARK(bm_fixed_clear_only);
+BENCHMARK(bm_fixed_sparse_scene)->Unit(benchmark::kMicrosecond);
 BENCHMARK(bm_fixed_flat);
 BENCHMARK(bm_fixed_textured_nearest);
+BENCHMARK(bm_fixed_flat_spans);
+BENCHMARK(bm_fixed_textured_nearest_spans);
+BENCHMARK(bm_fixed_overdraw)
+    ->ArgNames({"format", "back_to_front"})
+    ->ArgsProduct({{0, 1, 2}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
 
 BENCHMARK_MAIN();
@@ -80,6 +80,38 @@ void bm_fill_triangle_scanline(benchmark::State& state)
   }
 }
 
+/// Same triangle as bm_fill_triangle_scanline, traversed as spans: the per-pixel work is stepping the span
+/// attributes instead of recomputing barycentrics.
+void bm_fill_triangle_spans(benchmark::State& state)
+{
+  const rtw::sw_renderer::Point4F p0{80.0F, 40.0F, 0.0F};
+  const rtw::sw_renderer::Point4F p1{140.0F, 40.0F, 0.0F};
+  const rtw::sw_renderer::Point4F p2{140.0F, 100.0F, 0.0F};
+
+  const rtw::sw_renderer::VertexF v0{p0};
+  const rtw::sw_renderer::VertexF v1{p1};
+  const rtw::sw_renderer::VertexF v2{p2};
+
+  for (auto _ : state)
+  {
+    rtw::sw_renderer::fill_triangle_spans(v0, v1, v2,
+                                          [](const rtw::sw_renderer::Span& span)
+                                          {
+                                            auto attributes = span.start;
+                                            for (auto x = span.x_begin; x < span.x_end; ++x)
+                                            {
+                                              const rtw::sw_renderer::Point2I p{x, span.y};
+                                              auto pp = p;
+                                              benchmark::DoNotOptimize(pp);
+                                              benchmark::DoNotOptimize(attributes);
+                                              attributes.inv_w += span.step.inv_w;
+                                              attributes.u += span.step.u;
+                                              attributes.v += span.step.v;
+                                            }
+                                          });
+  }
+}
+
 void bm_fill_triangle_bbox(benchmark::State& state)
 {
   const rtw::sw_renderer::Point4F p0{80.0F, 40.0F, 0.0F};
@@ -182,6 +214,7 @@ BENCHMARK(bm_draw_line_bresenham);
 BENCHMARK(bm_draw_line_varyings_dda);
 BENCHMARK(bm_draw_line_varyings_bresenham);
 BENCHMARK(bm_fill_triangle_scanline);
+BENCHMARK(bm_fill_triangle_spans);
 BENCHMARK(bm_fill_triangle_bbox);
 
 BENCHMARK_MAIN();
@@ -0,0 +1,154 @@
+#include "sw_renderer/scene_bvh.h"
+#include "sw_renderer/types.h"
+
+#include "math/bounding_box_operations.h"
+#include "math/frustum.h"
+#include "math/matrix_operations.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+using rtw::sw_renderer::BoundingBox3F;
+using rtw::sw_renderer::Matrix4x4F;
+using rtw::sw_renderer::Point3F;
+using rtw::sw_renderer::SceneBvh;
+
+constexpr std::size_t OBJECT_COUNT{100'000U};
+constexpr float WORLD_HALF_EXTENT{500.0F};
+
+Matrix4x4F make_translation(const float x, const float y, const float z)
+{
+  auto matrix = Matrix4x4F::identity();
+  matrix(0U, 3U) = x;
+  matrix(1U, 3U) = y;
+  matrix(2U, 3U) = z;
+  return matrix;
+}
+
+struct Scene
+{
+  std::vector<BoundingBox3F> local_bounds;
+  std::vector<Matrix4x4F> transforms;
+};
+
+/// 100k small boxes scattered uniformly through a 1000^3 world.
+Scene make_scene()
+{
+  std::mt19937 rng{42U};
+  std::uniform_real_distribution<float> position{-WORLD_HALF_EXTENT, WORLD_HALF_EXTENT};
+  std::uniform_real_distribution<float> extent{0.5F, 4.0F};
+
+  Scene scene;
+  scene.local_bounds.reserve(OBJECT_COUNT);
+  scene.transforms.reserve(OBJECT_COUNT);
+  for (std::size_t i = 0U; i < OBJECT_COUNT; ++i)
+  {
+    const auto half = extent(rng);
+    scene.local_bounds.push_back(BoundingBox3F{Point3F{-half, -half, -half}, Point3F{half, half, half}});
+    scene.transforms.push_back(make_translation(position(rng), position(rng), position(rng)));
+  }
+  return scene;
+}
+
+/// A 60 degree camera at the origin looking down -Z, seeing roughly a tenth of the world.
+rtw::sw_renderer::Frustum3F make_frustum()
+{
+  const auto params = rtw::math::make_perspective_parameters(
+      rtw::sw_renderer::AngleF{rtw::math::DEG, 60.0F}, 16.0F / 9.0F, 0.1F, WORLD_HALF_EXTENT);
+  return rtw::math::extract_frustum(rtw::math::transpose(rtw::math::make_perspective_projection_matrix(params)));
+}
+
+void bm_scene_bvh_build(benchmark::State& state)
+{
+  const auto scene = make_scene();
+  SceneBvh bvh;
+  for (auto _ : state)
+  {
+    bvh.build(scene.local_bounds, scene.transforms);
+    benchmark::DoNotOptimize(bvh.node_count());
+  }
+  state.counters["nodes"] = static_cast<double>(bvh.node_count());
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * OBJECT_COUNT));
+}
+
+/// Moves `state.range(0)` objects per frame by a small offset, then refits. Small counts take the incremental
+/// path-to-root refit, large counts the full bottom-up sweep.
+void bm_scene_bvh_refit(benchmark::State& state)
+{
+  const auto scene = make_scene();
+  SceneBvh bvh;
+  bvh.build(scene.local_bounds, scene.transforms);
+
+  const auto moved = static_cast<std::size_t>(state.range(0));
+  const auto stride = OBJECT_COUNT / moved;
+  float offset = 0.0F;
+  for (auto _ : state)
+  {
+    offset = (offset > 1.0F) ? 0.0F : (offset + 0.01F);
+    for (std::size_t i = 0U; i < moved; ++i)
+    {
+      const auto id = static_cast<SceneBvh::ObjectId>(i * stride);
+      bvh.set_transform(id, make_translation(offset, 0.0F, 0.0F) * scene.transforms[id]);
+    }
+    bvh.refit();
+    benchmark::DoNotOptimize(bvh.bounds());
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * moved));
+}
+
+void bm_scene_bvh_query(benchmark::State& state)
+{
+  const auto scene = make_scene();
+  SceneBvh bvh;
+  bvh.build(scene.local_bounds, scene.transforms);
+  const auto frustum = make_frustum();
+  const Point3F eye{0.0F, 0.0F, 0.0F};
+
+  std::vector<SceneBvh::ObjectId> visible;
+  for (auto _ : state)
+  {
+    bvh.query(frustum, eye, visible);
+    benchmark::DoNotOptimize(visible.data());
+  }
+  state.counters["visible"] = static_cast<double>(visible.size());
+}
+
+/// Baseline for the query: test every object box against the frustum, no hierarchy and no sorting.
+void bm_scene_brute_force_cull(benchmark::State& state)
+{
+  const auto scene = make_scene();
+  SceneBvh bvh;
+  bvh.build(scene.local_bounds, scene.transforms);
+  const auto frustum = make_frustum();
+
+  std::vector<SceneBvh::ObjectId> visible;
+  for (auto _ : state)
+  {
+    visible.clear();
+    for (SceneBvh::ObjectId id = 0U; id < OBJECT_COUNT; ++id)
+    {
+      if (rtw::math::classify(frustum, bvh.world_bounds(id)) != rtw::math::Containment::OUTSIDE)
+      {
+        visible.push_back(id);
+      }
+    }
+    benchmark::DoNotOptimize(visible.data());
+  }
+  state.counters["visible"] = static_cast<double>(visible.size());
+}
+
+} // namespace
+
+BENCHMARK(bm_scene_bvh_build)->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_scene_bvh_refit)->Arg(100)->Arg(1'000)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(bm_scene_bvh_query)->Unit(benchmark::kMicrosecond);
+BENCHMARK(bm_scene_brute_force_cull)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
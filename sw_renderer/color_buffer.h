@@ -1,9 +1,9 @@
 #pragma once
 
 #include "sw_renderer/color.h"
+#include "sw_renderer/lazy_clear_buffer.h"
 
-#include <cassert>
-#include <vector>
+#include <cstdint>
 
 namespace rtw::sw_renderer
 {
@@ -14,46 +14,45 @@ namespace rtw::sw_renderer
 /// The buffer is stored in row-major order with the origin at the top-left.
 /// Pixel format is RGBA8888 (32 bits per pixel).
 ///
+/// Clears are lazy (see LazyClearBuffer): `clear()` only flags the tiles, `pixel()` reads the clear colour from
+/// flagged tiles, and `data()` resolves the remaining flagged tiles before handing out the pixels.
+///
 /// @note Access is not bounds-checked in release builds for performance.
 /// Use asserts to catch out-of-bounds access in debug builds.
 class ColorBuffer
 {
 public:
   ColorBuffer(const std::size_t width, const std::size_t height)
-      : buffer_(width * height, Color().rgba), width_(width), height_(height), pitch_(width * bytes_per_pixel_),
+      : buffer_(width, height, Color().rgba), pitch_(width * bytes_per_pixel_),
         aspect_ratio_(static_cast<float>(width) / static_cast<float>(height))
   {
   }
 
-  std::size_t width() const { return width_; }
-  std::size_t height() const { return height_; }
+  std::size_t width() const { return buffer_.width(); }
+  std::size_t height() const { return buffer_.height(); }
   float aspect_ratio() const { return aspect_ratio_; }
   std::size_t size() const { return buffer_.size(); }
   std::size_t bytes_per_pixel() const { return bytes_per_pixel_; }
   std::size_t pitch() const { return pitch_; }
 
-  void set_pixel(const std::size_t x, const std::size_t y, const Color color)
-  {
-    assert(x < width_ && "x coordinate out of bounds");
-    assert(y < height_ && "y coordinate out of bounds");
-    buffer_[(y * width_) + x] = color.rgba;
-  }
-
-  Color pixel(const std::size_t x, const std::size_t y) const
+  void set_pixel(const std::size_t x, const std::size_t y, const Color color) { buffer_.store(x, y, color.rgba); }
+  Color pixel(const std::size_t x, const std::size_t y) const { return Color{buffer_.load(x, y)}; }
+  /// @return Pointer to the pixels [x_begin, x_end) of row y for direct access; see LazyClearBuffer::row.
+  std::uint32_t* pixel_row(const std::size_t x_begin, const std::size_t x_end, const std::size_t y)
   {
-    assert(x < width_ && "x coordinate out of bounds");
-    assert(y < height_ && "y coordinate out of bounds");
-    return Color{buffer_[(y * width_) + x]};
+    return buffer_.row(x_begin, x_end, y);
   }
 
-  void clear(const Color color) { std::fill(buffer_.begin(), buffer_.end(), color.rgba); }
+  void clear(const Color color) { buffer_.clear(color.rgba); }
+  /// @return true if the tile holding (x, y) has not been drawn to since the last clear.
+  bool is_cleared(const std::size_t x, const std::size_t y) const { return buffer_.is_cleared(x, y); }
+  /// Writes the clear colour into all tiles not drawn to since the last clear, with streaming stores.
+  void resolve() const { buffer_.resolve(); }
 
   const std::uint32_t* data() const { return buffer_.data(); }
 
 private:
-  std::vector<std::uint32_t> buffer_;
-  std::size_t width_{};
-  std::size_t height_{};
+  LazyClearBuffer<std::uint32_t> buffer_;
   std::size_t bytes_per_pixel_{sizeof(std::uint32_t)};
   std::size_t pitch_{};
   float aspect_ratio_{1.0F};
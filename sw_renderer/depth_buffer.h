@@ -1,58 +1,180 @@
 #pragma once
 
+#include "sw_renderer/lazy_clear_buffer.h"
 #include "sw_renderer/precision.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <limits>
-#include <vector>
 
 namespace rtw::sw_renderer
 {
 
+/// Storage format of a DepthBuffer.
+enum class DepthFormat : std::uint8_t
+{
+  D32F = 0U, ///< single_precision per element; any value, e.g. the fixed pipeline's view depth.
+  D24_UNORM, ///< 24-bit unsigned normalised [0, 1], packed into the low bits of a 32-bit word (X8_D24).
+  D16_UNORM, ///< 16-bit unsigned normalised [0, 1]; half the memory traffic of D32F.
+};
+
 /// A 2D buffer for storing depth (Z) values.
 /// Used for depth testing to determine visibility.
 ///
-/// The buffer stores depth values in single_precision (float, or fixed-point when
+/// With the default D32F format the buffer stores depth values in single_precision (float, or fixed-point when
 /// RTW_USE_FIXED_POINT is enabled), initialised to std::numeric_limits<single_precision>::max()
 /// (farthest possible). Smaller values are closer to the camera. Storing the same scalar type the
 /// rasteriser interpolates avoids a per-pixel conversion in the depth test.
 ///
+/// The UNORM formats store depths in [0, 1] as unsigned integers. `encode()` quantises a depth once per fragment
+/// and the depth test compares the integers from `depth_unorm()` directly; `depth()` / `set_depth()` convert, so
+/// code that only needs the value stays format-agnostic. Values outside [0, 1] are clamped, so the default clear
+/// to `max()` clears an UNORM buffer to 1.
+///
+/// Clears are lazy (see LazyClearBuffer): a tile not written since the last clear is never materialised, and
+/// `depth()` answers for it with the clear value from a register, so depth tests against untouched parts of the
+/// screen read no depth memory at all.
+///
 /// @note Uses inverted depth (1/w) for better precision.
 class DepthBuffer
 {
 public:
-  DepthBuffer(const std::size_t width, const std::size_t height)
-      : buffer_(width * height, std::numeric_limits<single_precision>::max()), width_(width), height_(height)
+  DepthBuffer(const std::size_t width, const std::size_t height, const DepthFormat format = DepthFormat::D32F)
+      : buffer_(storage_size(format, DepthFormat::D32F, width), storage_size(format, DepthFormat::D32F, height),
+                std::numeric_limits<single_precision>::max()),
+        unorm24_(storage_size(format, DepthFormat::D24_UNORM, width),
+                 storage_size(format, DepthFormat::D24_UNORM, height), UNORM24_MAX),
+        unorm16_(storage_size(format, DepthFormat::D16_UNORM, width),
+                 storage_size(format, DepthFormat::D16_UNORM, height), UNORM16_MAX),
+        width_(width), height_(height), unorm_max_((format == DepthFormat::D16_UNORM) ? UNORM16_MAX : UNORM24_MAX),
+        format_(format)
   {
   }
 
   std::size_t width() const { return width_; }
   std::size_t height() const { return height_; }
-  std::size_t size() const { return buffer_.size(); }
+  std::size_t size() const { return width_ * height_; }
+
+  DepthFormat format() const { return format_; }
+  bool is_unorm() const { return format_ != DepthFormat::D32F; }
+  /// Bytes one depth occupies in memory.
+  std::size_t bytes_per_depth() const
+  {
+    return (format_ == DepthFormat::D16_UNORM) ? sizeof(std::uint16_t)
+         : (format_ == DepthFormat::D24_UNORM) ? sizeof(std::uint32_t)
+                                               : sizeof(single_precision);
+  }
 
   void clear(const single_precision value = std::numeric_limits<single_precision>::max())
   {
-    std::fill(buffer_.begin(), buffer_.end(), value);
+    switch (format_)
+    {
+    case DepthFormat::D32F:
+      buffer_.clear(value);
+      break;
+    case DepthFormat::D24_UNORM:
+      unorm24_.clear(encode(value));
+      break;
+    case DepthFormat::D16_UNORM:
+      unorm16_.clear(static_cast<std::uint16_t>(encode(value)));
+      break;
+    }
   }
 
   void set_depth(const std::size_t x, const std::size_t y, const single_precision depth)
   {
-    assert(x < width_ && "x coordinate out of bounds");
-    assert(y < height_ && "y coordinate out of bounds");
-    buffer_[(y * width_) + x] = depth;
+    if (format_ == DepthFormat::D32F)
+    {
+      buffer_.store(x, y, depth);
+      return;
+    }
+    set_depth_unorm(x, y, encode(depth));
   }
 
   single_precision depth(const std::size_t x, const std::size_t y) const
   {
-    assert(x < width_ && "x coordinate out of bounds");
-    assert(y < height_ && "y coordinate out of bounds");
-    return buffer_[(y * width_) + x];
+    return (format_ == DepthFormat::D32F) ? buffer_.load(x, y) : decode(depth_unorm(x, y));
+  }
+  /// @return Pointer to the depths [x_begin, x_end) of row y for direct access; see LazyClearBuffer::row.
+  /// @note D32F only.
+  single_precision* depth_row(const std::size_t x_begin, const std::size_t x_end, const std::size_t y)
+  {
+    assert(format_ == DepthFormat::D32F && "depth_row() needs a D32F buffer");
+    return buffer_.row(x_begin, x_end, y);
+  }
+
+  /// Largest integer of the UNORM format, i.e. the encoding of depth 1.
+  std::uint32_t unorm_max() const { return unorm_max_; }
+
+  /// Quantises @p depth to the UNORM format, rounding to nearest; values outside [0, 1] (and NaN) are clamped.
+  /// Runs once per fragment, so it is branch-free; double keeps all 24 bits exact.
+  std::uint32_t encode(const single_precision depth) const
+  {
+    const auto value = static_cast<double>(static_cast<float>(depth));
+    const auto clamped = (value > 0.0) ? std::min(value, 1.0) : 0.0;
+    return static_cast<std::uint32_t>((clamped * static_cast<double>(unorm_max_)) + 0.5);
+  }
+
+  single_precision decode(const std::uint32_t depth) const
+  {
+    return single_precision{static_cast<float>(static_cast<double>(depth) / static_cast<double>(unorm_max_))};
+  }
+
+  /// @return The stored integer at (x, y). @note UNORM formats only.
+  std::uint32_t depth_unorm(const std::size_t x, const std::size_t y) const
+  {
+    assert(is_unorm() && "depth_unorm() needs an UNORM buffer");
+    return (format_ == DepthFormat::D16_UNORM) ? std::uint32_t{unorm16_.load(x, y)} : unorm24_.load(x, y);
+  }
+
+  /// Stores an already encoded depth. @note UNORM formats only.
+  void set_depth_unorm(const std::size_t x, const std::size_t y, const std::uint32_t depth)
+  {
+    assert(is_unorm() && "set_depth_unorm() needs an UNORM buffer");
+    if (format_ == DepthFormat::D16_UNORM)
+    {
+      unorm16_.store(x, y, static_cast<std::uint16_t>(depth));
+    }
+    else
+    {
+      unorm24_.store(x, y, depth & UNORM24_MAX);
+    }
+  }
+
+  /// @return true if the tile holding (x, y) has not been written since the last clear, i.e. all of its depths are
+  /// known to equal the clear value.
+  bool is_cleared(const std::size_t x, const std::size_t y) const
+  {
+    switch (format_)
+    {
+    case DepthFormat::D24_UNORM:
+      return unorm24_.is_cleared(x, y);
+    case DepthFormat::D16_UNORM:
+      return unorm16_.is_cleared(x, y);
+    case DepthFormat::D32F:
+      break;
+    }
+    return buffer_.is_cleared(x, y);
   }
 
 private:
-  std::vector<single_precision> buffer_;
+  static constexpr std::uint32_t UNORM24_MAX{(1U << 24U) - 1U};
+  static constexpr std::uint16_t UNORM16_MAX{std::numeric_limits<std::uint16_t>::max()};
+
+  /// Only the storage of the selected format is allocated; the others stay empty.
+  static std::size_t storage_size(const DepthFormat format, const DepthFormat storage, const std::size_t extent)
+  {
+    return (format == storage) ? extent : 0U;
+  }
+
+  LazyClearBuffer<single_precision> buffer_;
+  LazyClearBuffer<std::uint32_t> unorm24_;
+  LazyClearBuffer<std::uint16_t> unorm16_;
   std::size_t width_{};
   std::size_t height_{};
+  std::uint32_t unorm_max_{UNORM24_MAX};
+  DepthFormat format_{DepthFormat::D32F};
 };
 
 } // namespace rtw::sw_renderer
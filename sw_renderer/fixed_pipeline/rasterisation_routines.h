@@ -9,6 +9,8 @@
 #include "math/vector_operations.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <type_traits>
 
 namespace rtw::sw_renderer
@@ -28,9 +30,15 @@ constexpr inline bool IS_TRIANGLE_RASTERISE_CALLBACK_V =
 
 } // namespace details
 
+/// Rasterises only the rows in [first_row, last_row] of the triangle.
+///
+/// The edge functions still start at the triangle's own bounding box and are stepped over the skipped rows, so every
+/// visited pixel gets bit-identical weights to the unrestricted call. Rasterising disjoint row bands independently
+/// therefore reproduces the single-pass result exactly.
 template <typename RasteriseCallbackT,
           typename = std::enable_if_t<details::IS_BARYCENTRIC_TRIANGLE_RASTERISE_CALLBACK_V<RasteriseCallbackT>>>
-void fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const VertexF& v2, RasteriseCallbackT rasterise)
+void fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const VertexF& v2, const std::int32_t first_row,
+                        const std::int32_t last_row, RasteriseCallbackT rasterise)
 {
   // Bounding-box rasterization via incremental edge functions in the style of
   // Juan Pineda's "A Parallel Algorithm for Polygon Rasterization".
@@ -70,25 +78,181 @@ void fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const VertexF& v2,
   edge_b /= area;
   edge_c /= area;
 
-  for (std::int32_t y = min_y; y <= max_y; ++y)
+  const auto end_y = std::min(max_y, last_row);
+  for (std::int32_t y = min_y; y <= end_y; ++y)
   {
-    auto w0 = w0_init;
-    auto w1 = w1_init;
-    auto w2 = w2_init;
-
-    for (std::int32_t x = min_x; x <= max_x; ++x)
+    if (y >= first_row)
     {
-      if ((w0 >= 0) && (w1 >= 0) && (w2 >= 0))
+      auto w0 = w0_init;
+      auto w1 = w1_init;
+      auto w2 = w2_init;
+
+      for (std::int32_t x = min_x; x <= max_x; ++x)
       {
-        const Point2I p{x, y};
-        const BarycentricF b{static_cast<single_precision>(w0), static_cast<single_precision>(w1),
-                             static_cast<single_precision>(w2)};
-        rasterise(v0, v1, v2, p, b);
+        if ((w0 >= 0) && (w1 >= 0) && (w2 >= 0))
+        {
+          const Point2I p{x, y};
+          const BarycentricF b{static_cast<single_precision>(w0), static_cast<single_precision>(w1),
+                               static_cast<single_precision>(w2)};
+          rasterise(v0, v1, v2, p, b);
+        }
+
+        w0 -= edge_a.y();
+        w1 -= edge_b.y();
+        w2 -= edge_c.y();
       }
+    }
+
+    w0_init += edge_a.x();
+    w1_init += edge_b.x();
+    w2_init += edge_c.x();
+  }
+}
+
+template <typename RasteriseCallbackT,
+          typename = std::enable_if_t<details::IS_BARYCENTRIC_TRIANGLE_RASTERISE_CALLBACK_V<RasteriseCallbackT>>>
+void fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const VertexF& v2, RasteriseCallbackT rasterise)
+{
+  fill_triangle_bbox(v0, v1, v2, std::numeric_limits<std::int32_t>::min(), std::numeric_limits<std::int32_t>::max(),
+                     rasterise);
+}
+
+/// Perspective-divided attributes interpolated along a span: 1/w (the depth test uses w = 1 / (1/w)) and the
+/// texture coordinates divided by w.
+struct SpanAttributes
+{
+  single_precision inv_w;
+  single_precision u;
+  single_precision v;
+};
+
+/// A run of covered pixels [x_begin, x_end) on row y. The attributes of pixel x_begin + i are `start + i * step`.
+struct Span
+{
+  std::int32_t y;
+  std::int32_t x_begin;
+  std::int32_t x_end;
+  SpanAttributes start;
+  SpanAttributes step;
+};
+
+namespace details
+{
+
+template <typename SpanCallbackT>
+constexpr inline bool IS_SPAN_CALLBACK_V = std::is_invocable_r_v<void, SpanCallbackT, const Span&>;
+
+/// Narrows the pixel range [first, last] of a row to the steps k for which `weight - k * step >= 0`.
+inline void narrow_to_edge(const double_precision weight, const double_precision step, double_precision& first,
+                           double_precision& last)
+{
+  using multiprecision::math::ceil;
+  using multiprecision::math::floor;
+  using std::ceil;
+  using std::floor;
+
+  if (step > 0)
+  {
+    last = std::min(last, floor(weight / step));
+  }
+  else if (step < 0)
+  {
+    first = std::max(first, ceil(weight / step));
+  }
+  else if (weight < 0)
+  {
+    first = last + double_precision{1};
+  }
+}
+
+} // namespace details
+
+/// Rasterises the triangle as horizontal spans, one per covered row in [first_row, last_row].
+///
+/// Coverage follows the same edge functions and fill rule as fill_triangle_bbox(), but each row's extent is solved
+/// from the edge functions instead of testing every pixel of the bounding box, and the attributes are handed out as
+/// a start value plus a per-pixel gradient, so the span can be shaded without per-pixel barycentrics.
+template <typename SpanCallbackT, typename = std::enable_if_t<details::IS_SPAN_CALLBACK_V<SpanCallbackT>>>
+void fill_triangle_spans(const VertexF& v0, const VertexF& v1, const VertexF& v2, const std::int32_t first_row,
+                         const std::int32_t last_row, SpanCallbackT emit)
+{
+  using multiprecision::math::ceil;
+  using multiprecision::math::floor;
+  using std::ceil;
+  using std::floor;
+
+  const auto min_x = static_cast<std::int32_t>(floor(std::min({v0.point.x(), v1.point.x(), v2.point.x()})));
+  const auto min_y = static_cast<std::int32_t>(floor(std::min({v0.point.y(), v1.point.y(), v2.point.y()})));
+  const auto max_x = static_cast<std::int32_t>(ceil(std::max({v0.point.x(), v1.point.x(), v2.point.x()})));
+  const auto max_y = static_cast<std::int32_t>(ceil(std::max({v0.point.y(), v1.point.y(), v2.point.y()})));
+
+  const auto va = v0.point.xy().cast<double_precision>();
+  const auto vb = v1.point.xy().cast<double_precision>();
+  const auto vc = v2.point.xy().cast<double_precision>();
+  auto edge_a = vc - vb;
+  auto edge_b = va - vc;
+  auto edge_c = vb - va;
+  const auto area = math::cross(edge_a, edge_b);
+  if (area == 0)
+  {
+    return;
+  }
+
+  const Point2D p0{static_cast<double_precision>(min_x) + double_precision{0.5},
+                   static_cast<double_precision>(min_y) + double_precision{0.5}};
+  auto w0_init = math::cross(edge_a, p0 - vc);
+  auto w1_init = math::cross(edge_b, p0 - va);
+  auto w2_init = math::cross(edge_c, p0 - vb);
 
-      w0 -= edge_a.y();
-      w1 -= edge_b.y();
-      w2 -= edge_c.y();
+  w0_init += fill_bias(area, edge_a);
+  w1_init += fill_bias(area, edge_b);
+  w2_init += fill_bias(area, edge_c);
+
+  w0_init /= area;
+  w1_init /= area;
+  w2_init /= area;
+
+  edge_a /= area;
+  edge_b /= area;
+  edge_c /= area;
+
+  const auto interpolate = [&v0, &v1, &v2](const double_precision w0, const double_precision w1,
+                                           const double_precision w2)
+  {
+    const auto attribute = [w0, w1, w2](const single_precision a0, const single_precision a1,
+                                        const single_precision a2)
+    {
+      return static_cast<single_precision>((static_cast<double_precision>(a0) * w0)
+                                           + (static_cast<double_precision>(a1) * w1)
+                                           + (static_cast<double_precision>(a2) * w2));
+    };
+    return SpanAttributes{attribute(v0.point.w(), v1.point.w(), v2.point.w()),
+                          attribute(v0.tex_coord.u(), v1.tex_coord.u(), v2.tex_coord.u()),
+                          attribute(v0.tex_coord.v(), v1.tex_coord.v(), v2.tex_coord.v())};
+  };
+  // Stepping one pixel in x subtracts edge_*.y() from the weights, so the attributes change by a constant.
+  const auto step = interpolate(-edge_a.y(), -edge_b.y(), -edge_c.y());
+
+  const auto row_width = static_cast<double_precision>(max_x - min_x);
+  const auto end_y = std::min(max_y, last_row);
+  for (std::int32_t y = min_y; y <= end_y; ++y)
+  {
+    if (y >= first_row)
+    {
+      double_precision first{0};
+      double_precision last{row_width};
+      details::narrow_to_edge(w0_init, edge_a.y(), first, last);
+      details::narrow_to_edge(w1_init, edge_b.y(), first, last);
+      details::narrow_to_edge(w2_init, edge_c.y(), first, last);
+
+      if (first <= last)
+      {
+        const auto x_begin = min_x + static_cast<std::int32_t>(first);
+        const auto x_end = min_x + static_cast<std::int32_t>(last) + 1;
+        const auto start =
+            interpolate(w0_init - (first * edge_a.y()), w1_init - (first * edge_b.y()), w2_init - (first * edge_c.y()));
+        emit(Span{y, x_begin, x_end, start, step});
+      }
     }
 
     w0_init += edge_a.x();
@@ -97,6 +261,13 @@ void fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const VertexF& v2,
   }
 }
 
+template <typename SpanCallbackT, typename = std::enable_if_t<details::IS_SPAN_CALLBACK_V<SpanCallbackT>>>
+void fill_triangle_spans(const VertexF& v0, const VertexF& v1, const VertexF& v2, SpanCallbackT emit)
+{
+  fill_triangle_spans(v0, v1, v2, std::numeric_limits<std::int32_t>::min(), std::numeric_limits<std::int32_t>::max(),
+                      emit);
+}
+
 namespace details
 {
 
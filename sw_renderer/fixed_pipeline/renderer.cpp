@@ -14,12 +14,230 @@
 #include "math/vector_operations.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
 
 namespace rtw::sw_renderer
 {
 
 using namespace angle_literals;
 
+namespace
+{
+
+/// Raster bands handed out per thread; more bands than threads lets a thread that finishes a cheap band pick up
+/// another one instead of idling behind the busiest band.
+constexpr std::size_t BANDS_PER_THREAD{4U};
+
+/// Near and far planes of the renderer's frustum; the UNORM depth formats store the view depth normalised to them.
+constexpr float Z_NEAR{0.1F};
+constexpr float Z_FAR{100.0F};
+
+/// Pixels the span kernels shade together: one 128-bit vector of floats, the widest the baseline targets (SSE2,
+/// NEON) have. Wider vectors would be split by the compiler anyway and change the calling convention of the helpers.
+constexpr std::int32_t SPAN_LANES{4};
+
+/// Clips @p span to the columns [0, width), moving its start attributes along with x_begin.
+/// @return false if nothing of the span is left or its row is off screen.
+bool clip_span(Span& span, const std::int32_t width, const std::int32_t height)
+{
+  if ((span.y < 0) || (span.y >= height))
+  {
+    return false;
+  }
+  if (span.x_begin < 0)
+  {
+    const auto skipped = static_cast<single_precision>(-span.x_begin);
+    span.start.inv_w += span.step.inv_w * skipped;
+    span.start.u += span.step.u * skipped;
+    span.start.v += span.step.v * skipped;
+    span.x_begin = 0;
+  }
+  span.x_end = std::min(span.x_end, width);
+  return span.x_begin < span.x_end;
+}
+
+single_precision span_inv_z(const Span& span, const std::int32_t i)
+{
+  return single_precision{1.0F} / (span.start.inv_w + (span.step.inv_w * static_cast<single_precision>(i)));
+}
+
+std::size_t texel_index(const single_precision coordinate, const std::size_t size)
+{
+  const auto index = static_cast<std::int32_t>(coordinate * static_cast<single_precision>(size));
+  return static_cast<std::size_t>(std::clamp(index, 0, static_cast<std::int32_t>(size) - 1));
+}
+
+#if defined(__GNUC__)
+// SIMD over SPAN_LANES pixels through the GCC/Clang vector extensions: they map onto SSE/AVX or NEON, whichever the
+// target has, without per-ISA intrinsics. Only used when single_precision is float.
+using FloatLanes = float __attribute__((vector_size(SPAN_LANES * sizeof(float))));
+using IntLanes = std::int32_t __attribute__((vector_size(SPAN_LANES * sizeof(std::int32_t))));
+
+template <typename LanesT, typename T>
+LanesT load_lanes(const T* source)
+{
+  static_assert(sizeof(LanesT) == SPAN_LANES * sizeof(T));
+  LanesT lanes;
+  std::memcpy(&lanes, source, sizeof(lanes));
+  return lanes;
+}
+
+template <typename T, typename LanesT>
+void store_lanes(T* destination, const LanesT& lanes)
+{
+  static_assert(sizeof(LanesT) == SPAN_LANES * sizeof(T));
+  std::memcpy(destination, &lanes, sizeof(lanes));
+}
+
+template <typename ToT, typename FromT>
+ToT lane_cast(const FromT& from)
+{
+  static_assert(sizeof(ToT) == sizeof(FromT));
+  ToT to;
+  std::memcpy(&to, &from, sizeof(to));
+  return to;
+}
+
+/// Lanes of @p if_set where @p mask is all ones, lanes of @p if_clear elsewhere.
+IntLanes select(const IntLanes mask, const IntLanes if_set, const IntLanes if_clear)
+{
+  return (if_set & mask) | (if_clear & ~mask);
+}
+
+bool any(const IntLanes mask)
+{
+  for (std::int32_t lane = 0; lane < SPAN_LANES; ++lane)
+  {
+    if (mask[lane] != 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Span-relative x of each lane for the block starting at pixel @p i.
+FloatLanes lanes_x(const std::int32_t i)
+{
+  static_assert(SPAN_LANES == 4, "the offsets must list every lane");
+  return static_cast<float>(i) + FloatLanes{0.0F, 1.0F, 2.0F, 3.0F};
+}
+
+/// 1/w of the pixels at @p x inverted to the stored depth.
+FloatLanes lanes_inv_z(const Span& span, const FloatLanes x)
+{
+  return 1.0F / (static_cast<float>(span.start.inv_w) + (static_cast<float>(span.step.inv_w) * x));
+}
+
+/// Texel index lanes for the interpolated, perspective-corrected coordinate, clamped to [0, size).
+IntLanes lanes_texel_index(const FloatLanes coordinate, const std::size_t size)
+{
+  const auto index = __builtin_convertvector(coordinate * static_cast<float>(size), IntLanes);
+  const auto low = select(index < 0, IntLanes{}, index);
+  const auto high = IntLanes{} + (static_cast<std::int32_t>(size) - 1);
+  return select(low > high, high, low);
+}
+#endif
+
+/// Depth-tests the pixels of @p span and writes @p rgba where the test passes.
+void shade_span(const Span& span, single_precision* depth, std::uint32_t* pixels, const std::uint32_t rgba)
+{
+  const auto count = span.x_end - span.x_begin;
+  std::int32_t i = 0;
+#if defined(__GNUC__)
+  if constexpr (std::is_same_v<single_precision, float>)
+  {
+    const auto colour = IntLanes{} + static_cast<std::int32_t>(rgba);
+    for (; (i + SPAN_LANES) <= count; i += SPAN_LANES)
+    {
+      const auto inv_z = lane_cast<IntLanes>(lanes_inv_z(span, lanes_x(i)));
+      const auto old_depth = load_lanes<IntLanes>(depth + i); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      const auto pass = lane_cast<FloatLanes>(inv_z) < lane_cast<FloatLanes>(old_depth);
+      if (any(pass))
+      {
+        store_lanes(depth + i, select(pass, inv_z, old_depth)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        store_lanes(pixels + i, select(pass, colour, load_lanes<IntLanes>(pixels + i)));
+      }
+    }
+  }
+#endif
+  // Remainder of the span, or all of it in fixed-point builds.
+  for (; i < count; ++i)
+  {
+    const auto inv_z = span_inv_z(span, i);
+    if (inv_z < depth[i]) // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    {
+      pixels[i] = rgba;  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      depth[i] = inv_z;  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+  }
+}
+
+/// Depth-tests the pixels of @p span and writes the nearest texel, scaled by @p light_intensity, where it passes.
+void shade_span(const Span& span, single_precision* depth, std::uint32_t* pixels, const Texture& texture,
+                const float light_intensity)
+{
+  const auto count = span.x_end - span.x_begin;
+  std::int32_t i = 0;
+#if defined(__GNUC__)
+  if constexpr (std::is_same_v<single_precision, float>)
+  {
+    for (; (i + SPAN_LANES) <= count; i += SPAN_LANES)
+    {
+      const auto x = lanes_x(i);
+      const auto inv_z = lanes_inv_z(span, x);
+      const auto old_depth = load_lanes<FloatLanes>(depth + i); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      const auto pass = inv_z < old_depth;
+      if (!any(pass))
+      {
+        continue;
+      }
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      store_lanes(depth + i, select(pass, lane_cast<IntLanes>(inv_z), lane_cast<IntLanes>(old_depth)));
+
+      const auto u = static_cast<float>(span.start.u) + (static_cast<float>(span.step.u) * x);
+      const auto v = static_cast<float>(span.start.v) + (static_cast<float>(span.step.v) * x);
+      const auto tex_x = lanes_texel_index(u * inv_z, texture.width());
+      const auto tex_y = lanes_texel_index(v * inv_z, texture.height());
+      // Texel fetches are gathers; the targets this builds for have no cheap gather, so they stay per lane.
+      for (std::int32_t lane = 0; lane < SPAN_LANES; ++lane)
+      {
+        if (pass[lane] != 0)
+        {
+          const auto texel = texture.texel(static_cast<std::size_t>(tex_x[lane]), static_cast<std::size_t>(tex_y[lane]));
+          pixels[i + lane] = (texel * light_intensity).rgba; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+      }
+    }
+  }
+#endif
+  for (; i < count; ++i)
+  {
+    const auto inv_z = span_inv_z(span, i);
+    if (inv_z < depth[i]) // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    {
+      const auto x = static_cast<single_precision>(i);
+      const auto tex_x = texel_index((span.start.u + (span.step.u * x)) * inv_z, texture.width());
+      const auto tex_y = texel_index((span.start.v + (span.step.v * x)) * inv_z, texture.height());
+      pixels[i] = (texture.texel(tex_x, tex_y) * light_intensity).rgba; // NOLINT
+      depth[i] = inv_z; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+  }
+}
+
+void accumulate(RenderStats& total, const RenderStats& stats)
+{
+  total.triangles_submitted += stats.triangles_submitted;
+  total.triangles_clipped += stats.triangles_clipped;
+  total.triangles_culled += stats.triangles_culled;
+  total.triangles_rendered += stats.triangles_rendered;
+}
+
+} // namespace
+
 Renderer::Renderer(const std::size_t width, const std::size_t height)
     : color_buffer_(width, height), depth_buffer_(width, height)
 {
@@ -27,13 +245,47 @@ Renderer::Renderer(const std::size_t width, const std::size_t height)
   const auto fov_y = 60.0_degF;
 
   const auto frustum_params =
-      make_perspective_parameters(fov_y, aspect_ratio, single_precision{0.1F}, single_precision{100.0F});
+      make_perspective_parameters(fov_y, aspect_ratio, single_precision{Z_NEAR}, single_precision{Z_FAR});
   projection_matrix_ = make_perspective_projection_matrix(frustum_params);
   frustum_ = make_frustum(frustum_params);
   screen_space_matrix_ = make_screen_space_matrix<single_precision>(width, height);
   light_direction_ = math::normalize(Vector3F{0.0F, 0.0F, -1.0F});
 }
 
+void Renderer::set_depth_format(const DepthFormat format)
+{
+  if (format != depth_buffer_.format())
+  {
+    depth_buffer_ = DepthBuffer{width(), height(), format};
+  }
+}
+
+bool Renderer::test_and_set_depth(const Point2I& point, const single_precision inv_z)
+{
+  const auto x = static_cast<std::size_t>(point.x());
+  const auto y = static_cast<std::size_t>(point.y());
+  if (!depth_buffer_.is_unorm())
+  {
+    if (inv_z < depth_buffer_.depth(x, y))
+    {
+      depth_buffer_.set_depth(x, y, inv_z);
+      return true;
+    }
+    return false;
+  }
+
+  // Linear in view depth (a "w-buffer"): the integers are spread evenly over the frustum instead of bunching up
+  // near the camera, which is what makes 16 bits usable for a 0.1 - 100 range.
+  constexpr float SCALE{1.0F / (Z_FAR - Z_NEAR)};
+  const auto encoded = depth_buffer_.encode(single_precision{(static_cast<float>(inv_z) - Z_NEAR) * SCALE});
+  if (encoded < depth_buffer_.depth_unorm(x, y))
+  {
+    depth_buffer_.set_depth_unorm(x, y, encoded);
+    return true;
+  }
+  return false;
+}
+
 void Renderer::draw_pixel(const Point2I& point, const Color color)
 {
   assert(point.x() >= 0 && point.x() < static_cast<std::int32_t>(width()));
@@ -42,6 +294,11 @@ void Renderer::draw_pixel(const Point2I& point, const Color color)
 }
 
 void Renderer::draw_pixel(const Point2I& point, const Color color, const std::uint16_t size)
+{
+  draw_pixel(point, color, size, RowBand{});
+}
+
+void Renderer::draw_pixel(const Point2I& point, const Color color, const std::uint16_t size, const RowBand& band)
 {
   const Point2I p0{point.x() - (size / 2), point.y() - (size / 2)};
   const auto w = static_cast<std::int32_t>(width()) - 1;
@@ -53,29 +310,49 @@ void Renderer::draw_pixel(const Point2I& point, const Color color, const std::ui
       auto p1 = p0 + math::Vector2I{i, j};
       p1.x() = std::clamp(p1.x(), 0, w);
       p1.y() = std::clamp(p1.y(), 0, h);
-      draw_pixel(p1, color);
+      if (band.contains(p1.y()))
+      {
+        draw_pixel(p1, color);
+      }
     }
   }
 }
 
 void Renderer::draw_line(const Point2I& p0, const Point2I& p1, const Color color)
 {
-  sw_renderer::draw_line_bresenham(p0, p1, [this, color](const Point2I& p) { draw_pixel(p, color); });
+  draw_line(p0, p1, color, RowBand{});
+}
+
+void Renderer::draw_line(const Point2I& p0, const Point2I& p1, const Color color, const RowBand& band)
+{
+  sw_renderer::draw_line_bresenham(p0, p1,
+                                   [this, color, &band](const Point2I& p)
+                                   {
+                                     if (band.contains(p.y()))
+                                     {
+                                       draw_pixel(p, color);
+                                     }
+                                   });
 }
 
 void Renderer::fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Color color,
                                   const float light_intensity)
+{
+  fill_triangle_bbox(v0, v1, v2, color, light_intensity, RowBand{});
+}
+
+void Renderer::fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Color color,
+                                  const float light_intensity, const RowBand& band)
 {
   sw_renderer::fill_triangle_bbox(
-      v0, v1, v2,
+      v0, v1, v2, band.first, band.last,
       [this, color, light_intensity](const VertexF& v0, const VertexF& v1, const VertexF& v2, const Point2I& p,
                                      const BarycentricF& b)
       {
         const auto inv_z = 1.0F / (v0.point.w() * b.w0() + v1.point.w() * b.w1() + v2.point.w() * b.w2());
-        if (inv_z < depth(p.x(), p.y()))
+        if (test_and_set_depth(p, inv_z))
         {
           draw_pixel(p, color * light_intensity);
-          set_depth(p.x(), p.y(), inv_z);
         }
       });
 }
@@ -88,7 +365,7 @@ void Renderer::fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const Ve
                                   {
                                     const auto inv_z =
                                         1.0F / (v0.point.w() * b.w0() + v1.point.w() * b.w1() + v2.point.w() * b.w2());
-                                    if (inv_z < depth(p.x(), p.y()))
+                                    if (test_and_set_depth(p, inv_z))
                                     {
                                       const auto w0 = static_cast<float>(b.w0());
                                       const auto w1 = static_cast<float>(b.w1());
@@ -96,21 +373,26 @@ void Renderer::fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const Ve
                                       const auto inv_z_f = static_cast<float>(inv_z);
                                       const auto color = (v0.color * w0 + v1.color * w1 + v2.color * w2) * inv_z_f;
                                       draw_pixel(p, color * light_intensity);
-                                      set_depth(p.x(), p.y(), inv_z);
                                     }
                                   });
 }
 
 void Renderer::fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Texture& texture,
                                   const float light_intensity)
+{
+  fill_triangle_bbox(v0, v1, v2, texture, light_intensity, RowBand{});
+}
+
+void Renderer::fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Texture& texture,
+                                  const float light_intensity, const RowBand& band)
 {
   sw_renderer::fill_triangle_bbox(
-      v0, v1, v2,
+      v0, v1, v2, band.first, band.last,
       [this, &texture, light_intensity](const VertexF& v0, const VertexF& v1, const VertexF& v2, const Point2I& p,
                                         const BarycentricF& b)
       {
         const auto inv_z = 1.0F / (v0.point.w() * b.w0() + v1.point.w() * b.w1() + v2.point.w() * b.w2());
-        if (inv_z < depth(p.x(), p.y()))
+        if (test_and_set_depth(p, inv_z))
         {
           const auto tex_coord = (v0.tex_coord * b.w0() + v1.tex_coord * b.w1() + v2.tex_coord * b.w2()) * inv_z;
           const auto tex_x =
@@ -121,11 +403,92 @@ void Renderer::fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const Ve
                        texture.height() - 1U);
           const auto texel = texture.texel(tex_x, tex_y);
           draw_pixel(p, texel * light_intensity);
-          set_depth(p.x(), p.y(), inv_z);
         }
       });
 }
 
+void Renderer::fill_triangle_spans(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Color color,
+                                   const float light_intensity)
+{
+  fill_triangle_spans(v0, v1, v2, color, light_intensity, RowBand{});
+}
+
+void Renderer::fill_triangle_spans(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Color color,
+                                   const float light_intensity, const RowBand& band)
+{
+  const auto rgba = (color * light_intensity).rgba;
+  sw_renderer::fill_triangle_spans(v0, v1, v2, band.first, band.last,
+                                   [this, rgba](Span span)
+                                   {
+                                     if (clip_span(span, static_cast<std::int32_t>(width()),
+                                                   static_cast<std::int32_t>(height())))
+                                     {
+                                       const auto x_begin = static_cast<std::size_t>(span.x_begin);
+                                       const auto x_end = static_cast<std::size_t>(span.x_end);
+                                       const auto y = static_cast<std::size_t>(span.y);
+                                       if (depth_buffer_.is_unorm())
+                                       {
+                                         // The span kernels work on D32F rows; UNORM depth is tested per pixel.
+                                         for (auto x = span.x_begin; x < span.x_end; ++x)
+                                         {
+                                           const Point2I p{x, span.y};
+                                           if (test_and_set_depth(p, span_inv_z(span, x - span.x_begin)))
+                                           {
+                                             color_buffer_.set_pixel(static_cast<std::size_t>(x), y, Color{rgba});
+                                           }
+                                         }
+                                         return;
+                                       }
+                                       shade_span(span, depth_buffer_.depth_row(x_begin, x_end, y),
+                                                  color_buffer_.pixel_row(x_begin, x_end, y), rgba);
+                                     }
+                                   });
+}
+
+void Renderer::fill_triangle_spans(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Texture& texture,
+                                   const float light_intensity)
+{
+  fill_triangle_spans(v0, v1, v2, texture, light_intensity, RowBand{});
+}
+
+void Renderer::fill_triangle_spans(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Texture& texture,
+                                   const float light_intensity, const RowBand& band)
+{
+  sw_renderer::fill_triangle_spans(v0, v1, v2, band.first, band.last,
+                                   [this, &texture, light_intensity](Span span)
+                                   {
+                                     if (clip_span(span, static_cast<std::int32_t>(width()),
+                                                   static_cast<std::int32_t>(height())))
+                                     {
+                                       const auto x_begin = static_cast<std::size_t>(span.x_begin);
+                                       const auto x_end = static_cast<std::size_t>(span.x_end);
+                                       const auto y = static_cast<std::size_t>(span.y);
+                                       if (depth_buffer_.is_unorm())
+                                       {
+                                         for (auto x = span.x_begin; x < span.x_end; ++x)
+                                         {
+                                           const auto i = x - span.x_begin;
+                                           const auto inv_z = span_inv_z(span, i);
+                                           if (test_and_set_depth(Point2I{x, span.y}, inv_z))
+                                           {
+                                             const auto offset = static_cast<single_precision>(i);
+                                             const auto tex_x = texel_index(
+                                                 (span.start.u + (span.step.u * offset)) * inv_z, texture.width());
+                                             const auto tex_y = texel_index(
+                                                 (span.start.v + (span.step.v * offset)) * inv_z, texture.height());
+                                             color_buffer_.set_pixel(static_cast<std::size_t>(x), y,
+                                                                     texture.texel(tex_x, tex_y) * light_intensity);
+                                           }
+                                         }
+                                         return;
+                                       }
+                                       shade_span(span, depth_buffer_.depth_row(x_begin, x_end, y),
+                                                  color_buffer_.pixel_row(x_begin, x_end, y), texture,
+                                                  light_intensity);
+                                     }
+                                   });
+}
+
 void Renderer::fill_triangle(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Color color,
                              const float light_intensity)
 {
@@ -137,10 +500,9 @@ void Renderer::fill_triangle(const VertexF& v0, const VertexF& v1, const VertexF
         if (contains(b))
         {
           const auto inv_z = 1.0F / (v0.point.w() * b.w0() + v1.point.w() * b.w1() + v2.point.w() * b.w2());
-          if (inv_z < depth(p.x(), p.y()))
+          if (test_and_set_depth(p, inv_z))
           {
             draw_pixel(p, color * light_intensity);
-            set_depth(p.x(), p.y(), inv_z);
           }
         }
       });
@@ -156,7 +518,7 @@ void Renderer::fill_triangle(const VertexF& v0, const VertexF& v1, const VertexF
         if (contains(b))
         {
           const auto inv_z = 1.0F / (v0.point.w() * b.w0() + v1.point.w() * b.w1() + v2.point.w() * b.w2());
-          if (inv_z < depth(p.x(), p.y()))
+          if (test_and_set_depth(p, inv_z))
           {
             const auto w0 = static_cast<float>(b.w0());
             const auto w1 = static_cast<float>(b.w1());
@@ -164,7 +526,6 @@ void Renderer::fill_triangle(const VertexF& v0, const VertexF& v1, const VertexF
             const auto inv_z_f = static_cast<float>(inv_z);
             const auto color = (v0.color * w0 + v1.color * w1 + v2.color * w2) * inv_z_f;
             draw_pixel(p, color * light_intensity);
-            set_depth(p.x(), p.y(), inv_z);
           }
         }
 #ifdef RTW_DEBUG_DRAWING
@@ -187,7 +548,7 @@ void Renderer::fill_triangle(const VertexF& v0, const VertexF& v1, const VertexF
         if (contains(b))
         {
           const auto inv_z = 1.0F / (v0.point.w() * b.w0() + v1.point.w() * b.w1() + v2.point.w() * b.w2());
-          if (inv_z < depth(p.x(), p.y()))
+          if (test_and_set_depth(p, inv_z))
           {
             const auto tex_coord = (v0.tex_coord * b.w0() + v1.tex_coord * b.w1() + v2.tex_coord * b.w2()) * inv_z;
             const auto tex_x =
@@ -198,7 +559,6 @@ void Renderer::fill_triangle(const VertexF& v0, const VertexF& v1, const VertexF
                          texture.height() - 1U);
             const auto texel = texture.texel(tex_x, tex_y);
             draw_pixel(p, texel * light_intensity);
-            set_depth(p.x(), p.y(), inv_z);
           }
         }
       });
@@ -263,76 +623,212 @@ void Renderer::project_to_screen(VertexF& vertex, const Matrix4x4F& projection_m
   vertex.tex_coord /= vertex_w;
 }
 
-void Renderer::draw_mesh(const Mesh& mesh, const Matrix4x4F& model_view_matrix)
+void Renderer::setup_face(const Mesh& mesh, const Face& face, const Matrix4x4F& model_view_matrix,
+                          RenderStats& stats, std::vector<ScreenTriangle>& triangles) const
 {
-  RenderStats frame_stats{};
-  for (const auto& face : mesh.faces)
+  using multiprecision::math::ceil;
+  using multiprecision::math::floor;
+  using std::ceil;
+  using std::floor;
+
+  const auto& material = mesh.material(face.material);
+
+  VertexF v0;
+  VertexF v1;
+  VertexF v2;
+  transform_face_vertices(v0, v1, v2, mesh, face, model_view_matrix);
+  setup_normals(v0, v1, v2, mesh, face, model_view_matrix);
+
+  float light_intensity = 1.0F;
+  if (light_enabled())
+  {
+    light_intensity = calculate_light_intensity(light_direction_, v0.normal);
+  }
+
+  const Texture* texture = nullptr;
+  if (texture_enabled() && !mesh.textures.empty() && !material.diffuse_texture.empty()
+      && mesh.has_texture(material.diffuse_texture))
+  {
+    texture = &mesh.texture(material.diffuse_texture);
+  }
+
+  const auto polygon = clip(v0, v1, v2, stl::make_span(frustum_.planes()));
+  const auto clipped = triangulate(polygon);
+
+  ++stats.triangles_submitted;
+  stats.triangles_clipped += static_cast<std::size_t>(clipped.triangle_count == 0U);
+
+  for (std::size_t i = 0U; i < clipped.triangle_count; ++i)
   {
-    const auto& material = mesh.material(face.material);
+    const auto& triangle = clipped.triangles[i]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    ScreenTriangle screen{triangle[0U], triangle[1U], triangle[2U], material.diffuse, texture, light_intensity};
 
-    VertexF v0;
-    VertexF v1;
-    VertexF v2;
-    transform_face_vertices(v0, v1, v2, mesh, face, model_view_matrix);
-    setup_normals(v0, v1, v2, mesh, face, model_view_matrix);
+    project_to_screen(screen.v0, projection_matrix_, screen_space_matrix_);
+    project_to_screen(screen.v1, projection_matrix_, screen_space_matrix_);
+    project_to_screen(screen.v2, projection_matrix_, screen_space_matrix_);
 
-    float light_intensity = 1.0F;
-    if (light_enabled())
+    if (face_culling_enabled())
     {
-      light_intensity = calculate_light_intensity(light_direction_, v0.normal);
+      if (math::winding_order(screen.v0.point.xy(), screen.v1.point.xy(), screen.v2.point.xy())
+          == math::WindingOrder::CLOCKWISE)
+      {
+        ++stats.triangles_culled;
+        continue;
+      }
     }
 
-    const auto polygon = clip(v0, v1, v2, stl::make_span(frustum_.planes()));
-    const auto triangles = triangulate(polygon);
+    ++stats.triangles_rendered;
+
+    // Vertex markers reach two rows beyond the triangle.
+    constexpr std::int32_t MARKER_REACH{2};
+    screen.min_y =
+        static_cast<std::int32_t>(floor(std::min({screen.v0.point.y(), screen.v1.point.y(), screen.v2.point.y()})))
+        - MARKER_REACH;
+    screen.max_y =
+        static_cast<std::int32_t>(ceil(std::max({screen.v0.point.y(), screen.v1.point.y(), screen.v2.point.y()})))
+        + MARKER_REACH;
+    triangles.push_back(screen);
+  }
+}
 
-    ++frame_stats.triangles_submitted;
-    frame_stats.triangles_clipped += static_cast<std::size_t>(triangles.triangle_count == 0U);
+void Renderer::rasterise_triangle(const ScreenTriangle& triangle, const RowBand& band)
+{
+  const auto& v0 = triangle.v0;
+  const auto& v1 = triangle.v1;
+  const auto& v2 = triangle.v2;
 
-    for (std::size_t i = 0U; i < triangles.triangle_count; ++i)
+  const auto spans = rasteriser_ == Rasteriser::SPANS;
+  if (shading_enabled())
+  {
+    if (spans)
     {
-      const auto& triangle = triangles.triangles[i]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-      v0 = triangle[0U];
-      v1 = triangle[1U];
-      v2 = triangle[2U];
+      fill_triangle_spans(v0, v1, v2, triangle.diffuse, triangle.light_intensity, band);
+    }
+    else
+    {
+      fill_triangle_bbox(v0, v1, v2, triangle.diffuse, triangle.light_intensity, band);
+    }
+  }
 
-      project_to_screen(v0, projection_matrix_, screen_space_matrix_);
-      project_to_screen(v1, projection_matrix_, screen_space_matrix_);
-      project_to_screen(v2, projection_matrix_, screen_space_matrix_);
+  if (triangle.texture != nullptr)
+  {
+    if (spans)
+    {
+      fill_triangle_spans(v0, v1, v2, *triangle.texture, triangle.light_intensity, band);
+    }
+    else
+    {
+      fill_triangle_bbox(v0, v1, v2, *triangle.texture, triangle.light_intensity, band);
+    }
+  }
 
-      if (face_culling_enabled())
-      {
-        if (math::winding_order(v0.point.xy(), v1.point.xy(), v2.point.xy()) == math::WindingOrder::CLOCKWISE)
-        {
-          ++frame_stats.triangles_culled;
-          continue;
-        }
-      }
+  if (wireframe_enabled())
+  {
+    const auto p0 = v0.point.xy().cast<std::int32_t>();
+    const auto p1 = v1.point.xy().cast<std::int32_t>();
+    const auto p2 = v2.point.xy().cast<std::int32_t>();
+    draw_line(p0, p1, Color{0x23'23'23'FF}, band);
+    draw_line(p1, p2, Color{0x23'23'23'FF}, band);
+    draw_line(p2, p0, Color{0x23'23'23'FF}, band);
+  }
 
-      ++frame_stats.triangles_rendered;
+  if (vertex_drawing_enabled())
+  {
+    draw_pixel(v0.point.xy().cast<std::int32_t>(), Color{0xFF'00'00'FF}, 5, band);
+    draw_pixel(v1.point.xy().cast<std::int32_t>(), Color{0xFF'00'00'FF}, 5, band);
+    draw_pixel(v2.point.xy().cast<std::int32_t>(), Color{0xFF'00'00'FF}, 5, band);
+  }
+}
 
-      if (shading_enabled())
-      {
-        fill_triangle_bbox(v0, v1, v2, material.diffuse, light_intensity);
-      }
+void Renderer::set_thread_count(const std::size_t count)
+{
+  thread_count_ = std::max<std::size_t>(count, 1U);
+  if (thread_count_ == 1U)
+  {
+    workers_.reset();
+  }
+  else if ((workers_ == nullptr) || (workers_->thread_count() != thread_count_))
+  {
+    workers_ = std::make_unique<WorkerPool>(thread_count_);
+  }
+}
 
-      if (texture_enabled() && !mesh.textures.empty() && !material.diffuse_texture.empty()
-          && mesh.has_texture(material.diffuse_texture))
-      {
-        const auto& texture = mesh.texture(material.diffuse_texture);
-        fill_triangle_bbox(v0, v1, v2, texture, light_intensity);
-      }
+void Renderer::draw_mesh_parallel(const Mesh& mesh, const Matrix4x4F& model_view_matrix, RenderStats& stats)
+{
+  // Triangle setup: one contiguous run of faces per thread. Concatenating the runs in order restores submission
+  // order, which the raster pass relies on for identical output.
+  const auto face_count = mesh.faces.size();
+  const auto chunk_count = std::clamp<std::size_t>(face_count, 1U, thread_count_);
+  std::vector<std::vector<ScreenTriangle>> chunks(chunk_count);
+  std::vector<RenderStats> chunk_stats(chunk_count);
+  workers_->run(chunk_count,
+                [&](const std::size_t chunk)
+                {
+                  const auto first = (face_count * chunk) / chunk_count;
+                  const auto last = (face_count * (chunk + 1U)) / chunk_count;
+                  chunks[chunk].reserve(last - first);
+                  for (auto face = first; face < last; ++face)
+                  {
+                    setup_face(mesh, mesh.faces[face], model_view_matrix, chunk_stats[chunk], chunks[chunk]);
+                  }
+                });
+  for (const auto& chunk : chunk_stats)
+  {
+    accumulate(stats, chunk);
+  }
 
-      if (wireframe_enabled())
-      {
-        draw_triangle(v0.point.xy().cast<std::int32_t>(), v1.point.xy().cast<std::int32_t>(),
-                      v2.point.xy().cast<std::int32_t>(), Color{0x23'23'23'FF});
-      }
+  // Rasterisation: bands are whole rows of buffer tiles, so the lazy clear of a tile is only ever materialised by
+  // the thread that owns its band.
+  constexpr auto TILE_SIZE = LazyClearBuffer<std::uint32_t>::TILE_SIZE;
+  const auto tile_rows = (height() + TILE_SIZE - 1U) / TILE_SIZE;
+  if (tile_rows == 0U)
+  {
+    return;
+  }
+  const auto target_band_count = thread_count_ * BANDS_PER_THREAD;
+  const auto tiles_per_band = (tile_rows + target_band_count - 1U) / target_band_count;
+  const auto band_count = (tile_rows + tiles_per_band - 1U) / tiles_per_band;
+
+  std::atomic<std::size_t> next_band{0U};
+  workers_->run(std::min(thread_count_, band_count),
+                [&](const std::size_t /*worker*/)
+                {
+                  for (auto band_index = next_band++; band_index < band_count; band_index = next_band++)
+                  {
+                    const auto first_row = band_index * tiles_per_band * TILE_SIZE;
+                    const auto last_row = std::min(first_row + (tiles_per_band * TILE_SIZE), height()) - 1U;
+                    const RowBand band{static_cast<std::int32_t>(first_row), static_cast<std::int32_t>(last_row)};
+                    for (const auto& chunk : chunks)
+                    {
+                      for (const auto& triangle : chunk)
+                      {
+                        if ((triangle.max_y >= band.first) && (triangle.min_y <= band.last))
+                        {
+                          rasterise_triangle(triangle, band);
+                        }
+                      }
+                    }
+                  }
+                });
+}
 
-      if (vertex_drawing_enabled())
+void Renderer::draw_mesh(const Mesh& mesh, const Matrix4x4F& model_view_matrix)
+{
+  RenderStats frame_stats{};
+  if (thread_count_ > 1U)
+  {
+    draw_mesh_parallel(mesh, model_view_matrix, frame_stats);
+  }
+  else
+  {
+    std::vector<ScreenTriangle> triangles;
+    for (const auto& face : mesh.faces)
+    {
+      triangles.clear();
+      setup_face(mesh, face, model_view_matrix, frame_stats, triangles);
+      for (const auto& triangle : triangles)
       {
-        draw_pixel(v0.point.xy().cast<std::int32_t>(), Color{0xFF'00'00'FF}, 5);
-        draw_pixel(v1.point.xy().cast<std::int32_t>(), Color{0xFF'00'00'FF}, 5);
-        draw_pixel(v2.point.xy().cast<std::int32_t>(), Color{0xFF'00'00'FF}, 5);
+        rasterise_triangle(triangle, RowBand{});
       }
     }
   }
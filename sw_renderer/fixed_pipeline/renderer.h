@@ -4,10 +4,17 @@
 #include "sw_renderer/color_buffer.h"
 #include "sw_renderer/depth_buffer.h"
 #include "sw_renderer/mesh.h"
+#include "sw_renderer/parallel.h"
 #include "sw_renderer/render_stats.h"
 #include "sw_renderer/types.h"
 #include "sw_renderer/vertex.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
 namespace rtw::sw_renderer
 {
 
@@ -26,6 +33,13 @@ enum class RenderMode : std::uint8_t
 
 using RenderModeFlags = stl::Flags<RenderMode>;
 
+/// How `Renderer::draw_mesh` fills triangles.
+enum class Rasteriser : std::uint8_t
+{
+  BOUNDING_BOX, ///< fill_triangle_bbox(): edge tests and barycentrics for every pixel of the bounding box.
+  SPANS,        ///< fill_triangle_spans(): per-row spans shaded several pixels at a time.
+};
+
 class Renderer
 {
 public:
@@ -36,6 +50,7 @@ public:
   std::size_t pitch() const { return color_buffer_.pitch(); }
 
   const std::uint32_t* data() const { return color_buffer_.data(); }
+  const ColorBuffer& color_buffer() const { return color_buffer_; }
 
   void clear(const Color color)
   {
@@ -64,6 +79,16 @@ public:
   void set_render_stats_enabled(const bool enabled) { render_mode_.set(RenderMode::STATS, enabled); }
   bool render_stats_enabled() const { return render_mode_.test(RenderMode::STATS); }
 
+  void set_rasteriser(const Rasteriser rasteriser) { rasteriser_ = rasteriser; }
+  Rasteriser rasteriser() const { return rasteriser_; }
+
+  /// Storage format of the depth buffer; D32F (the default) stores the interpolated view depth as is. The UNORM
+  /// formats store it normalised to the near / far planes and compare the integers directly, at the cost of the
+  /// span kernels (see set_rasteriser()), which fall back to a per-pixel loop. Changing the format discards the
+  /// depth buffer's contents.
+  void set_depth_format(const DepthFormat format);
+  DepthFormat depth_format() const { return depth_buffer_.format(); }
+
   void set_depth(const std::size_t x, const std::size_t y, const single_precision depth)
   {
     depth_buffer_.set_depth(x, y, depth);
@@ -87,15 +112,72 @@ public:
   void fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Texture& texture,
                           const float light_intensity);
 
+  /// Span-based counterparts of the fill_triangle_bbox() overloads: the triangle is split into horizontal spans
+  /// (see sw_renderer::fill_triangle_spans) and a span kernel runs the depth test, texture fetch and write for
+  /// several pixels at once. Lighting is per face in this renderer, so it is a constant of the kernel.
+  void fill_triangle_spans(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Color color,
+                           const float light_intensity);
+  void fill_triangle_spans(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Texture& texture,
+                           const float light_intensity);
+
   void fill_triangle(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Color color,
                      const float light_intensity);
   void fill_triangle(const VertexF& v0, const VertexF& v1, const VertexF& v2, const float light_intensity);
   void fill_triangle(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Texture& texture,
                      const float light_intensity);
 
+  /// Number of threads `draw_mesh` uses; 1 (the default) keeps the serial path.
+  ///
+  /// With more threads, faces are transformed, clipped and projected in parallel, then the frame is split into
+  /// horizontal bands of whole buffer tiles and each band is rasterised by one thread with its rows clipped to the
+  /// band. Every band replays the triangles in submission order, so the output is identical to the serial path.
+  /// The threads are started here and kept until the count changes, so draw calls do not create threads.
+  void set_thread_count(const std::size_t count);
+  std::size_t thread_count() const { return thread_count_; }
+
   void draw_mesh(const Mesh& mesh, const Matrix4x4F& model_view_matrix);
 
 private:
+  /// Inclusive range of rows a rasterisation pass may write to.
+  struct RowBand
+  {
+    std::int32_t first{std::numeric_limits<std::int32_t>::min()};
+    std::int32_t last{std::numeric_limits<std::int32_t>::max()};
+
+    bool contains(const std::int32_t y) const { return (y >= first) && (y <= last); }
+  };
+
+  /// A clipped, projected and culled triangle ready for rasterisation.
+  struct ScreenTriangle
+  {
+    VertexF v0;
+    VertexF v1;
+    VertexF v2;
+    Color diffuse;
+    const Texture* texture{nullptr}; ///< Set when textured fill applies to this triangle.
+    float light_intensity{1.0F};
+    std::int32_t min_y{}; ///< Rows touched by the triangle, including wireframe and vertex markers.
+    std::int32_t max_y{};
+  };
+
+  void setup_face(const Mesh& mesh, const Face& face, const Matrix4x4F& model_view_matrix, RenderStats& stats,
+                  std::vector<ScreenTriangle>& triangles) const;
+  void rasterise_triangle(const ScreenTriangle& triangle, const RowBand& band);
+  void draw_mesh_parallel(const Mesh& mesh, const Matrix4x4F& model_view_matrix, RenderStats& stats);
+
+  void fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Color color,
+                          const float light_intensity, const RowBand& band);
+  void fill_triangle_bbox(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Texture& texture,
+                          const float light_intensity, const RowBand& band);
+  void fill_triangle_spans(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Color color,
+                           const float light_intensity, const RowBand& band);
+  void fill_triangle_spans(const VertexF& v0, const VertexF& v1, const VertexF& v2, const Texture& texture,
+                           const float light_intensity, const RowBand& band);
+  void draw_pixel(const Point2I& point, const Color color, const std::uint16_t size, const RowBand& band);
+  /// Depth test (less) of @p inv_z at @p point in the depth buffer's format; stores it and returns true on pass.
+  bool test_and_set_depth(const Point2I& point, const single_precision inv_z);
+  void draw_line(const Point2I& p0, const Point2I& p1, const Color color, const RowBand& band);
+
   static void transform_face_vertices(VertexF& v0, VertexF& v1, VertexF& v2, const Mesh& mesh, const Face& face,
                                       const Matrix4x4F& model_view_matrix);
   static void setup_normals(VertexF& v0, VertexF& v1, VertexF& v2, const Mesh& mesh, const Face& face,
@@ -113,6 +195,9 @@ private:
   RenderStats stats_;
   RenderModeFlags render_mode_{RenderMode::FACE_CULLING | RenderMode::WIREFRAME | RenderMode::SHADING
                                | RenderMode::LIGHT | RenderMode::STATS};
+  std::size_t thread_count_{1U};
+  std::unique_ptr<WorkerPool> workers_; ///< Set while thread_count_ is above 1.
+  Rasteriser rasteriser_{Rasteriser::BOUNDING_BOX};
 };
 
 } // namespace rtw::sw_renderer
@@ -1,8 +1,11 @@
 #include "sw_renderer/fixed_pipeline/rasterisation_routines.h"
 
+#include "math/barycentric_operations.h"
+
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <vector>
@@ -111,6 +114,93 @@ TEST(Rasterisation, fill_triangle_scanline_flat_bottom)
   EXPECT_GT(pixel_count, 0U);
 }
 
+TEST(Rasterisation, fill_triangle_bbox_row_bands_match_single_pass)
+{
+  constexpr std::int32_t GRID = 64;
+  const VertexF v0{Point4F{3.3F, 2.7F, 1.0F, 1.0F}};
+  const VertexF v1{Point4F{60.1F, 21.9F, 1.0F, 1.0F}};
+  const VertexF v2{Point4F{17.6F, 58.4F, 1.0F, 1.0F}};
+
+  std::vector<float> single_pass(static_cast<std::size_t>(GRID * GRID), -1.0F);
+  std::vector<float> banded(static_cast<std::size_t>(GRID * GRID), -1.0F);
+  const auto record = [](std::vector<float>& weights)
+  {
+    return [&weights](const VertexF&, const VertexF&, const VertexF&, const Point2I& p, const BarycentricF& b)
+    {
+      auto& weight = weights[static_cast<std::size_t>((p.y() * GRID) + p.x())];
+      EXPECT_EQ(weight, -1.0F);
+      weight = static_cast<float>(b.w0());
+    };
+  };
+
+  fill_triangle_bbox(v0, v1, v2, record(single_pass));
+  for (std::int32_t first_row = 0; first_row < GRID; first_row += 16)
+  {
+    fill_triangle_bbox(v0, v1, v2, first_row, first_row + 15, record(banded));
+  }
+
+  EXPECT_EQ(banded, single_pass);
+}
+
+TEST(Rasterisation, fill_triangle_spans_cover_bbox_pixels)
+{
+  constexpr std::int32_t GRID = 64;
+  const std::vector<std::array<VertexF, 3U>> triangles{
+      {VertexF{Point4F{3.3F, 2.7F, 1.0F, 1.0F}}, VertexF{Point4F{60.1F, 21.9F, 1.0F, 1.0F}},
+       VertexF{Point4F{17.6F, 58.4F, 1.0F, 1.0F}}},
+      // Clockwise winding and a pixel-aligned axis-parallel edge (top-left rule).
+      {VertexF{Point4F{10.0F, 10.0F, 1.0F, 1.0F}}, VertexF{Point4F{10.0F, 50.0F, 1.0F, 1.0F}},
+       VertexF{Point4F{50.0F, 10.0F, 1.0F, 1.0F}}},
+      // A sliver.
+      {VertexF{Point4F{1.2F, 5.5F, 1.0F, 1.0F}}, VertexF{Point4F{62.8F, 7.1F, 1.0F, 1.0F}},
+       VertexF{Point4F{30.4F, 6.9F, 1.0F, 1.0F}}},
+  };
+
+  for (const auto& [v0, v1, v2] : triangles)
+  {
+    std::vector<int> bbox(static_cast<std::size_t>(GRID * GRID), 0);
+    std::vector<int> spans(static_cast<std::size_t>(GRID * GRID), 0);
+    fill_triangle_bbox(v0, v1, v2,
+                       [&bbox](const VertexF&, const VertexF&, const VertexF&, const Point2I& p, const BarycentricF&)
+                       { ++bbox[static_cast<std::size_t>((p.y() * GRID) + p.x())]; });
+    fill_triangle_spans(v0, v1, v2,
+                        [&spans](const Span& span)
+                        {
+                          for (auto x = span.x_begin; x < span.x_end; ++x)
+                          {
+                            ++spans[static_cast<std::size_t>((span.y * GRID) + x)];
+                          }
+                        });
+    EXPECT_EQ(spans, bbox);
+  }
+}
+
+TEST(Rasterisation, fill_triangle_spans_interpolate_attributes)
+{
+  VertexF v0{Point4F{4.0F, 4.0F, 1.0F, 0.5F}, TexCoordF{0.0F, 0.0F}};
+  VertexF v1{Point4F{60.0F, 8.0F, 1.0F, 0.25F}, TexCoordF{0.25F, 0.0F}};
+  VertexF v2{Point4F{20.0F, 56.0F, 1.0F, 0.125F}, TexCoordF{0.0F, 0.125F}};
+
+  std::size_t checked = 0U;
+  fill_triangle_spans(v0, v1, v2,
+                      [&](const Span& span)
+                      {
+                        for (auto x = span.x_begin; x < span.x_end; ++x)
+                        {
+                          const auto i = static_cast<float>(x - span.x_begin);
+                          const Point2F p{static_cast<float>(x) + 0.5F, static_cast<float>(span.y) + 0.5F};
+                          const auto b = math::make_barycentric(v0.point.xy(), v1.point.xy(), v2.point.xy(), p);
+                          const auto inv_w = (v0.point.w() * b.w0()) + (v1.point.w() * b.w1()) + (v2.point.w() * b.w2());
+                          const auto u = (v0.tex_coord.u() * b.w0()) + (v1.tex_coord.u() * b.w1())
+                                         + (v2.tex_coord.u() * b.w2());
+                          EXPECT_NEAR(span.start.inv_w + (span.step.inv_w * i), inv_w, 1e-5F);
+                          EXPECT_NEAR(span.start.u + (span.step.u * i), u, 1e-5F);
+                          ++checked;
+                        }
+                      });
+  EXPECT_GT(checked, 0U);
+}
+
 TEST(Rasterisation, fill_triangle_scanline_flat_top)
 {
   std::size_t pixel_count = 0;
@@ -5,6 +5,10 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <random>
+#include <vector>
+
 namespace rtw::sw_renderer
 {
 namespace
@@ -95,6 +99,163 @@ TEST(Renderer, render_mode_flags_toggle)
   EXPECT_FALSE(renderer.texture_enabled());
 }
 
+// --- Parallel draw tests ---
+
+/// Overlapping, randomly placed triangles in front of the camera, alternating between two materials.
+Mesh make_random_mesh(const std::size_t triangle_count)
+{
+  std::mt19937 rng{5U};
+  std::uniform_real_distribution<float> xy{-4.0F, 4.0F};
+  std::uniform_real_distribution<float> z{-12.0F, -3.0F};
+  std::uniform_real_distribution<float> offset{-1.5F, 1.5F};
+
+  Mesh mesh;
+  mesh.materials.emplace("red", Material{"red", {}, {}, {}, {}, Color{0xC0'20'20'FF}, {}});
+  mesh.materials.emplace("blue", Material{"blue", {}, {}, {}, {}, Color{0x20'40'C0'FF}, {}});
+  for (std::size_t i = 0U; i < triangle_count; ++i)
+  {
+    const Point3F centre{xy(rng), xy(rng), z(rng)};
+    const auto first = static_cast<std::uint32_t>(mesh.vertices.size());
+    for (std::size_t corner = 0U; corner < 3U; ++corner)
+    {
+      mesh.vertices.push_back(Point3F{centre.x() + offset(rng), centre.y() + offset(rng), centre.z() + offset(rng)});
+    }
+    mesh.faces.push_back(
+        Face{Index{first, first + 1U, first + 2U}, std::nullopt, std::nullopt, ((i % 2U) == 0U) ? "red" : "blue"});
+  }
+  return mesh;
+}
+
+TEST(Renderer, parallel_draw_mesh_matches_serial)
+{
+  // A height that is not a multiple of the band size exercises the short last band.
+  constexpr std::size_t WIDTH = 160;
+  constexpr std::size_t HEIGHT = 100;
+  const auto mesh = make_random_mesh(400U);
+  const auto identity = Matrix4x4F{math::IDENTITY};
+
+  const auto render = [&](const std::size_t thread_count)
+  {
+    auto renderer = std::make_unique<Renderer>(WIDTH, HEIGHT);
+    renderer->set_thread_count(thread_count);
+    renderer->set_face_culling_enabled(false);
+    renderer->set_vertex_drawing_enabled(true);
+    renderer->clear(Color{0x00'00'00'FF});
+    renderer->draw_mesh(mesh, identity);
+    return renderer;
+  };
+
+  const auto serial = render(1U);
+  const std::vector<std::uint32_t> expected(serial->data(), serial->data() + (WIDTH * HEIGHT));
+  for (const std::size_t thread_count : {2U, 3U, 8U})
+  {
+    const auto parallel = render(thread_count);
+    EXPECT_EQ(parallel->thread_count(), thread_count);
+    const std::vector<std::uint32_t> actual(parallel->data(), parallel->data() + (WIDTH * HEIGHT));
+    EXPECT_EQ(actual, expected) << thread_count << " threads";
+    EXPECT_EQ(parallel->stats().triangles_submitted, serial->stats().triangles_submitted);
+    EXPECT_EQ(parallel->stats().triangles_clipped, serial->stats().triangles_clipped);
+    EXPECT_EQ(parallel->stats().triangles_rendered, serial->stats().triangles_rendered);
+  }
+}
+
+TEST(Renderer, parallel_draws_reuse_the_workers)
+{
+  constexpr std::size_t WIDTH = 160;
+  constexpr std::size_t HEIGHT = 100;
+  const auto mesh = make_random_mesh(400U);
+  const auto identity = Matrix4x4F{math::IDENTITY};
+
+  const auto draw = [&](Renderer& renderer)
+  {
+    renderer.clear(Color{0x00'00'00'FF});
+    renderer.draw_mesh(mesh, identity);
+    return std::vector<std::uint32_t>(renderer.data(), renderer.data() + (WIDTH * HEIGHT));
+  };
+
+  Renderer renderer{WIDTH, HEIGHT};
+  renderer.set_face_culling_enabled(false);
+  const auto expected = draw(renderer);
+
+  // Several frames on the same workers, then on a different number of them, then serially again.
+  for (const std::size_t thread_count : {4U, 4U, 2U, 1U})
+  {
+    renderer.set_thread_count(thread_count);
+    EXPECT_EQ(draw(renderer), expected) << thread_count << " threads";
+    EXPECT_EQ(draw(renderer), expected) << thread_count << " threads";
+  }
+}
+
+TEST(Renderer, span_rasteriser_matches_bounding_box)
+{
+  constexpr std::size_t WIDTH = 160;
+  constexpr std::size_t HEIGHT = 100;
+  const auto mesh = make_random_mesh(400U);
+  const auto identity = Matrix4x4F{math::IDENTITY};
+
+  const auto render = [&](const Rasteriser rasteriser, const std::size_t thread_count)
+  {
+    auto renderer = std::make_unique<Renderer>(WIDTH, HEIGHT);
+    renderer->set_rasteriser(rasteriser);
+    renderer->set_thread_count(thread_count);
+    renderer->set_face_culling_enabled(false);
+    renderer->set_wireframe_enabled(false);
+    renderer->clear(Color{0x00'00'00'FF});
+    renderer->draw_mesh(mesh, identity);
+    return std::vector<std::uint32_t>(renderer->data(), renderer->data() + (WIDTH * HEIGHT));
+  };
+
+  // The spans interpolate 1/w incrementally in single precision instead of from double-precision barycentrics, so
+  // depth ties between overlapping triangles may resolve differently on a few pixels.
+  const auto bbox = render(Rasteriser::BOUNDING_BOX, 1U);
+  const auto spans = render(Rasteriser::SPANS, 1U);
+  std::size_t differing = 0U;
+  for (std::size_t i = 0U; i < bbox.size(); ++i)
+  {
+    differing += static_cast<std::size_t>(bbox[i] != spans[i]);
+  }
+  EXPECT_LT(differing, bbox.size() / 100U);
+
+  EXPECT_EQ(render(Rasteriser::SPANS, 4U), spans);
+}
+
+TEST(Renderer, unorm_depth_formats_match_d32f)
+{
+  constexpr std::size_t WIDTH = 160;
+  constexpr std::size_t HEIGHT = 100;
+  const auto mesh = make_random_mesh(400U);
+  const auto identity = Matrix4x4F{math::IDENTITY};
+
+  const auto render = [&](const DepthFormat format, const Rasteriser rasteriser)
+  {
+    auto renderer = std::make_unique<Renderer>(WIDTH, HEIGHT);
+    renderer->set_depth_format(format);
+    renderer->set_rasteriser(rasteriser);
+    renderer->set_face_culling_enabled(false);
+    renderer->set_wireframe_enabled(false);
+    renderer->clear(Color{0x00'00'00'FF});
+    renderer->draw_mesh(mesh, identity);
+    EXPECT_EQ(renderer->depth_format(), format);
+    return std::vector<std::uint32_t>(renderer->data(), renderer->data() + (WIDTH * HEIGHT));
+  };
+
+  // Quantised depths tie where D32F still tells two surfaces apart; only a few pixels may flip.
+  const auto reference = render(DepthFormat::D32F, Rasteriser::BOUNDING_BOX);
+  for (const auto format : {DepthFormat::D24_UNORM, DepthFormat::D16_UNORM})
+  {
+    for (const auto rasteriser : {Rasteriser::BOUNDING_BOX, Rasteriser::SPANS})
+    {
+      const auto image = render(format, rasteriser);
+      std::size_t differing = 0U;
+      for (std::size_t i = 0U; i < reference.size(); ++i)
+      {
+        differing += static_cast<std::size_t>(reference[i] != image[i]);
+      }
+      EXPECT_LT(differing, reference.size() / 100U);
+    }
+  }
+}
+
 // --- Texture coordinate boundary test ---
 
 TEST(Renderer, texture_coord_boundary_does_not_overflow)
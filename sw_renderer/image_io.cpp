@@ -0,0 +1,468 @@
+#include "sw_renderer/image_io.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+
+namespace
+{
+
+/// Reads the next unsigned header field of a PPM, skipping whitespace and `#` comments.
+std::optional<std::size_t> read_header_field(std::istream& stream)
+{
+  while (stream)
+  {
+    const auto c = stream.peek();
+    if (c == '#')
+    {
+      stream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    else if ((c == ' ') || (c == '\t') || (c == '\n') || (c == '\r'))
+    {
+      stream.get();
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  std::size_t value = 0U;
+  if (!(stream >> value))
+  {
+    return std::nullopt;
+  }
+  return value;
+}
+
+/// Same as read_header_field, over the bytes of a file held in memory; advances @p offset past the field.
+std::optional<std::size_t> parse_header_field(const stl::Span<const std::uint8_t> bytes, std::size_t& offset)
+{
+  while (offset < bytes.size())
+  {
+    const auto c = bytes[offset];
+    if (c == '#')
+    {
+      while ((offset < bytes.size()) && (bytes[offset] != '\n'))
+      {
+        ++offset;
+      }
+    }
+    else if ((c == ' ') || (c == '\t') || (c == '\n') || (c == '\r'))
+    {
+      ++offset;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  constexpr std::size_t MAX_DIGITS{9U};
+  const auto begin = offset;
+  std::size_t value = 0U;
+  while ((offset < bytes.size()) && (bytes[offset] >= '0') && (bytes[offset] <= '9') && ((offset - begin) < MAX_DIGITS))
+  {
+    value = (value * 10U) + static_cast<std::size_t>(bytes[offset] - '0');
+    ++offset;
+  }
+  if (offset == begin)
+  {
+    return std::nullopt;
+  }
+  return value;
+}
+
+constexpr std::uint32_t pack_rgba(const std::uint32_t r, const std::uint32_t g, const std::uint32_t b,
+                                  const std::uint32_t a)
+{
+  return (r << 24U) | (g << 16U) | (b << 8U) | a;
+}
+
+// QOI, see https://qoiformat.org/qoi-specification.pdf.
+constexpr std::size_t QOI_HEADER_SIZE{14U};
+constexpr std::array<std::uint8_t, 8U> QOI_END_MARKER{0U, 0U, 0U, 0U, 0U, 0U, 0U, 1U};
+constexpr std::uint8_t QOI_OP_INDEX{0x00U};
+constexpr std::uint8_t QOI_OP_DIFF{0x40U};
+constexpr std::uint8_t QOI_OP_LUMA{0x80U};
+constexpr std::uint8_t QOI_OP_RUN{0xC0U};
+constexpr std::uint8_t QOI_OP_RGB{0xFEU};
+constexpr std::uint8_t QOI_OP_RGBA{0xFFU};
+constexpr std::uint8_t QOI_TAG_MASK{0xC0U};
+/// The limit the QOI reference implementation enforces; the PPM decoder shares it.
+constexpr std::size_t MAX_PIXELS{400'000'000U};
+
+/// Position of @p rgba in the QOI table of recently seen pixels.
+constexpr std::size_t qoi_hash(const std::uint32_t rgba)
+{
+  const auto r = rgba >> 24U;
+  const auto g = (rgba >> 16U) & 0xFFU;
+  const auto b = (rgba >> 8U) & 0xFFU;
+  const auto a = rgba & 0xFFU;
+  return ((r * 3U) + (g * 5U) + (b * 7U) + (a * 11U)) % 64U;
+}
+
+std::uint32_t read_big_endian(const stl::Span<const std::uint8_t> bytes, const std::size_t offset)
+{
+  return (static_cast<std::uint32_t>(bytes[offset]) << 24U) | (static_cast<std::uint32_t>(bytes[offset + 1U]) << 16U)
+         | (static_cast<std::uint32_t>(bytes[offset + 2U]) << 8U) | static_cast<std::uint32_t>(bytes[offset + 3U]);
+}
+
+void write_big_endian(std::vector<std::uint8_t>& bytes, const std::uint32_t value)
+{
+  for (std::uint32_t shift = 32U; shift > 0U; shift -= 8U)
+  {
+    bytes.push_back(static_cast<std::uint8_t>(value >> (shift - 8U)));
+  }
+}
+
+} // namespace
+
+void write_ppm(std::ostream& stream, const ColorBuffer& buffer)
+{
+  stream << "P6\n" << buffer.width() << ' ' << buffer.height() << "\n255\n";
+
+  std::vector<char> row(buffer.width() * 3U);
+  for (std::size_t y = 0U; y < buffer.height(); ++y)
+  {
+    for (std::size_t x = 0U; x < buffer.width(); ++x)
+    {
+      const auto color = buffer.pixel(x, y);
+      row[(x * 3U) + 0U] = static_cast<char>(color.r());
+      row[(x * 3U) + 1U] = static_cast<char>(color.g());
+      row[(x * 3U) + 2U] = static_cast<char>(color.b());
+    }
+    stream.write(row.data(), static_cast<std::streamsize>(row.size()));
+  }
+}
+
+bool write_ppm(const std::filesystem::path& path, const ColorBuffer& buffer)
+{
+  std::ofstream file{path, std::ios::binary};
+  if (!file)
+  {
+    return false;
+  }
+  write_ppm(file, buffer);
+  return static_cast<bool>(file);
+}
+
+std::optional<ColorBuffer> read_ppm(std::istream& stream)
+{
+  std::string magic(2U, '\0');
+  if (!stream.read(magic.data(), 2) || (magic != "P6"))
+  {
+    return std::nullopt;
+  }
+
+  const auto width = read_header_field(stream);
+  const auto height = read_header_field(stream);
+  const auto max_value = read_header_field(stream);
+  if (!width || !height || !max_value || (*max_value != 255U))
+  {
+    return std::nullopt;
+  }
+  stream.get(); // The single whitespace character that ends the header.
+
+  ColorBuffer buffer{*width, *height};
+  std::vector<char> row(*width * 3U);
+  for (std::size_t y = 0U; y < *height; ++y)
+  {
+    if (!stream.read(row.data(), static_cast<std::streamsize>(row.size())))
+    {
+      return std::nullopt;
+    }
+    for (std::size_t x = 0U; x < *width; ++x)
+    {
+      buffer.set_pixel(x, y,
+                       Color{static_cast<std::uint8_t>(row[(x * 3U) + 0U]),
+                             static_cast<std::uint8_t>(row[(x * 3U) + 1U]),
+                             static_cast<std::uint8_t>(row[(x * 3U) + 2U])});
+    }
+  }
+  return buffer;
+}
+
+std::optional<ColorBuffer> read_ppm(const std::filesystem::path& path)
+{
+  std::ifstream file{path, std::ios::binary};
+  if (!file)
+  {
+    return std::nullopt;
+  }
+  return read_ppm(file);
+}
+
+std::optional<Image> decode_ppm(const stl::Span<const std::uint8_t> bytes)
+{
+  if ((bytes.size() < 2U) || (bytes[0U] != 'P') || (bytes[1U] != '6'))
+  {
+    return std::nullopt;
+  }
+
+  std::size_t offset = 2U;
+  const auto width = parse_header_field(bytes, offset);
+  const auto height = parse_header_field(bytes, offset);
+  const auto max_value = parse_header_field(bytes, offset);
+  if (!width || !height || !max_value || (*max_value != 255U) || (*width == 0U) || (*height == 0U)
+      || (*height > (MAX_PIXELS / *width)))
+  {
+    return std::nullopt;
+  }
+  ++offset; // The single whitespace character that ends the header.
+
+  const auto pixel_count = *width * *height;
+  if ((offset > bytes.size()) || (((bytes.size() - offset) / 3U) < pixel_count))
+  {
+    return std::nullopt;
+  }
+
+  Image image{*width, *height, std::vector<std::uint32_t>(pixel_count)};
+  for (auto& texel : image.texels)
+  {
+    texel = pack_rgba(bytes[offset], bytes[offset + 1U], bytes[offset + 2U], 0xFFU);
+    offset += 3U;
+  }
+  return image;
+}
+
+std::optional<Image> decode_qoi(const stl::Span<const std::uint8_t> bytes)
+{
+  if ((bytes.size() < (QOI_HEADER_SIZE + QOI_END_MARKER.size())) || (bytes[0U] != 'q') || (bytes[1U] != 'o')
+      || (bytes[2U] != 'i') || (bytes[3U] != 'f'))
+  {
+    return std::nullopt;
+  }
+  const std::size_t width = read_big_endian(bytes, 4U);
+  const std::size_t height = read_big_endian(bytes, 8U);
+  const auto channels = bytes[12U];
+  if ((width == 0U) || (height == 0U) || ((channels != 3U) && (channels != 4U)) || (height > (MAX_PIXELS / width)))
+  {
+    return std::nullopt;
+  }
+
+  Image image{width, height, std::vector<std::uint32_t>(width * height)};
+  std::array<std::uint32_t, 64U> seen{};
+  std::uint32_t pixel = pack_rgba(0U, 0U, 0U, 0xFFU);
+  const auto chunks_end = bytes.size() - QOI_END_MARKER.size();
+  std::size_t offset = QOI_HEADER_SIZE;
+  std::size_t run = 0U;
+  for (auto& texel : image.texels)
+  {
+    if (run > 0U)
+    {
+      --run;
+    }
+    else
+    {
+      if (offset >= chunks_end)
+      {
+        return std::nullopt;
+      }
+      const auto op = bytes[offset++];
+      const auto r = pixel >> 24U;
+      const auto g = (pixel >> 16U) & 0xFFU;
+      const auto b = (pixel >> 8U) & 0xFFU;
+      const auto a = pixel & 0xFFU;
+      if ((op == QOI_OP_RGB) || (op == QOI_OP_RGBA))
+      {
+        const std::size_t size = (op == QOI_OP_RGB) ? 3U : 4U;
+        if ((chunks_end - offset) < size)
+        {
+          return std::nullopt;
+        }
+        pixel = pack_rgba(bytes[offset], bytes[offset + 1U], bytes[offset + 2U], (size == 4U) ? bytes[offset + 3U] : a);
+        offset += size;
+      }
+      else if ((op & QOI_TAG_MASK) == QOI_OP_INDEX)
+      {
+        pixel = seen[op]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+      }
+      else if ((op & QOI_TAG_MASK) == QOI_OP_DIFF)
+      {
+        // Channel differences of -2..1, wrapping around.
+        pixel = pack_rgba((r + ((op >> 4U) & 3U) - 2U) & 0xFFU, (g + ((op >> 2U) & 3U) - 2U) & 0xFFU,
+                          (b + (op & 3U) - 2U) & 0xFFU, a);
+      }
+      else if ((op & QOI_TAG_MASK) == QOI_OP_LUMA)
+      {
+        if (offset >= chunks_end)
+        {
+          return std::nullopt;
+        }
+        // A green difference of -32..31 and red/blue differences of -8..7 relative to it.
+        const auto next = bytes[offset++];
+        const std::uint32_t dg = (op & 0x3FU) - 32U;
+        pixel = pack_rgba((r + dg + ((next >> 4U) & 0x0FU) - 8U) & 0xFFU, (g + dg) & 0xFFU,
+                          (b + dg + (next & 0x0FU) - 8U) & 0xFFU, a);
+      }
+      else
+      {
+        run = op & 0x3FU; // The current pixel plus `run` more repeat the previous one.
+      }
+      seen[qoi_hash(pixel)] = pixel; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+    texel = pixel;
+  }
+  return image;
+}
+
+std::vector<std::uint8_t> encode_qoi(const Image& image)
+{
+  assert(image.texels.size() == (image.width * image.height) && "texel count must match the size");
+
+  std::vector<std::uint8_t> bytes{'q', 'o', 'i', 'f'};
+  bytes.reserve(QOI_HEADER_SIZE + (image.texels.size() * 5U) + QOI_END_MARKER.size());
+  write_big_endian(bytes, static_cast<std::uint32_t>(image.width));
+  write_big_endian(bytes, static_cast<std::uint32_t>(image.height));
+  bytes.push_back(4U); // channels
+  bytes.push_back(0U); // sRGB with linear alpha
+
+  constexpr std::uint32_t MAX_RUN{62U};
+  std::array<std::uint32_t, 64U> seen{};
+  std::uint32_t previous = pack_rgba(0U, 0U, 0U, 0xFFU);
+  std::uint32_t run = 0U;
+  for (std::size_t i = 0U; i < image.texels.size(); ++i)
+  {
+    const auto pixel = image.texels[i];
+    if (pixel == previous)
+    {
+      ++run;
+      if ((run == MAX_RUN) || ((i + 1U) == image.texels.size()))
+      {
+        bytes.push_back(static_cast<std::uint8_t>(QOI_OP_RUN | (run - 1U)));
+        run = 0U;
+      }
+      continue;
+    }
+    if (run > 0U)
+    {
+      bytes.push_back(static_cast<std::uint8_t>(QOI_OP_RUN | (run - 1U)));
+      run = 0U;
+    }
+
+    const auto hash = qoi_hash(pixel);
+    if (seen[hash] == pixel) // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    {
+      bytes.push_back(static_cast<std::uint8_t>(QOI_OP_INDEX | hash));
+    }
+    else if ((pixel & 0xFFU) != (previous & 0xFFU))
+    {
+      bytes.insert(bytes.end(), {QOI_OP_RGBA, static_cast<std::uint8_t>(pixel >> 24U),
+                                 static_cast<std::uint8_t>(pixel >> 16U), static_cast<std::uint8_t>(pixel >> 8U),
+                                 static_cast<std::uint8_t>(pixel)});
+    }
+    else
+    {
+      const auto channel_delta = [&](const std::uint32_t shift)
+      { return static_cast<std::int32_t>(static_cast<std::int8_t>((pixel >> shift) - (previous >> shift))); };
+      const auto dr = channel_delta(24U);
+      const auto dg = channel_delta(16U);
+      const auto db = channel_delta(8U);
+      const auto dr_dg = dr - dg;
+      const auto db_dg = db - dg;
+      if ((dr >= -2) && (dr <= 1) && (dg >= -2) && (dg <= 1) && (db >= -2) && (db <= 1))
+      {
+        bytes.push_back(static_cast<std::uint8_t>(QOI_OP_DIFF | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)));
+      }
+      else if ((dg >= -32) && (dg <= 31) && (dr_dg >= -8) && (dr_dg <= 7) && (db_dg >= -8) && (db_dg <= 7))
+      {
+        bytes.push_back(static_cast<std::uint8_t>(QOI_OP_LUMA | (dg + 32)));
+        bytes.push_back(static_cast<std::uint8_t>(((dr_dg + 8) << 4) | (db_dg + 8)));
+      }
+      else
+      {
+        bytes.insert(bytes.end(), {QOI_OP_RGB, static_cast<std::uint8_t>(pixel >> 24U),
+                                   static_cast<std::uint8_t>(pixel >> 16U), static_cast<std::uint8_t>(pixel >> 8U)});
+      }
+    }
+    seen[hash] = pixel; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    previous = pixel;
+  }
+  bytes.insert(bytes.end(), QOI_END_MARKER.begin(), QOI_END_MARKER.end());
+  return bytes;
+}
+
+std::optional<Image> decode_image(const stl::Span<const std::uint8_t> bytes)
+{
+  if ((bytes.size() >= 4U) && (bytes[0U] == 'q') && (bytes[1U] == 'o') && (bytes[2U] == 'i') && (bytes[3U] == 'f'))
+  {
+    return decode_qoi(bytes);
+  }
+  return decode_ppm(bytes);
+}
+
+std::optional<std::vector<std::uint8_t>> read_file(const std::filesystem::path& path)
+{
+  std::ifstream file{path, std::ios::binary | std::ios::ate};
+  if (!file)
+  {
+    return std::nullopt;
+  }
+  const auto size = file.tellg();
+  if (size < 0)
+  {
+    return std::nullopt;
+  }
+  std::vector<std::uint8_t> bytes(static_cast<std::size_t>(size));
+  file.seekg(0);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  if (!file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+  {
+    return std::nullopt;
+  }
+  return bytes;
+}
+
+ImageDifference compare(const ColorBuffer& lhs, const ColorBuffer& rhs, const std::uint8_t channel_tolerance)
+{
+  assert((lhs.width() == rhs.width()) && (lhs.height() == rhs.height()) && "images must have the same size");
+
+  const auto delta = [](const std::uint8_t a, const std::uint8_t b)
+  { return static_cast<std::uint8_t>((a > b) ? (a - b) : (b - a)); };
+
+  ImageDifference difference;
+  for (std::size_t y = 0U; y < lhs.height(); ++y)
+  {
+    for (std::size_t x = 0U; x < lhs.width(); ++x)
+    {
+      const auto a = lhs.pixel(x, y);
+      const auto b = rhs.pixel(x, y);
+      const auto pixel_delta = std::max({delta(a.r(), b.r()), delta(a.g(), b.g()), delta(a.b(), b.b())});
+      difference.max_channel_delta = std::max(difference.max_channel_delta, pixel_delta);
+      if (pixel_delta > channel_tolerance)
+      {
+        ++difference.differing_pixels;
+      }
+    }
+  }
+  return difference;
+}
+
+std::uint64_t checksum(const ColorBuffer& buffer, const std::uint64_t seed)
+{
+  constexpr std::uint64_t FNV_PRIME{0x0000'0100'0000'01B3ULL};
+
+  auto hash = seed;
+  const auto* const pixels = buffer.data();
+  for (std::size_t i = 0U; i < buffer.size(); ++i)
+  {
+    const auto rgba = pixels[i]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    for (std::uint32_t shift = 32U; shift > 0U; shift -= 8U)
+    {
+      hash ^= (rgba >> (shift - 8U)) & 0xFFU;
+      hash *= FNV_PRIME;
+    }
+  }
+  return hash;
+}
+
+} // namespace rtw::sw_renderer
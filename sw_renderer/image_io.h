@@ -0,0 +1,98 @@
+#pragma once
+
+#include "sw_renderer/color_buffer.h"
+
+#include "stl/span.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+
+/// FNV-1a 64-bit offset basis; the default seed of `checksum()`.
+constexpr inline std::uint64_t CHECKSUM_SEED{0xCBF2'9CE4'8422'2325ULL};
+
+/// Write a colour buffer as a binary PPM (P6) image. The alpha channel is dropped.
+/// @param[in,out] stream The output stream; should be opened in binary mode.
+/// @param[in] buffer The image to write.
+void write_ppm(std::ostream& stream, const ColorBuffer& buffer);
+
+/// Write a colour buffer as a binary PPM (P6) file.
+/// @param[in] path Filesystem path of the file to create or overwrite.
+/// @param[in] buffer The image to write.
+/// @return false if the file cannot be opened or written.
+bool write_ppm(const std::filesystem::path& path, const ColorBuffer& buffer);
+
+/// Read a binary PPM (P6) image with a maximum value of 255. Every pixel gets an alpha of 0xFF.
+/// @param[in,out] stream The input stream; should be opened in binary mode.
+/// @return The image, or std::nullopt if the stream does not hold such an image.
+std::optional<ColorBuffer> read_ppm(std::istream& stream);
+
+/// Read a binary PPM (P6) file.
+/// @param[in] path Filesystem path of the file to read.
+/// @return The image, or std::nullopt if the file cannot be opened or is not a supported PPM.
+std::optional<ColorBuffer> read_ppm(const std::filesystem::path& path);
+
+/// A decoded image in Texture's texel layout: RGBA8888 (R in the most significant byte), row-major, top row first.
+/// `Texture{std::move(image.texels), image.width, image.height}` adopts the pixels without copying them.
+struct Image
+{
+  std::size_t width{0U};
+  std::size_t height{0U};
+  std::vector<std::uint32_t> texels;
+};
+
+/// Decode a binary PPM (P6) image with a maximum value of 255 held in memory. Every pixel gets an alpha of 0xFF.
+/// @param[in] bytes The file contents.
+/// @return The image, or std::nullopt if @p bytes do not hold such an image.
+std::optional<Image> decode_ppm(stl::Span<const std::uint8_t> bytes);
+
+/// Decode a QOI ("Quite OK Image") image held in memory. Three-channel images get an alpha of 0xFF; the colour
+/// space byte is ignored.
+/// @param[in] bytes The file contents.
+/// @return The image, or std::nullopt if @p bytes are not a well-formed QOI image.
+std::optional<Image> decode_qoi(stl::Span<const std::uint8_t> bytes);
+
+/// Encode an image as a four-channel QOI file.
+/// @param[in] image The image to encode.
+/// @return The file contents.
+std::vector<std::uint8_t> encode_qoi(const Image& image);
+
+/// Decode a PPM or QOI image held in memory, picking the decoder by the file's magic bytes.
+/// @param[in] bytes The file contents.
+/// @return The image, or std::nullopt if @p bytes hold neither format or are malformed.
+std::optional<Image> decode_image(stl::Span<const std::uint8_t> bytes);
+
+/// Read a whole file into memory.
+/// @param[in] path Filesystem path of the file to read.
+/// @return The file contents, or std::nullopt if the file cannot be opened or read.
+std::optional<std::vector<std::uint8_t>> read_file(const std::filesystem::path& path);
+
+/// Per-pixel difference between two images of the same size, over the RGB channels only.
+struct ImageDifference
+{
+  std::size_t differing_pixels{0U}; ///< Pixels where any channel differs by more than the tolerance.
+  std::uint8_t max_channel_delta{0U};
+};
+
+/// Compare two images of the same size channel by channel, ignoring alpha (PPM files do not store it).
+/// @param[in] lhs The first image.
+/// @param[in] rhs The second image; must have the same width and height as @\p lhs.
+/// @param[in] channel_tolerance Largest per-channel difference that still counts as equal.
+/// @return The number of differing pixels and the largest channel difference seen.
+ImageDifference compare(const ColorBuffer& lhs, const ColorBuffer& rhs, std::uint8_t channel_tolerance = 0U);
+
+/// 64-bit FNV-1a hash over the RGBA bytes of the buffer (row-major, R first), e.g. to compare rendered frames
+/// without storing them. Passing the result of a previous call as @p seed chains frames into one value.
+/// @param[in] buffer The image to hash.
+/// @param[in] seed The initial hash value.
+/// @return The hash.
+std::uint64_t checksum(const ColorBuffer& buffer, std::uint64_t seed = CHECKSUM_SEED);
+
+} // namespace rtw::sw_renderer
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace rtw::sw_renderer
+{
+
+namespace details
+{
+
+/// Fill @p count elements with @p value using non-temporal (streaming) stores where available, so a large fill
+/// does not evict the working set from the caches. Falls back to std::fill for other element sizes or targets.
+template <typename T>
+void stream_fill(T* first, const std::size_t count, const T value) noexcept
+{
+#if defined(__SSE2__)
+  if constexpr ((sizeof(T) == sizeof(std::int32_t)) && std::is_trivially_copyable_v<T>)
+  {
+    std::int32_t bits{0};
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    std::size_t i = 0U;
+    // Align to 16 bytes with scalar streaming stores, then write four elements per store.
+    for (; (i < count) && ((reinterpret_cast<std::uintptr_t>(first + i) & 0xFU) != 0U); ++i) // NOLINT
+    {
+      _mm_stream_si32(reinterpret_cast<int*>(first + i), bits); // NOLINT
+    }
+    const auto vector = _mm_set1_epi32(bits);
+    for (; (i + 4U) <= count; i += 4U)
+    {
+      _mm_stream_si128(reinterpret_cast<__m128i*>(first + i), vector); // NOLINT
+    }
+    for (; i < count; ++i)
+    {
+      _mm_stream_si32(reinterpret_cast<int*>(first + i), bits); // NOLINT
+    }
+    return;
+  }
+#endif
+  std::fill(first, first + count, value); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+/// Orders earlier streaming stores before any later store, so another thread reading the buffer sees them.
+inline void stream_fence() noexcept
+{
+#if defined(__SSE2__)
+  _mm_sfence();
+#endif
+}
+
+} // namespace details
+
+/// Row-major 2D storage whose clears are deferred per tile ("fast clear").
+///
+/// The buffer is split into TILE_SIZE x TILE_SIZE tiles, each with a "cleared" flag. `clear()` only records the
+/// clear value and raises every flag, so its cost is proportional to the number of tiles instead of the number of
+/// elements. Loads from a cleared tile return the clear value without touching the element memory; the first
+/// store into a cleared tile materialises the whole tile (fills it with the clear value) and lowers its flag.
+/// `resolve()` materialises the tiles that were never written with streaming stores, which is cheaper than a
+/// regular fill and leaves the caches to the tiles that were drawn to.
+///
+/// Stores into different tiles touch disjoint flags and elements, so threads that work on disjoint sets of tiles
+/// can write concurrently. `clear()`, `resolve()` and `data()` must not run concurrently with anything else.
+template <typename T>
+class LazyClearBuffer
+{
+public:
+  /// Tile edge length in elements; a power of two.
+  static constexpr std::size_t TILE_SIZE{16U};
+
+  LazyClearBuffer(const std::size_t width, const std::size_t height, const T value)
+      : buffer_(width * height, value), cleared_(tile_count(width, height), 0U), width_(width), height_(height),
+        tiles_x_((width + TILE_SIZE - 1U) / TILE_SIZE), clear_value_(value)
+  {
+  }
+
+  std::size_t width() const noexcept { return width_; }
+  std::size_t height() const noexcept { return height_; }
+  std::size_t size() const noexcept { return buffer_.size(); }
+  std::size_t tiles_x() const noexcept { return tiles_x_; }
+  std::size_t tiles_y() const noexcept { return (height_ + TILE_SIZE - 1U) / TILE_SIZE; }
+
+  T load(const std::size_t x, const std::size_t y) const
+  {
+    assert(x < width_ && "x coordinate out of bounds");
+    assert(y < height_ && "y coordinate out of bounds");
+    return (cleared_[tile_index(x, y)] != 0U) ? clear_value_ : buffer_[(y * width_) + x];
+  }
+
+  void store(const std::size_t x, const std::size_t y, const T value)
+  {
+    assert(x < width_ && "x coordinate out of bounds");
+    assert(y < height_ && "y coordinate out of bounds");
+    const auto tile = tile_index(x, y);
+    if (cleared_[tile] != 0U)
+    {
+      materialise(tile);
+    }
+    buffer_[(y * width_) + x] = value;
+  }
+
+  /// Materialises the tiles covering elements [@p x_begin, @p x_end) of row @p y and returns a pointer to element
+  /// (@p x_begin, @p y), so a span of the row can be loaded and stored directly, e.g. with SIMD.
+  T* row(const std::size_t x_begin, const std::size_t x_end, const std::size_t y)
+  {
+    assert(x_begin <= x_end && x_end <= width_ && "row span out of bounds");
+    assert(y < height_ && "y coordinate out of bounds");
+    if (x_begin < x_end)
+    {
+      const auto last_tile = tile_index(x_end - 1U, y);
+      for (auto tile = tile_index(x_begin, y); tile <= last_tile; ++tile)
+      {
+        if (cleared_[tile] != 0U)
+        {
+          materialise(tile);
+        }
+      }
+    }
+    return buffer_.data() + (y * width_) + x_begin; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  }
+
+  /// Defers filling the whole buffer with @p value; see the class description.
+  void clear(const T value)
+  {
+    clear_value_ = value;
+    std::fill(cleared_.begin(), cleared_.end(), std::uint8_t{1U});
+    resolve_pending_ = true;
+  }
+
+  T clear_value() const noexcept { return clear_value_; }
+
+  /// @return true if the tile holding (x, y) has not been written since the last clear, i.e. every element of it
+  /// equals `clear_value()`.
+  bool is_cleared(const std::size_t x, const std::size_t y) const { return cleared_[tile_index(x, y)] != 0U; }
+
+  /// Number of tiles still waiting to be materialised.
+  std::size_t cleared_tile_count() const
+  {
+    return static_cast<std::size_t>(std::count(cleared_.begin(), cleared_.end(), std::uint8_t{1U}));
+  }
+
+  /// Materialises every pending tile with streaming stores.
+  void resolve() const
+  {
+    if (!resolve_pending_)
+    {
+      return;
+    }
+    const auto tiles_y = this->tiles_y();
+    for (std::size_t ty = 0U; ty < tiles_y; ++ty)
+    {
+      const auto first = cleared_.begin() + static_cast<std::ptrdiff_t>(ty * tiles_x_);
+      const auto last = first + static_cast<std::ptrdiff_t>(tiles_x_);
+      if (std::all_of(first, last, [](const std::uint8_t flag) { return flag != 0U; }))
+      {
+        // A whole row of tiles is one contiguous range: stream it in one go instead of tile by tile.
+        const auto y0 = ty * TILE_SIZE;
+        const auto rows = std::min(TILE_SIZE, height_ - y0);
+        details::stream_fill(buffer_.data() + (y0 * width_), rows * width_, clear_value_); // NOLINT
+        continue;
+      }
+      for (std::size_t tile = ty * tiles_x_; tile < (ty + 1U) * tiles_x_; ++tile)
+      {
+        if (cleared_[tile] != 0U)
+        {
+          fill_tile(tile, true);
+        }
+      }
+    }
+    details::stream_fence();
+    std::fill(cleared_.begin(), cleared_.end(), std::uint8_t{0U});
+    resolve_pending_ = false;
+  }
+
+  /// @return The elements in row-major order, after resolving pending clears.
+  const T* data() const
+  {
+    resolve();
+    return buffer_.data();
+  }
+
+private:
+  static std::size_t tile_count(const std::size_t width, const std::size_t height) noexcept
+  {
+    return ((width + TILE_SIZE - 1U) / TILE_SIZE) * ((height + TILE_SIZE - 1U) / TILE_SIZE);
+  }
+
+  std::size_t tile_index(const std::size_t x, const std::size_t y) const noexcept
+  {
+    return ((y / TILE_SIZE) * tiles_x_) + (x / TILE_SIZE);
+  }
+
+  void materialise(const std::size_t tile)
+  {
+    // A regular fill: the caller is about to draw into this tile, so it should stay in the cache.
+    fill_tile(tile, false);
+    cleared_[tile] = 0U;
+  }
+
+  void fill_tile(const std::size_t tile, const bool streaming) const
+  {
+    const auto x0 = (tile % tiles_x_) * TILE_SIZE;
+    const auto y0 = (tile / tiles_x_) * TILE_SIZE;
+    const auto columns = std::min(TILE_SIZE, width_ - x0);
+    const auto rows = std::min(TILE_SIZE, height_ - y0);
+    for (std::size_t y = y0; y < y0 + rows; ++y)
+    {
+      auto* const row = buffer_.data() + (y * width_) + x0; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      if (streaming)
+      {
+        details::stream_fill(row, columns, clear_value_);
+      }
+      else
+      {
+        std::fill(row, row + columns, clear_value_); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      }
+    }
+  }
+
+  // Mutable so that the const `data()` used for presentation can resolve pending clears.
+  mutable std::vector<T> buffer_;
+  mutable std::vector<std::uint8_t> cleared_;
+  mutable bool resolve_pending_{false}; ///< Set by clear(), reset by resolve(); never touched by stores.
+  std::size_t width_{};
+  std::size_t height_{};
+  std::size_t tiles_x_{};
+  T clear_value_{};
+};
+
+} // namespace rtw::sw_renderer
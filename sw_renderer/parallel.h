@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+
+/// `thread_count - 1` persistent threads that sleep between calls to `run()`, so a parallel pass costs a wake-up
+/// instead of creating and joining threads.
+///
+/// `run()` must not be called concurrently or from inside a task.
+class WorkerPool
+{
+public:
+  /// @param[in] thread_count Threads a `run()` may use, the calling one included.
+  explicit WorkerPool(const std::size_t thread_count)
+  {
+    assert(thread_count > 0U);
+    workers_.reserve(thread_count - 1U);
+    for (std::size_t task = 1U; task < thread_count; ++task)
+    {
+      workers_.emplace_back([this, task] { work(task); });
+    }
+  }
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+  WorkerPool(WorkerPool&&) = delete;
+  WorkerPool& operator=(WorkerPool&&) = delete;
+
+  ~WorkerPool()
+  {
+    {
+      const std::lock_guard<std::mutex> lock{mutex_};
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_)
+    {
+      worker.join();
+    }
+  }
+
+  std::size_t thread_count() const { return workers_.size() + 1U; }
+
+  /// Runs @p function(0) ... @p function(task_count - 1) concurrently, the first one on the calling thread, and
+  /// returns once all of them have.
+  /// @pre @p task_count does not exceed `thread_count()`.
+  template <typename FunctionT>
+  void run(const std::size_t task_count, FunctionT&& function)
+  {
+    assert(task_count <= thread_count());
+    using Function = std::remove_reference_t<FunctionT>;
+    if (task_count > 1U)
+    {
+      {
+        const std::lock_guard<std::mutex> lock{mutex_};
+        task_ = [](void* context, const std::size_t task) { (*static_cast<Function*>(context))(task); };
+        context_ = const_cast<void*>(static_cast<const void*>(&function));
+        task_count_ = task_count;
+        pending_ = task_count - 1U;
+        ++generation_;
+      }
+      wake_.notify_all();
+    }
+    function(std::size_t{0U});
+    if (task_count > 1U)
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      done_.wait(lock, [this] { return pending_ == 0U; });
+    }
+  }
+
+private:
+  void work(const std::size_t task)
+  {
+    std::uint64_t seen_generation{0U};
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (true)
+    {
+      wake_.wait(lock, [this, seen_generation] { return stopping_ || (generation_ != seen_generation); });
+      if (stopping_)
+      {
+        return;
+      }
+      seen_generation = generation_;
+      if (task >= task_count_)
+      {
+        continue;
+      }
+      const auto function = task_;
+      auto* const context = context_;
+      lock.unlock();
+      function(context, task);
+      lock.lock();
+      if (--pending_ == 0U)
+      {
+        done_.notify_one();
+      }
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  void (*task_)(void*, std::size_t){nullptr};
+  void* context_{nullptr};
+  std::size_t task_count_{0U};
+  std::size_t pending_{0U};
+  std::uint64_t generation_{0U};
+  bool stopping_{false};
+};
+
+} // namespace rtw::sw_renderer
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "sw_renderer/programmable_pipeline/point_light.h"
 #include "sw_renderer/programmable_pipeline/sampler.h"
 #include "sw_renderer/programmable_pipeline/shader.h"
 #include "sw_renderer/programmable_pipeline/shader_builtins.h"
@@ -9,6 +10,8 @@
 #include "math/vector.h"
 #include "math/vector_operations.h"
 
+#include "stl/span.h"
+
 #include <cstdint>
 
 namespace rtw::sw_renderer
@@ -221,4 +224,99 @@ private:
   single_precision point_size_{1};
 };
 
+// Per-fragment Lambert diffuse from any number of point lights, evaluated in view space: the forward-shading
+// counterpart of a GBufferShader geometry pass followed by DeferredLighting, with the same lighting model
+// (`point_light_irradiance`). Every fragment that passes the depth test loops over all lights, including fragments
+// that a nearer surface overdraws later.
+class PointLitShader : public IShaderProgram
+{
+public:
+  constexpr static std::uint32_t POSITION_VARYING{0U};
+  constexpr static std::uint32_t NORMAL_VARYING{1U};
+
+  void set_model_view_matrix(const Matrix4x4F& model_view) noexcept { model_view_matrix_ = model_view; }
+  void set_normal_matrix(const Matrix4x4F& normal_matrix) noexcept { normal_matrix_ = normal_matrix; }
+  void set_base_color(const Vector4F& color) noexcept { base_color_ = color; }
+  void set_ambient(const Vector3F& ambient) noexcept { ambient_ = ambient; }
+  /// View-space lights; not owned.
+  void set_lights(const stl::Span<const PointLight> lights) noexcept { lights_ = lights; }
+
+  VertexShaderOutput vertex(const AttributeView& input, const VertexContext& /*context*/) const override
+  {
+    const auto position = input.attribute(attribute_location::POSITION);
+    const auto normal = input.attribute(attribute_location::NORMAL).xyz();
+
+    VertexShaderOutput out;
+    out.position = get_mvp_matrix() * position;
+    out.varyings[POSITION_VARYING] = model_view_matrix_ * position;
+    out.varyings[NORMAL_VARYING] = normal_matrix_ * Vector4F{normal.x(), normal.y(), normal.z(), single_precision{0}};
+    return out;
+  }
+
+  FragmentShaderOutput fragment(const DynamicVaryings& varyings, const FragmentContext& /*context*/) const override
+  {
+    const auto position = varyings[POSITION_VARYING].xyz();
+    const auto normal = math::normalize(varyings[NORMAL_VARYING].xyz());
+    auto irradiance = ambient_;
+    for (const auto& light : lights_)
+    {
+      irradiance += point_light_irradiance(position, normal, light);
+    }
+    const auto rgb = math::hadamard(base_color_.xyz(), irradiance);
+
+    FragmentShaderOutput out;
+    out.color = Vector4F{rgb.x(), rgb.y(), rgb.z(), base_color_.w()};
+    return out;
+  }
+
+private:
+  Matrix4x4F model_view_matrix_{Matrix4x4F::identity()};
+  Matrix4x4F normal_matrix_{Matrix4x4F::identity()};
+  Vector4F base_color_{1.0F, 1.0F, 1.0F, 1.0F};
+  Vector3F ambient_{0.0F, 0.0F, 0.0F};
+  stl::Span<const PointLight> lights_;
+};
+
+// Geometry pass of deferred shading: writes the unlit albedo (base colour, optionally textured) as the colour and the
+// view-space normal for the frame buffer's normal attachment, and leaves the lighting to DeferredLighting.
+class GBufferShader : public IShaderProgram
+{
+public:
+  constexpr static std::uint32_t UV_VARYING{0U};
+  constexpr static std::uint32_t NORMAL_VARYING{1U};
+
+  void set_normal_matrix(const Matrix4x4F& normal_matrix) noexcept { normal_matrix_ = normal_matrix; }
+  void set_base_color(const Vector4F& color) noexcept { base_color_ = color; }
+  void set_sampler(const Sampler2D& sampler) noexcept { sampler_ = sampler; }
+  void set_use_texture(const bool enabled) noexcept { use_texture_ = enabled; }
+
+  VertexShaderOutput vertex(const AttributeView& input, const VertexContext& /*context*/) const override
+  {
+    const auto normal = input.attribute(attribute_location::NORMAL).xyz();
+
+    VertexShaderOutput out;
+    out.position = get_mvp_matrix() * input.attribute(attribute_location::POSITION);
+    if (use_texture_)
+    {
+      out.varyings[UV_VARYING] = input.attribute(attribute_location::UV);
+    }
+    out.varyings[NORMAL_VARYING] = normal_matrix_ * Vector4F{normal.x(), normal.y(), normal.z(), single_precision{0}};
+    return out;
+  }
+
+  FragmentShaderOutput fragment(const DynamicVaryings& varyings, const FragmentContext& /*context*/) const override
+  {
+    FragmentShaderOutput out;
+    out.color = use_texture_ ? math::hadamard(base_color_, texture(sampler_, varyings[UV_VARYING].xy())) : base_color_;
+    out.normal = math::normalize(varyings[NORMAL_VARYING].xyz());
+    return out;
+  }
+
+private:
+  Matrix4x4F normal_matrix_{Matrix4x4F::identity()};
+  Vector4F base_color_{1.0F, 1.0F, 1.0F, 1.0F};
+  Sampler2D sampler_;
+  bool use_texture_{false};
+};
+
 } // namespace rtw::sw_renderer
@@ -0,0 +1,282 @@
+#include "sw_renderer/programmable_pipeline/deferred_lighting.h"
+
+#include "sw_renderer/lazy_clear_buffer.h"
+
+#include "math/matrix_decomposition.h"
+#include "math/matrix_operations.h"
+#include "math/vector_operations.h"
+
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <optional>
+
+namespace rtw::sw_renderer
+{
+
+namespace
+{
+
+constexpr single_precision ZERO{0};
+constexpr single_precision ONE{1};
+constexpr single_precision HALF{0.5F};
+
+/// Inclusive pixel rectangle.
+struct PixelRect
+{
+  std::int32_t min_x{0};
+  std::int32_t min_y{0};
+  std::int32_t max_x{0};
+  std::int32_t max_y{0};
+};
+
+/// The pixels the bounding sphere of @p light may cover, from the projected corners of its view-space bounding box,
+/// or nothing if the sphere is behind the camera or off screen. A sphere reaching behind the camera projects to an
+/// unbounded area and covers the whole frame.
+std::optional<PixelRect> project_light(const PointLight& light, const Matrix4x4F& projection, const Viewport& viewport,
+                                       const PixelRect& frame)
+{
+  const auto& centre = light.position;
+  if ((centre.z() - light.radius) >= ZERO)
+  {
+    return std::nullopt;
+  }
+  if ((centre.z() + light.radius) >= ZERO)
+  {
+    return frame;
+  }
+
+  auto min_x = std::numeric_limits<float>::max();
+  auto min_y = std::numeric_limits<float>::max();
+  auto max_x = std::numeric_limits<float>::lowest();
+  auto max_y = std::numeric_limits<float>::lowest();
+  for (std::uint32_t corner = 0U; corner < 8U; ++corner)
+  {
+    const Vector4F position{centre.x() + (((corner & 1U) != 0U) ? light.radius : -light.radius),
+                            centre.y() + (((corner & 2U) != 0U) ? light.radius : -light.radius),
+                            centre.z() + (((corner & 4U) != 0U) ? light.radius : -light.radius), ONE};
+    const auto clip = projection * position;
+    const auto inv_w = 1.0F / static_cast<float>(clip.w());
+    const auto ndc_x = static_cast<float>(clip.x()) * inv_w;
+    const auto ndc_y = static_cast<float>(clip.y()) * inv_w;
+    min_x = std::min(min_x, ndc_x);
+    max_x = std::max(max_x, ndc_x);
+    min_y = std::min(min_y, ndc_y);
+    max_y = std::max(max_y, ndc_y);
+  }
+
+  // Same mapping as the pipeline's viewport transform; pixel p's centre sits at window coordinate p + 0.5.
+  const auto half_width = 0.5F * static_cast<float>(viewport.width - 1);
+  const auto half_height = 0.5F * static_cast<float>(viewport.height - 1);
+  const auto to_pixel_x = [&](const float ndc)
+  { return static_cast<float>(viewport.x) + ((ndc + 1.0F) * half_width) - 0.5F; };
+  const auto to_pixel_y = [&](const float ndc)
+  { return static_cast<float>(viewport.y) + ((1.0F - ndc) * half_height) - 0.5F; };
+  const auto clamp_x = [&](const float pixel)
+  { return static_cast<std::int32_t>(std::clamp(pixel, -1.0F, static_cast<float>(frame.max_x) + 1.0F)); };
+  const auto clamp_y = [&](const float pixel)
+  { return static_cast<std::int32_t>(std::clamp(pixel, -1.0F, static_cast<float>(frame.max_y) + 1.0F)); };
+
+  const PixelRect rect{std::max(clamp_x(std::floor(to_pixel_x(min_x))), frame.min_x),
+                       std::max(clamp_y(std::floor(to_pixel_y(max_y))), frame.min_y),
+                       std::min(clamp_x(std::ceil(to_pixel_x(max_x))), frame.max_x),
+                       std::min(clamp_y(std::ceil(to_pixel_y(min_y))), frame.max_y)};
+  if ((rect.min_x > rect.max_x) || (rect.min_y > rect.max_y))
+  {
+    return std::nullopt;
+  }
+  return rect;
+}
+
+} // namespace
+
+DeferredLighting::DeferredLighting(const Config& config) : config_{config}
+{
+  assert(config_.tile_size > 0U && "tile size must be positive");
+}
+
+void DeferredLighting::set_thread_count(const std::size_t count)
+{
+  thread_count_ = std::max<std::size_t>(count, 1U);
+  if (thread_count_ == 1U)
+  {
+    workers_.reset();
+  }
+  else if ((workers_ == nullptr) || (workers_->thread_count() != thread_count_))
+  {
+    workers_ = std::make_unique<WorkerPool>(thread_count_);
+  }
+}
+
+void DeferredLighting::shade(const FrameBuffer& gbuffer, const Matrix4x4F& projection, const PipelineState& state,
+                             const stl::Span<const PointLight> lights, ColorBuffer& target)
+{
+  assert(!gbuffer.is_multisampled() && gbuffer.has_normal_buffer() && "not a G-buffer");
+  assert(target.width() == gbuffer.width() && target.height() == gbuffer.height() && "target size mismatch");
+
+  const auto width = gbuffer.width();
+  const auto height = gbuffer.height();
+  const auto tile_size = config_.tile_size;
+  const auto tiles_x = (width + tile_size - 1U) / tile_size;
+  const auto tiles_y = (height + tile_size - 1U) / tile_size;
+  tile_lights_.resize(tiles_x * tiles_y);
+  for (auto& tile : tile_lights_)
+  {
+    tile.clear();
+  }
+
+  // Bin the lights into the tiles their projected bounding spheres overlap.
+  const PixelRect frame{0, 0, static_cast<std::int32_t>(width) - 1, static_cast<std::int32_t>(height) - 1};
+  for (std::size_t index = 0U; index < lights.size(); ++index)
+  {
+    const auto rect = project_light(lights[index], projection, state.viewport, frame);
+    if (!rect.has_value())
+    {
+      continue;
+    }
+    for (auto tile_y = static_cast<std::size_t>(rect->min_y) / tile_size;
+         tile_y <= static_cast<std::size_t>(rect->max_y) / tile_size; ++tile_y)
+    {
+      for (auto tile_x = static_cast<std::size_t>(rect->min_x) / tile_size;
+           tile_x <= static_cast<std::size_t>(rect->max_x) / tile_size; ++tile_x)
+      {
+        tile_lights_[(tile_y * tiles_x) + tile_x].push_back(static_cast<std::uint32_t>(index));
+      }
+    }
+  }
+
+  // Window coordinates back to NDC, the inverse of the pipeline's viewport and depth range transforms.
+  // The inverse projection is linear in NDC, so a row of pixels only needs its x and z columns per pixel.
+  const auto inverse_projection = math::matrix_decomposition::qr::householder::inverse(projection);
+  const auto inverse_x = inverse_projection * Vector4F{ONE, ZERO, ZERO, ZERO};
+  const auto inverse_z = inverse_projection * Vector4F{ZERO, ZERO, ONE, ZERO};
+  const auto ndc_scale_x = single_precision{2} / static_cast<single_precision>(state.viewport.width - 1);
+  const auto ndc_scale_y = single_precision{2} / static_cast<single_precision>(state.viewport.height - 1);
+  const auto depth_extent = state.depth_range.z_far - state.depth_range.z_near;
+  const auto ndc_scale_z = single_precision{2} / depth_extent;
+  const auto ndc_offset_z = -(state.depth_range.z_near + state.depth_range.z_far) / depth_extent;
+  const auto& depth_buffer = gbuffer.depth_buffer();
+  const auto& albedo_buffer = gbuffer.color_buffer();
+  const auto& normal_buffer = gbuffer.normal_buffer();
+  const bool in_place = &target == &albedo_buffer;
+
+  // Albedo times irradiance; alpha passes through.
+  const auto write_lit = [&](const std::size_t x, const std::size_t y, const Vector3F& irradiance)
+  {
+    const auto albedo = static_cast<Vector4F>(albedo_buffer.pixel(x, y));
+    const auto rgb = math::hadamard(albedo.xyz(), irradiance);
+    target.set_pixel(x, y, Color{Vector4F{rgb.x(), rgb.y(), rgb.z(), albedo.w()}});
+  };
+
+  std::atomic<std::size_t> next_tile{0U};
+  std::atomic<std::size_t> lights_shaded{0U};
+  const auto tile_count = tile_lights_.size();
+  const auto workers = std::min(thread_count_, tile_count);
+  // Threads write disjoint light tiles, which are disjoint clear tiles of the target only if the two line up;
+  // otherwise two threads could materialise the same cleared tile at once, so clear it up front.
+  if ((workers > 1U) && ((tile_size % LazyClearBuffer<std::uint32_t>::TILE_SIZE) != 0U))
+  {
+    target.resolve();
+  }
+  const auto shade_tiles = [&](const std::size_t /*worker*/)
+  {
+    std::vector<Vector3F> positions(tile_size * tile_size);
+    std::vector<std::uint8_t> covered(tile_size * tile_size);
+    std::vector<std::uint32_t> tile_lights;
+    for (auto tile = next_tile++; tile < tile_count; tile = next_tile++)
+    {
+      const auto x_begin = (tile % tiles_x) * tile_size;
+      const auto y_begin = (tile / tiles_x) * tile_size;
+      const auto x_end = std::min(x_begin + tile_size, width);
+      const auto y_end = std::min(y_begin + tile_size, height);
+      const bool binned = !tile_lights_[tile].empty();
+
+      // Find the covered pixels and, if any light may reach the tile, reconstruct their view-space positions and the
+      // tile's depth range.
+      auto min_z = std::numeric_limits<single_precision>::max();
+      auto max_z = std::numeric_limits<single_precision>::lowest();
+      for (std::size_t y = y_begin; y < y_end; ++y)
+      {
+        const auto ndc_y =
+            ONE - ((static_cast<single_precision>(y) + HALF - static_cast<single_precision>(state.viewport.y))
+                   * ndc_scale_y);
+        const auto row_origin = inverse_projection * Vector4F{ZERO, ndc_y, ZERO, ONE};
+        for (std::size_t x = x_begin; x < x_end; ++x)
+        {
+          const auto local = ((y - y_begin) * tile_size) + (x - x_begin);
+          const auto depth = depth_buffer.depth(x, y);
+          covered[local] = (depth != state.depth_clear_value) ? 1U : 0U;
+          if (covered[local] == 0U)
+          {
+            if (!in_place)
+            {
+              target.set_pixel(x, y, albedo_buffer.pixel(x, y));
+            }
+            continue;
+          }
+          if (!binned)
+          {
+            continue;
+          }
+          const auto ndc_x =
+              ((static_cast<single_precision>(x) + HALF - static_cast<single_precision>(state.viewport.x))
+               * ndc_scale_x)
+              - ONE;
+          const auto ndc_z = (depth * ndc_scale_z) + ndc_offset_z;
+          const auto view = row_origin + (inverse_x * ndc_x) + (inverse_z * ndc_z);
+          const auto position = view.xyz() * (ONE / view.w());
+          positions[local] = position;
+          min_z = std::min(min_z, position.z());
+          max_z = std::max(max_z, position.z());
+        }
+      }
+
+      tile_lights.clear();
+      for (const auto index : tile_lights_[tile])
+      {
+        const auto& light = lights[index];
+        if (((light.position.z() - light.radius) <= max_z) && ((light.position.z() + light.radius) >= min_z))
+        {
+          tile_lights.push_back(index);
+        }
+      }
+      lights_shaded += tile_lights.size();
+
+      for (std::size_t y = y_begin; y < y_end; ++y)
+      {
+        for (std::size_t x = x_begin; x < x_end; ++x)
+        {
+          const auto local = ((y - y_begin) * tile_size) + (x - x_begin);
+          if (covered[local] == 0U)
+          {
+            continue;
+          }
+          auto irradiance = config_.ambient;
+          if (!tile_lights.empty())
+          {
+            const auto& position = positions[local];
+            const auto normal = normal_buffer.normal(x, y);
+            for (const auto index : tile_lights)
+            {
+              irradiance += point_light_irradiance(position, normal, lights[index]);
+            }
+          }
+          write_lit(x, y, irradiance);
+        }
+      }
+    }
+  };
+  if (workers_ == nullptr)
+  {
+    shade_tiles(std::size_t{0U});
+  }
+  else
+  {
+    workers_->run(workers, shade_tiles);
+  }
+  lights_shaded_per_tile_ = lights_shaded;
+}
+
+} // namespace rtw::sw_renderer
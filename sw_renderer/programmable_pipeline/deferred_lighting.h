@@ -0,0 +1,74 @@
+#pragma once
+
+#include "sw_renderer/color_buffer.h"
+#include "sw_renderer/parallel.h"
+#include "sw_renderer/programmable_pipeline/frame_buffer.h"
+#include "sw_renderer/programmable_pipeline/pipeline_state.h"
+#include "sw_renderer/programmable_pipeline/point_light.h"
+#include "sw_renderer/types.h"
+
+#include "stl/span.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+
+/// Tuning of DeferredLighting.
+struct DeferredLightingConfig
+{
+  std::size_t tile_size{16U}; ///< Pixels per side of a light-culling tile.
+  Vector3F ambient{single_precision{0.05F}, single_precision{0.05F}, single_precision{0.05F}};
+};
+
+/// The lighting pass of deferred shading.
+///
+/// A geometry pass first renders the scene with GBufferShader into a FrameBuffer with a normal attachment (the
+/// G-buffer): albedo in the colour buffer, view-space normals in the NormalBuffer, depth in the depth buffer. The
+/// depth test resolves the visible surface per pixel before any lighting runs, so `shade()` lights every covered
+/// pixel exactly once however much the scene overdraws.
+///
+/// Lights are culled per screen tile. Each light's bounding sphere is projected to a screen rectangle and appended
+/// to the lists of the tiles it overlaps; a tile then drops the lights whose depth range misses the range of the
+/// tile's reconstructed view-space depths, and its pixels loop over the survivors only. Tiles are shaded in
+/// parallel by `thread_count()` persistent threads. Positions are reconstructed from the depth buffer with the inverse
+/// projection, so the result matches PointLitShader's forward shading up to the G-buffer's quantisation.
+class DeferredLighting
+{
+public:
+  using Config = DeferredLightingConfig;
+
+  explicit DeferredLighting(const Config& config = Config{});
+
+  const Config& config() const { return config_; }
+
+  /// Number of threads `shade` uses; 1 (the default) shades the tiles serially on the caller. Above 1, the threads
+  /// are kept alive between calls.
+  void set_thread_count(std::size_t count);
+  std::size_t thread_count() const { return thread_count_; }
+
+  /// Lights the G-buffer into @p target.
+  /// @param gbuffer Single-sample frame buffer with a normal attachment, filled by a geometry pass.
+  /// @param projection The geometry pass's projection matrix; @p lights are in its view space.
+  /// @param state The geometry pass's state: its viewport and depth range map pixels back to view space, and pixels
+  /// still at its `depth_clear_value` are background, which copies the colour buffer unlit.
+  /// @param target Same size as @p gbuffer; may be `gbuffer.color_buffer()` itself.
+  void shade(const FrameBuffer& gbuffer, const Matrix4x4F& projection, const PipelineState& state,
+             stl::Span<const PointLight> lights, ColorBuffer& target);
+
+  /// Light-tile pairs the last `shade` evaluated after culling; without culling it would be lights x tiles.
+  std::size_t lights_shaded_per_tile() const { return lights_shaded_per_tile_; }
+
+private:
+  Config config_;
+  std::size_t thread_count_{1U};
+  std::unique_ptr<WorkerPool> workers_; ///< Set while thread_count_ is above 1.
+  std::vector<std::vector<std::uint32_t>> tile_lights_; ///< Per tile, indices of the lights overlapping it.
+  std::size_t lights_shaded_per_tile_{0U};
+};
+
+} // namespace rtw::sw_renderer
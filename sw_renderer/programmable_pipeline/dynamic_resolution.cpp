@@ -0,0 +1,217 @@
+#include "sw_renderer/programmable_pipeline/dynamic_resolution.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+
+namespace
+{
+
+constexpr std::uint32_t FRACTION_BITS{16U};
+constexpr std::uint64_t FIXED_ONE{std::uint64_t{1U} << FRACTION_BITS};
+
+/// 16.16 fixed-point source coordinate of the first target pixel centre and the step between target pixels.
+struct SampleWalk
+{
+  std::uint64_t start{0U};
+  std::uint64_t step{0U};
+};
+
+SampleWalk make_walk(const std::size_t source_extent, const std::size_t target_extent)
+{
+  const auto step = (static_cast<std::uint64_t>(source_extent) * FIXED_ONE) / target_extent;
+  return SampleWalk{step / 2U, step};
+}
+
+/// Blends two packed RGBA8 colours by @p weight / 256, two channels per multiply.
+std::uint32_t lerp_rgba(const std::uint32_t a, const std::uint32_t b, const std::uint32_t weight)
+{
+  constexpr std::uint32_t MASK{0x00'FF'00'FFU};
+  const auto inverse = 256U - weight;
+  const auto even = ((((a & MASK) * inverse) + ((b & MASK) * weight)) >> 8U) & MASK;
+  const auto odd = ((((a >> 8U) & MASK) * inverse) + (((b >> 8U) & MASK) * weight)) & ~MASK;
+  return even | odd;
+}
+
+/// Index pair and 8-bit weight of a bilinear tap at the 16.16 pixel-centre coordinate @p position.
+struct BilinearTap
+{
+  std::size_t first{0U};
+  std::size_t second{0U};
+  std::uint32_t weight{0U};
+};
+
+BilinearTap bilinear_tap(const std::uint64_t position, const std::size_t extent)
+{
+  // Texel centres sit at +0.5, so shift by half a texel and clamp at the first one.
+  const auto shifted = (position > (FIXED_ONE / 2U)) ? (position - (FIXED_ONE / 2U)) : 0U;
+  const auto first = std::min(static_cast<std::size_t>(shifted >> FRACTION_BITS), extent - 1U);
+  return BilinearTap{first, std::min(first + 1U, extent - 1U),
+                     static_cast<std::uint32_t>((shifted >> (FRACTION_BITS - 8U)) & 0xFFU)};
+}
+
+} // namespace
+
+DynamicResolution::DynamicResolution(const std::size_t full_width, const std::size_t full_height,
+                                     const Config& config, const Mode mode)
+    : config_{config}, mode_{mode}, full_width_{full_width}, full_height_{full_height},
+      scale_{quantise(config.max_scale)}
+{
+}
+
+Viewport DynamicResolution::viewport() const
+{
+  return Viewport{0, 0, static_cast<std::int32_t>(render_width()), static_cast<std::int32_t>(render_height())};
+}
+
+void DynamicResolution::set_scale(const float scale)
+{
+  scale_ = quantise(scale);
+  smoothed_ms_ = 0.0F;
+}
+
+float DynamicResolution::modelled_ms(const RenderStats& stats) const
+{
+  return (static_cast<float>(stats.fragments_shaded) * config_.ms_per_fragment)
+       + (static_cast<float>(stats.triangles_rendered) * config_.ms_per_triangle);
+}
+
+float DynamicResolution::update(const float frame_ms, const RenderStats& stats)
+{
+  const auto cost = (mode_ == Mode::TIMED) ? frame_ms : modelled_ms(stats);
+  smoothed_ms_ = (smoothed_ms_ > 0.0F) ? (smoothed_ms_ + (config_.smoothing * (cost - smoothed_ms_))) : cost;
+  if ((smoothed_ms_ <= 0.0F) || (config_.target_ms <= 0.0F))
+  {
+    return scale_;
+  }
+
+  const auto error = (smoothed_ms_ / config_.target_ms) - 1.0F;
+  if (std::abs(error) <= config_.dead_band)
+  {
+    return scale_;
+  }
+
+  const auto desired = scale_ * std::sqrt(config_.target_ms / smoothed_ms_);
+  const auto next = quantise(std::clamp(desired, scale_ - config_.max_change, scale_ + config_.max_change));
+  if (next != scale_)
+  {
+    // The average was measured at the old scale; carry it over to the new pixel count so the next updates do not
+    // react to the change twice.
+    smoothed_ms_ *= (next * next) / (scale_ * scale_);
+    scale_ = next;
+  }
+  return scale_;
+}
+
+std::size_t DynamicResolution::scaled(const std::size_t extent) const
+{
+  return std::max<std::size_t>(1U, static_cast<std::size_t>(std::lround(static_cast<float>(extent) * scale_)));
+}
+
+float DynamicResolution::quantise(const float scale) const
+{
+  const auto clamped = std::clamp(scale, config_.min_scale, config_.max_scale);
+  if (config_.scale_step <= 0.0F)
+  {
+    return clamped;
+  }
+  return std::clamp(std::round(clamped / config_.scale_step) * config_.scale_step, config_.min_scale,
+                    config_.max_scale);
+}
+
+void upscale(const ColorBuffer& source, const std::size_t source_width, const std::size_t source_height,
+             ColorBuffer& target, const UpscaleFilter filter)
+{
+  assert(source_width > 0U && source_width <= source.width() && "source rectangle out of bounds");
+  assert(source_height > 0U && source_height <= source.height() && "source rectangle out of bounds");
+
+  const auto target_width = target.width();
+  const auto target_height = target.height();
+  const auto* const pixels = source.data();
+  const auto stride = source.width();
+  const auto walk_x = make_walk(source_width, target_width);
+  const auto walk_y = make_walk(source_height, target_height);
+
+  // BILINEAR filters each source row horizontally once, however many target rows blend it: the column taps are
+  // computed up front and the two source rows the current target row blends are kept filtered.
+  struct FilteredRow
+  {
+    std::size_t row{std::numeric_limits<std::size_t>::max()};
+    std::vector<std::uint32_t> pixels;
+  };
+  std::vector<BilinearTap> column_taps;
+  std::array<FilteredRow, 2U> filtered_rows;
+  if (filter == UpscaleFilter::BILINEAR)
+  {
+    column_taps.reserve(target_width);
+    auto position_x = walk_x.start;
+    for (std::size_t x = 0U; x < target_width; ++x, position_x += walk_x.step)
+    {
+      column_taps.push_back(bilinear_tap(position_x, source_width));
+    }
+    filtered_rows[0U].pixels.resize(target_width);
+    filtered_rows[1U].pixels.resize(target_width);
+  }
+  const auto filter_row = [&](const std::size_t source_row, FilteredRow& filtered)
+  {
+    const auto* const texels = pixels + (source_row * stride); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const auto* const taps = column_taps.data();
+    auto* const out = filtered.pixels.data();
+    for (std::size_t x = 0U; x < target_width; ++x)
+    {
+      // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      out[x] = lerp_rgba(texels[taps[x].first], texels[taps[x].second], taps[x].weight);
+      // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    filtered.row = source_row;
+  };
+
+  auto position_y = walk_y.start;
+  for (std::size_t y = 0U; y < target_height; ++y, position_y += walk_y.step)
+  {
+    auto* const row = target.pixel_row(0U, target_width, y);
+    if (filter == UpscaleFilter::NEAREST)
+    {
+      auto position_x = walk_x.start;
+      const auto* const source_row = pixels + ((position_y >> FRACTION_BITS) * stride); // NOLINT
+      for (std::size_t x = 0U; x < target_width; ++x, position_x += walk_x.step)
+      {
+        row[x] = source_row[position_x >> FRACTION_BITS]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      }
+      continue;
+    }
+
+    const auto tap_y = bilinear_tap(position_y, source_height);
+    if (tap_y.first != filtered_rows[0U].row)
+    {
+      // Scrolling down by one source row reuses the old lower row as the new upper one.
+      if (tap_y.first == filtered_rows[1U].row)
+      {
+        std::swap(filtered_rows[0U], filtered_rows[1U]);
+      }
+      else
+      {
+        filter_row(tap_y.first, filtered_rows[0U]);
+      }
+    }
+    if (tap_y.second != filtered_rows[1U].row)
+    {
+      filter_row(tap_y.second, filtered_rows[1U]);
+    }
+    const auto* const upper = filtered_rows[0U].pixels.data();
+    const auto* const lower = filtered_rows[1U].pixels.data();
+    for (std::size_t x = 0U; x < target_width; ++x)
+    {
+      row[x] = lerp_rgba(upper[x], lower[x], tap_y.weight); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+  }
+}
+
+} // namespace rtw::sw_renderer
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "sw_renderer/color_buffer.h"
+#include "sw_renderer/programmable_pipeline/pipeline_state.h"
+#include "sw_renderer/render_stats.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rtw::sw_renderer
+{
+
+/// Filter used to stretch the render resolution to the presentation resolution.
+enum class UpscaleFilter : std::uint8_t
+{
+  NEAREST = 0U,
+  BILINEAR,
+};
+
+/// How DynamicResolution measures a frame's cost.
+enum class DynamicResolutionMode : std::uint8_t
+{
+  TIMED = 0U,    ///< The measured frame time.
+  DETERMINISTIC, ///< A cost modelled from the frame's RenderStats.
+};
+
+/// Tuning of DynamicResolution; scales are fractions of the full resolution per axis.
+struct DynamicResolutionConfig
+{
+  float target_ms{16.6F};
+  float min_scale{0.5F};
+  float max_scale{1.0F};
+  float scale_step{1.0F / 32.0F}; ///< Scales are multiples of this.
+  float max_change{0.125F};       ///< Largest scale change per update.
+  float dead_band{0.05F};         ///< Relative cost error that does not change the scale.
+  float smoothing{0.25F};         ///< Weight of the newest cost in the moving average.
+  float ms_per_fragment{2.0e-5F}; ///< DynamicResolutionMode::DETERMINISTIC cost model.
+  float ms_per_triangle{5.0e-4F}; ///< DynamicResolutionMode::DETERMINISTIC cost model.
+};
+
+/// Holds a target frame time by scaling the render resolution.
+///
+/// The frame is rendered into the top-left `render_width() x render_height()` rectangle of a full-size FrameBuffer
+/// (see `viewport()`), so changing the scale never reallocates, and then upscaled to the full size with
+/// `upscale()`. After every frame `update()` is given the frame's cost: the cost of rasterising and shading grows
+/// with the pixel count, i.e. with the square of the scale, so the controller moves the scale by the square root of
+/// target / cost. The cost is smoothed, changes inside a dead band are ignored and each step is limited, so the
+/// scale settles instead of oscillating; it is also quantised to `scale_step`, so small jitter does not
+/// change the resolution at all.
+///
+/// In `Mode::TIMED` the cost is the measured frame time. `Mode::DETERMINISTIC` ignores the timer and models the
+/// cost from the frame's RenderStats (`ms_per_fragment` per shaded fragment plus
+/// `ms_per_triangle` per rendered triangle), so the same frames always produce the same scales; benchmarks
+/// use it to compare quality and time at reproducible resolutions.
+class DynamicResolution
+{
+public:
+  using Mode = DynamicResolutionMode;
+  using Config = DynamicResolutionConfig;
+
+  DynamicResolution(std::size_t full_width, std::size_t full_height, const Config& config = Config{},
+                    Mode mode = Mode::TIMED);
+
+  const Config& config() const { return config_; }
+  Mode mode() const { return mode_; }
+  float scale() const { return scale_; }
+  /// The smoothed cost the last update acted on.
+  float smoothed_ms() const { return smoothed_ms_; }
+
+  std::size_t full_width() const { return full_width_; }
+  std::size_t full_height() const { return full_height_; }
+  std::size_t render_width() const { return scaled(full_width_); }
+  std::size_t render_height() const { return scaled(full_height_); }
+  /// The viewport covering the render rectangle.
+  Viewport viewport() const;
+
+  void set_target_ms(float target_ms) { config_.target_ms = target_ms; }
+  /// Pins the scale (clamped to the bounds and quantised) and restarts the moving average.
+  void set_scale(float scale);
+
+  /// Feeds the cost of the frame rendered at the current scale and returns the scale for the next frame.
+  /// @param frame_ms Measured frame time; used in Mode::TIMED.
+  /// @param stats The frame's RenderStats; used in Mode::DETERMINISTIC.
+  float update(float frame_ms, const RenderStats& stats);
+
+  /// The cost Mode::DETERMINISTIC assigns to a frame.
+  float modelled_ms(const RenderStats& stats) const;
+
+private:
+  std::size_t scaled(std::size_t extent) const;
+  float quantise(float scale) const;
+
+  Config config_;
+  Mode mode_{Mode::TIMED};
+  std::size_t full_width_{0U};
+  std::size_t full_height_{0U};
+  float scale_{1.0F};
+  float smoothed_ms_{0.0F};
+};
+
+/// Stretches the top-left @p source_width x @p source_height rectangle of @p source over all of @p target.
+/// Sample positions are stepped in 16.16 fixed point; BILINEAR blends the four nearest texels with 8-bit weights.
+void upscale(const ColorBuffer& source, std::size_t source_width, std::size_t source_height, ColorBuffer& target,
+             UpscaleFilter filter);
+
+} // namespace rtw::sw_renderer
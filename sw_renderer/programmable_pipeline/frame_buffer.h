@@ -4,17 +4,41 @@
 #include "sw_renderer/color_buffer.h"
 #include "sw_renderer/depth_buffer.h"
 #include "sw_renderer/precision.h"
+#include "sw_renderer/programmable_pipeline/multisample.h"
+#include "sw_renderer/programmable_pipeline/normal_buffer.h"
 
+#include <algorithm>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace rtw::sw_renderer
 {
 
+/// Colour and depth attachments of the programmable pipeline.
+///
+/// With SampleCount::X4 the frame buffer is multisampled:
+/// - depth is stored per sample: sample s of pixel (x, y) is `depth_buffer()` element (depth_column(x, s), y), so
+///   the depth buffer is four times as wide as the frame;
+/// - colour is compressed per pixel. A pixel whose samples all hold the same colour keeps it in `color_buffer()`
+///   only; the first write that covers part of a pixel with a different colour expands it into four sample
+///   colours, and a later write that makes them equal again folds it back. Interior pixels therefore never touch
+///   the sample storage, and only the pixels along edges pay for it;
+/// - `resolve()` averages the samples of expanded pixels into `color_buffer()`, which then holds the anti-aliased
+///   image.
+///
+/// A single-sample frame buffer can also hold a G-buffer for deferred shading (see DeferredLighting): with a normal
+/// attachment, the colour buffer takes the albedo and the pipeline stores each written fragment's normal next to it.
 class FrameBuffer
 {
 public:
-  FrameBuffer(const std::size_t width, const std::size_t height)
-      : color_buffer_{width, height}, depth_buffer_{width, height}
+  FrameBuffer(const std::size_t width, const std::size_t height, const DepthFormat depth_format = DepthFormat::D32F,
+              const SampleCount samples = SampleCount::X1)
+      : color_buffer_{width, height}, depth_buffer_{width * static_cast<std::size_t>(samples), height, depth_format},
+        sample_count_{static_cast<std::uint32_t>(samples)},
+        sample_colors_(is_multisampled(samples) ? (width * height * MSAA_SAMPLE_COUNT) : 0U),
+        expanded_(is_multisampled(samples) ? (width * height) : 0U)
   {
   }
 
@@ -28,15 +52,129 @@ public:
   DepthBuffer& depth_buffer() { return depth_buffer_; }
   const DepthBuffer& depth_buffer() const { return depth_buffer_; }
 
+  /// Adds a normal attachment in @p encoding; from then on the pipeline stores the FragmentShaderOutput::normal of
+  /// every fragment whose colour it writes. Not cleared by `clear()`: the depth buffer tells which pixels were
+  /// written. @note Single-sample frame buffers only.
+  void attach_normal_buffer(const NormalEncoding encoding)
+  {
+    assert(!is_multisampled() && "G-buffers are single-sample");
+    normal_buffer_ = NormalBuffer{width(), height(), encoding};
+  }
+  bool has_normal_buffer() const { return !normal_buffer_.empty(); }
+  NormalBuffer& normal_buffer() { return normal_buffer_; }
+  const NormalBuffer& normal_buffer() const { return normal_buffer_; }
+
+  std::uint32_t sample_count() const { return sample_count_; }
+  bool is_multisampled() const { return sample_count_ > 1U; }
+  /// Column of `depth_buffer()` holding sample @p sample of pixel column @p x; the samples of a pixel are adjacent.
+  std::size_t depth_column(const std::size_t x, const std::uint32_t sample) const
+  {
+    return (x * sample_count_) + sample;
+  }
+
   void clear(const Color color, const single_precision depth)
   {
     color_buffer_.clear(color);
     depth_buffer_.clear(depth);
+    std::fill(expanded_.begin(), expanded_.end(), std::uint8_t{0U});
+  }
+
+  /// @return true if the samples of pixel (x, y) hold different colours. @note Multisampled frame buffers only.
+  bool is_expanded(const std::size_t x, const std::size_t y) const { return expanded_[(y * width()) + x] != 0U; }
+
+  /// Colour of sample @p sample of pixel (x, y). @note Multisampled frame buffers only.
+  Color sample_color(const std::size_t x, const std::size_t y, const std::uint32_t sample) const
+  {
+    assert(is_multisampled() && sample < MSAA_SAMPLE_COUNT);
+    const auto pixel = (y * width()) + x;
+    return (expanded_[pixel] != 0U) ? Color{sample_colors_[(pixel * MSAA_SAMPLE_COUNT) + sample]}
+                                    : color_buffer_.pixel(x, y);
+  }
+
+  /// Writes the samples of pixel (x, y) selected by @p coverage. @p output maps a sample's current colour to its new
+  /// one (blending and the colour mask need the destination), and runs once for a compressed pixel.
+  /// @note Multisampled frame buffers only.
+  template <typename OutputT>
+  void write_samples(const std::size_t x, const std::size_t y, const std::uint32_t coverage, OutputT&& output)
+  {
+    assert(is_multisampled());
+    const auto pixel = (y * width()) + x;
+    auto* const samples = &sample_colors_[pixel * MSAA_SAMPLE_COUNT];
+    if (expanded_[pixel] == 0U)
+    {
+      const auto dest = color_buffer_.pixel(x, y);
+      const Color color = output(dest);
+      if (coverage == MSAA_FULL_COVERAGE)
+      {
+        color_buffer_.set_pixel(x, y, color);
+        return;
+      }
+      if (color == dest)
+      {
+        return;
+      }
+      std::fill(samples, samples + MSAA_SAMPLE_COUNT, dest.rgba); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+      {
+        if ((coverage & (1U << sample)) != 0U)
+        {
+          samples[sample] = color.rgba; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+      }
+      expanded_[pixel] = 1U;
+      return;
+    }
+
+    for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+    {
+      if ((coverage & (1U << sample)) != 0U)
+      {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        samples[sample] = Color{output(Color{samples[sample]})}.rgba;
+      }
+    }
+    if (std::all_of(samples + 1, samples + MSAA_SAMPLE_COUNT, // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                    [first = samples[0U]](const std::uint32_t rgba) { return rgba == first; }))
+    {
+      color_buffer_.set_pixel(x, y, Color{samples[0U]});
+      expanded_[pixel] = 0U;
+    }
+  }
+
+  /// Averages the samples of every expanded pixel into `color_buffer()`. Compressed pixels already hold their
+  /// colour, so the cost is proportional to the number of edge pixels. A no-op without multisampling.
+  void resolve()
+  {
+    for (std::size_t pixel = 0U; pixel < expanded_.size(); ++pixel)
+    {
+      if (expanded_[pixel] == 0U)
+      {
+        continue;
+      }
+      const auto* const samples = &sample_colors_[pixel * MSAA_SAMPLE_COUNT];
+      std::uint32_t resolved = 0U;
+      for (std::uint32_t shift = 0U; shift < 32U; shift += 8U)
+      {
+        std::uint32_t sum = MSAA_SAMPLE_COUNT / 2U; // round to nearest
+        for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+        {
+          sum += (samples[sample] >> shift) & 0xFFU; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+        resolved |= (sum / MSAA_SAMPLE_COUNT) << shift;
+      }
+      color_buffer_.set_pixel(pixel % width(), pixel / width(), Color{resolved});
+    }
   }
 
 private:
+  static constexpr bool is_multisampled(const SampleCount samples) { return samples != SampleCount::X1; }
+
   ColorBuffer color_buffer_;
   DepthBuffer depth_buffer_;
+  NormalBuffer normal_buffer_; ///< Empty unless attached.
+  std::uint32_t sample_count_{1U};
+  std::vector<std::uint32_t> sample_colors_; ///< MSAA_SAMPLE_COUNT colours per pixel; valid where expanded_ is set.
+  std::vector<std::uint8_t> expanded_;       ///< Per pixel: 1 if its samples differ and live in sample_colors_.
 };
 
 } // namespace rtw::sw_renderer
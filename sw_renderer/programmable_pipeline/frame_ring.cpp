@@ -0,0 +1,130 @@
+#include "sw_renderer/programmable_pipeline/frame_ring.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace rtw::sw_renderer
+{
+
+void Fence::signal()
+{
+  {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    signaled_ = true;
+  }
+  condition_.notify_all();
+}
+
+void Fence::reset()
+{
+  const std::lock_guard<std::mutex> lock{mutex_};
+  signaled_ = false;
+}
+
+void Fence::wait() const
+{
+  std::unique_lock<std::mutex> lock{mutex_};
+  condition_.wait(lock, [this] { return signaled_; });
+}
+
+bool Fence::is_signaled() const
+{
+  const std::lock_guard<std::mutex> lock{mutex_};
+  return signaled_;
+}
+
+FrameRing::Slot::Slot(const std::size_t width, const std::size_t height, const DepthFormat depth_format,
+                      const SampleCount samples)
+    : framebuffer{width, height, depth_format, samples}
+{
+}
+
+FrameRing::FrameRing(const std::size_t frame_count, const std::size_t width, const std::size_t height,
+                     const DepthFormat depth_format, const SampleCount samples)
+{
+  const auto count = std::clamp(frame_count, MIN_FRAMES, MAX_FRAMES);
+  slots_.reserve(count);
+  for (std::size_t i = 0U; i < count; ++i)
+  {
+    slots_.push_back(std::make_unique<Slot>(width, height, depth_format, samples));
+  }
+  worker_ = std::thread{[this] { work(); }};
+}
+
+FrameRing::~FrameRing()
+{
+  {
+    const std::lock_guard<std::mutex> lock{queue_mutex_};
+    stopping_ = true;
+  }
+  queue_condition_.notify_one();
+  worker_.join();
+}
+
+std::uint64_t FrameRing::submit(RenderFunction render)
+{
+  const auto frame = submitted_;
+  auto& slot = *slots_[frame % slots_.size()];
+  slot.released.wait();
+  slot.released.reset();
+  slot.rendered.reset();
+  slot.render = std::move(render);
+  {
+    const std::lock_guard<std::mutex> lock{queue_mutex_};
+    queue_.push_back(frame);
+  }
+  queue_condition_.notify_one();
+  ++submitted_;
+  return frame;
+}
+
+FrameRing::Frame FrameRing::acquire()
+{
+  assert(presented_ < submitted_ && "acquire() needs a submitted frame");
+  const auto& slot = *slots_[presented_ % slots_.size()];
+  slot.rendered.wait();
+  return Frame{&slot.framebuffer, presented_, slot.render_time};
+}
+
+void FrameRing::release()
+{
+  assert(presented_ < submitted_ && "release() needs an acquired frame");
+  slots_[presented_ % slots_.size()]->released.signal();
+  ++presented_;
+}
+
+void FrameRing::wait_idle()
+{
+  for (auto frame = presented_; frame < submitted_; ++frame)
+  {
+    slots_[frame % slots_.size()]->rendered.wait();
+  }
+}
+
+void FrameRing::work()
+{
+  while (true)
+  {
+    std::uint64_t frame = 0U;
+    {
+      std::unique_lock<std::mutex> lock{queue_mutex_};
+      queue_condition_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (queue_.empty())
+      {
+        return;
+      }
+      frame = queue_.front();
+      queue_.pop_front();
+    }
+
+    auto& slot = *slots_[frame % slots_.size()];
+    const auto start = std::chrono::steady_clock::now();
+    slot.render(slot.framebuffer, frame);
+    slot.render_time = std::chrono::steady_clock::now() - start;
+    slot.render = nullptr;
+    slot.rendered.signal();
+  }
+}
+
+} // namespace rtw::sw_renderer
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "sw_renderer/depth_buffer.h"
+#include "sw_renderer/programmable_pipeline/frame_buffer.h"
+#include "sw_renderer/programmable_pipeline/multisample.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+
+/// A CPU fence: one side signals it when its work is done, the other waits for that.
+class Fence
+{
+public:
+  explicit Fence(const bool signaled = false) : signaled_{signaled} {}
+
+  void signal();
+  void reset();
+  void wait() const;
+  bool is_signaled() const;
+
+private:
+  mutable std::mutex mutex_;
+  mutable std::condition_variable condition_;
+  bool signaled_{false};
+};
+
+/// A ring of two or three FrameBuffers that renders frame N+1 on a worker thread while the caller presents frame N.
+///
+/// Each slot owns a FrameBuffer and two fences: `rendered` is signaled by the worker when the slot's frame is
+/// complete, `released` by the caller when it no longer reads the slot. Frames are rendered and presented in
+/// submission order:
+///
+/// @code
+///   ring.submit(render_frame_0);
+///   while (running)
+///   {
+///     ring.submit(render_next_frame);    // waits until a slot is released
+///     const auto frame = ring.acquire(); // waits until the oldest frame is rendered
+///     present(frame.framebuffer->color_buffer());
+///     ring.release();
+///   }
+/// @endcode
+///
+/// The render function runs on the worker, so it must not share mutable state with the caller's thread; capture a
+/// copy of everything a frame needs (camera, pipeline state, shader parameters) when submitting it.
+class FrameRing
+{
+public:
+  /// Renders one frame into the framebuffer; the second argument is the frame index.
+  using RenderFunction = std::function<void(FrameBuffer&, std::uint64_t)>;
+
+  /// A rendered frame, valid until `release()`.
+  struct Frame
+  {
+    const FrameBuffer* framebuffer{nullptr};
+    std::uint64_t index{0U};
+    std::chrono::steady_clock::duration render_time{}; ///< Time the worker spent in the render function.
+  };
+
+  static constexpr std::size_t MIN_FRAMES{2U};
+  static constexpr std::size_t MAX_FRAMES{3U};
+
+  /// @param frame_count Number of FrameBuffers in flight, clamped to [MIN_FRAMES, MAX_FRAMES].
+  FrameRing(std::size_t frame_count, std::size_t width, std::size_t height,
+            DepthFormat depth_format = DepthFormat::D32F, SampleCount samples = SampleCount::X1);
+  FrameRing(const FrameRing&) = delete;
+  FrameRing(FrameRing&&) = delete;
+  FrameRing& operator=(const FrameRing&) = delete;
+  FrameRing& operator=(FrameRing&&) = delete;
+  /// Finishes the submitted frames, then stops the worker.
+  ~FrameRing();
+
+  std::size_t frame_count() const { return slots_.size(); }
+  /// Frames submitted but not yet released.
+  std::size_t frames_in_flight() const { return static_cast<std::size_t>(submitted_ - presented_); }
+
+  /// Queues @p render for the next slot, waiting until the caller has released that slot.
+  /// @return The index of the submitted frame.
+  std::uint64_t submit(RenderFunction render);
+
+  /// Waits until the oldest unreleased frame is rendered and returns it. @note At least one frame must be in flight.
+  Frame acquire();
+
+  /// Hands the acquired frame's slot back to the worker.
+  void release();
+
+  /// Waits until every submitted frame is rendered.
+  void wait_idle();
+
+private:
+  struct Slot
+  {
+    Slot(std::size_t width, std::size_t height, DepthFormat depth_format, SampleCount samples);
+
+    FrameBuffer framebuffer;
+    RenderFunction render;
+    std::chrono::steady_clock::duration render_time{};
+    Fence rendered{false};
+    Fence released{true};
+  };
+
+  void work();
+
+  std::vector<std::unique_ptr<Slot>> slots_;
+  std::uint64_t submitted_{0U};
+  std::uint64_t presented_{0U};
+
+  std::mutex queue_mutex_;
+  std::condition_variable queue_condition_;
+  std::deque<std::uint64_t> queue_; ///< Indices of frames waiting for the worker.
+  bool stopping_{false};
+  std::thread worker_;
+};
+
+} // namespace rtw::sw_renderer
@@ -0,0 +1,224 @@
+#include "sw_renderer/programmable_pipeline/meshlet.h"
+
+#include "math/frustum.h"
+#include "math/matrix_operations.h"
+#include "math/point_operations.h"
+#include "math/vector_operations.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace rtw::sw_renderer
+{
+
+namespace
+{
+
+constexpr std::uint32_t NO_OWNER{std::numeric_limits<std::uint32_t>::max()};
+
+MeshletBounds compute_bounds(const Meshlet& meshlet, const MeshletMesh& mesh, const std::vector<Point3F>& positions)
+{
+  using multiprecision::math::sqrt;
+  using std::sqrt;
+
+  constexpr single_precision ZERO{0};
+  constexpr single_precision ONE{1};
+
+  const auto* const vertex_indices = &mesh.vertices[meshlet.vertex_offset];
+  const auto* const local_indices = &mesh.triangles[static_cast<std::size_t>(meshlet.triangle_offset) * 3U];
+
+  // Bounding sphere around the centre of the cluster's AABB. Not minimal, but cheap and never smaller than needed.
+  auto min_corner = positions[vertex_indices[0U]];
+  auto max_corner = min_corner;
+  for (std::size_t i = 1U; i < meshlet.vertex_count; ++i)
+  {
+    const auto& p = positions[vertex_indices[i]];
+    for (std::uint16_t axis = 0U; axis < 3U; ++axis)
+    {
+      min_corner[axis] = std::min(min_corner[axis], p[axis]);
+      max_corner[axis] = std::max(max_corner[axis], p[axis]);
+    }
+  }
+
+  MeshletBounds bounds;
+  const single_precision half{0.5F};
+  bounds.center = Point3F{(min_corner.x() + max_corner.x()) * half, (min_corner.y() + max_corner.y()) * half,
+                          (min_corner.z() + max_corner.z()) * half};
+  for (std::size_t i = 0U; i < meshlet.vertex_count; ++i)
+  {
+    bounds.radius = std::max(bounds.radius, math::distance(positions[vertex_indices[i]], bounds.center));
+  }
+
+  // Normal cone: the axis is the mean unit face normal, the spread is the widest angle between it and any face.
+  std::array<Vector3F, MESHLET_MAX_TRIANGLES> normals{};
+  std::size_t normal_count = 0U;
+  Vector3F axis{ZERO, ZERO, ZERO};
+  for (std::size_t t = 0U; t < meshlet.triangle_count; ++t)
+  {
+    const auto& a = positions[vertex_indices[local_indices[(t * 3U) + 0U]]];
+    const auto& b = positions[vertex_indices[local_indices[(t * 3U) + 1U]]];
+    const auto& c = positions[vertex_indices[local_indices[(t * 3U) + 2U]]];
+    const auto normal = math::cross(b - a, c - a);
+    const auto length = math::norm(normal);
+    if (length <= ULP)
+    {
+      continue; // Degenerate triangles never reach the rasteriser and do not constrain the cone.
+    }
+    normals[normal_count] = normal / length; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    axis += normals[normal_count];           // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    ++normal_count;
+  }
+
+  const auto axis_length = math::norm(axis);
+  if ((normal_count == 0U) || (axis_length <= ULP))
+  {
+    return bounds;
+  }
+  bounds.cone_axis = axis / axis_length;
+
+  auto min_dot = ONE;
+  for (std::size_t i = 0U; i < normal_count; ++i)
+  {
+    min_dot = std::min(min_dot, math::dot(normals[i], bounds.cone_axis)); // NOLINT
+  }
+
+  // A cone of half-angle >= 90 degrees always contains a normal facing the viewer: leave cone culling disabled.
+  if (min_dot > ZERO)
+  {
+    bounds.cone_cutoff = sqrt(ONE - (min_dot * min_dot));
+  }
+  return bounds;
+}
+
+} // namespace
+
+MeshletMesh build_meshlets(const RawVertexStream& vertices, const IndexBuffer& indices,
+                           const std::uint32_t position_location)
+{
+  const auto vertex_count = vertices.size();
+  std::vector<Point3F> positions(vertex_count);
+  for (std::size_t i = 0U; i < vertex_count; ++i)
+  {
+    const auto position = vertices[i].attribute(position_location);
+    positions[i] = Point3F{position.x(), position.y(), position.z()};
+  }
+
+  MeshletMesh mesh;
+  const auto triangle_count = indices.size() / 3U;
+  mesh.triangles.reserve(triangle_count * 3U);
+  mesh.meshlets.reserve((triangle_count / MESHLET_MAX_TRIANGLES) + 1U);
+
+  // `owner[v]` records which meshlet last claimed vertex v and `local_slot[v]` its index inside that meshlet, so
+  // de-duplicating a vertex is a single compare instead of a search through the meshlet's vertex list.
+  std::vector<std::uint32_t> owner(vertex_count, NO_OWNER);
+  std::vector<std::uint8_t> local_slot(vertex_count, 0U);
+
+  Meshlet current;
+  const auto flush = [&](const std::uint32_t next_primitive)
+  {
+    if (current.triangle_count > 0U)
+    {
+      current.bounds = compute_bounds(current, mesh, positions);
+      mesh.meshlets.push_back(current);
+    }
+    current = Meshlet{};
+    current.vertex_offset = static_cast<std::uint32_t>(mesh.vertices.size());
+    current.triangle_offset = static_cast<std::uint32_t>(mesh.triangles.size() / 3U);
+    current.first_primitive = next_primitive;
+  };
+
+  for (std::size_t t = 0U; t < triangle_count; ++t)
+  {
+    const std::array<std::uint32_t, 3U> corners{indices[(t * 3U) + 0U], indices[(t * 3U) + 1U],
+                                                indices[(t * 3U) + 2U]};
+
+    auto meshlet_id = static_cast<std::uint32_t>(mesh.meshlets.size());
+    std::size_t new_vertices = 0U;
+    for (std::size_t i = 0U; i < 3U; ++i)
+    {
+      const bool repeated = ((i > 0U) && (corners[i] == corners[0U])) || ((i > 1U) && (corners[i] == corners[1U]));
+      new_vertices += static_cast<std::size_t>((owner[corners[i]] != meshlet_id) && !repeated);
+    }
+
+    if (((current.vertex_count + new_vertices) > MESHLET_MAX_VERTICES)
+        || (current.triangle_count >= MESHLET_MAX_TRIANGLES))
+    {
+      flush(static_cast<std::uint32_t>(t));
+      meshlet_id = static_cast<std::uint32_t>(mesh.meshlets.size());
+    }
+
+    for (const auto corner : corners)
+    {
+      if (owner[corner] != meshlet_id)
+      {
+        owner[corner] = meshlet_id;
+        local_slot[corner] = current.vertex_count;
+        mesh.vertices.push_back(corner);
+        ++current.vertex_count;
+      }
+      mesh.triangles.push_back(local_slot[corner]);
+    }
+    ++current.triangle_count;
+  }
+  flush(static_cast<std::uint32_t>(triangle_count));
+
+  return mesh;
+}
+
+MeshletCuller::MeshletCuller(const Matrix4x4F& mvp, const CullMode cull_mode, const FrontFace front_face)
+    // extract_frustum reads the plane equations from the columns of its argument (row-vector convention); the
+    // pipeline multiplies column vectors (`clip = mvp * position`), so hand it the transpose.
+    : frustum_{math::extract_frustum(math::transpose(mvp))}
+{
+  using multiprecision::math::abs;
+  using std::abs;
+
+  const auto eye = math::inverse(mvp) * Vector4F{single_precision{0}, single_precision{0}, single_precision{1},
+                                                 single_precision{0}};
+  if (abs(eye.w()) <= ULP)
+  {
+    return;
+  }
+  eye_ = Point3F{eye.x() / eye.w(), eye.y() / eye.w(), eye.z() / eye.w()};
+
+  // Object-space normals are built from counter-clockwise triangles. A clockwise front face flips which side is
+  // "front", and culling front faces looks for clusters whose flipped normals all face away.
+  const single_precision winding{(front_face == FrontFace::COUNTER_CLOCKWISE) ? 1.0F : -1.0F};
+  if (cull_mode == CullMode::BACK)
+  {
+    cone_sign_ = winding;
+  }
+  else if (cull_mode == CullMode::FRONT)
+  {
+    cone_sign_ = -winding;
+  }
+}
+
+MeshletVisibility MeshletCuller::classify(const MeshletBounds& bounds) const noexcept
+{
+  for (const auto& plane : frustum_.planes())
+  {
+    if (math::signed_distance(bounds.center, plane) < -bounds.radius)
+    {
+      return MeshletVisibility::OUTSIDE_FRUSTUM;
+    }
+  }
+
+  // A cluster is entirely back-facing when the view direction to every point of its sphere makes an angle of at
+  // most 90 degrees minus the cone half-angle with the cone axis (the conservative test from meshoptimizer's
+  // meshopt_computeClusterBounds documentation).
+  if ((cone_sign_ != single_precision{0}) && (bounds.cone_cutoff < single_precision{1}))
+  {
+    const auto to_center = bounds.center - eye_;
+    const auto axis = bounds.cone_axis * cone_sign_;
+    if (math::dot(to_center, axis) >= ((bounds.cone_cutoff * math::norm(to_center)) + bounds.radius))
+    {
+      return MeshletVisibility::BACKFACING;
+    }
+  }
+
+  return MeshletVisibility::VISIBLE;
+}
+
+} // namespace rtw::sw_renderer
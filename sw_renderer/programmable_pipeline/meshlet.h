@@ -0,0 +1,102 @@
+#pragma once
+
+#include "sw_renderer/precision.h"
+#include "sw_renderer/programmable_pipeline/pipeline_state.h"
+#include "sw_renderer/programmable_pipeline/vertex_stream.h"
+#include "sw_renderer/types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+
+/// Upper bound on the unique vertices referenced by one meshlet (the common mesh-shader limit).
+constexpr inline std::size_t MESHLET_MAX_VERTICES{64U};
+
+/// Upper bound on the triangles of one meshlet. 124 (not 128) keeps the 3-byte local index block of a full
+/// meshlet a multiple of 4 bytes, the same choice meshoptimizer recommends.
+constexpr inline std::size_t MESHLET_MAX_TRIANGLES{124U};
+
+/// Object-space culling bounds of a meshlet.
+///
+/// The sphere encloses every vertex of the cluster. The normal cone bounds the face normals of its triangles:
+/// every normal lies within the cone around `cone_axis`, and `cone_cutoff` is the sine of the cone's half-angle
+/// (see `MeshletCuller` for the test). A cluster whose normals spread over a hemisphere or more gets
+/// `cone_cutoff = 1`, which disables cone culling for it.
+struct MeshletBounds
+{
+  Point3F center;
+  single_precision radius{0};
+  Vector3F cone_axis;
+  single_precision cone_cutoff{1};
+};
+
+/// A cluster of at most `MESHLET_MAX_VERTICES` vertices and `MESHLET_MAX_TRIANGLES` triangles.
+///
+/// `vertex_offset` indexes `MeshletMesh::vertices` (global vertex indices of the cluster) and `triangle_offset`
+/// indexes `MeshletMesh::triangles` in units of triangles (three local indices each). Clusters are built from
+/// consecutive triangles of the index buffer, so `first_primitive` is also the `primitive_id` the first triangle
+/// would receive from `Pipeline::draw_elements`.
+struct Meshlet
+{
+  std::uint32_t vertex_offset{0U};
+  std::uint32_t triangle_offset{0U};
+  std::uint32_t first_primitive{0U};
+  std::uint8_t vertex_count{0U};
+  std::uint8_t triangle_count{0U};
+  MeshletBounds bounds;
+};
+
+/// The meshlet decomposition of an indexed triangle list.
+struct MeshletMesh
+{
+  std::vector<Meshlet> meshlets;
+  std::vector<std::uint32_t> vertices; ///< Global vertex indices, `Meshlet::vertex_count` per meshlet.
+  std::vector<std::uint8_t> triangles; ///< Meshlet-local vertex indices, three per triangle.
+};
+
+/// Splits an indexed triangle list into meshlets and computes their culling bounds.
+///
+/// Triangles are appended greedily in index-buffer order; a new meshlet starts when the next triangle would
+/// exceed either limit. Keeping the input order means `Pipeline::draw_meshlets` produces exactly the image of
+/// `Pipeline::draw_elements` when nothing is culled, but it also means cluster quality follows the input: index
+/// buffers should be ordered for locality (e.g. emitted in small grid tiles, or run through a vertex-cache
+/// optimiser) for the bounds to be tight enough to cull. Bounds are computed from the attribute at
+/// `position_location` (xyz), i.e. in the object space the shader's MVP matrix transforms from.
+/// @param[in] vertices The vertex stream the index buffer refers to.
+/// @param[in] indices Triangle list indices; a trailing partial triangle is ignored.
+/// @param[in] position_location Attribute location of the object-space position.
+/// @return The meshlet decomposition.
+MeshletMesh build_meshlets(const RawVertexStream& vertices, const IndexBuffer& indices,
+                           std::uint32_t position_location = 0U);
+
+enum class MeshletVisibility : std::uint8_t
+{
+  VISIBLE = 0U,
+  OUTSIDE_FRUSTUM,
+  BACKFACING,
+};
+
+/// Classifies meshlet bounds against the view of one draw call.
+///
+/// The frustum planes are extracted in object space from the MVP matrix (the clip-space planes pulled back
+/// through the transform), so bounds never need transforming. The eye position is recovered the same way: it is
+/// the object-space point that the MVP maps onto the clip-space direction (0, 0, 1, 0). Cone culling follows the
+/// pipeline's face-culling state: it runs only for `CullMode::BACK` / `CullMode::FRONT`, with the cone axis
+/// flipped for clockwise front faces, and is skipped for projections without an eye point (orthographic).
+class MeshletCuller
+{
+public:
+  MeshletCuller(const Matrix4x4F& mvp, CullMode cull_mode, FrontFace front_face);
+
+  MeshletVisibility classify(const MeshletBounds& bounds) const noexcept;
+
+private:
+  Frustum3F frustum_;
+  Point3F eye_;
+  single_precision cone_sign_{0};
+};
+
+} // namespace rtw::sw_renderer
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "sw_renderer/precision.h"
+
+#include <array>
+#include <cstdint>
+
+namespace rtw::sw_renderer
+{
+
+/// Samples per pixel of a FrameBuffer.
+enum class SampleCount : std::uint8_t
+{
+  X1 = 1U, ///< One sample at the pixel centre: no anti-aliasing.
+  X4 = 4U, ///< 4x MSAA: coverage and depth per sample, one fragment shader invocation per pixel.
+};
+
+/// Samples per pixel of the multisampled path; coverage masks have one bit per sample.
+constexpr inline std::uint32_t MSAA_SAMPLE_COUNT{static_cast<std::uint32_t>(SampleCount::X4)};
+constexpr inline std::uint32_t MSAA_FULL_COVERAGE{(1U << MSAA_SAMPLE_COUNT) - 1U};
+
+/// Per-sample window depths of one pixel, in sample order.
+using SampleDepths = std::array<single_precision, MSAA_SAMPLE_COUNT>;
+
+/// The 4x rotated-grid sample pattern (as in D3D / Vulkan standard sample locations), as offsets from the pixel's
+/// top-left corner. No two samples share a row or a column, so near-horizontal and near-vertical edges still get
+/// four coverage levels.
+constexpr inline std::array<std::array<float, 2U>, MSAA_SAMPLE_COUNT> MSAA_SAMPLE_POSITIONS{{
+    {0.375F, 0.125F},
+    {0.875F, 0.375F},
+    {0.125F, 0.625F},
+    {0.625F, 0.875F},
+}};
+
+} // namespace rtw::sw_renderer
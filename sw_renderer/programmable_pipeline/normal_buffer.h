@@ -0,0 +1,154 @@
+#pragma once
+
+#include "sw_renderer/types.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+
+/// Storage format of a NormalBuffer. Both project the unit sphere onto the octahedron |x| + |y| + |z| = 1, fold its
+/// lower half over the upper one and quantise the resulting square's two coordinates, which spreads the precision
+/// evenly over all directions.
+enum class NormalEncoding : std::uint8_t
+{
+  OCTAHEDRAL_2X16 = 0U, ///< 32 bits per normal; angular error below 0.01 degrees.
+  OCTAHEDRAL_2X8,       ///< 16 bits per normal; angular error below 1 degree.
+};
+
+namespace details
+{
+
+inline float sign_not_zero(const float value) { return (value < 0.0F) ? -1.0F : 1.0F; }
+
+/// Quantises @p value in [-1, 1] to an unsigned @p BITS-bit integer. The scale is symmetric (one code goes unused)
+/// so that -1, 0 and 1 are exact, which keeps axis-aligned normals exact.
+template <std::uint32_t BITS>
+std::uint32_t quantise_snorm(const float value)
+{
+  constexpr auto SCALE = static_cast<float>((1U << (BITS - 1U)) - 1U);
+  const auto clamped = (value < -1.0F) ? -1.0F : ((value > 1.0F) ? 1.0F : value);
+  return static_cast<std::uint32_t>(std::lround((clamped * SCALE) + SCALE));
+}
+
+template <std::uint32_t BITS>
+float dequantise_snorm(const std::uint32_t value)
+{
+  constexpr auto SCALE = static_cast<float>((1U << (BITS - 1U)) - 1U);
+  return (static_cast<float>(value) - SCALE) / SCALE;
+}
+
+template <std::uint32_t BITS>
+std::uint32_t encode_octahedral(const Vector3F& normal)
+{
+  auto x = static_cast<float>(normal.x());
+  auto y = static_cast<float>(normal.y());
+  const auto z = static_cast<float>(normal.z());
+  const auto l1 = std::abs(x) + std::abs(y) + std::abs(z);
+  if (l1 <= 0.0F)
+  {
+    return quantise_snorm<BITS>(0.0F) | (quantise_snorm<BITS>(0.0F) << BITS);
+  }
+  x /= l1;
+  y /= l1;
+  if (z < 0.0F)
+  {
+    const auto folded_x = (1.0F - std::abs(y)) * sign_not_zero(x);
+    y = (1.0F - std::abs(x)) * sign_not_zero(y);
+    x = folded_x;
+  }
+  return quantise_snorm<BITS>(x) | (quantise_snorm<BITS>(y) << BITS);
+}
+
+template <std::uint32_t BITS>
+Vector3F decode_octahedral(const std::uint32_t bits)
+{
+  constexpr std::uint32_t MASK{(1U << BITS) - 1U};
+  auto x = dequantise_snorm<BITS>(bits & MASK);
+  auto y = dequantise_snorm<BITS>((bits >> BITS) & MASK);
+  const auto z = 1.0F - std::abs(x) - std::abs(y);
+  if (z < 0.0F)
+  {
+    const auto unfolded_x = (1.0F - std::abs(y)) * sign_not_zero(x);
+    y = (1.0F - std::abs(x)) * sign_not_zero(y);
+    x = unfolded_x;
+  }
+  const auto inv_length = 1.0F / std::sqrt((x * x) + (y * y) + (z * z));
+  return Vector3F{single_precision{x * inv_length}, single_precision{y * inv_length}, single_precision{z * inv_length}};
+}
+
+} // namespace details
+
+/// Packs @p normal (unit length) into the low 32 or 16 bits of the result.
+inline std::uint32_t encode_normal(const Vector3F& normal, const NormalEncoding encoding)
+{
+  return (encoding == NormalEncoding::OCTAHEDRAL_2X16) ? details::encode_octahedral<16U>(normal)
+                                                       : details::encode_octahedral<8U>(normal);
+}
+
+/// The unit normal encoded by `encode_normal`.
+inline Vector3F decode_normal(const std::uint32_t bits, const NormalEncoding encoding)
+{
+  return (encoding == NormalEncoding::OCTAHEDRAL_2X16) ? details::decode_octahedral<16U>(bits)
+                                                       : details::decode_octahedral<8U>(bits);
+}
+
+/// Per-pixel normals of a G-buffer in a NormalEncoding; the normal attachment of a FrameBuffer (see
+/// `FrameBuffer::attach_normal_buffer`).
+class NormalBuffer
+{
+public:
+  NormalBuffer() = default;
+  NormalBuffer(const std::size_t width, const std::size_t height, const NormalEncoding encoding)
+      : width_{width}, height_{height}, encoding_{encoding}, words_(width * height * words_per_normal(encoding))
+  {
+  }
+
+  std::size_t width() const { return width_; }
+  std::size_t height() const { return height_; }
+  NormalEncoding encoding() const { return encoding_; }
+  bool empty() const { return words_.empty(); }
+  std::size_t bytes_per_normal() const { return words_per_normal(encoding_) * sizeof(std::uint16_t); }
+
+  void set_normal(const std::size_t x, const std::size_t y, const Vector3F& normal)
+  {
+    assert(x < width_ && y < height_);
+    const auto bits = encode_normal(normal, encoding_);
+    if (encoding_ == NormalEncoding::OCTAHEDRAL_2X16)
+    {
+      const auto index = ((y * width_) + x) * 2U;
+      words_[index] = static_cast<std::uint16_t>(bits);
+      words_[index + 1U] = static_cast<std::uint16_t>(bits >> 16U);
+      return;
+    }
+    words_[(y * width_) + x] = static_cast<std::uint16_t>(bits);
+  }
+
+  Vector3F normal(const std::size_t x, const std::size_t y) const
+  {
+    assert(x < width_ && y < height_);
+    if (encoding_ == NormalEncoding::OCTAHEDRAL_2X16)
+    {
+      const auto index = ((y * width_) + x) * 2U;
+      return decode_normal(words_[index] | (static_cast<std::uint32_t>(words_[index + 1U]) << 16U), encoding_);
+    }
+    return decode_normal(words_[(y * width_) + x], encoding_);
+  }
+
+private:
+  static constexpr std::size_t words_per_normal(const NormalEncoding encoding)
+  {
+    return (encoding == NormalEncoding::OCTAHEDRAL_2X16) ? 2U : 1U;
+  }
+
+  std::size_t width_{0U};
+  std::size_t height_{0U};
+  NormalEncoding encoding_{NormalEncoding::OCTAHEDRAL_2X16};
+  std::vector<std::uint16_t> words_; ///< words_per_normal(encoding_) 16-bit words per pixel.
+};
+
+} // namespace rtw::sw_renderer
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+namespace rtw::sw_renderer
+{
+
+/// Result of an occlusion query (see `Pipeline::begin_query`).
+///
+/// Counts the samples of the draws issued while the query is active that pass the scissor test, the depth test and
+/// the fragment shader's discard, i.e. the samples that would reach the colour buffer: one per pixel, or up to
+/// MSAA_SAMPLE_COUNT per pixel on a multisampled frame buffer. The count does not depend on the colour mask or on
+/// depth writes, so a cheap bounding-box proxy can be drawn with both disabled to test whether an expensive object
+/// would be visible. The pipeline is synchronous, so the result is final as soon as the query ends.
+struct OcclusionQuery
+{
+  std::uint64_t samples_passed{0U};
+  bool result_available{false}; ///< Set by `Pipeline::end_query`, cleared by `Pipeline::begin_query`.
+
+  bool any_samples_passed() const noexcept { return samples_passed != 0U; }
+};
+
+} // namespace rtw::sw_renderer
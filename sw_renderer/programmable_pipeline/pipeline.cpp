@@ -1,6 +1,9 @@
 #include "sw_renderer/programmable_pipeline/pipeline.h"
 
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <limits>
 
 namespace rtw::sw_renderer
 {
@@ -23,13 +26,16 @@ constexpr Vector4F clip_to_window(const Vector4F& clip_position, const Viewport&
                       + ((ndc_x + ONE) * HALF * static_cast<single_precision>(viewport.width - 1));
   const auto window_y = static_cast<single_precision>(viewport.y)
                       + ((ONE - ndc_y) * HALF * static_cast<single_precision>(viewport.height - 1));
-  const auto window_z = depth_range.z_near + ((depth_range.z_far - depth_range.z_near) * ((HALF * ndc_z) + HALF));
+  // Blend the two ends instead of `z_near + (z_far - z_near) * t`: for reversed-Z (z_near = 1, z_far = 0) the far
+  // plane then evaluates to `HALF - HALF * ndc_z`, which keeps the small values near 0 exact instead of
+  // rounding `1 - t` near 1. The default range {0, 1} gives the same bits as before.
+  const auto window_z = (depth_range.z_near * (HALF - (HALF * ndc_z))) + (depth_range.z_far * ((HALF * ndc_z) + HALF));
 
   return Vector4F{window_x, window_y, window_z, inv_w};
 }
 
-constexpr bool depth_test_passes(const DepthFunc func, const single_precision incoming,
-                                 const single_precision stored) noexcept
+template <typename T>
+constexpr bool depth_test_passes(const DepthFunc func, const T incoming, const T stored) noexcept
 {
   switch (func)
   {
@@ -53,6 +59,32 @@ constexpr bool depth_test_passes(const DepthFunc func, const single_precision in
   return false;
 }
 
+/// Depth buffer access in the D32F format: the test compares the interpolated scalars.
+struct FloatDepthAccess
+{
+  DepthBuffer& buffer;
+
+  single_precision encode(const single_precision depth) const noexcept { return depth; }
+  single_precision load(const std::size_t x, const std::size_t y) const { return buffer.depth(x, y); }
+  void store(const std::size_t x, const std::size_t y, const single_precision depth) const
+  {
+    buffer.set_depth(x, y, depth);
+  }
+};
+
+/// Depth buffer access in an UNORM format: the fragment depth is quantised once and the test compares integers.
+struct UnormDepthAccess
+{
+  DepthBuffer& buffer;
+
+  std::uint32_t encode(const single_precision depth) const { return buffer.encode(depth); }
+  std::uint32_t load(const std::size_t x, const std::size_t y) const { return buffer.depth_unorm(x, y); }
+  void store(const std::size_t x, const std::size_t y, const std::uint32_t depth) const
+  {
+    buffer.set_depth_unorm(x, y, depth);
+  }
+};
+
 constexpr bool inside_scissor(const Scissor& scissor, const std::int32_t x, const std::int32_t y) noexcept
 {
   return (x >= scissor.x) && (x < (scissor.x + scissor.width)) && (y >= scissor.y)
@@ -147,24 +179,16 @@ constexpr Vector4F blend_fragment(const BlendState& blend, const Vector4F& sourc
   return Vector4F{r, g, b, a};
 }
 
-constexpr void write_color(ColorBuffer& color_buffer, const std::size_t x, const std::size_t y, const Vector4F& source,
-                           const BlendState& blend, const ColorMask& mask)
+/// Applies blending and the colour mask to @p source over the current colour @p dest.
+constexpr Color output_color(const Color dest, const Vector4F& source, const BlendState& blend, const ColorMask& mask)
 {
-  Vector4F color = source;
-  if (blend.enabled)
-  {
-    const auto dest = static_cast<Vector4F>(color_buffer.pixel(x, y));
-    color = blend_fragment(blend, source, dest);
-  }
-
-  const Color src{color};
+  const Color src{blend.enabled ? blend_fragment(blend, source, static_cast<Vector4F>(dest)) : source};
   if (mask.red && mask.green && mask.blue && mask.alpha)
   {
-    color_buffer.set_pixel(x, y, src);
-    return;
+    return src;
   }
 
-  Color result = color_buffer.pixel(x, y);
+  Color result = dest;
   if (mask.red)
   {
     result.set_r(src.r());
@@ -181,21 +205,67 @@ constexpr void write_color(ColorBuffer& color_buffer, const std::size_t x, const
   {
     result.set_a(src.a());
   }
-  color_buffer.set_pixel(x, y, result);
+  return result;
+}
+
+/// Number of samples set in a coverage mask.
+constexpr std::uint32_t sample_count(const std::uint32_t mask) noexcept
+{
+  std::uint32_t count = 0U;
+  for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+  {
+    count += (mask >> sample) & 1U;
+  }
+  return count;
+}
+
+constexpr void write_color(ColorBuffer& color_buffer, const std::size_t x, const std::size_t y, const Vector4F& source,
+                           const BlendState& blend, const ColorMask& mask)
+{
+  if (!blend.enabled && mask.red && mask.green && mask.blue && mask.alpha)
+  {
+    // Opaque, unmasked write: the destination is not needed.
+    color_buffer.set_pixel(x, y, Color{source});
+    return;
+  }
+  color_buffer.set_pixel(x, y, output_color(color_buffer.pixel(x, y), source, blend, mask));
 }
 
 } // namespace details
 
+namespace
+{
+
+ClipVertex<single_precision> shade_vertex(const IShaderProgram& program, const RawVertexStream& vertices,
+                                          const std::uint32_t index)
+{
+  const VertexContext context{index, 0U};
+  const auto output = program.vertex(vertices[index], context);
+  return ClipVertex<single_precision>{output.position, output.varyings, output.point_size};
+}
+
+} // namespace
+
 void Pipeline::transform_vertices(const IShaderProgram& program, const RawVertexStream& vertices)
 {
   const auto count = vertices.size();
   transformed_.resize(count);
   for (std::size_t i = 0U; i < count; ++i)
   {
-    const VertexContext context{static_cast<std::uint32_t>(i), 0U};
-    const auto output = program.vertex(vertices[i], context);
-    transformed_[i] = ClipVertex<single_precision>{output.position, output.varyings, output.point_size};
+    transformed_[i] = shade_vertex(program, vertices, static_cast<std::uint32_t>(i));
+  }
+}
+
+const ClipVertex<single_precision>& Pipeline::transform_vertex(const IShaderProgram& program,
+                                                               const RawVertexStream& vertices,
+                                                               const std::uint32_t index)
+{
+  if (transformed_epoch_[index] != epoch_)
+  {
+    transformed_[index] = shade_vertex(program, vertices, index);
+    transformed_epoch_[index] = epoch_;
   }
+  return transformed_[index];
 }
 
 void Pipeline::process_triangle(const IShaderProgram& program, const ClipVertex<single_precision>& v0,
@@ -215,6 +285,20 @@ void Pipeline::process_triangle(const IShaderProgram& program, const ClipVertex<
 
   const math::BoundingBoxI bounds{0, 0, static_cast<std::int32_t>(framebuffer.width()) - 1,
                                   static_cast<std::int32_t>(framebuffer.height()) - 1};
+  const bool coarse_shading =
+      (state.shading_rate != ShadingRate::RATE_1X1) || (state.shading_rate_image != nullptr);
+  if (coarse_shading && (coarse_fragments_.size() < framebuffer.width()))
+  {
+    coarse_fragments_.resize(framebuffer.width());
+  }
+  // An all-false mask (e.g. an occlusion query proxy) leaves the colour untouched, so the write is skipped.
+  const bool color_writes =
+      state.color_mask.red || state.color_mask.green || state.color_mask.blue || state.color_mask.alpha;
+  // A G-buffer's normals are written with its albedo, so the colour mask covers them too.
+  const bool normal_writes = color_writes && framebuffer.has_normal_buffer();
+  auto& normal_buffer = framebuffer.normal_buffer();
+  // Samples reaching the output merger, added to the active occlusion query after the last triangle.
+  std::uint64_t samples_passed = 0U;
   for (std::size_t i = 0U; i < triangles.triangle_count; ++i)
   {
     const auto& triangle = triangles.triangles[i]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
@@ -245,77 +329,308 @@ void Pipeline::process_triangle(const IShaderProgram& program, const ClipVertex<
       continue;
     }
 
-    const auto shade_fragment = [&](const Point2I& p, const RegisterFile<single_precision, MAX_VARYING_COUNT>& varyings,
-                                    const single_precision window_z, const single_precision inv_w)
+    // Runs the fragment shader, or with a coarse shading rate reuses the output already shaded for the pixel's block
+    // in this triangle. The cache holds one block row per column, which the row-by-row walk of a single triangle
+    // never revisits, and a new epoch per triangle invalidates the previous triangle's blocks. Blocks split between
+    // the clipped triangles of one primitive are therefore shaded once per triangle.
+    if (coarse_shading)
     {
-      if (state.scissor.enabled && !details::inside_scissor(state.scissor, p.x(), p.y()))
+      if (coarse_epoch_ == std::numeric_limits<std::uint32_t>::max())
       {
-        return;
+        std::fill(coarse_fragments_.begin(), coarse_fragments_.end(), CoarseFragment{});
+        coarse_epoch_ = 0U;
       }
-
-      auto& depth_buffer = framebuffer.depth_buffer();
-      const auto x = static_cast<std::size_t>(p.x());
-      const auto y = static_cast<std::size_t>(p.y());
-      const auto stored_z = depth_buffer.depth(x, y);
-      if (state.depth_test_enabled && !details::depth_test_passes(state.depth_func, window_z, stored_z))
+      ++coarse_epoch_;
+    }
+    // Both are passed to the fragment callbacks as a type, so the full-rate instantiation carries no coarse-shading
+    // checks.
+    const auto shade_full_rate = [&](const Point2I& /*p*/, const auto& varyings, const FragmentContext& context)
+    {
+      ++stats.fragments_shaded;
+      return program.fragment(varyings, context);
+    };
+    const auto shade_coarse = [&](const Point2I& p, const auto& varyings, const FragmentContext& context)
+    {
+      const auto rate = (state.shading_rate_image != nullptr) ? state.shading_rate_image->rate(p.x(), p.y())
+                                                              : state.shading_rate;
+      if (rate == ShadingRate::RATE_1X1)
       {
-        return;
+        return shade_full_rate(p, varyings, context);
       }
 
-      const FragmentContext context{Vector4F{static_cast<single_precision>(p.x()) + 0.5F,
-                                             static_cast<single_precision>(p.y()) + 0.5F, window_z, inv_w},
-                                    primitive_id, front_facing};
-      const auto fragment = program.fragment(varyings, context);
-      if (fragment.discard)
+      const auto block_y = p.y() & ~(shading_rate_height(rate) - 1);
+      auto& block = coarse_fragments_[static_cast<std::size_t>(p.x() & ~(shading_rate_width(rate) - 1))];
+      if ((block.epoch != coarse_epoch_) || (block.block_y != block_y))
       {
-        return;
+        ++stats.fragments_shaded;
+        block = CoarseFragment{coarse_epoch_, block_y, program.fragment(varyings, context)};
       }
+      return block.output;
+    };
 
-      const auto depth = fragment.depth.value_or(window_z);
-      // Re-test depth only when the fragment shader overrode it.
-      // Otherwise `depth == window_z` and the early test above already passed against
-      // the same stored_z (nothing writes the depth buffer in between),
-      // so the re-test is redundant and skipping it leaves the depth/colour result unchanged.
-      if (fragment.depth.has_value() && state.depth_test_enabled
-          && !details::depth_test_passes(state.depth_func, depth, stored_z))
-      {
-        return;
-      }
-      if (state.depth_write_enabled)
+    // The fragment callback is instantiated per depth format, so the per-fragment test compares the format's own
+    // representation (scalars for D32F, integers for the UNORM formats) without a format switch.
+    const auto make_shade_fragment = [&](const auto depth_access, const auto& shade)
+    {
+      return [&, depth_access](const Point2I& p, const RegisterFile<single_precision, MAX_VARYING_COUNT>& varyings,
+                               const single_precision window_z, const single_precision inv_w)
       {
-        depth_buffer.set_depth(x, y, depth);
-      }
+        if (state.scissor.enabled && !details::inside_scissor(state.scissor, p.x(), p.y()))
+        {
+          return;
+        }
+
+        const auto x = static_cast<std::size_t>(p.x());
+        const auto y = static_cast<std::size_t>(p.y());
+        const auto incoming_z = depth_access.encode(window_z);
+        const auto stored_z = depth_access.load(x, y);
+        if (state.depth_test_enabled && !details::depth_test_passes(state.depth_func, incoming_z, stored_z))
+        {
+          return;
+        }
+
+        const FragmentContext context{Vector4F{static_cast<single_precision>(p.x()) + 0.5F,
+                                               static_cast<single_precision>(p.y()) + 0.5F, window_z, inv_w},
+                                      primitive_id, front_facing};
+        const auto fragment = shade(p, varyings, context);
+        if (fragment.discard)
+        {
+          return;
+        }
+
+        // Re-test depth only when the fragment shader overrode it.
+        // Otherwise the depth is `incoming_z` and the early test above already passed against
+        // the same stored_z (nothing writes the depth buffer in between),
+        // so the re-test is redundant and skipping it leaves the depth/colour result unchanged.
+        const auto depth = fragment.depth.has_value() ? depth_access.encode(*fragment.depth) : incoming_z;
+        if (fragment.depth.has_value() && state.depth_test_enabled
+            && !details::depth_test_passes(state.depth_func, depth, stored_z))
+        {
+          return;
+        }
+        ++samples_passed;
+        if (state.depth_write_enabled)
+        {
+          depth_access.store(x, y, depth);
+        }
+
+        if (color_writes)
+        {
+          details::write_color(framebuffer.color_buffer(), x, y, fragment.color, state.blend, state.color_mask);
+        }
+        if (normal_writes)
+        {
+          normal_buffer.set_normal(x, y, fragment.normal);
+        }
+      };
+    };
 
-      details::write_color(framebuffer.color_buffer(), x, y, fragment.color, state.blend, state.color_mask);
+    // 4x MSAA: the rasteriser reports which samples the triangle covers and their depths. Depth is tested and
+    // written per sample, the fragment shader runs once per pixel at its centre, and its colour goes to the samples
+    // that passed (see FrameBuffer for how the colour stays compressed).
+    const auto make_shade_samples = [&](const auto depth_access, const auto& shade)
+    {
+      return [&, depth_access](const Point2I& p, const RegisterFile<single_precision, MAX_VARYING_COUNT>& varyings,
+                               const single_precision window_z, const single_precision inv_w,
+                               const std::uint32_t coverage, const SampleDepths& depths)
+      {
+        if (state.scissor.enabled && !details::inside_scissor(state.scissor, p.x(), p.y()))
+        {
+          return;
+        }
+
+        const auto x = static_cast<std::size_t>(p.x());
+        const auto y = static_cast<std::size_t>(p.y());
+        std::array<decltype(depth_access.encode(window_z)), MSAA_SAMPLE_COUNT> incoming_z{};
+        std::uint32_t pass_mask = 0U;
+        for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+        {
+          if ((coverage & (1U << sample)) == 0U)
+          {
+            continue;
+          }
+          incoming_z[sample] = depth_access.encode(depths[sample]);
+          if (!state.depth_test_enabled
+              || details::depth_test_passes(state.depth_func, incoming_z[sample],
+                                            depth_access.load(framebuffer.depth_column(x, sample), y)))
+          {
+            pass_mask |= 1U << sample;
+          }
+        }
+        if (pass_mask == 0U)
+        {
+          return;
+        }
+
+        const FragmentContext context{Vector4F{static_cast<single_precision>(p.x()) + 0.5F,
+                                               static_cast<single_precision>(p.y()) + 0.5F, window_z, inv_w},
+                                      primitive_id, front_facing};
+        const auto fragment = shade(p, varyings, context);
+        if (fragment.discard)
+        {
+          return;
+        }
+
+        // A depth written by the shader replaces the interpolated one for every sample, as in the single-sample path.
+        if (fragment.depth.has_value())
+        {
+          const auto depth = depth_access.encode(*fragment.depth);
+          for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+          {
+            incoming_z[sample] = depth;
+            if (state.depth_test_enabled && ((pass_mask & (1U << sample)) != 0U)
+                && !details::depth_test_passes(state.depth_func, depth,
+                                               depth_access.load(framebuffer.depth_column(x, sample), y)))
+            {
+              pass_mask &= ~(1U << sample);
+            }
+          }
+          if (pass_mask == 0U)
+          {
+            return;
+          }
+        }
+        samples_passed += details::sample_count(pass_mask);
+        if (state.depth_write_enabled)
+        {
+          for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+          {
+            if ((pass_mask & (1U << sample)) != 0U)
+            {
+              depth_access.store(framebuffer.depth_column(x, sample), y, incoming_z[sample]);
+            }
+          }
+        }
+
+        if (color_writes)
+        {
+          const auto output = [&](const Color dest)
+          { return details::output_color(dest, fragment.color, state.blend, state.color_mask); };
+          framebuffer.write_samples(x, y, pass_mask, output);
+        }
+      };
     };
 
     // PolygonMode selects how the (clipped, culled) triangle becomes fragments. FILL is the default and its call
     // is unchanged; LINE and POINT reuse the same fragment-shading callback, so the depth test, discard, blend
     // and colour write behave identically across all three modes.
-    switch (state.polygon_mode)
+    const auto rasterise = [&](const auto& shade_fragment)
+    {
+      switch (state.polygon_mode)
+      {
+      case PolygonMode::FILL:
+        fill_triangle_bbox(w0, w1, w2, cv0.varyings, cv1.varyings, cv2.varyings, bounds, shade_fragment);
+        break;
+      case PolygonMode::LINE:
+        draw_line_varyings(w0, w1, cv0.varyings, cv1.varyings, bounds, shade_fragment);
+        draw_line_varyings(w1, w2, cv1.varyings, cv2.varyings, bounds, shade_fragment);
+        draw_line_varyings(w2, w0, cv2.varyings, cv0.varyings, bounds, shade_fragment);
+        break;
+      case PolygonMode::POINT:
+        draw_point_varyings(w0, cv0.varyings, bounds, shade_fragment, cv0.point_size);
+        draw_point_varyings(w1, cv1.varyings, bounds, shade_fragment, cv1.point_size);
+        draw_point_varyings(w2, cv2.varyings, bounds, shade_fragment, cv2.point_size);
+        break;
+      }
+    };
+
+    // Lines and points are not multisampled: they cover every sample of their pixels at the centre depth.
+    const auto rasterise_multisample = [&](const auto& shade_samples)
+    {
+      if (state.polygon_mode == PolygonMode::FILL)
+      {
+        fill_triangle_bbox_multisample(w0, w1, w2, cv0.varyings, cv1.varyings, cv2.varyings, bounds, shade_samples);
+        return;
+      }
+      rasterise(
+          [&shade_samples](const Point2I& p, const RegisterFile<single_precision, MAX_VARYING_COUNT>& varyings,
+                           const single_precision window_z, const single_precision inv_w)
+          {
+            shade_samples(p, varyings, window_z, inv_w, MSAA_FULL_COVERAGE,
+                          SampleDepths{window_z, window_z, window_z, window_z});
+          });
+    };
+
+    auto& depth_buffer = framebuffer.depth_buffer();
+    const auto rasterise_shaded = [&](const auto& shade)
+    {
+      if (framebuffer.is_multisampled())
+      {
+        if (depth_buffer.is_unorm())
+        {
+          rasterise_multisample(make_shade_samples(details::UnormDepthAccess{depth_buffer}, shade));
+        }
+        else
+        {
+          rasterise_multisample(make_shade_samples(details::FloatDepthAccess{depth_buffer}, shade));
+        }
+      }
+      else if (depth_buffer.is_unorm())
+      {
+        rasterise(make_shade_fragment(details::UnormDepthAccess{depth_buffer}, shade));
+      }
+      else
+      {
+        rasterise(make_shade_fragment(details::FloatDepthAccess{depth_buffer}, shade));
+      }
+    };
+    if (coarse_shading)
+    {
+      rasterise_shaded(shade_coarse);
+    }
+    else
     {
-    case PolygonMode::FILL:
-      fill_triangle_bbox(w0, w1, w2, cv0.varyings, cv1.varyings, cv2.varyings, bounds, shade_fragment);
-      break;
-    case PolygonMode::LINE:
-      draw_line_varyings(w0, w1, cv0.varyings, cv1.varyings, bounds, shade_fragment);
-      draw_line_varyings(w1, w2, cv1.varyings, cv2.varyings, bounds, shade_fragment);
-      draw_line_varyings(w2, w0, cv2.varyings, cv0.varyings, bounds, shade_fragment);
-      break;
-    case PolygonMode::POINT:
-      draw_point_varyings(w0, cv0.varyings, bounds, shade_fragment, cv0.point_size);
-      draw_point_varyings(w1, cv1.varyings, bounds, shade_fragment, cv1.point_size);
-      draw_point_varyings(w2, cv2.varyings, bounds, shade_fragment, cv2.point_size);
-      break;
+      rasterise_shaded(shade_full_rate);
     }
 
     ++stats.triangles_rendered;
   }
+
+  if (active_query_ != nullptr)
+  {
+    active_query_->samples_passed += samples_passed;
+  }
+}
+
+void Pipeline::begin_query(OcclusionQuery& query)
+{
+  assert((active_query_ == nullptr) && "an occlusion query is already active");
+  query = OcclusionQuery{};
+  active_query_ = &query;
+}
+
+void Pipeline::end_query()
+{
+  assert((active_query_ != nullptr) && "no occlusion query is active");
+  active_query_->result_available = true;
+  active_query_ = nullptr;
+}
+
+void Pipeline::begin_conditional_render(const OcclusionQuery& query)
+{
+  assert((condition_ == nullptr) && "conditional rendering is already active");
+  condition_ = &query;
+}
+
+void Pipeline::end_conditional_render() { condition_ = nullptr; }
+
+bool Pipeline::skip_draw(RenderStats& stats) const
+{
+  if ((condition_ == nullptr) || !condition_->result_available || condition_->any_samples_passed())
+  {
+    return false;
+  }
+  ++stats.draws_skipped;
+  return true;
 }
 
 void Pipeline::draw_arrays(const IShaderProgram& program, const RawVertexStream& vertices, const PipelineState& state,
                            FrameBuffer& framebuffer, RenderStats& stats)
 {
+  if (skip_draw(stats))
+  {
+    return;
+  }
   transform_vertices(program, vertices);
   for (std::size_t i = 0U, primitive = 0U; (i + 2U) < transformed_.size(); i += 3U, ++primitive)
   {
@@ -327,6 +642,10 @@ void Pipeline::draw_arrays(const IShaderProgram& program, const RawVertexStream&
 void Pipeline::draw_elements(const IShaderProgram& program, const RawVertexStream& vertices, const IndexBuffer& indices,
                              const PipelineState& state, FrameBuffer& framebuffer, RenderStats& stats)
 {
+  if (skip_draw(stats))
+  {
+    return;
+  }
   transform_vertices(program, vertices);
   for (std::size_t i = 0U, primitive = 0U; (i + 2U) < indices.size(); i += 3U, ++primitive)
   {
@@ -335,4 +654,45 @@ void Pipeline::draw_elements(const IShaderProgram& program, const RawVertexStrea
   }
 }
 
+void Pipeline::draw_meshlets(const IShaderProgram& program, const RawVertexStream& vertices, const MeshletMesh& mesh,
+                             const PipelineState& state, FrameBuffer& framebuffer, RenderStats& stats)
+{
+  if (skip_draw(stats))
+  {
+    return;
+  }
+  const auto count = vertices.size();
+  transformed_.resize(count);
+  transformed_epoch_.resize(count, 0U);
+
+  // Epoch 0 marks "never shaded"; on wrap-around the stamps are cleared so stale vertices cannot alias a new draw.
+  if (epoch_ == std::numeric_limits<std::uint32_t>::max())
+  {
+    std::fill(transformed_epoch_.begin(), transformed_epoch_.end(), 0U);
+    epoch_ = 0U;
+  }
+  ++epoch_;
+
+  const MeshletCuller culler{program.get_mvp_matrix(), state.cull_mode, state.front_face};
+  for (const auto& meshlet : mesh.meshlets)
+  {
+    ++stats.meshlets_submitted;
+    if (culler.classify(meshlet.bounds) != MeshletVisibility::VISIBLE)
+    {
+      ++stats.meshlets_culled;
+      continue;
+    }
+
+    const auto* const vertex_indices = &mesh.vertices[meshlet.vertex_offset];
+    const auto* const local_indices = &mesh.triangles[static_cast<std::size_t>(meshlet.triangle_offset) * 3U];
+    for (std::uint32_t t = 0U; t < meshlet.triangle_count; ++t)
+    {
+      const auto& v0 = transform_vertex(program, vertices, vertex_indices[local_indices[(t * 3U) + 0U]]);
+      const auto& v1 = transform_vertex(program, vertices, vertex_indices[local_indices[(t * 3U) + 1U]]);
+      const auto& v2 = transform_vertex(program, vertices, vertex_indices[local_indices[(t * 3U) + 2U]]);
+      process_triangle(program, v0, v1, v2, meshlet.first_primitive + t, state, framebuffer, stats);
+    }
+  }
+}
+
 } // namespace rtw::sw_renderer
@@ -7,6 +7,8 @@
 #include "sw_renderer/precision.h"
 #include "sw_renderer/programmable_pipeline/clip_space.h"
 #include "sw_renderer/programmable_pipeline/frame_buffer.h"
+#include "sw_renderer/programmable_pipeline/meshlet.h"
+#include "sw_renderer/programmable_pipeline/occlusion_query.h"
 #include "sw_renderer/programmable_pipeline/pipeline_rasterisation.h"
 #include "sw_renderer/programmable_pipeline/pipeline_state.h"
 #include "sw_renderer/programmable_pipeline/register_file.h"
@@ -34,15 +36,54 @@ public:
   void draw_elements(const IShaderProgram& program, const RawVertexStream& vertices, const IndexBuffer& indices,
                      const PipelineState& state, FrameBuffer& framebuffer, RenderStats& stats);
 
+  /// Draws a meshlet decomposition (see `build_meshlets`) of an indexed triangle list.
+  ///
+  /// Each meshlet is first classified against the program's MVP matrix (`MeshletCuller`); clusters outside the
+  /// frustum or entirely back-facing are skipped before any of their vertices is shaded. Vertices of the surviving
+  /// clusters are shaded lazily, once per draw, so the output is identical to `draw_elements` on the same indices.
+  void draw_meshlets(const IShaderProgram& program, const RawVertexStream& vertices, const MeshletMesh& mesh,
+                     const PipelineState& state, FrameBuffer& framebuffer, RenderStats& stats);
+
+  /// Starts counting into @p query (reset first) the samples that pass the scissor and depth tests in the following
+  /// draws; see OcclusionQuery. One query is active at a time, and it must outlive `end_query`.
+  void begin_query(OcclusionQuery& query);
+  /// Stops counting and marks the active query's result available.
+  void end_query();
+
+  /// Conditional rendering: the draws up to `end_conditional_render` are skipped, before any vertex is shaded, when
+  /// @p query has a result and no sample passed. A query without a result draws as usual. @p query must outlive
+  /// `end_conditional_render`.
+  void begin_conditional_render(const OcclusionQuery& query);
+  void end_conditional_render();
+
 private:
+  /// Whether conditional rendering skips the current draw; counts it in @p stats if so.
+  bool skip_draw(RenderStats& stats) const;
+
   void transform_vertices(const IShaderProgram& program, const RawVertexStream& vertices);
+  const ClipVertex<single_precision>& transform_vertex(const IShaderProgram& program, const RawVertexStream& vertices,
+                                                       std::uint32_t index);
+
+  void process_triangle(const IShaderProgram& program, const ClipVertex<single_precision>& v0,
+                        const ClipVertex<single_precision>& v1, const ClipVertex<single_precision>& v2,
+                        std::uint32_t primitive_id, const PipelineState& state, FrameBuffer& framebuffer,
+                        RenderStats& stats);
 
-  static void process_triangle(const IShaderProgram& program, const ClipVertex<single_precision>& v0,
-                               const ClipVertex<single_precision>& v1, const ClipVertex<single_precision>& v2,
-                               std::uint32_t primitive_id, const PipelineState& state, FrameBuffer& framebuffer,
-                               RenderStats& stats);
+  /// The fragment shader output of one coarse shading block (see ShadingRate) of the triangle being rasterised.
+  struct CoarseFragment
+  {
+    std::uint32_t epoch{0U}; ///< Triangle the entry belongs to; older entries are stale.
+    std::int32_t block_y{-1};
+    FragmentShaderOutput output;
+  };
 
   std::vector<ClipVertex<single_precision>> transformed_;
+  std::vector<std::uint32_t> transformed_epoch_; ///< Draw in which `transformed_[i]` was last written (lazy path).
+  std::uint32_t epoch_{0U};
+  std::vector<CoarseFragment> coarse_fragments_; ///< Indexed by the x of a block's first column.
+  std::uint32_t coarse_epoch_{0U};
+  OcclusionQuery* active_query_{nullptr};
+  const OcclusionQuery* condition_{nullptr};
 };
 
 } // namespace rtw::sw_renderer
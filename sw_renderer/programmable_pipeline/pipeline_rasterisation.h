@@ -1,5 +1,6 @@
 #pragma once
 
+#include "sw_renderer/programmable_pipeline/multisample.h"
 #include "sw_renderer/programmable_pipeline/register_file.h"
 #include "sw_renderer/raster_common.h"
 #include "sw_renderer/types.h"
@@ -10,6 +11,7 @@
 #include "math/vector_operations.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstdlib>
 #include <type_traits>
@@ -25,15 +27,20 @@ constexpr inline bool IS_VARYING_RASTERISE_CALLBACK_V =
     std::is_invocable_r_v<void, RasteriseCallbackT, const Point2I&, const RegisterFile<single_precision, N>&,
                           single_precision, single_precision>;
 
-} // namespace details
-
-template <std::uint16_t N, typename RasteriseCallbackT,
-          typename = std::enable_if_t<details::IS_VARYING_RASTERISE_CALLBACK_V<N, RasteriseCallbackT>>>
-constexpr void fill_triangle_bbox(const Vector4F& p0, const Vector4F& p1, const Vector4F& p2,
-                                  const RegisterFile<single_precision, N>& varyings0,
-                                  const RegisterFile<single_precision, N>& varyings1,
-                                  const RegisterFile<single_precision, N>& varyings2, const math::BoundingBoxI& bounds,
-                                  RasteriseCallbackT rasterise)
+template <std::uint16_t N, typename RasteriseCallbackT>
+constexpr inline bool IS_MULTISAMPLE_RASTERISE_CALLBACK_V =
+    std::is_invocable_r_v<void, RasteriseCallbackT, const Point2I&, const RegisterFile<single_precision, N>&,
+                          single_precision, single_precision, std::uint32_t, const SampleDepths&>;
+
+/// Shared body of fill_triangle_bbox and fill_triangle_bbox_multisample. With MULTISAMPLE the edge functions are
+/// also evaluated at the MSAA_SAMPLE_POSITIONS: a pixel is emitted when any sample is covered, together with the
+/// coverage mask and the per-sample depths, while the varyings are still interpolated once, at the pixel centre.
+template <bool MULTISAMPLE, std::uint16_t N, typename RasteriseCallbackT>
+constexpr void fill_triangle_bbox_impl(const Vector4F& p0, const Vector4F& p1, const Vector4F& p2,
+                                       const RegisterFile<single_precision, N>& varyings0,
+                                       const RegisterFile<single_precision, N>& varyings1,
+                                       const RegisterFile<single_precision, N>& varyings2,
+                                       const math::BoundingBoxI& bounds, RasteriseCallbackT& rasterise)
 {
   // Bounding-box rasterization via incremental edge functions in the style of
   // Juan Pineda's "A Parallel Algorithm for Polygon Rasterization".
@@ -65,6 +72,24 @@ constexpr void fill_triangle_bbox(const Vector4F& p0, const Vector4F& p1, const
   w1_init += fill_bias(area, edge_b);
   w2_init += fill_bias(area, edge_c);
 
+  // With MULTISAMPLE each sample gets its own edge weights, set up exactly like the centre ones (cross product and
+  // fill bias before normalising), so the top-left rule decides ties on shared edges at every sample.
+  std::array<double_precision, MSAA_SAMPLE_COUNT> sample_w0_init{};
+  std::array<double_precision, MSAA_SAMPLE_COUNT> sample_w1_init{};
+  std::array<double_precision, MSAA_SAMPLE_COUNT> sample_w2_init{};
+  if constexpr (MULTISAMPLE)
+  {
+    for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+    {
+      const Vector2D position{
+          static_cast<double_precision>(min_x) + static_cast<double_precision>(MSAA_SAMPLE_POSITIONS[sample][0U]),
+          static_cast<double_precision>(min_y) + static_cast<double_precision>(MSAA_SAMPLE_POSITIONS[sample][1U])};
+      sample_w0_init[sample] = (math::cross(edge_a, position - vc) + fill_bias(area, edge_a)) / area;
+      sample_w1_init[sample] = (math::cross(edge_b, position - va) + fill_bias(area, edge_b)) / area;
+      sample_w2_init[sample] = (math::cross(edge_c, position - vb) + fill_bias(area, edge_c)) / area;
+    }
+  }
+
   w0_init /= area;
   w1_init /= area;
   w2_init /= area;
@@ -104,6 +129,18 @@ constexpr void fill_triangle_bbox(const Vector4F& p0, const Vector4F& p1, const
   // row), so they stay aligned with w0/w1/w2 without the per-fragment multiply-add.
   auto window_z_row = (w0_init * z0) + (w1_init * z1) + (w2_init * z2);
 
+  // Offsets of the depth from the pixel centre to each sample, fixed per triangle.
+  std::array<double_precision, MSAA_SAMPLE_COUNT> sample_z{};
+  if constexpr (MULTISAMPLE)
+  {
+    for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+    {
+      const auto dx = static_cast<double_precision>(MSAA_SAMPLE_POSITIONS[sample][0U] - 0.5F);
+      const auto dy = static_cast<double_precision>(MSAA_SAMPLE_POSITIONS[sample][1U] - 0.5F);
+      sample_z[sample] = (dz_dx * dx) + (dz_dy * dy);
+    }
+  }
+
   RegisterFile<single_precision, N> varyings;
   for (std::int32_t y = min_y; y <= max_y; ++y)
   {
@@ -111,10 +148,27 @@ constexpr void fill_triangle_bbox(const Vector4F& p0, const Vector4F& p1, const
     auto w1 = w1_init;
     auto w2 = w2_init;
     auto window_z_acc = window_z_row;
+    auto sample_w0 = sample_w0_init;
+    auto sample_w1 = sample_w1_init;
+    auto sample_w2 = sample_w2_init;
 
     for (std::int32_t x = min_x; x <= max_x; ++x)
     {
-      if ((w0 >= 0) && (w1 >= 0) && (w2 >= 0))
+      std::uint32_t coverage = 0U;
+      if constexpr (MULTISAMPLE)
+      {
+        for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+        {
+          const bool covered = (sample_w0[sample] >= 0) && (sample_w1[sample] >= 0) && (sample_w2[sample] >= 0);
+          coverage |= static_cast<std::uint32_t>(covered) << sample;
+        }
+      }
+      else
+      {
+        coverage = static_cast<std::uint32_t>((w0 >= 0) && (w1 >= 0) && (w2 >= 0));
+      }
+
+      if (coverage != 0U)
       {
         const auto window_z = static_cast<single_precision>(window_z_acc);
 
@@ -136,22 +190,82 @@ constexpr void fill_triangle_bbox(const Vector4F& p0, const Vector4F& p1, const
           }
         }
 
-        rasterise(Point2I{x, y}, varyings, window_z, inv_w);
+        if constexpr (MULTISAMPLE)
+        {
+          SampleDepths depths{};
+          for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+          {
+            depths[sample] = static_cast<single_precision>(window_z_acc + sample_z[sample]);
+          }
+          rasterise(Point2I{x, y}, varyings, window_z, inv_w, coverage, depths);
+        }
+        else
+        {
+          rasterise(Point2I{x, y}, varyings, window_z, inv_w);
+        }
       }
 
       w0 -= edge_a.y();
       w1 -= edge_b.y();
       w2 -= edge_c.y();
       window_z_acc += dz_dx;
+      if constexpr (MULTISAMPLE)
+      {
+        for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+        {
+          sample_w0[sample] -= edge_a.y();
+          sample_w1[sample] -= edge_b.y();
+          sample_w2[sample] -= edge_c.y();
+        }
+      }
     }
 
     w0_init += edge_a.x();
     w1_init += edge_b.x();
     w2_init += edge_c.x();
     window_z_row += dz_dy;
+    if constexpr (MULTISAMPLE)
+    {
+      for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+      {
+        sample_w0_init[sample] += edge_a.x();
+        sample_w1_init[sample] += edge_b.x();
+        sample_w2_init[sample] += edge_c.x();
+      }
+    }
   }
 }
 
+} // namespace details
+
+template <std::uint16_t N, typename RasteriseCallbackT,
+          typename = std::enable_if_t<details::IS_VARYING_RASTERISE_CALLBACK_V<N, RasteriseCallbackT>>>
+constexpr void fill_triangle_bbox(const Vector4F& p0, const Vector4F& p1, const Vector4F& p2,
+                                  const RegisterFile<single_precision, N>& varyings0,
+                                  const RegisterFile<single_precision, N>& varyings1,
+                                  const RegisterFile<single_precision, N>& varyings2, const math::BoundingBoxI& bounds,
+                                  RasteriseCallbackT rasterise)
+{
+  details::fill_triangle_bbox_impl<false>(p0, p1, p2, varyings0, varyings1, varyings2, bounds, rasterise);
+}
+
+/// 4x MSAA counterpart of fill_triangle_bbox: the same edge walk, top-left rule and perspective-correct varyings,
+/// but coverage is tested at the four MSAA_SAMPLE_POSITIONS. Each pixel with at least one covered sample invokes
+/// `rasterise(pixel, varyings, window_z, inv_w, coverage, sample_depths)` once; bit i of `coverage` is set when
+/// sample i is inside the triangle and `sample_depths[i]` is the window z at that sample. `window_z`, `inv_w` and
+/// the varyings are evaluated at the pixel centre (which may lie outside the triangle), so a fragment shader runs
+/// once per pixel regardless of how many samples it covers.
+template <std::uint16_t N, typename RasteriseCallbackT,
+          typename = std::enable_if_t<details::IS_MULTISAMPLE_RASTERISE_CALLBACK_V<N, RasteriseCallbackT>>>
+constexpr void fill_triangle_bbox_multisample(const Vector4F& p0, const Vector4F& p1, const Vector4F& p2,
+                                              const RegisterFile<single_precision, N>& varyings0,
+                                              const RegisterFile<single_precision, N>& varyings1,
+                                              const RegisterFile<single_precision, N>& varyings2,
+                                              const math::BoundingBoxI& bounds, RasteriseCallbackT rasterise)
+{
+  details::fill_triangle_bbox_impl<true>(p0, p1, p2, varyings0, varyings1, varyings2, bounds, rasterise);
+}
+
 /// Integer line-walk algorithm used by draw_line_varyings.
 enum class LineRaster : std::uint8_t
 {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "sw_renderer/programmable_pipeline/shading_rate.h"
 #include "sw_renderer/types.h"
 
 #include <cstdint>
@@ -79,10 +80,18 @@ struct Viewport
   std::int32_t height{0};
 };
 
+/// Maps NDC z in [-1, 1] to window z in [z_near, z_far] (glDepthRange).
+///
+/// `reversed()` swaps the ends so that the far plane lands on 0. Combined with DepthFunc::GREATER and a depth clear
+/// of 0 this is reversed-Z: a float depth buffer then spends its dense exponents near 0 on distant geometry,
+/// where a perspective depth is least precise.
 struct DepthRange
 {
   single_precision z_near{0};
   single_precision z_far{1};
+
+  static constexpr DepthRange reversed() noexcept { return DepthRange{single_precision{1}, single_precision{0}}; }
+  constexpr bool is_reversed() const noexcept { return z_far < z_near; }
 };
 
 struct Scissor
@@ -128,6 +137,9 @@ struct PipelineState
   single_precision depth_clear_value{1};
   bool depth_test_enabled{true};
   bool depth_write_enabled{true};
+  ShadingRate shading_rate{ShadingRate::RATE_1X1};
+  /// Per-tile rates overriding `shading_rate` when set; not owned.
+  const ShadingRateImage* shading_rate_image{nullptr};
 };
 
 } // namespace rtw::sw_renderer
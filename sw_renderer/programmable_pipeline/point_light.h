@@ -0,0 +1,50 @@
+#pragma once
+
+#include "sw_renderer/precision.h"
+#include "sw_renderer/types.h"
+
+#include "math/vector_operations.h"
+
+#include "multiprecision/fixed_point.h"
+#include "multiprecision/fixed_point_math.h"
+
+#include <cmath>
+
+namespace rtw::sw_renderer
+{
+
+/// A point light of finite range, in the space the lighting is evaluated in (view space for PointLitShader and
+/// DeferredLighting).
+struct PointLight
+{
+  Vector3F position{};
+  Vector3F color{single_precision{1}, single_precision{1}, single_precision{1}};
+  single_precision radius{1}; ///< Distance at which the light's contribution reaches zero.
+};
+
+/// Lambert diffuse irradiance of @p light at @p position with unit normal @p normal. The falloff
+/// (1 - (d / radius)^2)^2 is smooth and exactly zero from the radius on, so a light can be culled by its bounding
+/// sphere without a visible seam.
+inline Vector3F point_light_irradiance(const Vector3F& position, const Vector3F& normal, const PointLight& light)
+{
+  using multiprecision::math::sqrt;
+  using std::sqrt;
+
+  constexpr single_precision ZERO{0};
+  constexpr single_precision ONE{1};
+
+  const auto to_light = light.position - position;
+  const auto distance2 = math::dot(to_light, to_light);
+  const auto radius2 = light.radius * light.radius;
+  const auto n_dot_l = math::dot(normal, to_light);
+  if ((distance2 >= radius2) || (n_dot_l <= ZERO))
+  {
+    return Vector3F{ZERO, ZERO, ZERO};
+  }
+
+  const auto falloff = ONE - (distance2 / radius2);
+  const auto cosine = n_dot_l / sqrt(distance2);
+  return light.color * (cosine * falloff * falloff);
+}
+
+} // namespace rtw::sw_renderer
@@ -37,6 +37,9 @@ struct VertexShaderOutput
 struct FragmentShaderOutput
 {
   Vector4F color;
+  /// Unit surface normal for the frame buffer's normal attachment in a G-buffer geometry pass (see
+  /// `FrameBuffer::attach_normal_buffer`); ignored without one.
+  Vector3F normal;
   std::optional<single_precision> depth;
   bool discard{false};
 };
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+
+/// Pixels covered by one fragment shader invocation (variable-rate shading).
+///
+/// The framebuffer is divided into screen-aligned blocks of the rate's size. Within a triangle, the fragment shader
+/// runs for the first covered pixel of a block that passes the depth test, and its output (colour, discard and any
+/// written depth) is broadcast to the block's other covered pixels. Coverage, the depth test and the depth write
+/// stay per pixel, so edges and intersections are as exact as at 1x1; only the shading is coarse.
+enum class ShadingRate : std::uint8_t
+{
+  RATE_1X1 = 0U,
+  RATE_2X1,
+  RATE_2X2,
+  RATE_4X4,
+};
+
+/// Largest block extent of any ShadingRate; ShadingRateImage tiles must be a multiple of it.
+constexpr inline std::int32_t MAX_SHADING_RATE_EXTENT{4};
+
+constexpr std::int32_t shading_rate_width(const ShadingRate rate) noexcept
+{
+  switch (rate)
+  {
+  case ShadingRate::RATE_1X1:
+    return 1;
+  case ShadingRate::RATE_2X1:
+  case ShadingRate::RATE_2X2:
+    return 2;
+  case ShadingRate::RATE_4X4:
+    return 4;
+  }
+  return 1;
+}
+
+constexpr std::int32_t shading_rate_height(const ShadingRate rate) noexcept
+{
+  switch (rate)
+  {
+  case ShadingRate::RATE_1X1:
+  case ShadingRate::RATE_2X1:
+    return 1;
+  case ShadingRate::RATE_2X2:
+    return 2;
+  case ShadingRate::RATE_4X4:
+    return 4;
+  }
+  return 1;
+}
+
+/// A shading rate per screen tile, e.g. coarse shading in the periphery and full rate in the centre. Set it as
+/// `PipelineState::shading_rate_image` to override `PipelineState::shading_rate`.
+class ShadingRateImage
+{
+public:
+  static constexpr std::size_t DEFAULT_TILE_SIZE{16U};
+
+  /// @param width, height Size in pixels of the framebuffer the image covers.
+  /// @param tile_size Pixels per tile side; a power of two and a multiple of MAX_SHADING_RATE_EXTENT, so no coarse
+  /// block straddles two tiles.
+  ShadingRateImage(const std::size_t width, const std::size_t height, const std::size_t tile_size = DEFAULT_TILE_SIZE,
+                   const ShadingRate rate = ShadingRate::RATE_1X1)
+      : tile_shift_{tile_shift(tile_size)}, tiles_x_{(width + tile_size - 1U) / tile_size},
+        tiles_y_{(height + tile_size - 1U) / tile_size}, rates_(tiles_x_ * tiles_y_, rate)
+  {
+    assert((tile_size % static_cast<std::size_t>(MAX_SHADING_RATE_EXTENT)) == 0U && "tile too small for 4x4 blocks");
+  }
+
+  std::size_t tile_size() const { return std::size_t{1U} << tile_shift_; }
+  std::size_t tiles_x() const { return tiles_x_; }
+  std::size_t tiles_y() const { return tiles_y_; }
+
+  ShadingRate tile_rate(const std::size_t tile_x, const std::size_t tile_y) const
+  {
+    assert(tile_x < tiles_x_ && tile_y < tiles_y_ && "tile out of bounds");
+    return rates_[(tile_y * tiles_x_) + tile_x];
+  }
+  void set_tile_rate(const std::size_t tile_x, const std::size_t tile_y, const ShadingRate rate)
+  {
+    assert(tile_x < tiles_x_ && tile_y < tiles_y_ && "tile out of bounds");
+    rates_[(tile_y * tiles_x_) + tile_x] = rate;
+  }
+
+  /// The rate of the tile holding pixel (x, y); pixels past the image use its last row / column.
+  ShadingRate rate(const std::int32_t x, const std::int32_t y) const
+  {
+    const auto tile_x = std::min(static_cast<std::size_t>(x) >> tile_shift_, tiles_x_ - 1U);
+    const auto tile_y = std::min(static_cast<std::size_t>(y) >> tile_shift_, tiles_y_ - 1U);
+    return rates_[(tile_y * tiles_x_) + tile_x];
+  }
+
+private:
+  static std::uint32_t tile_shift(const std::size_t tile_size)
+  {
+    assert(tile_size > 0U && (tile_size & (tile_size - 1U)) == 0U && "tile size must be a power of two");
+    std::uint32_t shift = 0U;
+    while ((std::size_t{1U} << shift) < tile_size)
+    {
+      ++shift;
+    }
+    return shift;
+  }
+
+  std::uint32_t tile_shift_{0U};
+  std::size_t tiles_x_{0U};
+  std::size_t tiles_y_{0U};
+  std::vector<ShadingRate> rates_;
+};
+
+} // namespace rtw::sw_renderer
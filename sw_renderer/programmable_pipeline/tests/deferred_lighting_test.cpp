@@ -0,0 +1,236 @@
+#include "sw_renderer/programmable_pipeline/deferred_lighting.h"
+
+#include "sw_renderer/color.h"
+#include "sw_renderer/programmable_pipeline/builtin_shaders.h"
+#include "sw_renderer/programmable_pipeline/frame_buffer.h"
+#include "sw_renderer/programmable_pipeline/pipeline.h"
+#include "sw_renderer/programmable_pipeline/pipeline_state.h"
+#include "sw_renderer/programmable_pipeline/point_light.h"
+#include "sw_renderer/programmable_pipeline/vertex_layout.h"
+#include "sw_renderer/programmable_pipeline/vertex_stream.h"
+#include "sw_renderer/render_stats.h"
+
+#include "math/frustum.h"
+
+#include "stl/span.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace
+{
+namespace sw = rtw::sw_renderer;
+
+constexpr std::size_t SIZE{64U};
+constexpr std::size_t TILE{16U};
+const sw::Color BACKGROUND{0x20'40'60'FFU};
+const sw::Vector4F ALBEDO{1.0F, 0.6F, 0.2F, 1.0F};
+
+struct Vertex
+{
+  std::array<float, 4> position;
+  std::array<float, 3> normal;
+};
+
+sw::VertexLayout make_layout()
+{
+  namespace loc = sw::attribute_location;
+  return sw::VertexLayout{{sw::VertexAttribute{loc::POSITION, 0U, sw::ComponentType::FLOAT32, 4U},
+                           sw::VertexAttribute{loc::NORMAL, 16U, sw::ComponentType::FLOAT32, 3U}},
+                          sizeof(Vertex)};
+}
+
+/// A view-space quad receding to the upper right, leaving background around it, and a nearer triangle in front of
+/// its lower left corner, so the frame has several depths, normals and some overdraw.
+std::vector<Vertex> make_scene()
+{
+  const std::array<float, 3> tilted{-0.3F, 0.2F, 0.933F};
+  const std::array<float, 3> facing{0.0F, 0.0F, 1.0F};
+  return {
+      Vertex{{-1.0F, -1.0F, -2.5F, 1.0F}, tilted}, Vertex{{1.2F, -1.0F, -3.4F, 1.0F}, tilted},
+      Vertex{{1.2F, 1.0F, -3.8F, 1.0F}, tilted},   Vertex{{-1.0F, -1.0F, -2.5F, 1.0F}, tilted},
+      Vertex{{1.2F, 1.0F, -3.8F, 1.0F}, tilted},   Vertex{{-1.0F, 1.0F, -2.9F, 1.0F}, tilted},
+      Vertex{{-0.9F, -0.9F, -2.0F, 1.0F}, facing}, Vertex{{0.0F, -0.9F, -2.0F, 1.0F}, facing},
+      Vertex{{-0.9F, 0.0F, -2.0F, 1.0F}, facing},
+  };
+}
+
+sw::Matrix4x4F make_projection()
+{
+  const auto params = rtw::math::make_perspective_parameters(sw::AngleF{rtw::math::DEG, 60.0F}, 1.0F, 0.1F, 100.0F);
+  return rtw::math::make_perspective_projection_matrix(params);
+}
+
+sw::PipelineState make_state()
+{
+  sw::PipelineState state;
+  state.viewport = sw::Viewport{0, 0, static_cast<std::int32_t>(SIZE), static_cast<std::int32_t>(SIZE)};
+  return state;
+}
+
+std::vector<sw::PointLight> make_lights()
+{
+  return {
+      sw::PointLight{{-0.5F, -0.3F, -1.5F}, {1.0F, 0.9F, 0.8F}, 2.0F},
+      sw::PointLight{{0.8F, 0.7F, -3.0F}, {0.2F, 0.4F, 1.0F}, 1.2F},
+      sw::PointLight{{0.5F, -0.8F, -2.6F}, {0.9F, 0.2F, 0.2F}, 0.8F},
+  };
+}
+
+sw::FrameBuffer render_forward(const std::vector<sw::PointLight>& lights)
+{
+  const auto vertices = make_scene();
+  const sw::RawVertexStream stream{make_layout(), rtw::stl::as_bytes(rtw::stl::make_span(vertices))};
+  sw::PointLitShader shader;
+  shader.set_mvp_matrix(make_projection());
+  shader.set_base_color(ALBEDO);
+  shader.set_ambient(sw::DeferredLightingConfig{}.ambient);
+  shader.set_lights(rtw::stl::make_span(lights));
+
+  sw::FrameBuffer framebuffer{SIZE, SIZE};
+  framebuffer.clear(BACKGROUND, 1.0F);
+  sw::Pipeline pipeline;
+  sw::RenderStats stats;
+  pipeline.draw_arrays(shader, stream, make_state(), framebuffer, stats);
+  return framebuffer;
+}
+
+sw::FrameBuffer render_gbuffer(const sw::NormalEncoding encoding)
+{
+  const auto vertices = make_scene();
+  const sw::RawVertexStream stream{make_layout(), rtw::stl::as_bytes(rtw::stl::make_span(vertices))};
+  sw::GBufferShader shader;
+  shader.set_mvp_matrix(make_projection());
+  shader.set_base_color(ALBEDO);
+
+  sw::FrameBuffer gbuffer{SIZE, SIZE};
+  gbuffer.attach_normal_buffer(encoding);
+  gbuffer.clear(BACKGROUND, 1.0F);
+  sw::Pipeline pipeline;
+  sw::RenderStats stats;
+  pipeline.draw_arrays(shader, stream, make_state(), gbuffer, stats);
+  return gbuffer;
+}
+
+/// Largest per-channel difference between two images.
+int max_channel_difference(const sw::ColorBuffer& lhs, const sw::ColorBuffer& rhs)
+{
+  int result = 0;
+  for (std::size_t y = 0U; y < lhs.height(); ++y)
+  {
+    for (std::size_t x = 0U; x < lhs.width(); ++x)
+    {
+      const auto a = lhs.pixel(x, y);
+      const auto b = rhs.pixel(x, y);
+      for (const auto [first, second] : {std::array<int, 2>{a.r(), b.r()}, std::array<int, 2>{a.g(), b.g()},
+                                         std::array<int, 2>{a.b(), b.b()}, std::array<int, 2>{a.a(), b.a()}})
+      {
+        result = std::max(result, std::abs(first - second));
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(DeferredLighting, geometry_pass_writes_albedo_and_view_space_normals)
+{
+  const auto gbuffer = render_gbuffer(sw::NormalEncoding::OCTAHEDRAL_2X16);
+
+  // The nearer triangle covers the lower left, the quad the centre; the corners stay background.
+  EXPECT_EQ(gbuffer.color_buffer().pixel(12U, 50U), sw::Color{ALBEDO});
+  EXPECT_NEAR(gbuffer.normal_buffer().normal(12U, 50U).z(), 1.0F, 1.0e-4F);
+  EXPECT_NEAR(gbuffer.normal_buffer().normal(36U, 28U).x(), -0.3F, 1.0e-3F);
+  EXPECT_EQ(gbuffer.color_buffer().pixel(1U, 1U), BACKGROUND);
+  EXPECT_FLOAT_EQ(gbuffer.depth_buffer().depth(1U, 1U), 1.0F);
+}
+
+TEST(DeferredLighting, matches_forward_shading)
+{
+  const auto lights = make_lights();
+  const auto forward = render_forward(lights);
+
+  // The G-buffer stores the albedo in 8 bits, which costs up to one step before lighting and one after.
+  for (const auto [encoding, tolerance] :
+       {std::pair{sw::NormalEncoding::OCTAHEDRAL_2X16, 2}, std::pair{sw::NormalEncoding::OCTAHEDRAL_2X8, 4}})
+  {
+    auto gbuffer = render_gbuffer(encoding);
+    sw::DeferredLighting lighting{sw::DeferredLightingConfig{TILE}};
+    lighting.shade(gbuffer, make_projection(), make_state(), rtw::stl::make_span(lights), gbuffer.color_buffer());
+    EXPECT_LE(max_channel_difference(gbuffer.color_buffer(), forward.color_buffer()), tolerance);
+    EXPECT_EQ(gbuffer.color_buffer().pixel(1U, 1U), BACKGROUND);
+  }
+}
+
+TEST(DeferredLighting, culls_lights_per_tile)
+{
+  const auto gbuffer = render_gbuffer(sw::NormalEncoding::OCTAHEDRAL_2X16);
+  sw::DeferredLighting lighting{sw::DeferredLightingConfig{TILE}};
+  sw::ColorBuffer target{SIZE, SIZE};
+  constexpr std::size_t TILES{(SIZE / TILE) * (SIZE / TILE)};
+
+  // A small light only reaches the tiles around it, one behind the camera and one beyond the scene's depth reach no
+  // tile at all.
+  const std::vector<sw::PointLight> lights{sw::PointLight{{-0.5F, -0.5F, -2.2F}, {1.0F, 1.0F, 1.0F}, 0.4F},
+                                           sw::PointLight{{0.0F, 0.0F, 2.0F}, {1.0F, 1.0F, 1.0F}, 1.0F},
+                                           sw::PointLight{{0.0F, 0.0F, -20.0F}, {1.0F, 1.0F, 1.0F}, 2.0F}};
+  lighting.shade(gbuffer, make_projection(), make_state(), rtw::stl::make_span(lights), target);
+  EXPECT_GT(lighting.lights_shaded_per_tile(), 0U);
+  EXPECT_LT(lighting.lights_shaded_per_tile(), TILES / 2U);
+
+  const auto forward = render_forward(lights);
+  EXPECT_LE(max_channel_difference(target, forward.color_buffer()), 2);
+}
+
+TEST(DeferredLighting, threads_produce_the_same_image)
+{
+  const auto gbuffer = render_gbuffer(sw::NormalEncoding::OCTAHEDRAL_2X16);
+  const auto lights = make_lights();
+
+  sw::ColorBuffer serial{SIZE, SIZE};
+  sw::DeferredLighting lighting{sw::DeferredLightingConfig{TILE}};
+  lighting.shade(gbuffer, make_projection(), make_state(), rtw::stl::make_span(lights), serial);
+  const auto serial_lights = lighting.lights_shaded_per_tile();
+
+  sw::ColorBuffer parallel{SIZE, SIZE};
+  lighting.set_thread_count(4U);
+  lighting.shade(gbuffer, make_projection(), make_state(), rtw::stl::make_span(lights), parallel);
+  EXPECT_EQ(lighting.lights_shaded_per_tile(), serial_lights);
+  EXPECT_EQ(max_channel_difference(serial, parallel), 0);
+
+  // The threads are kept between calls and replaced when the count changes.
+  for (const std::size_t thread_count : {4U, 3U, 1U, 2U})
+  {
+    sw::ColorBuffer again{SIZE, SIZE};
+    lighting.set_thread_count(thread_count);
+    lighting.shade(gbuffer, make_projection(), make_state(), rtw::stl::make_span(lights), again);
+    EXPECT_EQ(max_channel_difference(serial, again), 0) << thread_count;
+  }
+}
+
+TEST(DeferredLighting, threads_produce_the_same_image_with_unaligned_tiles)
+{
+  const auto gbuffer = render_gbuffer(sw::NormalEncoding::OCTAHEDRAL_2X16);
+  const auto lights = make_lights();
+
+  // Light tiles that straddle the target's clear tiles.
+  for (const std::size_t tile_size : {8U, 24U})
+  {
+    sw::ColorBuffer serial{SIZE, SIZE};
+    sw::DeferredLighting lighting{sw::DeferredLightingConfig{tile_size}};
+    lighting.shade(gbuffer, make_projection(), make_state(), rtw::stl::make_span(lights), serial);
+
+    sw::ColorBuffer parallel{SIZE, SIZE};
+    lighting.set_thread_count(4U);
+    lighting.shade(gbuffer, make_projection(), make_state(), rtw::stl::make_span(lights), parallel);
+    EXPECT_EQ(max_channel_difference(serial, parallel), 0) << tile_size;
+  }
+}
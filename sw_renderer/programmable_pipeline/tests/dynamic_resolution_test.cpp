@@ -0,0 +1,190 @@
+#include "sw_renderer/programmable_pipeline/dynamic_resolution.h"
+
+#include "sw_renderer/color.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+namespace sw = rtw::sw_renderer;
+
+using Controller = sw::DynamicResolution;
+
+/// Stats whose modelled cost is proportional to the pixels a frame at @p scale covers.
+sw::RenderStats frame_stats(const Controller& controller)
+{
+  sw::RenderStats stats;
+  stats.fragments_shaded = controller.render_width() * controller.render_height();
+  return stats;
+}
+
+bool is_step_multiple(const float scale, const float step)
+{
+  const auto steps = scale / step;
+  return std::abs(steps - std::round(steps)) < 1.0e-4F;
+}
+
+} // namespace
+
+TEST(DynamicResolution, starts_at_the_largest_scale)
+{
+  const Controller controller{640U, 480U};
+  EXPECT_FLOAT_EQ(controller.scale(), 1.0F);
+  EXPECT_EQ(controller.render_width(), 640U);
+  EXPECT_EQ(controller.render_height(), 480U);
+  EXPECT_EQ(controller.viewport().width, 640);
+  EXPECT_EQ(controller.viewport().height, 480);
+}
+
+TEST(DynamicResolution, lowers_the_scale_when_over_budget_and_raises_it_when_under)
+{
+  Controller::Config config;
+  config.target_ms = 10.0F;
+  Controller controller{640U, 480U, config};
+
+  const sw::RenderStats stats;
+  float previous = controller.scale();
+  for (int frame = 0; frame < 4; ++frame)
+  {
+    const auto scale = controller.update(20.0F, stats);
+    EXPECT_LT(scale, previous);
+    EXPECT_GE(previous - scale, 0.0F);
+    EXPECT_LE(previous - scale, config.max_change + 1.0e-6F);
+    EXPECT_TRUE(is_step_multiple(scale, config.scale_step));
+    previous = scale;
+  }
+
+  // Sustained overload never goes below the bound.
+  for (int frame = 0; frame < 64; ++frame)
+  {
+    controller.update(100.0F, stats);
+  }
+  EXPECT_FLOAT_EQ(controller.scale(), config.min_scale);
+  EXPECT_EQ(controller.render_width(), 320U);
+
+  // Sustained headroom climbs back to the upper bound.
+  for (int frame = 0; frame < 64; ++frame)
+  {
+    controller.update(1.0F, stats);
+  }
+  EXPECT_FLOAT_EQ(controller.scale(), config.max_scale);
+}
+
+TEST(DynamicResolution, ignores_costs_inside_the_dead_band)
+{
+  Controller::Config config;
+  config.target_ms = 10.0F;
+  Controller controller{640U, 480U, config};
+  controller.set_scale(0.75F);
+
+  for (int frame = 0; frame < 16; ++frame)
+  {
+    EXPECT_FLOAT_EQ(controller.update((frame % 2 == 0) ? 10.4F : 9.6F, sw::RenderStats{}), 0.75F);
+  }
+}
+
+TEST(DynamicResolution, set_scale_clamps_and_quantises)
+{
+  Controller controller{100U, 50U};
+  controller.set_scale(0.1F);
+  EXPECT_FLOAT_EQ(controller.scale(), 0.5F);
+  controller.set_scale(0.70F);
+  EXPECT_FLOAT_EQ(controller.scale(), 0.6875F); // 22 / 32
+  EXPECT_EQ(controller.render_width(), 69U);
+  EXPECT_EQ(controller.render_height(), 34U);
+}
+
+TEST(DynamicResolution, deterministic_mode_settles_on_the_modelled_budget)
+{
+  Controller::Config config;
+  config.ms_per_fragment = 1.0e-4F;
+  config.ms_per_triangle = 0.0F;
+  // 640x480 costs 30.72 ms in this model, so a 10 ms budget needs ~57% of the pixels per axis.
+  config.target_ms = 10.0F;
+
+  const auto run = [&config]
+  {
+    Controller controller{640U, 480U, config, Controller::Mode::DETERMINISTIC};
+    std::vector<float> scales;
+    for (int frame = 0; frame < 32; ++frame)
+    {
+      // The measured time is noise the deterministic mode must ignore.
+      scales.push_back(controller.update(static_cast<float>(frame * 7 % 13), frame_stats(controller)));
+    }
+    return scales;
+  };
+
+  const auto scales = run();
+  EXPECT_EQ(scales, run());
+
+  Controller controller{640U, 480U, config, Controller::Mode::DETERMINISTIC};
+  controller.set_scale(scales.back());
+  const auto settled_ms = controller.modelled_ms(frame_stats(controller));
+  EXPECT_NEAR(settled_ms, config.target_ms, config.target_ms * 0.15F);
+}
+
+TEST(Upscale, nearest_replicates_source_texels)
+{
+  sw::ColorBuffer source{4U, 4U};
+  source.set_pixel(0U, 0U, sw::Color{0xFF0000FFU});
+  source.set_pixel(1U, 0U, sw::Color{0xFF00FF00U});
+  source.set_pixel(0U, 1U, sw::Color{0xFFFF0000U});
+  source.set_pixel(1U, 1U, sw::Color{0xFFFFFFFFU});
+
+  sw::ColorBuffer target{6U, 4U};
+  sw::upscale(source, 2U, 2U, target, sw::UpscaleFilter::NEAREST);
+
+  for (std::size_t y = 0U; y < 4U; ++y)
+  {
+    for (std::size_t x = 0U; x < 6U; ++x)
+    {
+      EXPECT_EQ(target.pixel(x, y), source.pixel(x / 3U, y / 2U)) << x << ", " << y;
+    }
+  }
+}
+
+TEST(Upscale, bilinear_blends_between_texel_centres)
+{
+  sw::ColorBuffer source{2U, 1U};
+  source.set_pixel(0U, 0U, sw::Color{0xFF000000U});
+  source.set_pixel(1U, 0U, sw::Color{0xFFFFFFFFU});
+
+  sw::ColorBuffer target{4U, 1U};
+  sw::upscale(source, 2U, 1U, target, sw::UpscaleFilter::BILINEAR);
+
+  // Target centres map to source x 0.25, 0.75, 1.25, 1.75: the outer pixels clamp to the edge texels, the inner
+  // ones sit a quarter of the way from each centre.
+  EXPECT_EQ(target.pixel(0U, 0U), sw::Color{0xFF000000U});
+  EXPECT_EQ(target.pixel(1U, 0U), sw::Color{0xFF3F3F3FU});
+  EXPECT_EQ(target.pixel(2U, 0U), sw::Color{0xFFBFBFBFU});
+  EXPECT_EQ(target.pixel(3U, 0U), sw::Color{0xFFFFFFFFU});
+}
+
+TEST(Upscale, same_size_is_a_copy)
+{
+  sw::ColorBuffer source{5U, 3U};
+  for (std::size_t y = 0U; y < 3U; ++y)
+  {
+    for (std::size_t x = 0U; x < 5U; ++x)
+    {
+      source.set_pixel(x, y, sw::Color{static_cast<std::uint32_t>(0xFF000000U + (x * 40U) + (y * 0x5000U))});
+    }
+  }
+
+  for (const auto filter : {sw::UpscaleFilter::NEAREST, sw::UpscaleFilter::BILINEAR})
+  {
+    sw::ColorBuffer target{5U, 3U};
+    sw::upscale(source, 5U, 3U, target, filter);
+    for (std::size_t y = 0U; y < 3U; ++y)
+    {
+      for (std::size_t x = 0U; x < 5U; ++x)
+      {
+        EXPECT_EQ(target.pixel(x, y), source.pixel(x, y));
+      }
+    }
+  }
+}
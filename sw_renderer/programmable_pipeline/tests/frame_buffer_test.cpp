@@ -64,3 +64,54 @@ TEST(FrameBuffer, mutable_accessors_write_through)
   EXPECT_EQ(const_ref.color_buffer().pixel(1, 2), sw::Color{0xAA'BB'CC'DDU});
   EXPECT_EQ(const_ref.depth_buffer().depth(1, 2), sw::single_precision{0.25F});
 }
+
+TEST(FrameBuffer, multisampled_depth_holds_every_sample)
+{
+  const sw::FrameBuffer frame_buffer{8, 4, sw::DepthFormat::D32F, sw::SampleCount::X4};
+  EXPECT_TRUE(frame_buffer.is_multisampled());
+  EXPECT_EQ(frame_buffer.sample_count(), 4U);
+  EXPECT_EQ(frame_buffer.width(), 8);
+  EXPECT_EQ(frame_buffer.color_buffer().width(), 8);
+  EXPECT_EQ(frame_buffer.depth_buffer().width(), 32);
+  EXPECT_EQ(frame_buffer.depth_buffer().height(), 4);
+  EXPECT_EQ(frame_buffer.depth_column(3, 2), 14U);
+}
+
+TEST(FrameBuffer, multisampled_color_compresses_and_resolves)
+{
+  constexpr sw::Color BLACK{0x00'00'00'FFU};
+  constexpr sw::Color WHITE{0xFF'FF'FF'FFU};
+  const auto replace = [](const sw::Color color) { return [color](const sw::Color) { return color; }; };
+
+  sw::FrameBuffer frame_buffer{4, 4, sw::DepthFormat::D32F, sw::SampleCount::X4};
+  frame_buffer.clear(BLACK, sw::single_precision{1});
+
+  // Full coverage and unchanged colours keep the pixel compressed.
+  frame_buffer.write_samples(0, 0, sw::MSAA_FULL_COVERAGE, replace(WHITE));
+  frame_buffer.write_samples(1, 0, 0b0011U, replace(BLACK));
+  EXPECT_FALSE(frame_buffer.is_expanded(0, 0));
+  EXPECT_FALSE(frame_buffer.is_expanded(1, 0));
+  EXPECT_EQ(frame_buffer.color_buffer().pixel(0, 0), WHITE);
+
+  // Partial coverage with a new colour expands the pixel.
+  frame_buffer.write_samples(1, 1, 0b0011U, replace(WHITE));
+  ASSERT_TRUE(frame_buffer.is_expanded(1, 1));
+  EXPECT_EQ(frame_buffer.sample_color(1, 1, 0U), WHITE);
+  EXPECT_EQ(frame_buffer.sample_color(1, 1, 1U), WHITE);
+  EXPECT_EQ(frame_buffer.sample_color(1, 1, 2U), BLACK);
+  EXPECT_EQ(frame_buffer.sample_color(1, 1, 3U), BLACK);
+
+  frame_buffer.resolve();
+  EXPECT_EQ(frame_buffer.color_buffer().pixel(1, 1), (sw::Color{0x80'80'80'FFU}));
+  EXPECT_EQ(frame_buffer.color_buffer().pixel(0, 0), WHITE);
+  EXPECT_EQ(frame_buffer.color_buffer().pixel(2, 2), BLACK);
+
+  // Covering the remaining samples with the same colour folds the pixel back.
+  frame_buffer.write_samples(1, 1, 0b1100U, replace(WHITE));
+  EXPECT_FALSE(frame_buffer.is_expanded(1, 1));
+  EXPECT_EQ(frame_buffer.color_buffer().pixel(1, 1), WHITE);
+
+  frame_buffer.write_samples(2, 2, 0b0001U, replace(WHITE));
+  frame_buffer.clear(BLACK, sw::single_precision{1});
+  EXPECT_FALSE(frame_buffer.is_expanded(2, 2));
+}
@@ -0,0 +1,93 @@
+#include "sw_renderer/programmable_pipeline/frame_ring.h"
+
+#include "sw_renderer/color.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace
+{
+namespace sw = rtw::sw_renderer;
+
+/// Fills the frame with a colour derived from its index, so a presented frame shows which submission it came from.
+void render_index(sw::FrameBuffer& framebuffer, const std::uint64_t frame)
+{
+  framebuffer.clear(sw::Color{static_cast<std::uint32_t>(frame + 1U)}, sw::single_precision{1});
+}
+
+} // namespace
+
+TEST(Fence, signal_wakes_a_waiting_thread)
+{
+  sw::Fence fence;
+  EXPECT_FALSE(fence.is_signaled());
+
+  std::thread signaler{[&fence] { fence.signal(); }};
+  fence.wait();
+  signaler.join();
+  EXPECT_TRUE(fence.is_signaled());
+
+  fence.reset();
+  EXPECT_FALSE(fence.is_signaled());
+}
+
+TEST(FrameRing, frame_count_is_clamped)
+{
+  const sw::FrameRing single{1U, 4U, 4U};
+  EXPECT_EQ(single.frame_count(), sw::FrameRing::MIN_FRAMES);
+  const sw::FrameRing many{8U, 4U, 4U};
+  EXPECT_EQ(many.frame_count(), sw::FrameRing::MAX_FRAMES);
+}
+
+TEST(FrameRing, presents_frames_in_submission_order)
+{
+  for (const std::size_t frame_count : {2U, 3U})
+  {
+    sw::FrameRing ring{frame_count, 4U, 4U};
+    constexpr std::uint64_t FRAMES{16U};
+
+    ring.submit(render_index);
+    for (std::uint64_t i = 0U; i < FRAMES; ++i)
+    {
+      ring.submit(render_index);
+      EXPECT_LE(ring.frames_in_flight(), ring.frame_count());
+
+      const auto frame = ring.acquire();
+      ASSERT_NE(frame.framebuffer, nullptr);
+      EXPECT_EQ(frame.index, i);
+      EXPECT_EQ(frame.framebuffer->color_buffer().pixel(1U, 1U), sw::Color{static_cast<std::uint32_t>(i + 1U)});
+      ring.release();
+    }
+    ring.wait_idle();
+    EXPECT_EQ(ring.frames_in_flight(), 1U);
+  }
+}
+
+TEST(FrameRing, renders_the_next_frame_while_one_is_held)
+{
+  sw::FrameRing ring{2U, 4U, 4U};
+  std::atomic<bool> second_rendered{false};
+
+  ring.submit(render_index);
+  const auto first = ring.acquire();
+  // The first slot is still held, yet the worker renders the second frame into the other one.
+  ring.submit(
+      [&second_rendered](sw::FrameBuffer& framebuffer, const std::uint64_t frame)
+      {
+        render_index(framebuffer, frame);
+        second_rendered = true;
+      });
+  ring.wait_idle();
+  EXPECT_TRUE(second_rendered);
+  EXPECT_EQ(first.framebuffer->color_buffer().pixel(0U, 0U), sw::Color{1U});
+  ring.release();
+
+  const auto second = ring.acquire();
+  EXPECT_EQ(second.index, 1U);
+  EXPECT_NE(second.framebuffer, first.framebuffer);
+  EXPECT_EQ(second.framebuffer->color_buffer().pixel(0U, 0U), sw::Color{2U});
+  ring.release();
+}
@@ -0,0 +1,335 @@
+#include "sw_renderer/programmable_pipeline/meshlet.h"
+
+#include "constants/math_constants.h"
+#include "sw_renderer/color.h"
+#include "sw_renderer/programmable_pipeline/frame_buffer.h"
+#include "sw_renderer/programmable_pipeline/pipeline.h"
+#include "sw_renderer/programmable_pipeline/pipeline_state.h"
+#include "sw_renderer/programmable_pipeline/shader.h"
+#include "sw_renderer/programmable_pipeline/vertex_layout.h"
+#include "sw_renderer/programmable_pipeline/vertex_stream.h"
+#include "sw_renderer/render_stats.h"
+#include "sw_renderer/types.h"
+
+#include "math/frustum.h"
+#include "math/matrix_operations.h"
+#include "math/point_operations.h"
+
+#include "stl/span.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+namespace
+{
+
+// --- Fixtures and helpers ---------------------------------------------------
+
+constexpr std::size_t WIDTH{64U};
+constexpr std::size_t HEIGHT{48U};
+
+constexpr std::uint32_t POSITION_LOCATION{0U};
+
+struct Vertex
+{
+  std::array<float, 4> position;
+};
+
+RawVertexStream make_stream(const std::vector<Vertex>& vertices)
+{
+  const VertexLayout layout{{VertexAttribute{POSITION_LOCATION, 0U, ComponentType::FLOAT32, 4U}}, sizeof(Vertex)};
+  return RawVertexStream{layout, stl::as_bytes(stl::make_span(vertices))};
+}
+
+/// A UV sphere of radius `radius` centred at `center`, with counter-clockwise (outward-facing) triangles.
+struct SphereMesh
+{
+  std::vector<Vertex> vertices;
+  std::vector<std::uint32_t> indices;
+};
+
+SphereMesh make_sphere(const std::size_t stacks, const std::size_t slices, const float radius = 1.0F,
+                       const std::array<float, 3> center = {0.0F, 0.0F, 0.0F})
+{
+  SphereMesh mesh;
+  for (std::size_t i = 0U; i <= stacks; ++i)
+  {
+    const auto theta = rtw::math_constants::PI<float> * static_cast<float>(i) / static_cast<float>(stacks);
+    for (std::size_t j = 0U; j <= slices; ++j)
+    {
+      const auto phi = 2.0F * rtw::math_constants::PI<float> * static_cast<float>(j) / static_cast<float>(slices);
+      mesh.vertices.push_back(Vertex{{center[0U] + (radius * std::sin(theta) * std::sin(phi)),
+                                      center[1U] + (radius * std::cos(theta)),
+                                      center[2U] + (radius * std::sin(theta) * std::cos(phi)), 1.0F}});
+    }
+  }
+  // Quads are emitted in 7x7 blocks (64 vertices, 98 triangles), so consecutive triangles are spatially close and
+  // the order-preserving builder produces compact clusters.
+  constexpr std::uint32_t BLOCK{7U};
+  const auto row = static_cast<std::uint32_t>(slices + 1U);
+  for (std::uint32_t bi = 0U; bi < stacks; bi += BLOCK)
+  {
+    for (std::uint32_t bj = 0U; bj < slices; bj += BLOCK)
+    {
+      for (std::uint32_t i = bi; i < std::min<std::uint32_t>(bi + BLOCK, stacks); ++i)
+      {
+        for (std::uint32_t j = bj; j < std::min<std::uint32_t>(bj + BLOCK, slices); ++j)
+        {
+          const auto a = (i * row) + j;
+          const auto b = ((i + 1U) * row) + j;
+          const auto c = b + 1U;
+          const auto d = a + 1U;
+          mesh.indices.insert(mesh.indices.end(), {a, b, c, a, c, d});
+        }
+      }
+    }
+  }
+  return mesh;
+}
+
+/// Perspective camera at the origin looking down -Z; the object is pushed `depth` units away.
+Matrix4x4F make_mvp(const float offset_x = 0.0F, const float depth = 4.0F)
+{
+  const auto params = math::make_perspective_parameters(AngleF{math::DEG, 60.0F},
+                                                        static_cast<single_precision>(WIDTH) / HEIGHT, 0.1F, 100.0F);
+  const auto projection = math::make_perspective_projection_matrix(params);
+  // clang-format off
+  const Matrix4x4F model{math::FROM_ROW_MAJOR,
+    1.0F, 0.0F, 0.0F, offset_x,
+    0.0F, 1.0F, 0.0F, 0.0F,
+    0.0F, 0.0F, 1.0F, -depth,
+    0.0F, 0.0F, 0.0F, 1.0F,
+  };
+  // clang-format on
+  return projection * model;
+}
+
+/// Colours every fragment by its primitive id, so a mismatch in triangle order or id shows up in the image.
+class PrimitiveIdProgram : public IShaderProgram
+{
+public:
+  VertexShaderOutput vertex(const AttributeView& input, const VertexContext& /*context*/) const override
+  {
+    VertexShaderOutput out;
+    out.position = get_mvp_matrix() * input.attribute(POSITION_LOCATION);
+    return out;
+  }
+
+  FragmentShaderOutput fragment(const DynamicVaryings& /*varyings*/, const FragmentContext& context) const override
+  {
+    FragmentShaderOutput out;
+    const auto id = context.primitive_id;
+    out.color = Vector4F{static_cast<float>(id & 0xFFU) / 255.0F, static_cast<float>((id >> 8U) & 0xFFU) / 255.0F,
+                         0.0F, 1.0F};
+    return out;
+  }
+};
+
+PipelineState make_state(const CullMode cull_mode)
+{
+  PipelineState state;
+  state.viewport = Viewport{0, 0, static_cast<std::int32_t>(WIDTH), static_cast<std::int32_t>(HEIGHT)};
+  state.cull_mode = cull_mode;
+  return state;
+}
+
+MeshletBounds make_patch_bounds(const Point3F& center, const Vector3F& normal)
+{
+  MeshletBounds bounds;
+  bounds.center = center;
+  bounds.radius = 0.1F;
+  bounds.cone_axis = normal;
+  bounds.cone_cutoff = 0.2F;
+  return bounds;
+}
+
+// --- build_meshlets ---------------------------------------------------------
+
+TEST(Meshlet, build_meshlets_respects_limits_and_preserves_triangle_order)
+{
+  const auto sphere = make_sphere(24U, 48U);
+  const auto mesh = build_meshlets(make_stream(sphere.vertices), IndexBuffer{sphere.indices});
+
+  ASSERT_FALSE(mesh.meshlets.empty());
+  std::vector<std::uint32_t> rebuilt;
+  std::uint32_t next_primitive = 0U;
+  for (const auto& meshlet : mesh.meshlets)
+  {
+    EXPECT_GT(meshlet.triangle_count, 0U);
+    EXPECT_LE(meshlet.vertex_count, MESHLET_MAX_VERTICES);
+    EXPECT_LE(meshlet.triangle_count, MESHLET_MAX_TRIANGLES);
+    EXPECT_EQ(meshlet.first_primitive, next_primitive);
+    next_primitive += meshlet.triangle_count;
+
+    // The vertex list of a meshlet is free of duplicates.
+    const std::set<std::uint32_t> unique(mesh.vertices.begin() + meshlet.vertex_offset,
+                                         mesh.vertices.begin() + meshlet.vertex_offset + meshlet.vertex_count);
+    EXPECT_EQ(unique.size(), meshlet.vertex_count);
+
+    for (std::size_t i = 0U; i < (meshlet.triangle_count * 3U); ++i)
+    {
+      const auto local = mesh.triangles[(meshlet.triangle_offset * 3U) + i];
+      ASSERT_LT(local, meshlet.vertex_count);
+      rebuilt.push_back(mesh.vertices[meshlet.vertex_offset + local]);
+    }
+  }
+  EXPECT_EQ(rebuilt, sphere.indices);
+}
+
+TEST(Meshlet, build_meshlets_bounds_enclose_vertices_and_normals)
+{
+  const auto sphere = make_sphere(16U, 32U);
+  const auto mesh = build_meshlets(make_stream(sphere.vertices), IndexBuffer{sphere.indices});
+
+  for (const auto& meshlet : mesh.meshlets)
+  {
+    const auto& bounds = meshlet.bounds;
+    for (std::size_t i = 0U; i < meshlet.vertex_count; ++i)
+    {
+      const auto& p = sphere.vertices[mesh.vertices[meshlet.vertex_offset + i]].position;
+      EXPECT_LE(math::distance(Point3F{p[0U], p[1U], p[2U]}, bounds.center), bounds.radius + 1e-5F);
+    }
+
+    // On a convex sphere the outward cone axis points roughly along the cluster centre.
+    if (bounds.cone_cutoff < 1.0F)
+    {
+      EXPECT_GT(math::dot(bounds.cone_axis, static_cast<Vector3F>(bounds.center)), 0.0F);
+    }
+  }
+}
+
+TEST(Meshlet, build_meshlets_ignores_empty_input)
+{
+  const std::vector<Vertex> vertices;
+  const auto mesh = build_meshlets(make_stream(vertices), IndexBuffer{std::vector<std::uint32_t>{}});
+  EXPECT_TRUE(mesh.meshlets.empty());
+  EXPECT_TRUE(mesh.vertices.empty());
+  EXPECT_TRUE(mesh.triangles.empty());
+}
+
+// --- MeshletCuller ----------------------------------------------------------
+
+TEST(MeshletCuller, rejects_bounds_outside_the_frustum)
+{
+  const MeshletCuller culler{make_mvp(), CullMode::NONE, FrontFace::COUNTER_CLOCKWISE};
+
+  EXPECT_EQ(culler.classify(make_patch_bounds(Point3F{0.0F, 0.0F, 0.0F}, Vector3F{0.0F, 0.0F, 1.0F})),
+            MeshletVisibility::VISIBLE);
+  EXPECT_EQ(culler.classify(make_patch_bounds(Point3F{20.0F, 0.0F, 0.0F}, Vector3F{0.0F, 0.0F, 1.0F})),
+            MeshletVisibility::OUTSIDE_FRUSTUM);
+  EXPECT_EQ(culler.classify(make_patch_bounds(Point3F{0.0F, 0.0F, 10.0F}, Vector3F{0.0F, 0.0F, 1.0F})),
+            MeshletVisibility::OUTSIDE_FRUSTUM);
+  EXPECT_EQ(culler.classify(make_patch_bounds(Point3F{0.0F, 0.0F, -200.0F}, Vector3F{0.0F, 0.0F, 1.0F})),
+            MeshletVisibility::OUTSIDE_FRUSTUM);
+
+  // A sphere straddling the right plane is kept.
+  auto straddling = make_patch_bounds(Point3F{3.0F, 0.0F, 0.0F}, Vector3F{0.0F, 0.0F, 1.0F});
+  straddling.radius = 1.5F;
+  EXPECT_EQ(culler.classify(straddling), MeshletVisibility::VISIBLE);
+}
+
+TEST(MeshletCuller, cone_test_follows_cull_mode_and_front_face)
+{
+  const auto towards = make_patch_bounds(Point3F{0.0F, 0.0F, 0.0F}, Vector3F{0.0F, 0.0F, 1.0F});
+  const auto away = make_patch_bounds(Point3F{0.0F, 0.0F, 0.0F}, Vector3F{0.0F, 0.0F, -1.0F});
+  const auto mvp = make_mvp();
+
+  const MeshletCuller back{mvp, CullMode::BACK, FrontFace::COUNTER_CLOCKWISE};
+  EXPECT_EQ(back.classify(towards), MeshletVisibility::VISIBLE);
+  EXPECT_EQ(back.classify(away), MeshletVisibility::BACKFACING);
+
+  const MeshletCuller front{mvp, CullMode::FRONT, FrontFace::COUNTER_CLOCKWISE};
+  EXPECT_EQ(front.classify(towards), MeshletVisibility::BACKFACING);
+  EXPECT_EQ(front.classify(away), MeshletVisibility::VISIBLE);
+
+  const MeshletCuller back_cw{mvp, CullMode::BACK, FrontFace::CLOCKWISE};
+  EXPECT_EQ(back_cw.classify(towards), MeshletVisibility::BACKFACING);
+  EXPECT_EQ(back_cw.classify(away), MeshletVisibility::VISIBLE);
+
+  const MeshletCuller none{mvp, CullMode::NONE, FrontFace::COUNTER_CLOCKWISE};
+  EXPECT_EQ(none.classify(away), MeshletVisibility::VISIBLE);
+
+  // A cone that spans a hemisphere never culls.
+  auto wide = away;
+  wide.cone_cutoff = 1.0F;
+  EXPECT_EQ(back.classify(wide), MeshletVisibility::VISIBLE);
+}
+
+// --- Pipeline::draw_meshlets ------------------------------------------------
+
+void expect_same_image(const FrameBuffer& expected, const FrameBuffer& actual)
+{
+  for (std::size_t y = 0U; y < HEIGHT; ++y)
+  {
+    for (std::size_t x = 0U; x < WIDTH; ++x)
+    {
+      ASSERT_EQ(expected.color_buffer().pixel(x, y), actual.color_buffer().pixel(x, y)) << x << ", " << y;
+      ASSERT_EQ(expected.depth_buffer().depth(x, y), actual.depth_buffer().depth(x, y)) << x << ", " << y;
+    }
+  }
+}
+
+TEST(Meshlet, draw_meshlets_matches_draw_elements_for_partially_visible_mesh)
+{
+  const auto sphere = make_sphere(24U, 48U);
+  const auto stream = make_stream(sphere.vertices);
+  const IndexBuffer indices{sphere.indices};
+  const auto mesh = build_meshlets(stream, indices);
+
+  PrimitiveIdProgram program;
+  program.set_mvp_matrix(make_mvp(3.0F)); // Sphere hangs off the right edge of the screen.
+
+  for (const auto cull_mode : {CullMode::NONE, CullMode::BACK})
+  {
+    const auto state = make_state(cull_mode);
+    Pipeline pipeline;
+
+    FrameBuffer expected{WIDTH, HEIGHT};
+    expected.clear(Color{}, 1.0F);
+    RenderStats expected_stats;
+    pipeline.draw_elements(program, stream, indices, state, expected, expected_stats);
+
+    FrameBuffer actual{WIDTH, HEIGHT};
+    actual.clear(Color{}, 1.0F);
+    RenderStats actual_stats;
+    pipeline.draw_meshlets(program, stream, mesh, state, actual, actual_stats);
+
+    expect_same_image(expected, actual);
+    EXPECT_EQ(actual_stats.triangles_rendered, expected_stats.triangles_rendered);
+    EXPECT_EQ(actual_stats.meshlets_submitted, mesh.meshlets.size());
+    EXPECT_GT(actual_stats.meshlets_culled, 0U);
+    EXPECT_LT(actual_stats.triangles_submitted, expected_stats.triangles_submitted);
+  }
+}
+
+TEST(Meshlet, draw_meshlets_culls_everything_off_screen)
+{
+  const auto sphere = make_sphere(8U, 16U);
+  const auto stream = make_stream(sphere.vertices);
+  const IndexBuffer indices{sphere.indices};
+  const auto mesh = build_meshlets(stream, indices);
+
+  PrimitiveIdProgram program;
+  program.set_mvp_matrix(make_mvp(50.0F));
+
+  FrameBuffer framebuffer{WIDTH, HEIGHT};
+  framebuffer.clear(Color{}, 1.0F);
+  RenderStats stats;
+  Pipeline pipeline;
+  pipeline.draw_meshlets(program, stream, mesh, make_state(CullMode::BACK), framebuffer, stats);
+
+  EXPECT_EQ(stats.meshlets_culled, mesh.meshlets.size());
+  EXPECT_EQ(stats.triangles_submitted, 0U);
+}
+
+} // namespace
+} // namespace rtw::sw_renderer
@@ -0,0 +1,103 @@
+#include "sw_renderer/programmable_pipeline/normal_buffer.h"
+
+#include "sw_renderer/programmable_pipeline/frame_buffer.h"
+
+#include "constants/math_constants.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+namespace sw = rtw::sw_renderer;
+
+/// Roughly uniform unit directions (a Fibonacci sphere), plus the axes and the octahedron's fold edges.
+std::vector<sw::Vector3F> directions()
+{
+  std::vector<sw::Vector3F> result{{1.0F, 0.0F, 0.0F},  {-1.0F, 0.0F, 0.0F}, {0.0F, 1.0F, 0.0F},
+                                   {0.0F, -1.0F, 0.0F}, {0.0F, 0.0F, 1.0F},  {0.0F, 0.0F, -1.0F},
+                                   {0.6F, 0.8F, 0.0F},  {-0.8F, 0.0F, -0.6F}};
+  constexpr std::size_t COUNT{2000U};
+  const auto golden_angle = rtw::math_constants::PI<float> * (3.0F - std::sqrt(5.0F));
+  for (std::size_t i = 0U; i < COUNT; ++i)
+  {
+    const auto y = 1.0F - ((2.0F * (static_cast<float>(i) + 0.5F)) / static_cast<float>(COUNT));
+    const auto ring = std::sqrt(1.0F - (y * y));
+    const auto phi = golden_angle * static_cast<float>(i);
+    result.emplace_back(ring * std::cos(phi), y, ring * std::sin(phi));
+  }
+  return result;
+}
+
+/// Largest angle between a direction and its round trip through @p encoding; from the chord length, which unlike the
+/// arc cosine stays accurate in float for tiny angles.
+float max_angle_degrees(const sw::NormalEncoding encoding)
+{
+  float max_angle = 0.0F;
+  for (const auto& normal : directions())
+  {
+    const auto decoded = sw::decode_normal(sw::encode_normal(normal, encoding), encoding);
+    const auto dx = normal.x() - decoded.x();
+    const auto dy = normal.y() - decoded.y();
+    const auto dz = normal.z() - decoded.z();
+    const auto chord = std::sqrt((dx * dx) + (dy * dy) + (dz * dz));
+    const auto angle = 2.0F * std::asin(std::min(chord * 0.5F, 1.0F));
+    max_angle = std::max(max_angle, angle * 180.0F / rtw::math_constants::PI<float>);
+  }
+  return max_angle;
+}
+
+} // namespace
+
+TEST(NormalEncoding, octahedral_round_trip_error_is_bounded)
+{
+  EXPECT_LT(max_angle_degrees(sw::NormalEncoding::OCTAHEDRAL_2X16), 0.01F);
+  EXPECT_LT(max_angle_degrees(sw::NormalEncoding::OCTAHEDRAL_2X8), 1.0F);
+}
+
+TEST(NormalEncoding, decoded_normals_are_unit_length)
+{
+  for (const auto encoding : {sw::NormalEncoding::OCTAHEDRAL_2X16, sw::NormalEncoding::OCTAHEDRAL_2X8})
+  {
+    for (const auto& normal : directions())
+    {
+      const auto decoded = sw::decode_normal(sw::encode_normal(normal, encoding), encoding);
+      EXPECT_NEAR((decoded.x() * decoded.x()) + (decoded.y() * decoded.y()) + (decoded.z() * decoded.z()), 1.0F,
+                  1.0e-5F);
+    }
+  }
+}
+
+TEST(NormalBuffer, stores_a_normal_per_pixel_in_its_encoding)
+{
+  sw::NormalBuffer compact{4U, 2U, sw::NormalEncoding::OCTAHEDRAL_2X8};
+  sw::NormalBuffer precise{4U, 2U, sw::NormalEncoding::OCTAHEDRAL_2X16};
+  EXPECT_EQ(compact.bytes_per_normal(), 2U);
+  EXPECT_EQ(precise.bytes_per_normal(), 4U);
+
+  const sw::Vector3F up{0.0F, 1.0F, 0.0F};
+  const sw::Vector3F back{0.0F, 0.0F, -1.0F};
+  for (auto* buffer : {&compact, &precise})
+  {
+    buffer->set_normal(3U, 1U, up);
+    buffer->set_normal(2U, 1U, back);
+    EXPECT_NEAR(buffer->normal(3U, 1U).y(), 1.0F, 1.0e-6F);
+    EXPECT_NEAR(buffer->normal(2U, 1U).z(), -1.0F, 1.0e-6F);
+  }
+}
+
+TEST(NormalBuffer, is_an_optional_frame_buffer_attachment)
+{
+  sw::FrameBuffer framebuffer{8U, 4U};
+  EXPECT_FALSE(framebuffer.has_normal_buffer());
+
+  framebuffer.attach_normal_buffer(sw::NormalEncoding::OCTAHEDRAL_2X8);
+  ASSERT_TRUE(framebuffer.has_normal_buffer());
+  EXPECT_EQ(framebuffer.normal_buffer().width(), 8U);
+  EXPECT_EQ(framebuffer.normal_buffer().height(), 4U);
+  EXPECT_EQ(framebuffer.normal_buffer().encoding(), sw::NormalEncoding::OCTAHEDRAL_2X8);
+}
@@ -123,6 +123,83 @@ TEST(PipelineRasterisation, fill_triangle_bbox_shared_edge_back_facing_single_co
   EXPECT_GT(total_coverage, 0);
 }
 
+TEST(PipelineRasterisation, fill_triangle_bbox_multisample_shared_edge_covers_each_sample_once)
+{
+  constexpr std::int32_t GRID = 64;
+  std::vector<std::uint32_t> coverage(static_cast<std::size_t>(GRID * GRID), 0U);
+  int overlaps = 0;
+
+  // A diagonal shared edge crosses pixels, so some of them are covered partially by both triangles.
+  const Vector4F tl{10.25F, 10.5F, 1.0F, 1.0F};
+  const Vector4F tr{30.5F, 10.5F, 1.0F, 1.0F};
+  const Vector4F br{30.5F, 29.5F, 1.0F, 1.0F};
+  const Vector4F bl{10.25F, 29.5F, 1.0F, 1.0F};
+
+  const RegisterFile<single_precision, 1U> varyings0;
+  const RegisterFile<single_precision, 1U> varyings1;
+  const RegisterFile<single_precision, 1U> varyings2;
+
+  int partial = 0;
+  const auto accumulate = [&](const Point2I& p, const RegisterFile<single_precision, 1U>&, single_precision window_z,
+                              single_precision, const std::uint32_t mask, const SampleDepths& depths)
+  {
+    ASSERT_NE(mask, 0U);
+    ASSERT_EQ(mask & ~MSAA_FULL_COVERAGE, 0U);
+    auto& pixel = coverage[static_cast<std::size_t>((p.y() * GRID) + p.x())];
+    overlaps += ((pixel & mask) != 0U) ? 1 : 0;
+    pixel |= mask;
+    partial += (mask != MSAA_FULL_COVERAGE) ? 1 : 0;
+    for (const auto depth : depths)
+    {
+      EXPECT_NEAR(depth, window_z, 1e-4F);
+    }
+  };
+
+  fill_triangle_bbox_multisample(tl, br, tr, varyings0, varyings1, varyings2, math::BoundingBoxI{0, 0, 1'023, 1'023},
+                                 accumulate);
+  fill_triangle_bbox_multisample(tl, bl, br, varyings0, varyings1, varyings2, math::BoundingBoxI{0, 0, 1'023, 1'023},
+                                 accumulate);
+
+  EXPECT_EQ(overlaps, 0);
+  EXPECT_GT(partial, 0);
+  // The interior of the quad is covered completely; a pixel on the diagonal gets samples from both triangles.
+  EXPECT_EQ(coverage[static_cast<std::size_t>((20 * GRID) + 15)], MSAA_FULL_COVERAGE);
+  EXPECT_EQ(coverage[static_cast<std::size_t>((20 * GRID) + 20)], MSAA_FULL_COVERAGE);
+  EXPECT_EQ(coverage[static_cast<std::size_t>((5 * GRID) + 5)], 0U);
+}
+
+TEST(PipelineRasterisation, fill_triangle_bbox_multisample_depth_per_sample)
+{
+  // Depth grows by 1 per pixel in x, so each sample's depth is offset from the centre by its x offset.
+  const Vector4F p0{0.0F, 0.0F, 0.0F, 1.0F};
+  const Vector4F p1{32.0F, 0.0F, 32.0F, 1.0F};
+  const Vector4F p2{0.0F, 32.0F, 0.0F, 1.0F};
+
+  const RegisterFile<single_precision, 1U> varyings0;
+  const RegisterFile<single_precision, 1U> varyings1;
+  const RegisterFile<single_precision, 1U> varyings2;
+
+  std::size_t pixel_count = 0U;
+  fill_triangle_bbox_multisample(
+      p0, p1, p2, varyings0, varyings1, varyings2, math::BoundingBoxI{0, 0, 1'023, 1'023},
+      [&pixel_count](const Point2I& p, const RegisterFile<single_precision, 1U>&, single_precision window_z,
+                     single_precision, const std::uint32_t mask, const SampleDepths& depths)
+      {
+        if (mask != MSAA_FULL_COVERAGE)
+        {
+          return;
+        }
+        ++pixel_count;
+        EXPECT_NEAR(window_z, static_cast<single_precision>(p.x()) + 0.5F, 1e-3F);
+        for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+        {
+          EXPECT_NEAR(depths[sample], static_cast<single_precision>(p.x()) + MSAA_SAMPLE_POSITIONS[sample][0U],
+                      1e-3F);
+        }
+      });
+  EXPECT_GT(pixel_count, 0U);
+}
+
 TEST(PipelineRasterisation, draw_line_varyings_covers_endpoints)
 {
   std::vector<Point2I> pixels;
@@ -84,6 +84,10 @@ TEST(PipelineState, defaults_follow_opengl)
   EXPECT_TRUE(STATE.color_mask.red);
   EXPECT_TRUE(STATE.color_mask.alpha);
   EXPECT_FALSE(STATE.scissor.enabled);
+
+  // Full-rate shading.
+  EXPECT_EQ(STATE.shading_rate, sw::ShadingRate::RATE_1X1);
+  EXPECT_EQ(STATE.shading_rate_image, nullptr);
 }
 
 TEST(PipelineState, fields_are_mutable)
@@ -131,3 +135,30 @@ TEST(PipelineState, enums_use_uint8_underlying_type)
   EXPECT_EQ(reversed_z.depth_range.z_far, sw::single_precision{0});
   EXPECT_EQ(reversed_z.depth_func, sw::DepthFunc::GREATER);
 }
+
+TEST(ShadingRate, block_extents)
+{
+  EXPECT_EQ(sw::shading_rate_width(sw::ShadingRate::RATE_1X1), 1);
+  EXPECT_EQ(sw::shading_rate_height(sw::ShadingRate::RATE_1X1), 1);
+  EXPECT_EQ(sw::shading_rate_width(sw::ShadingRate::RATE_2X1), 2);
+  EXPECT_EQ(sw::shading_rate_height(sw::ShadingRate::RATE_2X1), 1);
+  EXPECT_EQ(sw::shading_rate_width(sw::ShadingRate::RATE_2X2), 2);
+  EXPECT_EQ(sw::shading_rate_height(sw::ShadingRate::RATE_2X2), 2);
+  EXPECT_EQ(sw::shading_rate_width(sw::ShadingRate::RATE_4X4), 4);
+  EXPECT_EQ(sw::shading_rate_height(sw::ShadingRate::RATE_4X4), 4);
+}
+
+TEST(ShadingRateImage, looks_up_the_rate_of_the_pixel_tile)
+{
+  sw::ShadingRateImage image{40U, 20U, 16U, sw::ShadingRate::RATE_2X2};
+  EXPECT_EQ(image.tile_size(), 16U);
+  EXPECT_EQ(image.tiles_x(), 3U);
+  EXPECT_EQ(image.tiles_y(), 2U);
+
+  image.set_tile_rate(1U, 1U, sw::ShadingRate::RATE_1X1);
+  EXPECT_EQ(image.tile_rate(1U, 1U), sw::ShadingRate::RATE_1X1);
+  EXPECT_EQ(image.rate(0, 0), sw::ShadingRate::RATE_2X2);
+  EXPECT_EQ(image.rate(16, 16), sw::ShadingRate::RATE_1X1);
+  EXPECT_EQ(image.rate(31, 19), sw::ShadingRate::RATE_1X1);
+  EXPECT_EQ(image.rate(32, 19), sw::ShadingRate::RATE_2X2);
+}
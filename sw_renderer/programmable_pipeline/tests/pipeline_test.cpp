@@ -2,8 +2,10 @@
 
 #include "sw_renderer/color.h"
 #include "sw_renderer/programmable_pipeline/frame_buffer.h"
+#include "sw_renderer/programmable_pipeline/occlusion_query.h"
 #include "sw_renderer/programmable_pipeline/pipeline_state.h"
 #include "sw_renderer/programmable_pipeline/shader.h"
+#include "sw_renderer/programmable_pipeline/shading_rate.h"
 #include "sw_renderer/programmable_pipeline/vertex_layout.h"
 #include "sw_renderer/programmable_pipeline/vertex_stream.h"
 #include "sw_renderer/render_stats.h"
@@ -16,6 +18,8 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <map>
+#include <utility>
 #include <vector>
 
 namespace rtw::sw_renderer
@@ -86,6 +90,13 @@ std::vector<Vertex> inside_triangle(const float z = 0.0F)
   return {make_vertex(-0.5F, -0.5F, z, RED), make_vertex(0.5F, -0.5F, z, RED), make_vertex(0.0F, 0.5F, z, RED)};
 }
 
+/// A counter-clockwise triangle inside the frustum whose edges and depth slope across the pixel grid.
+std::vector<Vertex> sloped_triangle()
+{
+  return {make_vertex(-0.9F, -0.8F, -0.5F, RED), make_vertex(0.7F, -0.6F, 0.3F, RED),
+          make_vertex(-0.3F, 0.9F, 0.8F, RED)};
+}
+
 /// A triangle entirely behind the near plane (NDC z < -1): the clipper rejects it completely.
 std::vector<Vertex> behind_near_triangle()
 {
@@ -189,6 +200,64 @@ public:
   }
 };
 
+/// A shader whose colour encodes the window position it was invoked at, so a broadcast output is recognisable.
+class FragCoordProgram : public IShaderProgram
+{
+public:
+  VertexShaderOutput vertex(const AttributeView& input, const VertexContext& /*context*/) const override
+  {
+    VertexShaderOutput out;
+    out.position = input.attribute(POSITION_LOCATION);
+    return out;
+  }
+
+  FragmentShaderOutput fragment(const DynamicVaryings& /*varyings*/, const FragmentContext& context) const override
+  {
+    FragmentShaderOutput out;
+    out.color = Vector4F{context.frag_coord.x() / 8.0F, context.frag_coord.y() / 8.0F, 0.0F, 1.0F};
+    return out;
+  }
+};
+
+/// Renders `sloped_triangle()` into a cleared framebuffer.
+FrameBuffer render_sloped_triangle(const IShaderProgram& program, const PipelineState& state, RenderStats& stats)
+{
+  FrameBuffer framebuffer{WIDTH, HEIGHT};
+  framebuffer.clear(Color{}, 1.0F);
+  const auto vertices = sloped_triangle();
+  Pipeline pipeline;
+  pipeline.draw_arrays(program, make_stream(vertices), state, framebuffer, stats);
+  return framebuffer;
+}
+
+/// Checks that every covered pixel of @p coarse holds the colour @p full_rate has at the first covered pixel (in
+/// scan order) of its shading block, and that uncovered pixels stay clear.
+/// @return The number of blocks with coverage, i.e. the expected fragment shader invocations.
+template <typename RateAtT>
+std::size_t expect_broadcast_per_block(const FrameBuffer& full_rate, const FrameBuffer& coarse, const RateAtT& rate_at)
+{
+  std::map<std::pair<std::int32_t, std::int32_t>, Color> shaded_blocks;
+  for (std::int32_t y = 0; y < static_cast<std::int32_t>(HEIGHT); ++y)
+  {
+    for (std::int32_t x = 0; x < static_cast<std::int32_t>(WIDTH); ++x)
+    {
+      const auto px = static_cast<std::size_t>(x);
+      const auto py = static_cast<std::size_t>(y);
+      if (full_rate.color_buffer().pixel(px, py) == Color{})
+      {
+        EXPECT_EQ(coarse.color_buffer().pixel(px, py), Color{}) << x << ", " << y;
+        continue;
+      }
+      const auto rate = rate_at(x, y);
+      const std::pair<std::int32_t, std::int32_t> block{x & ~(shading_rate_width(rate) - 1),
+                                                        y & ~(shading_rate_height(rate) - 1)};
+      const auto shaded = shaded_blocks.emplace(block, full_rate.color_buffer().pixel(px, py)).first->second;
+      EXPECT_EQ(coarse.color_buffer().pixel(px, py), shaded) << x << ", " << y;
+    }
+  }
+  return shaded_blocks.size();
+}
+
 // --- Tests ------------------------------------------------------------------
 
 TEST(Pipeline, draw_arrays_fills_color_and_depth)
@@ -211,6 +280,7 @@ TEST(Pipeline, draw_arrays_fills_color_and_depth)
   EXPECT_EQ(stats.triangles_submitted, 1U);
   EXPECT_GE(stats.triangles_rendered, 1U);
   EXPECT_EQ(stats.triangles_clipped, 0U);
+  EXPECT_EQ(stats.fragments_shaded, (WIDTH - 1U) * (HEIGHT - 1U));
 }
 
 TEST(Pipeline, varying_is_interpolated_across_the_triangle)
@@ -284,6 +354,141 @@ TEST(Pipeline, farther_fragment_fails_depth_test)
   EXPECT_FLOAT_EQ(framebuffer.depth_buffer().depth(4U, 4U), 0.25F);
 }
 
+TEST(Pipeline, depth_test_uses_unorm_formats)
+{
+  for (const auto format : {DepthFormat::D16_UNORM, DepthFormat::D24_UNORM})
+  {
+    FrameBuffer framebuffer{WIDTH, HEIGHT, format};
+    framebuffer.clear(Color{}, 1.0F);
+
+    Pipeline pipeline;
+    RenderStats stats;
+    const auto state = make_state();
+
+    // Near, far, near again at the same depth: the far fragment fails LESS, and so does the repeated near one,
+    // whose quantised depth equals the stored integer.
+    const ConstantColorProgram near_program{GREEN};
+    const auto near_vertices = full_screen_triangle(GREEN, -0.5F);
+    const auto near_stream = make_stream(near_vertices);
+    pipeline.draw_arrays(near_program, near_stream, state, framebuffer, stats);
+
+    const ConstantColorProgram far_program{RED};
+    const auto far_vertices = full_screen_triangle(RED, 0.5F);
+    const auto far_stream = make_stream(far_vertices);
+    pipeline.draw_arrays(far_program, far_stream, state, framebuffer, stats);
+
+    const ConstantColorProgram same_program{BLUE};
+    pipeline.draw_arrays(same_program, near_stream, state, framebuffer, stats);
+
+    EXPECT_EQ(framebuffer.color_buffer().pixel(4U, 4U), Color{GREEN});
+    EXPECT_EQ(framebuffer.depth_buffer().depth_unorm(4U, 4U), framebuffer.depth_buffer().encode(0.25F));
+  }
+}
+
+TEST(Pipeline, reversed_z_keeps_the_nearer_fragment)
+{
+  for (const auto format : {DepthFormat::D32F, DepthFormat::D16_UNORM})
+  {
+    FrameBuffer framebuffer{WIDTH, HEIGHT, format};
+    framebuffer.clear(Color{}, 0.0F);
+
+    auto state = make_state();
+    state.depth_range = DepthRange::reversed();
+    state.depth_func = DepthFunc::GREATER;
+    ASSERT_TRUE(state.depth_range.is_reversed());
+
+    Pipeline pipeline;
+    RenderStats stats;
+    const ConstantColorProgram near_program{GREEN};
+    const auto near_vertices = full_screen_triangle(GREEN, -0.5F);
+    const auto near_stream = make_stream(near_vertices);
+    const ConstantColorProgram far_program{RED};
+    const auto far_vertices = full_screen_triangle(RED, 0.5F);
+    const auto far_stream = make_stream(far_vertices);
+    pipeline.draw_arrays(far_program, far_stream, state, framebuffer, stats);
+    pipeline.draw_arrays(near_program, near_stream, state, framebuffer, stats);
+    pipeline.draw_arrays(far_program, far_stream, state, framebuffer, stats);
+
+    // NDC z -0.5 lands on window z 0.75 with the ends swapped.
+    EXPECT_EQ(framebuffer.color_buffer().pixel(4U, 4U), Color{GREEN});
+    EXPECT_NEAR(static_cast<float>(framebuffer.depth_buffer().depth(4U, 4U)), 0.75F, 1.0e-4F);
+  }
+}
+
+TEST(Pipeline, multisampling_matches_single_sampling_without_edges)
+{
+  // The full-screen triangle covers every sample of the pixels it covers, so the fragment shader runs at the same
+  // pixel centres and the resolved image equals the single-sampled one.
+  const VaryingColorProgram program;
+  const auto vertices = full_screen_triangle_rgb();
+  const auto stream = make_stream(vertices);
+  Pipeline pipeline;
+  RenderStats stats;
+
+  FrameBuffer single{WIDTH, HEIGHT};
+  single.clear(Color{}, 1.0F);
+  pipeline.draw_arrays(program, stream, make_state(), single, stats);
+
+  FrameBuffer multi{WIDTH, HEIGHT, DepthFormat::D32F, SampleCount::X4};
+  multi.clear(Color{}, 1.0F);
+  pipeline.draw_arrays(program, stream, make_state(), multi, stats);
+  multi.resolve();
+
+  for (std::size_t y = 0U; y < HEIGHT; ++y)
+  {
+    for (std::size_t x = 0U; x < WIDTH; ++x)
+    {
+      EXPECT_FALSE(multi.is_expanded(x, y));
+      EXPECT_EQ(multi.color_buffer().pixel(x, y), single.color_buffer().pixel(x, y)) << x << ", " << y;
+    }
+  }
+}
+
+TEST(Pipeline, multisampling_antialiases_edges_and_tests_depth_per_sample)
+{
+  FrameBuffer framebuffer{WIDTH, HEIGHT, DepthFormat::D32F, SampleCount::X4};
+  framebuffer.clear(Color{0x00'00'00'FFU}, 1.0F);
+
+  Pipeline pipeline;
+  RenderStats stats;
+  const auto state = make_state();
+
+  const ConstantColorProgram near_program{RED};
+  const auto near_vertices = inside_triangle(-0.5F);
+  const auto near_stream = make_stream(near_vertices);
+  pipeline.draw_arrays(near_program, near_stream, state, framebuffer, stats);
+
+  // A farther full-screen triangle only reaches the samples the near triangle left uncovered.
+  const ConstantColorProgram far_program{GREEN};
+  const auto far_vertices = full_screen_triangle(GREEN, 0.5F);
+  const auto far_stream = make_stream(far_vertices);
+  pipeline.draw_arrays(far_program, far_stream, state, framebuffer, stats);
+  framebuffer.resolve();
+
+  std::size_t edge_pixels = 0U;
+  for (std::size_t y = 0U; y < HEIGHT; ++y)
+  {
+    for (std::size_t x = 0U; x < WIDTH; ++x)
+    {
+      const auto pixel = framebuffer.color_buffer().pixel(x, y);
+      if (framebuffer.is_expanded(x, y))
+      {
+        ++edge_pixels;
+        EXPECT_GT(pixel.r(), 0U);
+        EXPECT_GT(pixel.g(), 0U);
+        EXPECT_EQ(pixel.b(), 0U);
+      }
+    }
+  }
+  EXPECT_GT(edge_pixels, 0U);
+  EXPECT_EQ(framebuffer.color_buffer().pixel(3U, 4U), Color{RED});
+  EXPECT_EQ(framebuffer.color_buffer().pixel(0U, 0U), Color{GREEN});
+  for (std::uint32_t sample = 0U; sample < MSAA_SAMPLE_COUNT; ++sample)
+  {
+    EXPECT_FLOAT_EQ(framebuffer.depth_buffer().depth(framebuffer.depth_column(3U, sample), 4U), 0.25F);
+  }
+}
+
 TEST(Pipeline, depth_write_can_be_disabled)
 {
   FrameBuffer framebuffer{WIDTH, HEIGHT};
@@ -325,6 +530,64 @@ TEST(Pipeline, scissor_rejects_fragments_outside_the_rectangle)
   EXPECT_EQ(framebuffer.color_buffer().pixel(5U, 5U), Color{});    // covered, but scissored out
 }
 
+TEST(Pipeline, coarse_shading_broadcasts_one_invocation_per_block)
+{
+  const FragCoordProgram program;
+  RenderStats full_rate_stats;
+  const auto full_rate = render_sloped_triangle(program, make_state(), full_rate_stats);
+
+  for (const auto rate : {ShadingRate::RATE_2X1, ShadingRate::RATE_2X2, ShadingRate::RATE_4X4})
+  {
+    auto state = make_state();
+    state.shading_rate = rate;
+    RenderStats stats;
+    const auto coarse = render_sloped_triangle(program, state, stats);
+    EXPECT_EQ(stats.fragments_shaded,
+              expect_broadcast_per_block(full_rate, coarse, [rate](std::int32_t, std::int32_t) { return rate; }));
+    EXPECT_LT(stats.fragments_shaded, full_rate_stats.fragments_shaded);
+  }
+}
+
+TEST(Pipeline, coarse_shading_keeps_coverage_and_depth_per_pixel)
+{
+  // Coverage and depth must match the full-rate render.
+  const ConstantColorProgram program{RED};
+  RenderStats stats;
+  const auto full_rate = render_sloped_triangle(program, make_state(), stats);
+  auto state = make_state();
+  state.shading_rate = ShadingRate::RATE_4X4;
+  const auto coarse = render_sloped_triangle(program, state, stats);
+  for (std::size_t y = 0U; y < HEIGHT; ++y)
+  {
+    for (std::size_t x = 0U; x < WIDTH; ++x)
+    {
+      EXPECT_EQ(coarse.color_buffer().pixel(x, y), full_rate.color_buffer().pixel(x, y)) << x << ", " << y;
+      EXPECT_EQ(coarse.depth_buffer().depth(x, y), full_rate.depth_buffer().depth(x, y)) << x << ", " << y;
+    }
+  }
+}
+
+TEST(Pipeline, shading_rate_image_selects_the_rate_per_tile)
+{
+  const FragCoordProgram program;
+  RenderStats full_rate_stats;
+  const auto full_rate = render_sloped_triangle(program, make_state(), full_rate_stats);
+
+  ShadingRateImage image{WIDTH, HEIGHT, 4U};
+  image.set_tile_rate(1U, 0U, ShadingRate::RATE_4X4);
+  image.set_tile_rate(0U, 1U, ShadingRate::RATE_2X1);
+  auto state = make_state();
+  state.shading_rate = ShadingRate::RATE_2X2; // overridden by the image
+  state.shading_rate_image = &image;
+  RenderStats stats;
+  const auto coarse = render_sloped_triangle(program, state, stats);
+
+  EXPECT_EQ(stats.fragments_shaded,
+            expect_broadcast_per_block(full_rate, coarse,
+                                       [&image](const std::int32_t x, const std::int32_t y) { return image.rate(x, y); }));
+  EXPECT_LT(stats.fragments_shaded, full_rate_stats.fragments_shaded);
+}
+
 TEST(Pipeline, color_mask_disables_channel_writes)
 {
   FrameBuffer framebuffer{WIDTH, HEIGHT};
@@ -414,6 +677,113 @@ TEST(Pipeline, discarded_fragments_leave_the_framebuffer_untouched)
   EXPECT_GE(stats.triangles_rendered, 1U);                         // but the triangle was rasterised
 }
 
+TEST(Pipeline, occlusion_query_counts_samples_passing_scissor_and_depth)
+{
+  FrameBuffer framebuffer{WIDTH, HEIGHT};
+  framebuffer.clear(Color{}, 1.0F);
+
+  Pipeline pipeline;
+  RenderStats stats;
+  const ConstantColorProgram program{RED};
+  const auto occluder_vertices = full_screen_triangle(RED, 0.0F);
+  const auto occluder = make_stream(occluder_vertices);
+  pipeline.draw_arrays(program, occluder, make_state(), framebuffer, stats);
+
+  // A bounding-box style proxy: no colour or depth writes, only the count.
+  auto proxy_state = make_state();
+  proxy_state.color_mask = ColorMask{false, false, false, false};
+  proxy_state.depth_write_enabled = false;
+
+  OcclusionQuery hidden;
+  const auto behind_vertices = full_screen_triangle(GREEN, 0.5F);
+  const auto behind = make_stream(behind_vertices);
+  pipeline.begin_query(hidden);
+  pipeline.draw_arrays(program, behind, proxy_state, framebuffer, stats);
+  pipeline.end_query();
+  EXPECT_TRUE(hidden.result_available);
+  EXPECT_EQ(hidden.samples_passed, 0U);
+  EXPECT_FALSE(hidden.any_samples_passed());
+
+  OcclusionQuery visible;
+  const auto in_front_vertices = full_screen_triangle(GREEN, -0.5F);
+  const auto in_front = make_stream(in_front_vertices);
+  proxy_state.scissor = Scissor{0, 0, 4, 4, true};
+  pipeline.begin_query(visible);
+  pipeline.draw_arrays(program, in_front, proxy_state, framebuffer, stats);
+  pipeline.end_query();
+  EXPECT_EQ(visible.samples_passed, 16U);
+
+  // The proxy draws wrote neither colour nor depth.
+  EXPECT_EQ(framebuffer.color_buffer().pixel(2U, 2U), Color{RED});
+  EXPECT_FLOAT_EQ(framebuffer.depth_buffer().depth(2U, 2U), 0.5F);
+}
+
+TEST(Pipeline, occlusion_query_excludes_discarded_fragments_and_counts_msaa_samples)
+{
+  const auto vertices = full_screen_triangle(WHITE);
+  const auto stream = make_stream(vertices);
+  RenderStats stats;
+  Pipeline pipeline;
+
+  FrameBuffer framebuffer{WIDTH, HEIGHT};
+  framebuffer.clear(Color{}, 1.0F);
+  OcclusionQuery discarded;
+  pipeline.begin_query(discarded);
+  pipeline.draw_arrays(DiscardProgram{}, stream, make_state(), framebuffer, stats);
+  pipeline.end_query();
+  EXPECT_EQ(discarded.samples_passed, 0U);
+
+  FrameBuffer multisampled{WIDTH, HEIGHT, DepthFormat::D32F, SampleCount::X4};
+  multisampled.clear(Color{}, 1.0F);
+  OcclusionQuery samples;
+  pipeline.begin_query(samples);
+  pipeline.draw_arrays(ConstantColorProgram{RED}, stream, make_state(), multisampled, stats);
+  pipeline.end_query();
+  EXPECT_EQ(samples.samples_passed, (WIDTH - 1U) * (HEIGHT - 1U) * MSAA_SAMPLE_COUNT);
+}
+
+TEST(Pipeline, conditional_render_skips_draws_after_a_query_without_samples)
+{
+  FrameBuffer framebuffer{WIDTH, HEIGHT};
+  framebuffer.clear(Color{}, 0.0F); // everything fails LESS
+
+  Pipeline pipeline;
+  RenderStats stats;
+  const ConstantColorProgram program{RED};
+  const auto vertices = full_screen_triangle(RED);
+  const auto stream = make_stream(vertices);
+
+  OcclusionQuery query;
+  pipeline.begin_query(query);
+  pipeline.draw_arrays(program, stream, make_state(), framebuffer, stats);
+  pipeline.end_query();
+  ASSERT_EQ(query.samples_passed, 0U);
+
+  stats.reset();
+  auto always = make_state();
+  always.depth_func = DepthFunc::ALWAYS;
+  const IndexBuffer indices{std::vector<std::uint32_t>{0U, 1U, 2U}};
+  pipeline.begin_conditional_render(query);
+  pipeline.draw_arrays(program, stream, always, framebuffer, stats);
+  pipeline.draw_elements(program, stream, indices, always, framebuffer, stats);
+  pipeline.end_conditional_render();
+  EXPECT_EQ(stats.draws_skipped, 2U);
+  EXPECT_EQ(stats.triangles_submitted, 0U);
+  EXPECT_EQ(framebuffer.color_buffer().pixel(4U, 4U), Color{});
+
+  // A query without a result does not skip, and neither does one with samples.
+  for (const auto& condition : {OcclusionQuery{}, OcclusionQuery{1U, true}})
+  {
+    stats.reset();
+    pipeline.begin_conditional_render(condition);
+    pipeline.draw_arrays(program, stream, always, framebuffer, stats);
+    pipeline.end_conditional_render();
+    EXPECT_EQ(stats.draws_skipped, 0U);
+    EXPECT_EQ(stats.triangles_submitted, 1U);
+  }
+  EXPECT_EQ(framebuffer.color_buffer().pixel(4U, 4U), Color{RED});
+}
+
 TEST(Pipeline, inside_triangle_produces_exact_stats)
 {
   FrameBuffer framebuffer{WIDTH, HEIGHT};
@@ -12,6 +12,10 @@ struct RenderStats
   std::size_t triangles_clipped{0};   ///< Triangles fully outside frustum
   std::size_t triangles_culled{0};    ///< Triangles removed by face culling
   std::size_t triangles_rendered{0};  ///< Triangles actually drawn
+  std::size_t meshlets_submitted{0};  ///< Meshlets passed to Pipeline::draw_meshlets
+  std::size_t meshlets_culled{0};     ///< Meshlets rejected by the frustum/cone pre-pass
+  std::size_t fragments_shaded{0};    ///< Fragment shader invocations (programmable pipeline)
+  std::size_t draws_skipped{0};       ///< Draws skipped by conditional rendering (programmable pipeline)
 
   void reset() noexcept
   {
@@ -19,6 +23,10 @@ struct RenderStats
     triangles_clipped = 0;
     triangles_culled = 0;
     triangles_rendered = 0;
+    meshlets_submitted = 0;
+    meshlets_culled = 0;
+    fragments_shaded = 0;
+    draws_skipped = 0;
   }
 };
 
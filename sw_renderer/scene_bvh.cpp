@@ -0,0 +1,320 @@
+#include "sw_renderer/scene_bvh.h"
+
+#include "math/bounding_box_operations.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace rtw::sw_renderer
+{
+
+namespace
+{
+
+bool same_bounds(const BoundingBox3F& lhs, const BoundingBox3F& rhs) noexcept
+{
+  for (std::uint16_t i = 0U; i < 3U; ++i)
+  {
+    if ((lhs.min[i] != rhs.min[i]) || (lhs.max[i] != rhs.max[i]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct Bin
+{
+  BoundingBox3F bounds;
+  std::uint32_t count{0U};
+};
+
+struct Split
+{
+  std::uint16_t axis{0U};
+  std::uint32_t bin{0U}; ///< Objects in bins [0, bin] go left.
+  single_precision cost{std::numeric_limits<single_precision>::max()};
+};
+
+} // namespace
+
+void SceneBvh::build(const std::vector<BoundingBox3F>& local_bounds, const std::vector<Matrix4x4F>& transforms)
+{
+  const auto count = local_bounds.size();
+  local_bounds_ = local_bounds;
+  world_bounds_.resize(count);
+  for (std::size_t i = 0U; i < count; ++i)
+  {
+    world_bounds_[i] = math::transform(transforms[i], local_bounds[i]);
+  }
+
+  objects_.resize(count);
+  std::iota(objects_.begin(), objects_.end(), ObjectId{0U});
+  object_leaf_.assign(count, 0U);
+  dirty_leaves_.clear();
+  nodes_.clear();
+  if (count == 0U)
+  {
+    return;
+  }
+  nodes_.reserve(2U * ((count / MAX_LEAF_SIZE) + 1U));
+
+  std::vector<Point3F> centroids(count);
+  for (std::size_t i = 0U; i < count; ++i)
+  {
+    centroids[i] = math::center(world_bounds_[i]);
+  }
+
+  nodes_.push_back(Node{BoundingBox3F{}, 0U, static_cast<std::uint32_t>(count), NO_PARENT});
+  update_leaf_bounds(nodes_.front());
+  subdivide(0U, centroids);
+}
+
+void SceneBvh::subdivide(const std::uint32_t node_index, const std::vector<Point3F>& centroids)
+{
+  std::vector<std::uint32_t> pending{node_index};
+  while (!pending.empty())
+  {
+    const auto index = pending.back();
+    pending.pop_back();
+
+    const auto first = nodes_[index].first;
+    const auto count = nodes_[index].count;
+    if (count <= MAX_LEAF_SIZE)
+    {
+      for (std::uint32_t i = first; i < first + count; ++i)
+      {
+        object_leaf_[objects_[i]] = index;
+      }
+      continue;
+    }
+
+    // Bins are laid over the centroid bounds (not the object bounds), so every bin can receive objects.
+    auto centroid_min = centroids[objects_[first]];
+    auto centroid_max = centroid_min;
+    for (std::uint32_t i = first + 1U; i < first + count; ++i)
+    {
+      const auto& c = centroids[objects_[i]];
+      for (std::uint16_t axis = 0U; axis < 3U; ++axis)
+      {
+        centroid_min[axis] = std::min(centroid_min[axis], c[axis]);
+        centroid_max[axis] = std::max(centroid_max[axis], c[axis]);
+      }
+    }
+
+    const auto bin_of = [&](const Point3F& c, const std::uint16_t axis)
+    {
+      const auto scale = static_cast<single_precision>(BIN_COUNT) / (centroid_max[axis] - centroid_min[axis]);
+      const auto bin = static_cast<std::uint32_t>((c[axis] - centroid_min[axis]) * scale);
+      return std::min(bin, BIN_COUNT - 1U);
+    };
+
+    Split best;
+    for (std::uint16_t axis = 0U; axis < 3U; ++axis)
+    {
+      if (centroid_max[axis] <= centroid_min[axis])
+      {
+        continue;
+      }
+
+      std::array<Bin, BIN_COUNT> bins{};
+      for (std::uint32_t i = first; i < first + count; ++i)
+      {
+        const auto object = objects_[i];
+        auto& bin = bins[bin_of(centroids[object], axis)]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        bin.bounds = (bin.count == 0U) ? world_bounds_[object] : math::merge(bin.bounds, world_bounds_[object]);
+        ++bin.count;
+      }
+
+      // Sweep from the right to get the cost of every right-hand side, then from the left to combine.
+      std::array<single_precision, BIN_COUNT> right_cost{};
+      BoundingBox3F right_bounds;
+      std::uint32_t right_count = 0U;
+      for (std::uint32_t b = BIN_COUNT - 1U; b > 0U; --b)
+      {
+        const auto& bin = bins[b]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        if (bin.count > 0U)
+        {
+          right_bounds = (right_count == 0U) ? bin.bounds : math::merge(right_bounds, bin.bounds);
+          right_count += bin.count;
+        }
+        const auto cost = math::surface_area(right_bounds) * static_cast<single_precision>(right_count);
+        right_cost[b - 1U] = cost; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+      }
+
+      BoundingBox3F left_bounds;
+      std::uint32_t left_count = 0U;
+      for (std::uint32_t b = 0U; (b + 1U) < BIN_COUNT; ++b)
+      {
+        const auto& bin = bins[b]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        if (bin.count > 0U)
+        {
+          left_bounds = (left_count == 0U) ? bin.bounds : math::merge(left_bounds, bin.bounds);
+          left_count += bin.count;
+        }
+        if ((left_count == 0U) || (left_count == count))
+        {
+          continue;
+        }
+        const auto cost = (math::surface_area(left_bounds) * static_cast<single_precision>(left_count))
+                        + right_cost[b]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        if (cost < best.cost)
+        {
+          best = Split{axis, b, cost};
+        }
+      }
+    }
+
+    std::uint32_t middle = 0U;
+    const auto begin = objects_.begin() + first;
+    const auto end = begin + count;
+    if (best.cost < std::numeric_limits<single_precision>::max())
+    {
+      const auto split = std::partition(begin, end, [&](const ObjectId object)
+                                        { return bin_of(centroids[object], best.axis) <= best.bin; });
+      middle = static_cast<std::uint32_t>(split - objects_.begin());
+    }
+    else
+    {
+      // All centroids coincide: no plane separates them, so split the range in half.
+      middle = first + (count / 2U);
+    }
+
+    const auto left = static_cast<std::uint32_t>(nodes_.size());
+    nodes_[index].first = left;
+    nodes_[index].count = 0U;
+    nodes_.push_back(Node{BoundingBox3F{}, first, middle - first, index});
+    nodes_.push_back(Node{BoundingBox3F{}, middle, first + count - middle, index});
+    update_leaf_bounds(nodes_[left]);
+    update_leaf_bounds(nodes_[left + 1U]);
+    pending.push_back(left + 1U);
+    pending.push_back(left);
+  }
+}
+
+void SceneBvh::update_leaf_bounds(Node& node) const
+{
+  node.bounds = world_bounds_[objects_[node.first]];
+  for (std::uint32_t i = node.first + 1U; i < node.first + node.count; ++i)
+  {
+    node.bounds = math::merge(node.bounds, world_bounds_[objects_[i]]);
+  }
+}
+
+void SceneBvh::set_transform(const ObjectId id, const Matrix4x4F& transform)
+{
+  world_bounds_[id] = math::transform(transform, local_bounds_[id]);
+  dirty_leaves_.push_back(object_leaf_[id]);
+}
+
+void SceneBvh::refit()
+{
+  if (dirty_leaves_.empty())
+  {
+    return;
+  }
+
+  // When a large part of the scene moved, walking every dirty path costs more than one sweep over all nodes.
+  if ((dirty_leaves_.size() * 4U) > nodes_.size())
+  {
+    for (auto i = nodes_.size(); i-- > 0U;)
+    {
+      auto& node = nodes_[i];
+      if (node.count > 0U)
+      {
+        update_leaf_bounds(node);
+      }
+      else
+      {
+        node.bounds = math::merge(nodes_[node.first].bounds, nodes_[node.first + 1U].bounds);
+      }
+    }
+    dirty_leaves_.clear();
+    return;
+  }
+
+  for (const auto leaf : dirty_leaves_)
+  {
+    update_leaf_bounds(nodes_[leaf]);
+    // Stop as soon as an ancestor's box does not change: everything above it is still consistent.
+    for (auto parent = nodes_[leaf].parent; parent != NO_PARENT; parent = nodes_[parent].parent)
+    {
+      auto& node = nodes_[parent];
+      const auto merged = math::merge(nodes_[node.first].bounds, nodes_[node.first + 1U].bounds);
+      if (same_bounds(merged, node.bounds))
+      {
+        break;
+      }
+      node.bounds = merged;
+    }
+  }
+  dirty_leaves_.clear();
+}
+
+void SceneBvh::query(const Frustum3F& frustum, const Point3F& eye, std::vector<ObjectId>& visible) const
+{
+  visible.clear();
+  if (nodes_.empty())
+  {
+    return;
+  }
+
+  // `inside` marks subtrees whose box is fully inside the frustum: their descendants need no further plane tests.
+  std::vector<std::pair<std::uint32_t, bool>> stack;
+  stack.reserve(64U);
+  stack.emplace_back(0U, false);
+  while (!stack.empty())
+  {
+    const auto [index, parent_inside] = stack.back();
+    stack.pop_back();
+
+    const auto& node = nodes_[index];
+    auto inside = parent_inside;
+    if (!inside)
+    {
+      const auto containment = math::classify(frustum, node.bounds);
+      if (containment == math::Containment::OUTSIDE)
+      {
+        continue;
+      }
+      inside = (containment == math::Containment::INSIDE);
+    }
+
+    if (node.count > 0U)
+    {
+      for (std::uint32_t i = node.first; i < node.first + node.count; ++i)
+      {
+        const auto object = objects_[i];
+        if (inside || (math::classify(frustum, world_bounds_[object]) != math::Containment::OUTSIDE))
+        {
+          visible.push_back(object);
+        }
+      }
+      continue;
+    }
+
+    // Visit the nearer child first, so the result is already close to sorted.
+    const auto left = node.first;
+    const auto right = node.first + 1U;
+    const bool left_first =
+        math::distance_squared(eye, nodes_[left].bounds) <= math::distance_squared(eye, nodes_[right].bounds);
+    stack.emplace_back(left_first ? right : left, inside);
+    stack.emplace_back(left_first ? left : right, inside);
+  }
+
+  std::vector<std::pair<single_precision, ObjectId>> keyed(visible.size());
+  for (std::size_t i = 0U; i < visible.size(); ++i)
+  {
+    keyed[i] = {math::distance_squared(eye, world_bounds_[visible[i]]), visible[i]};
+  }
+  std::sort(keyed.begin(), keyed.end());
+  for (std::size_t i = 0U; i < visible.size(); ++i)
+  {
+    visible[i] = keyed[i].second;
+  }
+}
+
+} // namespace rtw::sw_renderer
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "sw_renderer/precision.h"
+#include "sw_renderer/types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+
+/// A bounding volume hierarchy over the world-space boxes of scene objects, used to frustum-cull whole groups of
+/// objects at once.
+///
+/// Objects are identified by their index in the arrays passed to `build()`. Each object contributes its local
+/// (model-space) box transformed by its model matrix (see `math::transform3` for building those matrices); the
+/// world box is the axis-aligned box enclosing the transformed local box.
+///
+/// The tree is built top-down with a binned surface area heuristic over the box centroids. Nodes live in one
+/// array; the two children of an interior node are adjacent and always stored after their parent, so a reverse
+/// sweep over the array visits children before parents.
+///
+/// Moving objects does not rebuild the tree: `set_transform()` updates the object's world box and records its
+/// leaf, and `refit()` then grows or shrinks the boxes on the path to the root. The topology is kept, so query
+/// cost slowly degrades if objects travel far; call `build()` again in that case.
+class SceneBvh
+{
+public:
+  using ObjectId = std::uint32_t;
+
+  /// Maximum number of objects stored in one leaf.
+  static constexpr std::uint32_t MAX_LEAF_SIZE{4U};
+  /// Number of centroid bins evaluated per axis when searching for the SAH split.
+  static constexpr std::uint32_t BIN_COUNT{16U};
+
+  /// Builds the hierarchy from scratch.
+  /// @param[in] local_bounds The model-space box of every object.
+  /// @param[in] transforms The model matrix of every object; must have the same size as @p local_bounds.
+  void build(const std::vector<BoundingBox3F>& local_bounds, const std::vector<Matrix4x4F>& transforms);
+
+  /// Updates the model matrix of an object. The hierarchy is out of date until `refit()` is called.
+  /// @param[in] id The object.
+  /// @param[in] transform The new model matrix.
+  void set_transform(ObjectId id, const Matrix4x4F& transform);
+
+  /// Recomputes the boxes of all nodes above objects changed since the last build or refit.
+  void refit();
+
+  /// Collects the objects whose world boxes intersect the frustum, sorted front to back, i.e. by increasing
+  /// distance from @p eye to the closest point of their world box.
+  /// @param[in] frustum The view frustum in world space, plane normals pointing inwards.
+  /// @param[in] eye The camera position in world space.
+  /// @param[out] visible Cleared, then filled with the visible objects.
+  void query(const Frustum3F& frustum, const Point3F& eye, std::vector<ObjectId>& visible) const;
+
+  std::size_t object_count() const noexcept { return local_bounds_.size(); }
+  std::size_t node_count() const noexcept { return nodes_.size(); }
+
+  const BoundingBox3F& world_bounds(const ObjectId id) const { return world_bounds_[id]; }
+  /// The box of the root node, i.e. of the whole scene. Undefined for an empty hierarchy.
+  const BoundingBox3F& bounds() const { return nodes_.front().bounds; }
+
+private:
+  static constexpr std::uint32_t NO_PARENT{0xFFFF'FFFFU};
+
+  struct Node
+  {
+    BoundingBox3F bounds;
+    std::uint32_t first{0U};  ///< Interior: index of the left child (right child is first + 1). Leaf: first slot.
+    std::uint32_t count{0U};  ///< Number of objects in a leaf, 0 for interior nodes.
+    std::uint32_t parent{NO_PARENT};
+  };
+
+  void subdivide(std::uint32_t node_index, const std::vector<Point3F>& centroids);
+  void update_leaf_bounds(Node& node) const;
+
+  std::vector<Node> nodes_;
+  std::vector<ObjectId> objects_;          ///< Object ids in leaf order; leaves reference ranges of this array.
+  std::vector<std::uint32_t> object_leaf_; ///< Leaf node holding each object.
+  std::vector<BoundingBox3F> local_bounds_;
+  std::vector<BoundingBox3F> world_bounds_;
+  std::vector<std::uint32_t> dirty_leaves_;
+};
+
+} // namespace rtw::sw_renderer
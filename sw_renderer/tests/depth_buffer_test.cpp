@@ -99,5 +99,41 @@ TEST(DepthBuffer, corner_pixels)
   EXPECT_EQ(buffer.depth(99, 79), 0.4F);
 }
 
+TEST(DepthBuffer, unorm_formats_quantise_and_clamp)
+{
+  DepthBuffer d16{10, 10, DepthFormat::D16_UNORM};
+  DepthBuffer d24{10, 10, DepthFormat::D24_UNORM};
+  EXPECT_EQ(d16.bytes_per_depth(), 2U);
+  EXPECT_EQ(d24.bytes_per_depth(), 4U);
+
+  // The default clear to max() clamps to the farthest representable depth.
+  EXPECT_EQ(d16.depth_unorm(3, 3), 0xFF'FFU);
+  EXPECT_EQ(d24.depth_unorm(3, 3), 0xFF'FF'FFU);
+  EXPECT_EQ(d16.depth(3, 3), 1.0F);
+
+  EXPECT_EQ(d16.encode(0.0F), 0U);
+  EXPECT_EQ(d16.encode(-1.0F), 0U);
+  EXPECT_EQ(d16.encode(0.5F), 0x80'00U);
+  EXPECT_EQ(d24.encode(0.5F), 0x80'00'00U);
+  EXPECT_EQ(d24.encode(2.0F), 0xFF'FF'FFU);
+
+  d16.set_depth(5, 5, 0.25F);
+  d24.set_depth(5, 5, 0.25F);
+  EXPECT_NEAR(d16.depth(5, 5), 0.25F, 1.0F / 65535.0F);
+  EXPECT_NEAR(d24.depth(5, 5), 0.25F, 1.0F / 16777215.0F);
+
+  d16.clear(0.0F);
+  EXPECT_EQ(d16.depth_unorm(5, 5), 0U);
+}
+
+TEST(DepthBuffer, unorm_precision_per_format)
+{
+  // Two depths 1e-6 apart: too close for 16 bits, distinct in 24 bits.
+  const DepthBuffer d16{1, 1, DepthFormat::D16_UNORM};
+  const DepthBuffer d24{1, 1, DepthFormat::D24_UNORM};
+  EXPECT_EQ(d16.encode(0.25F), d16.encode(0.250001F));
+  EXPECT_LT(d24.encode(0.25F), d24.encode(0.250001F));
+}
+
 } // namespace
 } // namespace rtw::sw_renderer
@@ -0,0 +1,207 @@
+#include "sw_renderer/image_io.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+namespace
+{
+
+TEST(ImageIo, write_ppm_emits_header_and_rgb_triplets)
+{
+  ColorBuffer buffer{2U, 1U};
+  buffer.set_pixel(0U, 0U, Color{0x10'20'30'FFU});
+  buffer.set_pixel(1U, 0U, Color{0xA0'B0'C0'00U});
+
+  std::ostringstream stream;
+  write_ppm(stream, buffer);
+
+  const std::string expected_header{"P6\n2 1\n255\n"};
+  const auto output = stream.str();
+  ASSERT_EQ(output.size(), expected_header.size() + 6U);
+  EXPECT_EQ(output.substr(0U, expected_header.size()), expected_header);
+  EXPECT_EQ(output.substr(expected_header.size()), (std::string{"\x10\x20\x30\xA0\xB0\xC0"}));
+}
+
+TEST(ImageIo, read_ppm_round_trips_rgb)
+{
+  ColorBuffer buffer{3U, 2U};
+  buffer.clear(Color{0x11'22'33'FFU});
+  buffer.set_pixel(2U, 1U, Color{0xFE'01'80'FFU});
+
+  std::stringstream stream;
+  write_ppm(stream, buffer);
+  const auto image = read_ppm(stream);
+
+  ASSERT_TRUE(image.has_value());
+  EXPECT_EQ(image->width(), 3U);
+  EXPECT_EQ(image->height(), 2U);
+  EXPECT_EQ(image->pixel(0U, 0U).rgba, 0x11'22'33'FFU);
+  EXPECT_EQ(image->pixel(2U, 1U).rgba, 0xFE'01'80'FFU);
+}
+
+TEST(ImageIo, read_ppm_skips_header_comments)
+{
+  std::stringstream stream{std::string{"P6\n# made by hand\n1 1\n255\n\x01\x02\x03"}};
+  const auto image = read_ppm(stream);
+  ASSERT_TRUE(image.has_value());
+  EXPECT_EQ(image->pixel(0U, 0U).rgba, 0x01'02'03'FFU);
+}
+
+TEST(ImageIo, read_ppm_rejects_unsupported_input)
+{
+  std::stringstream ascii{std::string{"P3\n1 1\n255\n1 2 3\n"}};
+  EXPECT_FALSE(read_ppm(ascii).has_value());
+
+  std::stringstream sixteen_bit{std::string{"P6\n1 1\n65535\n\x00\x01\x00\x02\x00\x03"}};
+  EXPECT_FALSE(read_ppm(sixteen_bit).has_value());
+
+  std::stringstream truncated{std::string{"P6\n2 2\n255\n\x01\x02\x03"}};
+  EXPECT_FALSE(read_ppm(truncated).has_value());
+}
+
+TEST(ImageIo, decode_ppm_matches_read_ppm)
+{
+  ColorBuffer buffer{3U, 2U};
+  buffer.clear(Color{0x11'22'33'FFU});
+  buffer.set_pixel(2U, 1U, Color{0xFE'01'80'FFU});
+  std::stringstream stream;
+  write_ppm(stream, buffer);
+  const auto text = stream.str();
+  const std::vector<std::uint8_t> bytes(text.begin(), text.end());
+
+  const auto image = decode_ppm(stl::make_span(bytes));
+  ASSERT_TRUE(image.has_value());
+  EXPECT_EQ(image->width, 3U);
+  EXPECT_EQ(image->height, 2U);
+  ASSERT_EQ(image->texels.size(), 6U);
+  EXPECT_EQ(image->texels[0U], 0x11'22'33'FFU);
+  EXPECT_EQ(image->texels[5U], 0xFE'01'80'FFU);
+
+  const std::vector<std::uint8_t> truncated(bytes.begin(), bytes.end() - 1);
+  EXPECT_FALSE(decode_ppm(stl::make_span(truncated)).has_value());
+}
+
+TEST(ImageIo, decode_ppm_rejects_empty_and_oversized_images)
+{
+  for (const std::string header : {"P6 0 4 255\n", "P6 4 0 255\n", "P6 100000 100000 255\n"})
+  {
+    const std::vector<std::uint8_t> bytes(header.begin(), header.end());
+    EXPECT_FALSE(decode_ppm(stl::make_span(bytes)).has_value()) << header;
+    EXPECT_FALSE(decode_image(stl::make_span(bytes)).has_value()) << header;
+  }
+}
+
+TEST(ImageIo, encode_qoi_follows_the_specification)
+{
+  // Header, an RGB chunk, a small difference (red down one, blue up one), a run of one and the end marker.
+  const Image image{3U, 1U, {0x80'40'20'FFU, 0x7F'40'21'FFU, 0x7F'40'21'FFU}};
+  std::vector<std::uint8_t> expected{'q', 'o', 'i', 'f', 0U, 0U, 0U, 3U, 0U, 0U, 0U, 1U, 4U, 0U};
+  expected.insert(expected.end(), {0xFEU, 0x80U, 0x40U, 0x20U, 0x5BU, 0xC0U});
+  expected.insert(expected.end(), {0U, 0U, 0U, 0U, 0U, 0U, 0U, 1U});
+  EXPECT_EQ(encode_qoi(image), expected);
+}
+
+TEST(ImageIo, qoi_round_trips_every_chunk_type)
+{
+  // Runs, small and luma-sized differences, a repeat of an earlier colour and alpha changes.
+  Image image{5U, 4U, {}};
+  image.texels = {0x00'00'00'FFU, 0x00'00'00'FFU, 0x01'00'FF'FFU, 0x11'1A'0C'FFU, 0x80'40'20'FFU,
+                  0x80'40'20'10U, 0x00'00'00'FFU, 0x01'00'FF'FFU, 0xFF'FF'FF'FFU, 0xFF'FF'FF'FFU,
+                  0xFF'FF'FF'FFU, 0xFF'FF'FF'FFU, 0x00'00'00'00U, 0x12'34'56'78U, 0x13'35'57'78U,
+                  0x9A'BC'DE'F0U, 0x9A'BC'DE'F0U, 0x00'00'00'FFU, 0x20'30'40'FFU, 0x20'30'40'FFU};
+  const auto bytes = encode_qoi(image);
+  const auto decoded = decode_qoi(stl::make_span(bytes));
+  ASSERT_TRUE(decoded.has_value());
+  EXPECT_EQ(decoded->width, 5U);
+  EXPECT_EQ(decoded->height, 4U);
+  EXPECT_EQ(decoded->texels, image.texels);
+
+  // A run longer than one chunk holds.
+  const Image flat{100U, 1U, std::vector<std::uint32_t>(100U, 0x40'40'40'FFU)};
+  const auto flat_bytes = encode_qoi(flat);
+  EXPECT_EQ(decode_qoi(stl::make_span(flat_bytes))->texels, flat.texels);
+}
+
+TEST(ImageIo, decode_qoi_rejects_malformed_input)
+{
+  const Image image{4U, 4U, std::vector<std::uint32_t>(16U, 0x12'34'56'FFU)};
+  auto bytes = encode_qoi(image);
+
+  const std::vector<std::uint8_t> truncated(bytes.begin(), bytes.begin() + 16);
+  EXPECT_FALSE(decode_qoi(stl::make_span(truncated)).has_value());
+
+  auto bad_channels = bytes;
+  bad_channels[12U] = 2U;
+  EXPECT_FALSE(decode_qoi(stl::make_span(bad_channels)).has_value());
+
+  auto bad_magic = bytes;
+  bad_magic[0U] = 'x';
+  EXPECT_FALSE(decode_qoi(stl::make_span(bad_magic)).has_value());
+}
+
+TEST(ImageIo, decode_image_picks_the_decoder_by_magic)
+{
+  const Image image{1U, 1U, {0x01'02'03'04U}};
+  const auto qoi = encode_qoi(image);
+  EXPECT_EQ(decode_image(stl::make_span(qoi))->texels, image.texels);
+
+  const std::string ppm_text{"P6\n1 1\n255\n\x01\x02\x03"};
+  const std::vector<std::uint8_t> ppm(ppm_text.begin(), ppm_text.end());
+  EXPECT_EQ(decode_image(stl::make_span(ppm))->texels, (std::vector<std::uint32_t>{0x01'02'03'FFU}));
+
+  const std::vector<std::uint8_t> png{0x89U, 'P', 'N', 'G', '\r', '\n', 0x1AU, '\n'};
+  EXPECT_FALSE(decode_image(stl::make_span(png)).has_value());
+}
+
+TEST(ImageIo, compare_counts_pixels_beyond_tolerance_and_ignores_alpha)
+{
+  ColorBuffer a{4U, 1U};
+  ColorBuffer b{4U, 1U};
+  a.clear(Color{0x80'80'80'FFU});
+  b.clear(Color{0x80'80'80'00U});
+  EXPECT_EQ(compare(a, b).differing_pixels, 0U);
+
+  b.set_pixel(1U, 0U, Color{0x82'80'80'00U});
+  b.set_pixel(3U, 0U, Color{0x80'80'70'00U});
+
+  const auto exact = compare(a, b);
+  EXPECT_EQ(exact.differing_pixels, 2U);
+  EXPECT_EQ(exact.max_channel_delta, 0x10U);
+
+  const auto tolerant = compare(a, b, 2U);
+  EXPECT_EQ(tolerant.differing_pixels, 1U);
+  EXPECT_EQ(tolerant.max_channel_delta, 0x10U);
+}
+
+TEST(ImageIo, checksum_is_deterministic_and_content_sensitive)
+{
+  ColorBuffer a{4U, 4U};
+  ColorBuffer b{4U, 4U};
+  a.clear(Color{0x80'80'80'FFU});
+  b.clear(Color{0x80'80'80'FFU});
+  EXPECT_EQ(checksum(a), checksum(b));
+  EXPECT_NE(checksum(a), CHECKSUM_SEED);
+
+  b.set_pixel(3U, 3U, Color{0x80'80'81'FFU});
+  EXPECT_NE(checksum(a), checksum(b));
+
+  // Chaining: hashing two frames differs from hashing one frame twice with the default seed.
+  EXPECT_EQ(checksum(b, checksum(a)), checksum(b, checksum(a)));
+  EXPECT_NE(checksum(b, checksum(a)), checksum(b));
+}
+
+TEST(ImageIo, checksum_of_empty_buffer_is_the_seed)
+{
+  const ColorBuffer buffer{0U, 0U};
+  EXPECT_EQ(checksum(buffer), CHECKSUM_SEED);
+  EXPECT_EQ(checksum(buffer, 42U), 42U);
+}
+
+} // namespace
+} // namespace rtw::sw_renderer
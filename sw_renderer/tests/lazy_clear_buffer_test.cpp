@@ -0,0 +1,102 @@
+#include "sw_renderer/color_buffer.h"
+#include "sw_renderer/depth_buffer.h"
+#include "sw_renderer/lazy_clear_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+namespace
+{
+
+// 40 x 20 elements: 3 x 2 tiles, the right column and bottom row of tiles are partial.
+constexpr std::size_t WIDTH{40U};
+constexpr std::size_t HEIGHT{20U};
+
+TEST(LazyClearBuffer, construction_is_materialised)
+{
+  const LazyClearBuffer<std::uint32_t> buffer{WIDTH, HEIGHT, 7U};
+  EXPECT_EQ(buffer.tiles_x(), 3U);
+  EXPECT_EQ(buffer.tiles_y(), 2U);
+  EXPECT_EQ(buffer.cleared_tile_count(), 0U);
+  EXPECT_EQ(buffer.load(39U, 19U), 7U);
+}
+
+TEST(LazyClearBuffer, clear_is_deferred_until_store)
+{
+  LazyClearBuffer<std::uint32_t> buffer{WIDTH, HEIGHT, 0U};
+  buffer.store(1U, 1U, 5U);
+  buffer.clear(9U);
+
+  EXPECT_EQ(buffer.cleared_tile_count(), 6U);
+  EXPECT_TRUE(buffer.is_cleared(1U, 1U));
+  EXPECT_EQ(buffer.load(1U, 1U), 9U);
+
+  buffer.store(2U, 3U, 4U);
+  EXPECT_FALSE(buffer.is_cleared(1U, 1U));
+  EXPECT_EQ(buffer.cleared_tile_count(), 5U);
+  EXPECT_EQ(buffer.load(2U, 3U), 4U);
+  // The rest of the materialised tile holds the clear value, not the value stored before the clear.
+  EXPECT_EQ(buffer.load(1U, 1U), 9U);
+  EXPECT_EQ(buffer.load(15U, 15U), 9U);
+}
+
+TEST(LazyClearBuffer, data_resolves_every_pending_tile)
+{
+  LazyClearBuffer<std::uint32_t> buffer{WIDTH, HEIGHT, 0U};
+  buffer.clear(0xABU);
+  buffer.store(20U, 17U, 1U); // Middle tile of the (partial) bottom row.
+
+  const auto* const data = buffer.data();
+  EXPECT_EQ(buffer.cleared_tile_count(), 0U);
+
+  const std::vector<std::uint32_t> elements(data, data + (WIDTH * HEIGHT));
+  for (std::size_t y = 0U; y < HEIGHT; ++y)
+  {
+    for (std::size_t x = 0U; x < WIDTH; ++x)
+    {
+      EXPECT_EQ(elements[(y * WIDTH) + x], ((x == 20U) && (y == 17U)) ? 1U : 0xABU) << x << ", " << y;
+    }
+  }
+}
+
+TEST(LazyClearBuffer, stream_fill_handles_unaligned_ranges)
+{
+  std::vector<std::uint32_t> elements(37U, 0U);
+  details::stream_fill(elements.data() + 1U, 35U, 3U);
+  details::stream_fence();
+  EXPECT_EQ(elements.front(), 0U);
+  EXPECT_EQ(elements.back(), 0U);
+  for (std::size_t i = 1U; i < 36U; ++i)
+  {
+    EXPECT_EQ(elements[i], 3U);
+  }
+}
+
+TEST(LazyClearBuffer, color_and_depth_buffers_clear_lazily)
+{
+  ColorBuffer color{WIDTH, HEIGHT};
+  DepthBuffer depth{WIDTH, HEIGHT};
+  color.clear(Color{0x10'20'30'40U});
+  depth.clear(0.75F);
+
+  EXPECT_TRUE(color.is_cleared(39U, 0U));
+  EXPECT_TRUE(depth.is_cleared(39U, 0U));
+  EXPECT_EQ(color.pixel(39U, 0U).rgba, 0x10'20'30'40U);
+  EXPECT_EQ(depth.depth(39U, 0U), 0.75F);
+
+  color.set_pixel(39U, 0U, Color{0xFF'FF'FF'FFU});
+  depth.set_depth(39U, 0U, 0.5F);
+  EXPECT_FALSE(color.is_cleared(39U, 0U));
+  EXPECT_FALSE(depth.is_cleared(39U, 0U));
+  EXPECT_EQ(color.pixel(38U, 0U).rgba, 0x10'20'30'40U);
+  EXPECT_EQ(depth.depth(38U, 0U), 0.75F);
+  EXPECT_EQ(color.data()[39U], 0xFF'FF'FF'FFU);
+  EXPECT_EQ(color.data()[0U], 0x10'20'30'40U);
+}
+
+} // namespace
+} // namespace rtw::sw_renderer
@@ -0,0 +1,40 @@
+#include "sw_renderer/parallel.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+namespace
+{
+
+TEST(WorkerPool, runs_every_task_once)
+{
+  WorkerPool pool{4U};
+  EXPECT_EQ(pool.thread_count(), 4U);
+
+  // Runs reuse the same threads; a run may use fewer tasks than there are threads.
+  for (const std::size_t task_count : {4U, 1U, 3U, 4U, 2U})
+  {
+    std::vector<std::atomic<int>> runs(task_count);
+    pool.run(task_count, [&runs](const std::size_t task) { ++runs[task]; });
+    for (std::size_t task = 0U; task < task_count; ++task)
+    {
+      EXPECT_EQ(runs[task].load(), 1) << task_count << " tasks";
+    }
+  }
+}
+
+TEST(WorkerPool, single_thread_runs_on_the_caller)
+{
+  WorkerPool pool{1U};
+  bool ran = false;
+  pool.run(1U, [&ran](const std::size_t task) { ran = (task == 0U); });
+  EXPECT_TRUE(ran);
+}
+
+} // namespace
+} // namespace rtw::sw_renderer
@@ -0,0 +1,180 @@
+#include "sw_renderer/scene_bvh.h"
+
+#include "math/bounding_box_operations.h"
+#include "math/frustum.h"
+#include "math/matrix_operations.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+namespace
+{
+
+// --- Fixtures and helpers ---------------------------------------------------
+
+Matrix4x4F make_translation(const float x, const float y, const float z)
+{
+  auto matrix = Matrix4x4F::identity();
+  matrix(0U, 3U) = x;
+  matrix(1U, 3U) = y;
+  matrix(2U, 3U) = z;
+  return matrix;
+}
+
+struct Scene
+{
+  std::vector<BoundingBox3F> local_bounds;
+  std::vector<Matrix4x4F> transforms;
+};
+
+/// Unit-ish boxes scattered over a 200 x 200 x 200 cube around the origin.
+Scene make_scene(const std::size_t count, const std::uint32_t seed)
+{
+  std::mt19937 rng{seed};
+  std::uniform_real_distribution<float> position{-100.0F, 100.0F};
+  std::uniform_real_distribution<float> extent{0.1F, 2.0F};
+
+  Scene scene;
+  for (std::size_t i = 0U; i < count; ++i)
+  {
+    const auto half = extent(rng);
+    scene.local_bounds.push_back(BoundingBox3F{Point3F{-half, -half, -half}, Point3F{half, half, half}});
+    scene.transforms.push_back(make_translation(position(rng), position(rng), position(rng)));
+  }
+  return scene;
+}
+
+/// A camera at the origin looking down -Z.
+Frustum3F make_frustum()
+{
+  using namespace angle_literals;
+  const auto params = math::make_perspective_parameters(60.0_degF, 1.0F, 0.1F, 150.0F);
+  return math::extract_frustum(math::transpose(math::make_perspective_projection_matrix(params)));
+}
+
+std::vector<SceneBvh::ObjectId> brute_force(const SceneBvh& bvh, const Frustum3F& frustum)
+{
+  std::vector<SceneBvh::ObjectId> visible;
+  for (SceneBvh::ObjectId id = 0U; id < bvh.object_count(); ++id)
+  {
+    if (math::classify(frustum, bvh.world_bounds(id)) != math::Containment::OUTSIDE)
+    {
+      visible.push_back(id);
+    }
+  }
+  return visible;
+}
+
+void expect_query_matches_brute_force(const SceneBvh& bvh, const Frustum3F& frustum, const Point3F& eye)
+{
+  std::vector<SceneBvh::ObjectId> visible;
+  bvh.query(frustum, eye, visible);
+
+  for (std::size_t i = 1U; i < visible.size(); ++i)
+  {
+    EXPECT_LE(math::distance_squared(eye, bvh.world_bounds(visible[i - 1U])),
+              math::distance_squared(eye, bvh.world_bounds(visible[i])));
+  }
+
+  std::sort(visible.begin(), visible.end());
+  EXPECT_EQ(visible, brute_force(bvh, frustum));
+}
+
+void expect_root_encloses_objects(const SceneBvh& bvh)
+{
+  const auto& root = bvh.bounds();
+  for (SceneBvh::ObjectId id = 0U; id < bvh.object_count(); ++id)
+  {
+    EXPECT_EQ(math::merge(root, bvh.world_bounds(id)).min, root.min);
+    EXPECT_EQ(math::merge(root, bvh.world_bounds(id)).max, root.max);
+  }
+}
+
+// --- Tests ------------------------------------------------------------------
+
+TEST(SceneBvh, empty_scene)
+{
+  SceneBvh bvh;
+  bvh.build({}, {});
+  EXPECT_EQ(bvh.object_count(), 0U);
+  EXPECT_EQ(bvh.node_count(), 0U);
+
+  std::vector<SceneBvh::ObjectId> visible{1U, 2U};
+  bvh.query(make_frustum(), Point3F{0.0F, 0.0F, 0.0F}, visible);
+  EXPECT_TRUE(visible.empty());
+}
+
+TEST(SceneBvh, world_bounds_follow_transforms)
+{
+  SceneBvh bvh;
+  bvh.build({BoundingBox3F{Point3F{-1.0F, -1.0F, -1.0F}, Point3F{1.0F, 1.0F, 1.0F}}},
+            {make_translation(5.0F, 0.0F, -3.0F)});
+  EXPECT_EQ(bvh.world_bounds(0U).min, (Point3F{4.0F, -1.0F, -4.0F}));
+  EXPECT_EQ(bvh.world_bounds(0U).max, (Point3F{6.0F, 1.0F, -2.0F}));
+}
+
+TEST(SceneBvh, query_matches_brute_force_and_is_front_to_back)
+{
+  const auto scene = make_scene(2000U, 7U);
+  SceneBvh bvh;
+  bvh.build(scene.local_bounds, scene.transforms);
+
+  EXPECT_GT(bvh.node_count(), 1U);
+  expect_root_encloses_objects(bvh);
+  expect_query_matches_brute_force(bvh, make_frustum(), Point3F{0.0F, 0.0F, 0.0F});
+}
+
+TEST(SceneBvh, coincident_objects_are_split)
+{
+  const std::vector<BoundingBox3F> local(100U, BoundingBox3F{Point3F{-1.0F, -1.0F, -1.0F}, Point3F{1.0F, 1.0F, 1.0F}});
+  const std::vector<Matrix4x4F> transforms(100U, make_translation(0.0F, 0.0F, -10.0F));
+  SceneBvh bvh;
+  bvh.build(local, transforms);
+
+  std::vector<SceneBvh::ObjectId> visible;
+  bvh.query(make_frustum(), Point3F{0.0F, 0.0F, 0.0F}, visible);
+  EXPECT_EQ(visible.size(), 100U);
+}
+
+TEST(SceneBvh, refit_tracks_few_moved_objects)
+{
+  auto scene = make_scene(2000U, 11U);
+  SceneBvh bvh;
+  bvh.build(scene.local_bounds, scene.transforms);
+
+  // Move a handful of objects from anywhere to right in front of the camera (incremental path).
+  for (SceneBvh::ObjectId id = 0U; id < 20U; ++id)
+  {
+    bvh.set_transform(id * 97U, make_translation(0.0F, 0.0F, -5.0F - static_cast<float>(id)));
+  }
+  bvh.refit();
+
+  expect_root_encloses_objects(bvh);
+  expect_query_matches_brute_force(bvh, make_frustum(), Point3F{0.0F, 0.0F, 0.0F});
+}
+
+TEST(SceneBvh, refit_tracks_whole_scene_motion)
+{
+  auto scene = make_scene(2000U, 13U);
+  SceneBvh bvh;
+  bvh.build(scene.local_bounds, scene.transforms);
+
+  // Shift everything (full-sweep path): half of the scene now sits behind the camera.
+  for (SceneBvh::ObjectId id = 0U; id < bvh.object_count(); ++id)
+  {
+    bvh.set_transform(id, make_translation(0.0F, 0.0F, 60.0F) * scene.transforms[id]);
+  }
+  bvh.refit();
+
+  expect_root_encloses_objects(bvh);
+  expect_query_matches_brute_force(bvh, make_frustum(), Point3F{0.0F, 0.0F, 0.0F});
+}
+
+} // namespace
+} // namespace rtw::sw_renderer
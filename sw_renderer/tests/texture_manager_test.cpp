@@ -0,0 +1,162 @@
+#include "sw_renderer/texture_manager.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+namespace
+{
+
+Image make_image(const std::size_t width, const std::size_t height, const std::uint32_t rgba)
+{
+  return Image{width, height, std::vector<std::uint32_t>(width * height, rgba)};
+}
+
+/// Writes @p bytes to a file in the test's temporary directory and returns its path.
+std::filesystem::path write_file(const std::string& name, const std::vector<std::uint8_t>& bytes)
+{
+  const auto path = std::filesystem::path{testing::TempDir()} / name;
+  std::ofstream file{path, std::ios::binary};
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+  return path;
+}
+
+/// Bytes of a full mip chain of a square power-of-two image.
+constexpr std::size_t chain_bytes(const std::size_t size)
+{
+  return (size == 1U) ? 4U : ((size * size * 4U) + chain_bytes(size / 2U));
+}
+
+TEST(TextureManager, make_mip_chain_box_filters_down_to_one_texel)
+{
+  Image image{4U, 2U, {}};
+  image.texels = {0x00'00'00'FFU, 0x10'00'00'FFU, 0x20'00'00'FFU, 0x30'00'00'FFU,
+                  0x00'10'00'FFU, 0x10'10'00'FFU, 0x20'10'00'FFU, 0x30'10'00'FFU};
+  const auto* const data = image.texels.data();
+
+  const auto levels = make_mip_chain(std::move(image));
+  ASSERT_EQ(levels.size(), 3U);
+  EXPECT_EQ(levels[0U].data(), data); // adopted, not copied
+  EXPECT_EQ(levels[1U].width(), 2U);
+  EXPECT_EQ(levels[1U].height(), 1U);
+  EXPECT_EQ(levels[1U].texel(0U, 0U).rgba, 0x08'08'00'FFU);
+  EXPECT_EQ(levels[1U].texel(1U, 0U).rgba, 0x28'08'00'FFU);
+  EXPECT_EQ(levels[2U].width(), 1U);
+  EXPECT_EQ(levels[2U].texel(0U, 0U).rgba, 0x18'08'00'FFU);
+}
+
+TEST(TextureManager, make_mip_chain_averages_odd_sizes)
+{
+  const auto levels = make_mip_chain(make_image(3U, 1U, 0x30'60'90'FFU));
+  ASSERT_EQ(levels.size(), 2U);
+  EXPECT_EQ(levels[1U].width(), 1U);
+  EXPECT_EQ(levels[1U].texel(0U, 0U).rgba, 0x30'60'90'FFU);
+}
+
+TEST(TextureManager, loads_ppm_and_qoi_files_on_the_workers)
+{
+  const std::string ppm_text{"P6\n2 2\n255\n\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0A\x0B\x0C"};
+  const auto ppm = write_file("texture_manager_test.ppm", std::vector<std::uint8_t>(ppm_text.begin(), ppm_text.end()));
+  const auto qoi = write_file("texture_manager_test.qoi", encode_qoi(make_image(8U, 4U, 0x11'22'33'44U)));
+
+  TextureManager manager{TextureManagerConfig{2U, 0U, {}}};
+  const auto first = manager.load(ppm);
+  const auto second = manager.load(qoi);
+  manager.wait_idle();
+
+  ASSERT_EQ(manager.status(first), TextureStatus::RESIDENT);
+  ASSERT_EQ(manager.status(second), TextureStatus::RESIDENT);
+  EXPECT_EQ(manager.texture(first)->texel(1U, 1U).rgba, 0x0A'0B'0C'FFU);
+  EXPECT_EQ(manager.texture(second)->width(), 8U);
+  EXPECT_EQ(manager.level_count(second), 4U);
+  EXPECT_EQ(manager.resident_level_count(second), 4U);
+  EXPECT_GT(manager.load_latency(first).count(), 0);
+  EXPECT_EQ(manager.stats().loads_completed, 2U);
+  EXPECT_GE(manager.stats().max_load_latency, manager.load_latency(second));
+  EXPECT_EQ(manager.stats().resident_bytes, (16U + 4U) + ((32U + 8U + 2U + 1U) * 4U));
+}
+
+TEST(TextureManager, reports_failures_and_uses_the_fallback_decoder)
+{
+  const auto unknown = write_file("texture_manager_test.bin", {0x89U, 'P', 'N', 'G'});
+
+  TextureManager plain{TextureManagerConfig{1U, 0U, {}}};
+  const auto missing = plain.load(std::filesystem::path{testing::TempDir()} / "does_not_exist.qoi");
+  const auto undecodable = plain.load(unknown);
+  plain.wait_idle();
+  EXPECT_EQ(plain.status(missing), TextureStatus::FAILED);
+  EXPECT_EQ(plain.status(undecodable), TextureStatus::FAILED);
+  EXPECT_EQ(plain.texture(undecodable), nullptr);
+  EXPECT_EQ(plain.stats().loads_failed, 2U);
+
+  const auto fallback = [](const std::filesystem::path&) { return std::optional<Image>{make_image(2U, 2U, 0xABU)}; };
+  TextureManager with_fallback{TextureManagerConfig{1U, 0U, fallback}};
+  const auto decoded = with_fallback.load(unknown);
+  with_fallback.wait_idle();
+  ASSERT_EQ(with_fallback.status(decoded), TextureStatus::RESIDENT);
+  EXPECT_EQ(with_fallback.texture(decoded)->texel(0U, 0U).rgba, 0xABU);
+}
+
+TEST(TextureManager, evicts_the_finest_levels_of_the_least_recently_used_textures)
+{
+  TextureManager manager{TextureManagerConfig{1U, chain_bytes(16U) + chain_bytes(8U), {}}};
+  const auto other = manager.adopt(make_image(16U, 16U, 0x30'30'30'FFU));
+  const auto stale = manager.adopt(make_image(8U, 8U, 0x20'20'20'FFU));
+  manager.texture(stale);
+  manager.update();
+  EXPECT_EQ(manager.stats().levels_evicted, 0U);
+
+  const auto recent = manager.adopt(make_image(16U, 16U, 0x10'10'10'FFU));
+  EXPECT_EQ(manager.stats().resident_bytes, (2U * chain_bytes(16U)) + chain_bytes(8U));
+  manager.texture(recent);
+  manager.update();
+
+  // `other` was never used and goes down to 1x1 first, then `stale` loses its 8x8 level.
+  EXPECT_EQ(manager.resident_level_count(recent), 5U);
+  EXPECT_EQ(manager.resident_level_count(stale), 3U);
+  EXPECT_EQ(manager.resident_level_count(other), 1U);
+  EXPECT_EQ(manager.texture(stale)->width(), 4U);
+  EXPECT_EQ(manager.texture(other)->width(), 1U);
+  EXPECT_EQ(manager.texture(other)->texel(0U, 0U).rgba, 0x30'30'30'FFU);
+  EXPECT_LE(manager.stats().resident_bytes, manager.config().budget_bytes);
+  EXPECT_EQ(manager.stats().levels_evicted, 4U + 1U);
+}
+
+TEST(TextureManager, restores_evicted_levels_of_used_textures_that_fit)
+{
+  const auto first_path = write_file("texture_manager_restore_0.qoi", encode_qoi(make_image(16U, 16U, 0x40U)));
+  const auto second_path = write_file("texture_manager_restore_1.qoi", encode_qoi(make_image(16U, 16U, 0x80U)));
+
+  TextureManager manager{TextureManagerConfig{1U, chain_bytes(16U) + chain_bytes(4U), {}}};
+  const auto first = manager.load(first_path);
+  const auto second = manager.load(second_path);
+  manager.wait_idle();
+  ASSERT_LT(manager.resident_level_count(first), 5U); // neither was used yet, so the first is evicted first
+
+  // Using only `first` makes it the working set, which fits at full resolution: it is decoded again and `second`
+  // makes room.
+  manager.texture(first);
+  manager.update();
+  EXPECT_EQ(manager.stats().reloads, 1U);
+  manager.wait_idle();
+  EXPECT_EQ(manager.resident_level_count(first), 5U);
+  EXPECT_EQ(manager.texture(first)->width(), 16U);
+  EXPECT_EQ(manager.resident_level_count(second), 3U);
+  EXPECT_LE(manager.stats().resident_bytes, manager.config().budget_bytes);
+
+  // Both together do not fit, so using both restores nothing.
+  manager.texture(first);
+  manager.texture(second);
+  manager.update();
+  EXPECT_EQ(manager.stats().reloads, 1U);
+}
+
+} // namespace
+} // namespace rtw::sw_renderer
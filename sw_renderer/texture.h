@@ -3,6 +3,9 @@
 #include "sw_renderer/color.h"
 
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 namespace rtw::sw_renderer
@@ -25,12 +28,20 @@ public:
         width_(width), height_(height), pitch_(width * bytes_per_pixel_)
   {
   }
+  /// Adopts @p texels (width * height RGBA8888 values in the layout above) without copying them.
+  Texture(std::vector<std::uint32_t>&& texels, const std::size_t width, const std::size_t height)
+      : buffer_(std::move(texels)), width_(width), height_(height), pitch_(width * bytes_per_pixel_)
+  {
+    assert(buffer_.size() == (width * height) && "texel count must match the size");
+  }
 
   std::size_t width() const { return width_; }
   std::size_t height() const { return height_; }
   std::size_t size() const { return buffer_.size(); }
   std::size_t bytes_per_pixel() const { return bytes_per_pixel_; }
   std::size_t pitch() const { return pitch_; }
+  std::size_t size_bytes() const { return buffer_.size() * bytes_per_pixel_; }
+  const std::uint32_t* data() const { return buffer_.data(); }
 
   Color texel(const std::size_t x, const std::size_t y) const
   {
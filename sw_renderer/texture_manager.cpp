@@ -0,0 +1,307 @@
+#include "sw_renderer/texture_manager.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <numeric>
+
+namespace rtw::sw_renderer
+{
+
+std::vector<Texture> make_mip_chain(Image image)
+{
+  std::vector<Texture> levels;
+  while ((image.width > 1U) || (image.height > 1U))
+  {
+    const auto width = std::max<std::size_t>(image.width / 2U, 1U);
+    const auto height = std::max<std::size_t>(image.height / 2U, 1U);
+    Image next{width, height, std::vector<std::uint32_t>(width * height)};
+    for (std::size_t y = 0U; y < height; ++y)
+    {
+      const auto y_begin = (y * image.height) / height;
+      const auto y_end = ((y + 1U) * image.height) / height;
+      for (std::size_t x = 0U; x < width; ++x)
+      {
+        const auto x_begin = (x * image.width) / width;
+        const auto x_end = ((x + 1U) * image.width) / width;
+        std::array<std::uint32_t, 4U> sums{};
+        for (auto source_y = y_begin; source_y < y_end; ++source_y)
+        {
+          for (auto source_x = x_begin; source_x < x_end; ++source_x)
+          {
+            const auto texel = image.texels[(source_y * image.width) + source_x];
+            sums[0U] += texel >> 24U;
+            sums[1U] += (texel >> 16U) & 0xFFU;
+            sums[2U] += (texel >> 8U) & 0xFFU;
+            sums[3U] += texel & 0xFFU;
+          }
+        }
+        const auto count = static_cast<std::uint32_t>((y_end - y_begin) * (x_end - x_begin));
+        std::uint32_t packed = 0U;
+        for (const auto sum : sums)
+        {
+          packed = (packed << 8U) | ((sum + (count / 2U)) / count);
+        }
+        next.texels[(y * width) + x] = packed;
+      }
+    }
+    levels.emplace_back(std::move(image.texels), image.width, image.height);
+    image = std::move(next);
+  }
+  levels.emplace_back(std::move(image.texels), image.width, image.height);
+  return levels;
+}
+
+TextureManager::TextureManager(Config config) : config_{std::move(config)}
+{
+  const auto thread_count = std::max<std::size_t>(config_.thread_count, 1U);
+  workers_.reserve(thread_count);
+  for (std::size_t i = 0U; i < thread_count; ++i)
+  {
+    workers_.emplace_back([this] { work(); });
+  }
+}
+
+TextureManager::~TextureManager()
+{
+  {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    stopping_ = true;
+  }
+  work_condition_.notify_all();
+  for (auto& worker : workers_)
+  {
+    worker.join();
+  }
+}
+
+TextureHandle TextureManager::load(const std::filesystem::path& path)
+{
+  const auto handle = static_cast<TextureHandle>(entries_.size());
+  Entry entry;
+  entry.path = path;
+  entry.requested = std::chrono::steady_clock::now();
+  entries_.push_back(std::move(entry));
+  queue(handle);
+  return handle;
+}
+
+TextureHandle TextureManager::adopt(Image image)
+{
+  const auto handle = static_cast<TextureHandle>(entries_.size());
+  Entry entry;
+  entry.status = TextureStatus::RESIDENT;
+  entry.levels = make_mip_chain(std::move(image));
+  entry.full_bytes = resident_bytes(entry);
+  stats_.resident_bytes += entry.full_bytes;
+  ++stats_.loads_completed;
+  entries_.push_back(std::move(entry));
+  return handle;
+}
+
+void TextureManager::update()
+{
+  restore_used_textures();
+
+  std::vector<Result> results;
+  {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    results.swap(results_);
+  }
+  for (auto& result : results)
+  {
+    integrate(result);
+  }
+
+  enforce_budget();
+  ++frame_;
+}
+
+void TextureManager::wait_idle()
+{
+  {
+    std::unique_lock<std::mutex> lock{mutex_};
+    idle_condition_.wait(lock, [this] { return jobs_.empty() && (busy_workers_ == 0U); });
+  }
+  update();
+}
+
+TextureStatus TextureManager::status(const TextureHandle handle) const
+{
+  assert(handle < entries_.size() && "unknown texture");
+  return entries_[handle].status;
+}
+
+const Texture* TextureManager::texture(const TextureHandle handle)
+{
+  assert(handle < entries_.size() && "unknown texture");
+  auto& entry = entries_[handle];
+  if (entry.status != TextureStatus::RESIDENT)
+  {
+    return nullptr;
+  }
+  entry.last_used = frame_;
+  return &entry.levels[entry.first_resident];
+}
+
+std::size_t TextureManager::level_count(const TextureHandle handle) const
+{
+  assert(handle < entries_.size() && "unknown texture");
+  return entries_[handle].levels.size();
+}
+
+std::size_t TextureManager::resident_level_count(const TextureHandle handle) const
+{
+  assert(handle < entries_.size() && "unknown texture");
+  const auto& entry = entries_[handle];
+  return entry.levels.size() - entry.first_resident;
+}
+
+std::chrono::steady_clock::duration TextureManager::load_latency(const TextureHandle handle) const
+{
+  assert(handle < entries_.size() && "unknown texture");
+  return entries_[handle].load_latency;
+}
+
+void TextureManager::work()
+{
+  while (true)
+  {
+    std::pair<TextureHandle, std::filesystem::path> job;
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      work_condition_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+      if (stopping_)
+      {
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+      ++busy_workers_;
+    }
+
+    Result result{job.first, std::nullopt};
+    const auto bytes = read_file(job.second);
+    auto image = bytes.has_value() ? decode_image(stl::make_span(*bytes)) : std::nullopt;
+    if (!image.has_value() && config_.fallback_decoder)
+    {
+      image = config_.fallback_decoder(job.second);
+    }
+    if (image.has_value())
+    {
+      result.levels = make_mip_chain(std::move(*image));
+    }
+
+    {
+      const std::lock_guard<std::mutex> lock{mutex_};
+      results_.push_back(std::move(result));
+      --busy_workers_;
+    }
+    idle_condition_.notify_all();
+  }
+}
+
+void TextureManager::queue(const TextureHandle handle)
+{
+  {
+    const std::lock_guard<std::mutex> lock{mutex_};
+    jobs_.emplace_back(handle, entries_[handle].path);
+  }
+  work_condition_.notify_one();
+}
+
+void TextureManager::integrate(Result& result)
+{
+  auto& entry = entries_[result.handle];
+  const bool reload = entry.reload_pending;
+  entry.reload_pending = false;
+  if (!result.levels.has_value())
+  {
+    if (!reload)
+    {
+      entry.status = TextureStatus::FAILED;
+      ++stats_.loads_failed;
+    }
+    return; // A failed reload keeps the levels that are still resident.
+  }
+
+  stats_.resident_bytes -= resident_bytes(entry);
+  entry.levels = std::move(*result.levels);
+  entry.first_resident = 0U;
+  entry.full_bytes = resident_bytes(entry);
+  stats_.resident_bytes += entry.full_bytes;
+  if (!reload)
+  {
+    entry.status = TextureStatus::RESIDENT;
+    entry.load_latency = std::chrono::steady_clock::now() - entry.requested;
+    stats_.total_load_latency += entry.load_latency;
+    stats_.max_load_latency = std::max(stats_.max_load_latency, entry.load_latency);
+    ++stats_.loads_completed;
+  }
+}
+
+void TextureManager::enforce_budget()
+{
+  if ((config_.budget_bytes == 0U) || (stats_.resident_bytes <= config_.budget_bytes))
+  {
+    return;
+  }
+
+  std::vector<TextureHandle> order(entries_.size());
+  std::iota(order.begin(), order.end(), TextureHandle{0U});
+  std::stable_sort(order.begin(), order.end(),
+                   [this](const TextureHandle lhs, const TextureHandle rhs)
+                   { return entries_[lhs].last_used < entries_[rhs].last_used; });
+  for (const auto handle : order)
+  {
+    auto& entry = entries_[handle];
+    while ((stats_.resident_bytes > config_.budget_bytes) && ((entry.first_resident + 1U) < entry.levels.size()))
+    {
+      auto& level = entry.levels[entry.first_resident];
+      stats_.resident_bytes -= level.size_bytes();
+      level = Texture{};
+      ++entry.first_resident;
+      ++stats_.levels_evicted;
+    }
+    if (stats_.resident_bytes <= config_.budget_bytes)
+    {
+      return;
+    }
+  }
+}
+
+void TextureManager::restore_used_textures()
+{
+  std::size_t working_set = 0U;
+  for (const auto& entry : entries_)
+  {
+    working_set += (entry.last_used == frame_) ? entry.full_bytes : 0U;
+  }
+  if ((config_.budget_bytes != 0U) && (working_set > config_.budget_bytes))
+  {
+    return; // Restoring would only evict another texture that is in use.
+  }
+
+  for (std::size_t handle = 0U; handle < entries_.size(); ++handle)
+  {
+    auto& entry = entries_[handle];
+    if ((entry.last_used == frame_) && (entry.first_resident > 0U) && !entry.reload_pending && !entry.path.empty())
+    {
+      entry.reload_pending = true;
+      ++stats_.reloads;
+      queue(static_cast<TextureHandle>(handle));
+    }
+  }
+}
+
+std::size_t TextureManager::resident_bytes(const Entry& entry)
+{
+  std::size_t bytes = 0U;
+  for (auto level = entry.first_resident; level < entry.levels.size(); ++level)
+  {
+    bytes += entry.levels[level].size_bytes();
+  }
+  return bytes;
+}
+
+} // namespace rtw::sw_renderer
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "sw_renderer/image_io.h"
+#include "sw_renderer/texture.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace rtw::sw_renderer
+{
+
+/// Decodes a file the built-in PPM/QOI decoders do not recognise, e.g. a PNG through SDL_image. Runs on the
+/// manager's worker threads, so it must be thread-safe.
+using ImageDecoder = std::function<std::optional<Image>(const std::filesystem::path&)>;
+
+/// Tuning of TextureManager.
+struct TextureManagerConfig
+{
+  std::size_t thread_count{2U};                  ///< Decode threads; at least one is started.
+  std::size_t budget_bytes{64U * 1024U * 1024U}; ///< Texel memory the resident mip levels may use; 0 is unlimited.
+  ImageDecoder fallback_decoder{};               ///< Used when the file is neither PPM nor QOI; none by default.
+};
+
+/// Identifies a texture of a TextureManager.
+using TextureHandle = std::uint32_t;
+
+enum class TextureStatus : std::uint8_t
+{
+  PENDING = 0U, ///< Queued or being decoded.
+  RESIDENT,     ///< At least its coarsest mip level is in memory.
+  FAILED,       ///< The file could not be read or decoded.
+};
+
+/// Counters of a TextureManager since it was created.
+struct TextureManagerStats
+{
+  std::size_t loads_completed{0U};
+  std::size_t loads_failed{0U};
+  std::size_t levels_evicted{0U};
+  std::size_t reloads{0U}; ///< Decodes requested to restore evicted levels.
+  std::size_t resident_bytes{0U};
+  std::chrono::steady_clock::duration total_load_latency{};
+  std::chrono::steady_clock::duration max_load_latency{};
+};
+
+/// Loads textures on a thread pool and keeps their mip chains within a memory budget.
+///
+/// `load()` queues a file; a worker reads it, decodes it (PPM or QOI locally, anything else through the
+/// configured fallback decoder), box-filters the mip chain down to 1x1 and hands the levels back. Every level is a
+/// Texture that adopts the decoder's pixel buffer, so the texels are never copied after decoding. The owning thread
+/// picks up finished loads in `update()`, which also enforces the budget: while the resident levels exceed it, the
+/// finest level of the least recently used texture is evicted, down to each texture's 1x1 level, so a texture never
+/// becomes unavailable. `texture()` marks a texture as used and returns its finest resident level. When the
+/// textures used since the previous `update()` all fit in the budget at full resolution, the evicted levels of
+/// those loaded from files are restored by decoding them again.
+///
+/// The load latency of a texture is the time from `load()` to the `update()` that makes it resident.
+///
+/// @note Except for the workers, the manager is single-threaded: call it from one thread. A pointer returned by
+/// `texture()` stays valid until the next `update()`, `wait_idle()` or the manager's destruction.
+class TextureManager
+{
+public:
+  using Config = TextureManagerConfig;
+  using Stats = TextureManagerStats;
+
+  explicit TextureManager(Config config = Config{});
+  TextureManager(const TextureManager&) = delete;
+  TextureManager(TextureManager&&) = delete;
+  TextureManager& operator=(const TextureManager&) = delete;
+  TextureManager& operator=(TextureManager&&) = delete;
+  /// Abandons the queued loads and joins the workers.
+  ~TextureManager();
+
+  const Config& config() const { return config_; }
+  const Stats& stats() const { return stats_; }
+
+  /// Queues @p path for decoding.
+  TextureHandle load(const std::filesystem::path& path);
+
+  /// Adds an image that is already decoded, e.g. generated in code, adopting its pixels. The mip chain is built on
+  /// the calling thread and the texture is resident immediately. It has no file to reload, so evicting its levels
+  /// is permanent.
+  TextureHandle adopt(Image image);
+
+  /// Takes over finished loads and enforces the budget.
+  void update();
+
+  /// Waits until every queued load is decoded, then calls `update()`.
+  void wait_idle();
+
+  TextureStatus status(TextureHandle handle) const;
+
+  /// The finest resident mip level of @p handle, or nullptr unless it is resident. Marks the texture as used.
+  const Texture* texture(TextureHandle handle);
+
+  /// Number of mip levels of @p handle (0 until it is resident) and how many of them are resident.
+  std::size_t level_count(TextureHandle handle) const;
+  std::size_t resident_level_count(TextureHandle handle) const;
+
+  /// Time from `load()` to residency; zero for adopted textures and those not yet resident.
+  std::chrono::steady_clock::duration load_latency(TextureHandle handle) const;
+
+private:
+  struct Entry
+  {
+    std::filesystem::path path; ///< Empty for adopted images.
+    TextureStatus status{TextureStatus::PENDING};
+    std::vector<Texture> levels; ///< Finest first; levels before `first_resident` are evicted (empty).
+    std::size_t full_bytes{0U}; ///< Size of all levels together.
+    std::size_t first_resident{0U};
+    bool reload_pending{false};
+    std::uint64_t last_used{0U}; ///< Value of `frame_` when `texture()` last returned it.
+    std::chrono::steady_clock::time_point requested{};
+    std::chrono::steady_clock::duration load_latency{};
+  };
+
+  struct Result
+  {
+    TextureHandle handle{0U};
+    std::optional<std::vector<Texture>> levels;
+  };
+
+  void work();
+  void queue(TextureHandle handle);
+  void integrate(Result& result);
+  void enforce_budget();
+  void restore_used_textures();
+  static std::size_t resident_bytes(const Entry& entry);
+
+  Config config_;
+  Stats stats_;
+  std::vector<Entry> entries_;
+  std::uint64_t frame_{1U}; ///< Incremented by every `update()`.
+
+  std::mutex mutex_;
+  std::condition_variable work_condition_;
+  std::condition_variable idle_condition_;
+  std::deque<std::pair<TextureHandle, std::filesystem::path>> jobs_;
+  std::vector<Result> results_;
+  std::size_t busy_workers_{0U};
+  bool stopping_{false};
+  std::vector<std::thread> workers_;
+};
+
+/// Box-filters @p image down to 1x1 and returns the levels, finest first, each adopting its own pixel buffer. Each
+/// level halves the size (rounding down) and averages the texels of the previous level that each texel covers.
+std::vector<Texture> make_mip_chain(Image image);
+
+} // namespace rtw::sw_renderer
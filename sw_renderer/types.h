@@ -5,6 +5,7 @@
 
 #include "math/angle.h"
 #include "math/barycentric.h"
+#include "math/bounding_box.h"
 #include "math/frustum.h"
 #include "math/matrix.h"
 #include "math/point.h"
@@ -57,6 +58,9 @@ using Matrix4x4D = math::Matrix4x4<double_precision>; ///< 4x4 matrix (double pr
 using Frustum3F = math::Frustum3<single_precision>; ///< 3D view frustum (single precision).
 using Frustum3D = math::Frustum3<double_precision>; ///< 3D view frustum (double precision).
 
+using BoundingBox3F = math::BoundingBox3<single_precision>; ///< 3D axis-aligned box (single precision).
+using BoundingBox3D = math::BoundingBox3<double_precision>; ///< 3D axis-aligned box (double precision).
+
 // --- Angles -----------------------------------------------------------------
 
 using AngleF = math::Angle<single_precision>; ///< Angle (single precision).